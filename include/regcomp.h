@@ -36,7 +36,10 @@
 __DECL_BEGIN
 
 /* RE error codes */
+#ifndef __re_errno_t_defined
+#define __re_errno_t_defined
 typedef int re_errno_t;
+#endif /* !__re_errno_t_defined */
 #define RE_NOERROR  0  /* Success. */
 #define RE_NOMATCH  1  /* Didn't find a match (for `regexec(3)'). */
 #define RE_BADPAT   2  /* General pattern syntax error. */
@@ -56,6 +59,7 @@ typedef int re_errno_t;
 #define RE_ERPAREN  16 /* Unmatched ')' (only when `RE_SYNTAX_UNMATCHED_RIGHT_PAREN_ORD' wasn't set) */
 #define RE_EILLSEQ  17 /* Illegal unicode character (when `RE_NO_UTF8' wasn't set) */
 #define RE_EILLSET  18 /* Tried to combine raw bytes with unicode characters in charsets (e.g. "[Ä\xC3]") */
+#define RE_ENOSYS   19 /* Pattern can't be matched the way that was requested (e.g. with `RE_EXEC_LINEAR', or by a stream, when it uses back-references) */
 
 
 
@@ -128,6 +132,10 @@ typedef int re_errno_t;
  *     >>            2:  <Z>
  *     >>            3:
  *
+ *     >> "foo|bar|..."  REOP_TRIE {"foo", "bar", ...}   // If all alternatives are literals, and there are enough of them
+ *                                                       // (not used with `RE_SYNTAX_NO_POSIX_BACKTRACKING', where the
+ *                                                       // order of alternatives matters)
+ *
  *     >> "X?"           REOP_JMP_ONFAIL 1f
  *     >>                <X>
  *     >>                REOP_MAYBE_POP_ONFAIL   // Replaced with `REOP_POP_ONFAIL_AT 1f'
@@ -490,6 +498,7 @@ for (local segment: [0x64:0xe3+1].segments(4)) {
 	case RECS_ISEMPTY:   case RECS_ISLF:      case RECS_ISHEX:    case RECS_ISTITLE: \
 	case RECS_ISNUMERIC
 #define RECS_ISX_MIN RECS_ISCNTRL
+	/* NOTE: Once compiled, `REOP_[N]CS_UTF8' no longer contain these (s.a. `RECS_ISX_MASK') */
 	RECS_ISCNTRL,           /* [+0] consume trait `unicode_iscntrl(ch)'   (ONLY VALID IN UTF-8 MODE) */
 	RECS_ISSPACE,           /* [+0] consume trait `unicode_isspace(ch)'   (ONLY VALID IN UTF-8 MODE) */
 	RECS_ISUPPER,           /* [+0] consume trait `unicode_isupper(ch)'   (ONLY VALID IN UTF-8 MODE) */
@@ -528,9 +537,36 @@ for (local segment: [0x64:0xe3+1].segments(4)) {
 	RECS_CONTAINS,          /* [+1+n] Followed by a COUNT-byte, followed by a `COUNT'-character long byte/utf-8 string.
 	                         * Whether or not COUNT are bytes/utf-8 depends on the `REOP_CS_*' starting opcode. Matches
 	                         * a character contained in said string. NOTE: COUNT must be >= 3 */
+	RECS_ISX_MASK,          /* [+2] Followed by a 16-bit (unaligned) mask of `__UNICODE_IS*' flags (ONLY VALID IN UTF-8 MODE)
+	                         *      Matches characters with any of those traits, such that all traits of a charset only take
+	                         *      a single `__unicode_descriptor()' lookup (e.g. "[[:alpha:][:digit:]_-]") */
+	RECS_CONTAINS_SORTED,   /* [+2+n] Followed by a 16-bit (unaligned) byte-length `N', followed by an `N'-byte long utf-8 string
+	                         *      of characters sorted ascendingly by their ordinal values. Matches a character contained in
+	                         *      said string, which is done via binary search (ONLY VALID IN UTF-8 MODE)
+	                         *      Used instead of `RECS_CONTAINS' for long lists of characters (e.g. lists of emoji) */
 };
 
 
+/************************************************************************/
+/* Regex trie nodes (operand of `REOP_TRIE')                            */
+/************************************************************************/
+/* Every node starts with a header byte:
+ *  - RETRIE_LEAF:   [+0]      Node has no children (RETRIE_ACCEPT must be set)
+ *  - RETRIE_RUN:    [+n]      Followed by `n = HDR & RETRIE_RUNMASK' (>= 1) bytes that must be
+ *                             matched  exactly,  which  are  followed  by  the  next  node
+ *  - RETRIE_BRANCH: [+1+3*n]  Followed  by  1  byte  N  (n  = N + 1; n >= 2), n sorted (ascending)
+ *                             bytes, and n 16-bit offsets of the child nodes for each of them
+ * Offsets of nodes are relative to the `REOP_TRIE' opcode, and the root node
+ * (which never has `RETRIE_ACCEPT' set) is always at `RETRIE_ROOT'. */
+#define RETRIE_ACCEPT  0x80 /* Flag: a literal ends at this node */
+#define RETRIE_RUN     0x40 /* Flag: node is a run of bytes */
+#define RETRIE_RUNMASK 0x3f /* Mask for the length of a run */
+#define RETRIE_LEAF    0x00 /* Node has no children */
+#define RETRIE_BRANCH  0x01 /* Node has at least 2 children */
+#define RETRIE_ROOT    3    /* Offset of the root node */
+
+
+
 /************************************************************************/
 /* Regex opcodes (always encoded as a single byte)                      */
 /************************************************************************/
@@ -541,10 +577,13 @@ enum {
 	                            * NOTE: N must be >= 2 */
 	REOP_EXACT_ASCII_ICASE,    /* [+1+n] Like 'REOP_EXACT', but strings are both ascii, and casing should be ignored (used instead of
 	                            * `REOP_EXACT_UTF8_ICASE' when the pattern string is ascii-only, or when `RE_SYNTAX_NO_UTF8' was set)
-	                            * NOTE: N must be >= 2 */
+	                            * NOTE: N must be >= 2
+	                            * NOTE: ASCII letters of the string are always lower-case */
 	REOP_EXACT_UTF8_ICASE,     /* [+1+n] Followed  by  a  COUNT-byte, followed  by  a `COUNT'-character
 	                            * long utf-8 string (matches utf-8 character contained in said string).
-	                            * NOTE: COUNT must be >= 1 */
+	                            * NOTE: COUNT must be >= 1
+	                            * NOTE: Characters of the string are always folded via `unicode_tolower(3)',
+	                            *       except for non-ascii characters whose lower-case is ascii (e.g. U+212A) */
 
 #ifdef REOP_ANY
 #define REOP_ANY_MIN REOP_ANY
@@ -642,9 +681,10 @@ enum {
 	REOP_NBYTE2,               /* [+2] Followed by 2 bytes, neither of which may be matched (the 2 bytes must be sorted ascendingly) */
 	REOP_RANGE,                /* [+2] Followed by 2 bytes, with input having to match `ch >= pc[0] && ch <= pc[1]' */
 	REOP_NRANGE,               /* [+2] Followed by 2 bytes, with input having to match `ch < pc[0] || ch > pc[1]' */
-	/* TODO: Re-design `REOP_CONTAINS_UTF8' / `REOP_NCONTAINS_UTF8'  to allow for binary  search!
-	 *       For this, instead of encoding a COUNT-byte, we need to encode the actual # of bytes,
-	 *       with the assumption that the # of bytes ends at the perfect end of a utf-8 char. */
+	REOP_BITSET,               /* [+32] Followed by a 256-bit bitset, with input having to match `pc[ch / 8] & (1 << (ch % 8))'
+	                            * - Used for byte-based charsets that can't be encoded as one of the above (instead of `REOP_CS_BYTE') */
+	/* NOTE: `REOP_[N]CONTAINS_UTF8' are only used for short lists of characters. Longer
+	 *       ones are encoded as `REOP_[N]CS_UTF8' with `RECS_CONTAINS_SORTED' instead. */
 	REOP_CONTAINS_UTF8,        /* [+1+n] Followed by a COUNT-byte, followed by a `COUNT'-character long utf-8 string
 	                            * - Matches utf-8 character contained in said string
 	                            * - The utf-8 character in the follow-up string must be sorted ascendingly by their ordinal values
@@ -653,9 +693,24 @@ enum {
 	                            * - Matches utf-8 character NOT contained in said string
 	                            * - The utf-8 character in the follow-up string must be sorted ascendingly by their ordinal values
 	                            * NOTE: COUNT must be >= 1 */
-	REOP_CS_UTF8,              /* [+*] Followed by a `RECS_*' sequence which the next utf-8 character must match */
+	REOP_CS_UTF8,              /* [+16+*] Followed by a 128-bit bitset of matching ASCII characters (layout like `REOP_BITSET'),
+	                            * followed by a `RECS_*' sequence which the next (non-ASCII) utf-8 character must match
+	                            * - The sequence never contains `RECS_BITSET_*' (those can only match ASCII characters)
+	                            * - The sequence never contains `RECS_IS*' (those are merged into a single, leading `RECS_ISX_MASK') */
 	REOP_CS_BYTE,              /* [+*] Followed by a `RECS_*' sequence which the next byte must match */
-	REOP_NCS_UTF8,             /* [+*] Followed by a `RECS_*' sequence which the next utf-8 character must not match */
+	REOP_NCS_UTF8,             /* [+16+*] Same as `REOP_CS_UTF8', but the next utf-8 character must not be matched */
+	REOP_SEQ_UTF8,             /* [+16+*] Followed by a 128-bit bitset of matching ASCII characters (layout like `REOP_BITSET'),
+	                            * followed by a 0-terminated list of byte-range sequences matching multi-byte characters:
+	                            * >> [N (2-4)] [LO_1, HI_1] ... [LO_N, HI_N]   // Byte #i must be in `[LO_i, HI_i]'
+	                            * - Sequences are sorted ascendingly by the characters they match (and so by `LO_1')
+	                            * - Sequences only match the shortest encoding of characters `<= 0x1fffff'. Any other
+	                            *   input is decoded (s.a. `unicode_readutf8()') and re-encoded before being matched.
+	                            * - Used for `REOP_CS_UTF8'-charsets made up of only characters and ranges, so matching
+	                            *   (well-formed) utf-8 input never has to decode it */
+	REOP_NSEQ_UTF8,            /* [+16+*] Same as `REOP_SEQ_UTF8', but the next utf-8 character must not be matched */
+	REOP_TRIE,                /* [+2+n] Followed by a 16-bit N, followed by N bytes of `RETRIE_*' nodes, which encode a
+	                            * set of (non-empty) literals, any one of which must be matched. Longer literals are tried
+	                            * first  (shorter ones upon  fail), as though this  was an alternation  of the literals */
 	REOP_GROUP_MATCH,          /* [+1] Re-match the contents of the (N = *PC++)'th already-matched group; If group start/end aren't, triggers a match-failure. */
 #define case_REOP_GROUP_MATCH_JMIN_to_JMAX                                         \
 	case REOP_GROUP_MATCH_J3: case REOP_GROUP_MATCH_J4:  case REOP_GROUP_MATCH_J5: \
@@ -743,6 +798,18 @@ enum {
 	REOP_JMP_ONFAIL_DUMMY,      /* [+0] Like `REOP_JMP_ONFAIL_DUMMY_AT', but the produced on-failure item can't be identified by `REOP_POP_ONFAIL_AT' */
 	REOP_JMP,                   /* [+2] 16-bit, signed, relative jump (relative to instruction end) */
 	REOP_JMP_AND_RETURN_ONFAIL, /* [+2] push onto the "on-failure stack" the address of the next instruction before doing `REOP_JMP' */
+	REOP_SPAN,                  /* [+2] Same as `REOP_JMP_AND_RETURN_ONFAIL', but the jump always goes back to a single-character opcode `X',
+	                             * which is  followed by `REOP_POP_ONFAIL'  and then this  opcode. Rather  than running that  loop once  per
+	                             * character, consume all repetitions of `X' at once and continue with the next instruction.
+	                             * - Only generated by the peephole optimizer (before that, it's a `REOP_JMP_AND_RETURN_ONFAIL') */
+	REOP_SPAN_AND_RETURN_ONFAIL, /* [+2] Same as `REOP_SPAN', but `X' is directly followed by this opcode (no `REOP_POP_ONFAIL'), meaning
+	                             * that repetitions may have to be given back. For this purpose, push a single pair of on-fail items
+	                             * from which that happens one repetition at a time (rather than 1 item per repetition) */
+	REOP_SPAN_LIT,              /* [+2] Same as `REOP_SPAN', but the next instruction (after any number of `REOP_GROUP_START' / `REOP_GROUP_END')
+	                             * is a `REOP_BYTE' or `REOP_EXACT'. Offsets where that literal doesn't appear are skipped (using `memrchr(3)')
+	                             * - Only generated by the peephole optimizer (before that, it's a `REOP_JMP_AND_RETURN_ONFAIL') */
+	REOP_SPAN_LIT_AND_RETURN_ONFAIL, /* [+2] Same as `REOP_SPAN_AND_RETURN_ONFAIL', but like `REOP_SPAN_LIT', skip offsets
+	                             * where the following literal doesn't appear (when matching, and when giving back) */
 	REOP_DEC_JMP,               /* [+3] VAR = VARS[*PC++]; if VAR != 0, do `--VAR', followed by `REOP_JMP'; else, do nothing (and leave `VAR' unchanged) */
 	REOP_DEC_JMP_AND_RETURN_ONFAIL, /* [+3] VAR = VARS[*PC++]; if VAR != 0, do `--VAR', followed by `REOP_JMP_AND_RETURN_ONFAIL'; else, do nothing (and leave `VAR' and the "on-failure stack" unchanged) */
 	REOP_SETVAR,                /* [+2] VAR = VARS[*PC++]; VAR = *PC++; */
@@ -904,6 +971,32 @@ struct re_code {
 #define RE_CODE_FLAG_NORMAL     0x00 /* Normal flags. */
 #define RE_CODE_FLAG_NEEDGROUPS 0x01 /* Groups are expected to be correct (set if `REOP_GROUP_MATCH*' opcodes are used) */
 #define RE_CODE_FLAG_OPTGROUPS  0x02 /* The regex code contains optional groups (e.g. "foo(x)?bar" or "foo(|b(a)r)") */
+#define RE_CODE_FLAG_POPPRUNES  0x04 /* The  peephole optimizer inserted `REOP_POP_ONFAIL[_AT]' opcodes that may discard
+                                      * on-fail items which could still have produced a (longer) match (e.g. "b.*.").
+                                      * Code with this flag can only be executed by the backtracking interpreter. */
+	/* NOTE: `rc_code' is a trailing flexible array, so the fields below grow the header and
+	 *       move `rc_code' (libregex itself only ever uses `offsetof(struct re_code, rc_code)',
+	 *       but code built against an older version of this header must be re-compiled). */
+	__uint8_t  rc_pfxlen;    /* Length of a literal byte-prefix that every match must start with (or `0' if unknown)
+	                          * When non-zero, `re_exec_search(3R)' only  starts `rc_code' at offsets where input
+	                          * begins with these bytes (which can be found via `memchr(3)', rather than having to
+	                          * start the interpreter for every single offset). */
+	__uint16_t rc_pfxoff;    /* [valid_if(rc_pfxlen != 0)] Offset into `rc_code' where the `rc_pfxlen' prefix bytes are stored. */
+	__uint8_t  rc_mustlen;   /* Length of a literal byte-sequence that every match must contain (or `0' if unknown)
+	                          * Used by `re_exec_search(3R)'  to reject input that doesn't  contain this literal,
+	                          * and to narrow the range of possible starting offsets around each occurrence. */
+	__uint16_t rc_mustoff;   /* [valid_if(rc_mustlen != 0)] Offset into `rc_code' where the `rc_mustlen' bytes are stored. */
+	__uint16_t rc_mustmin;   /* [valid_if(rc_mustlen != 0)] Min # of bytes between the start of a match and the literal (allowed to be too small) */
+	__uint16_t rc_mustmax;   /* [valid_if(rc_mustlen != 0)] Max # of bytes between the start of a match and the literal (allowed to be too large) */
+#define RE_CODE_MUSTMAX_UNBOUNDED 0xffff /* Special value for `rc_mustmax': the literal can appear arbitrarily far into a match. */
+	__uint8_t  rc_mlcount;   /* # of literals in `rc_mlits' (or `0' if unknown; always `0' when `rc_pfxlen != 0')
+	                          * When non-zero, every match starts with the leading `rc_mllen' bytes of one of these,
+	                          * and `re_exec_search(3R)' looks for all of them at once, a machine word of input at a
+	                          * time (e.g. "GET|POST|PUT|DELETE" only gets started at "GET", "POS", "PUT" or "DEL") */
+	__uint8_t  rc_mllen;     /* [valid_if(rc_mlcount != 0)] # of leading bytes stored per literal (in `[2, RE_CODE_MLITS_LEN]') */
+#define RE_CODE_MLITS_MAX 8 /* Max # of literals in `rc_mlits' */
+#define RE_CODE_MLITS_LEN 3 /* Max # of leading bytes stored per literal in `rc_mlits' */
+	__byte_t   rc_mlits[RE_CODE_MLITS_MAX][RE_CODE_MLITS_LEN]; /* [rc_mlcount][rc_mllen] Leading bytes of literals */
 	__COMPILER_FLEXIBLE_ARRAY(__byte_t, rc_code); /* Code buffer (`REOP_*' instruction stream) */
 };
 #endif /* !__re_code_defined */
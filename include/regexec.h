@@ -31,6 +31,12 @@ __DECL_BEGIN
 
 struct re_code;
 
+/* RE error codes (s.a. `RE_NOERROR' and friends in <libregex/regcomp.h>) */
+#ifndef __re_errno_t_defined
+#define __re_errno_t_defined
+typedef int re_errno_t;
+#endif /* !__re_errno_t_defined */
+
 /* Flags for `struct re_exec::rx_eflags' */
 #ifndef RE_EXEC_NOTBOL
 #define RE_EXEC_NOTBOL 0x0001 /* '^' (REOP_AT_SOL) doesn't match at the start of the input buffer (but only at an actual begin-of-line) */
@@ -38,6 +44,20 @@ struct re_code;
 #ifndef RE_EXEC_NOTEOL
 #define RE_EXEC_NOTEOL 0x0002 /* '$' (REOP_AT_EOL) doesn't match at the end of the input buffer (but only before an actual line-feed) */
 #endif /* !RE_EXEC_NOTEOL */
+#ifndef RE_EXEC_LINEAR
+#define RE_EXEC_LINEAR 0x0004 /* Don't backtrack, but follow all alternatives at once (in time linear to the input length, even
+                               * for patterns like "(a|aa)*b"). Patterns that can't be executed like this (ones that use
+                               * back-references, or bounded repetitions that are compiled into counters; s.a. `REOP_SETVAR')
+                               * make matches and searches of non-empty input fail with `RE_ENOSYS' (rather than backtrack),
+                               * as does malformed utf-8 in the input of a pattern that is matched as utf-8. Because no
+                               * alternatives are ever pruned, a longer match may be found than without this flag, and when
+                               * multiple equally long matches exist, group offsets may differ from the ones that would have
+                               * been produced without it. */
+#endif /* !RE_EXEC_LINEAR */
+#ifndef RE_EXEC_CTX
+#define RE_EXEC_CTX    0x0008 /* `struct re_exec::rx_ctx' is valid: re-use (and keep) the buffers it holds, rather than allocating
+                               * new ones every time. Without this flag, `rx_ctx' is never accessed (and needn't be initialized) */
+#endif /* !RE_EXEC_CTX */
 
 /* *sigh* this has to be an int for Glibc compat (but it should have been a `size_t')
  * NOTE: When nothing got matched for some given group, set to `RE_REGOFF_UNSET'. */
@@ -60,6 +80,39 @@ typedef struct {
 } re_regmatch_t;
 #endif /* !__re_regmatch_t_defined */
 
+#ifndef __re_exec_ctx_defined
+#define __re_exec_ctx_defined
+/* Buffers that  can be  kept alive  in-between calls  to `re_exec_*(3R)'  (for use  with
+ * `RE_EXEC_CTX'). Before its first use, a context must be initialized by `re_exec_ctx_init',
+ * and once it's no longer needed, it must be finalized using `re_exec_ctx_fini'.
+ * The same context must never be used by more than one call at the same time (iow:
+ * you probably want to have one of these per thread). It can be used with any pattern,
+ * and keeps the machine code of the one that was last executed often enough (if that
+ * is supported), so that later calls with the same pattern can use it right away. */
+struct re_exec_ctx {
+	void       *rxc_onfailv; /* [0..rxc_onfaila][owned] On-failure stack of the interpreter */
+	__size_t    rxc_onfaila; /* Allocated # of on-failure stack items */
+	void       *rxc_memov;   /* [0..rxc_memoa][owned] Bitmap of (pc, offset) pairs known to fail */
+	__size_t    rxc_memoa;   /* Allocated # of bytes in `rxc_memov' */
+	void       *rxc_jit;     /* [0..1][owned] Machine code of the last pattern that was executed often enough (if supported) */
+	void const *rxc_jitcode; /* [0..1] Pattern of the last call (for which `rxc_jitwait' applies) */
+	__size_t    rxc_jitwait; /* # of match attempts with `rxc_jitcode' left before machine code is created for it */
+};
+#define RE_EXEC_CTX_INIT { __NULLPTR, 0, __NULLPTR, 0, __NULLPTR, __NULLPTR, 0 }
+#define re_exec_ctx_init(self)                                           \
+	(void)((self)->rxc_onfailv = __NULLPTR, (self)->rxc_onfaila = 0, \
+	       (self)->rxc_memov = __NULLPTR, (self)->rxc_memoa = 0,     \
+	       (self)->rxc_jit = __NULLPTR, (self)->rxc_jitcode = __NULLPTR, (self)->rxc_jitwait = 0)
+#endif /* !__re_exec_ctx_defined */
+
+/* Free all buffers (and machine code) held by a context initialized by `re_exec_ctx_init' */
+typedef __ATTR_NONNULL_T((1)) void
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_EXEC_CTX_FINI)(struct re_exec_ctx *__restrict self);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_NONNULL((1)) void
+__NOTHROW_NCX(LIBREGEX_CC re_exec_ctx_fini)(struct re_exec_ctx *__restrict self);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
 #ifndef __re_exec_defined
 #define __re_exec_defined
 struct iovec;
@@ -90,14 +143,16 @@ struct re_exec {
 	                                    * to read this extra memory in order to check matches. */
 #endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
 	unsigned int          rx_eflags;   /* Execution-flags (set of `RE_EXEC_*') */
+	struct re_exec_ctx   *rx_ctx;      /* [1..1][valid_if(rx_eflags & RE_EXEC_CTX)] Buffers to re-use (and to leave behind for the next call) */
 };
 #endif /* !__re_exec_defined */
 
 /* Execute a regular expression.
  * @return: >= 0:        The # of bytes starting at `exec->rx_startoff' that got matched.
  * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
  * @return: -RE_ESPACE:  Out of memory
- * @return: -RE_ESIZE:   On-failure stack became too large. */
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
 typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) __ssize_t
 __NOTHROW_NCX_T(LIBREGEX_CC *PRE_EXEC_MATCH)(struct re_exec const *__restrict exec);
 #ifdef LIBREGEX_WANT_PROTOTYPES
@@ -114,8 +169,9 @@ __NOTHROW_NCX(LIBREGEX_CC re_exec_match)(struct re_exec const *__restrict exec);
  *                       This would have  been the return  value of  `re_exec_match(3R)'.
  * @return: >= 0:        The offset where the matched area starts (in `[exec->rx_startoff, exec->rx_startoff + search_range)').
  * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
  * @return: -RE_ESPACE:  Out of memory
- * @return: -RE_ESIZE:   On-failure stack became too large. */
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
 typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) __ssize_t
 __NOTHROW_NCX_T(LIBREGEX_CC *PRE_EXEC_SEARCH)(struct re_exec const *__restrict exec,
                                               __size_t search_range, __size_t *p_match_size);
@@ -150,6 +206,282 @@ __NOTHROW_NCX(LIBREGEX_CC re_exec_rsearch)(struct re_exec const *__restrict exec
                                            __size_t search_range, __size_t *p_match_size);
 #endif /* LIBREGEX_WANT_PROTOTYPES */
 
+/* Same as `re_exec_search(3R)', but split the range of starting offsets between
+ * up to `nthreads' threads that all search their part at the same time.  Every
+ * thread can still read all of the input for its match attempts, so the result
+ * (including groups written to `rx_pmatch') is the same as that of a call  to
+ * `re_exec_search(3R)'. Only worth it for very large inputs; for small search
+ * ranges (or with `RE_EXEC_LINEAR'), this just calls `re_exec_search(3R)'.
+ * Every call creates (and joins) its own threads with `pthread_create(3)', and
+ * every thread also sets up its own interpreter, DFA, etc. Because of this, a
+ * thread is only used for every 256KiB of starting offsets (at least), and no
+ * thread ever runs once this function has returned.
+ * NOTE: Threads are only used when libregex was built with `LIBREGEX_REGEXEC_THREADS'.
+ *       Otherwise, this function is always the same as `re_exec_search(3R)'.
+ * @param: nthreads: Max # of threads to use (including the calling thread),
+ *                   or `0' to use one per online CPU. */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) __ssize_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_EXEC_SEARCH_PARALLEL)(struct re_exec const *__restrict exec,
+                                                       __size_t search_range, __size_t *p_match_size,
+                                                       unsigned int nthreads);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1)) __ssize_t
+__NOTHROW_NCX(LIBREGEX_CC re_exec_search_parallel)(struct re_exec const *__restrict exec,
+                                                   __size_t search_range, __size_t *p_match_size,
+                                                   unsigned int nthreads);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Same as calling `re_exec_match(3R)' / `re_exec_search(3R)' for each of `inputs', except
+ * that whatever has to be set up for matching is only done once for all of them. Every
+ * input is matched from its start until its end (`rx_iov', `rx_startoff', `rx_endoff'
+ * and `rx_extra' of `exec' are ignored).
+ * @param: inputs:      [0..count] Inputs to match (each as a single chunk of input)
+ * @param: results:     [1..count] Results for each of `inputs' (as would be returned by
+ *                      `re_exec_match(3R)' / `re_exec_search(3R)' for that input). This
+ *                      is always written for every input, even when an error is returned.
+ * @param: match_sizes: [0..count] When non-NULL, match sizes for each of `inputs' (only
+ *                      valid for inputs where `results[i] >= 0')
+ * NOTE: `exec->rx_pmatch' must have space for `count * exec->rx_nmatch' groups. Those of
+ *       `inputs[i]' are written to `exec->rx_pmatch[i * exec->rx_nmatch]', and are left
+ *       in an undefined state when `results[i] < 0'.
+ * NOTE: An error (e.g. `-RE_ESPACE') for one input doesn't stop the batch: all following
+ *       inputs are still matched, and get their own result in `results' (which may be the
+ *       same error again, or a normal result when that input didn't need more memory).
+ * @return: >= 0: The # of inputs that were matched (iow: where `results[i] >= 0'), when
+ *                no input resulted in an error (`-RE_NOMATCH' isn't an error here)
+ * @return: < 0:  The first error (other than `-RE_NOMATCH') found in `results'. The # of
+ *                matched inputs isn't returned in this case, but all of `results' (and the
+ *                groups/match sizes of inputs with `results[i] >= 0') are still valid. */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1, 4)) __ssize_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_EXEC_MATCH_BATCH)(struct re_exec const *__restrict exec,
+                                                   struct iovec const *inputs, __size_t count,
+                                                   __ssize_t *results);
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1, 4)) __ssize_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_EXEC_SEARCH_BATCH)(struct re_exec const *__restrict exec,
+                                                    struct iovec const *inputs, __size_t count,
+                                                    __ssize_t *results, __size_t *match_sizes);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1, 4)) __ssize_t
+__NOTHROW_NCX(LIBREGEX_CC re_exec_match_batch)(struct re_exec const *__restrict exec,
+                                               struct iovec const *inputs, __size_t count,
+                                               __ssize_t *results);
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1, 4)) __ssize_t
+__NOTHROW_NCX(LIBREGEX_CC re_exec_search_batch)(struct re_exec const *__restrict exec,
+                                                struct iovec const *inputs, __size_t count,
+                                                __ssize_t *results, __size_t *match_sizes);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+
+/* Iterator over all matches in some input (s.a. `re_findall_new(3R)') */
+struct re_findall;
+
+/* Create an iterator that returns all matches of `exec->rx_code' in the input of
+ * `exec' (one per call to `re_findall_next(3R)'). This is the same as repeatedly
+ * calling `re_exec_search_noepsilon(3R)', and starting every search at the end of
+ * the previous match, except that whatever  searches have to set up is only  set
+ * up once, and then re-used for all matches.
+ * @param: exec:  Exec command block (copied, but the input and `rx_pmatch' that
+ *                it references must be kept alive until the iterator is destroyed)
+ * @return: * :   The new iterator (to be destroyed using `re_findall_destroy(3R)')
+ * @return: NULL: Out of memory */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) struct re_findall *
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_FINDALL_NEW)(struct re_exec const *__restrict exec);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1)) struct re_findall *
+__NOTHROW_NCX(LIBREGEX_CC re_findall_new)(struct re_exec const *__restrict exec);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Destroy an iterator previously created by `re_findall_new(3R)' */
+typedef __ATTR_NONNULL_T((1)) void
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_FINDALL_DESTROY)(struct re_findall *__restrict self);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_NONNULL((1)) void
+__NOTHROW_NCX(LIBREGEX_CC re_findall_destroy)(struct re_findall *__restrict self);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Return the next match of `self'. Matches are returned in order, never overlap,
+ * and are never empty (s.a. `re_exec_search_noepsilon(3R)'). Group offsets of the
+ * match are written to the `rx_pmatch' buffer of the exec command block that was
+ * given to `re_findall_new(3R)', and remain valid until the next call.
+ * @param: p_match_size: When non-NULL, set to the # of bytes that were matched.
+ * @return: >= 0:        The offset where the matched area starts
+ * @return: -RE_NOMATCH: There are no more matches
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits).
+ * Once an error (or `-RE_NOMATCH') was returned, all further calls return it, too. */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) __ssize_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_FINDALL_NEXT)(struct re_findall *__restrict self,
+                                               __size_t *p_match_size);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1)) __ssize_t
+__NOTHROW_NCX(LIBREGEX_CC re_findall_next)(struct re_findall *__restrict self,
+                                           __size_t *p_match_size);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+
+/* Pattern set (s.a. `re_set_new(3R)') */
+struct re_set;
+
+/* Create a set of patterns that can all be matched against the same input at
+ * once (in a single pass over input, rather than one per pattern, where possible)
+ * Sets cache what they learn about patterns while scanning input, so the same set
+ * must never be used by more than one call at the same time.
+ * @param: codev: [codec] Patterns of the set (the caller must keep them alive
+ *                until the set is destroyed, but not the vector itself)
+ * @return: * :   The new set (to be destroyed using `re_set_destroy(3R)')
+ * @return: NULL: Out of memory */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) struct re_set *
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_SET_NEW)(struct re_code const *const *__restrict codev, __size_t codec);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1)) struct re_set *
+__NOTHROW_NCX(LIBREGEX_CC re_set_new)(struct re_code const *const *__restrict codev, __size_t codec);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Compile `patternv' (each using `syntax', s.a. `re_compiler_init(3R)') and
+ * create a set of them, the same way `re_set_new(3R)' would. Compiled patterns
+ * belong to the set, and are freed by `re_set_destroy(3R)'.
+ * @param: patternv:    [patternc] NUL-terminated patterns of the set
+ * @param: p_errindex:  [0..1] Set to the index of the pattern that didn't compile
+ * @return: RE_NOERROR: Success (`*p_set' is the new set)
+ * @return: RE_ESPACE:  Out of memory
+ * @return: * :         Error of `re_compiler_compile(3R)' for `patternv[*p_errindex]' */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) re_errno_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_SET_COMPILE)(struct re_set **__restrict p_set,
+                                              char const *const *patternv, __size_t patternc,
+                                              __uintptr_t syntax, __size_t *p_errindex);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1)) re_errno_t
+__NOTHROW_NCX(LIBREGEX_CC re_set_compile)(struct re_set **__restrict p_set,
+                                          char const *const *patternv, __size_t patternc,
+                                          __uintptr_t syntax, __size_t *p_errindex);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Destroy a set previously created by `re_set_new(3R)' or `re_set_compile(3R)' */
+typedef __ATTR_NONNULL_T((1)) void
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_SET_DESTROY)(struct re_set *__restrict self);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_NONNULL((1)) void
+__NOTHROW_NCX(LIBREGEX_CC re_set_destroy)(struct re_set *__restrict self);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Check which patterns of `self' match somewhere in the input of `exec' (with
+ * the same semantics as `re_exec_search(3R)' for an unlimited search range).
+ * `exec->rx_code', `exec->rx_nmatch' and `exec->rx_pmatch' are ignored.
+ * @param: matches: [(codec + 7) / 8] Bitset of patterns that match (bit `i % 8'
+ *                  of `matches[i / 8]' is set if `codev[i]' matches)
+ * @return: >= 0:        The # of patterns that match
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1, 2, 3)) __ssize_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_SET_EXEC)(struct re_set *__restrict self,
+                                           struct re_exec const *__restrict exec,
+                                           __byte_t *__restrict matches);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1, 2, 3)) __ssize_t
+__NOTHROW_NCX(LIBREGEX_CC re_set_exec)(struct re_set *__restrict self,
+                                       struct re_exec const *__restrict exec,
+                                       __byte_t *__restrict matches);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Same as `re_set_exec(3R)', but only return the index of the pattern whose match
+ * starts first (as per `re_exec_search(3R)'). When more than one pattern matches
+ * at that offset, the one that comes first in `codev' is returned.
+ * @return: >= 0:        Index of the pattern with the leftmost match
+ * @return: -RE_NOMATCH: No pattern matches
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1, 2)) __ssize_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_SET_FIRST)(struct re_set *__restrict self,
+                                            struct re_exec const *__restrict exec);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1, 2)) __ssize_t
+__NOTHROW_NCX(LIBREGEX_CC re_set_first)(struct re_set *__restrict self,
+                                        struct re_exec const *__restrict exec);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+
+/* Stream of input that arrives piece by piece (s.a. `re_stream_new(3R)') */
+struct re_stream;
+
+/* Create a stream for searching `code' in input that isn't available all at once
+ * (e.g. because it is being received from a socket). Input is passed to the stream
+ * by `re_stream_feed(3R)' as it arrives, and its end is marked by `re_stream_finish(3R)'.
+ * In-between, `re_stream_next(3R)' returns matches as soon as no further input can
+ * change them. Only input that may still be part of a match is kept by the stream
+ * (though for patterns like "a.*b", that can be a lot of it). Telling when a match
+ * is final needs a DFA, so patterns that use back-references, or that aren't
+ * compiled for POSIX backtracking are rejected with `RE_ENOSYS'.
+ * @param: code:        Pattern to search for (must be kept alive until the stream is destroyed)
+ * @param: eflags:      Set of `RE_EXEC_NOTBOL | RE_EXEC_NOTEOL | RE_EXEC_LINEAR'
+ * @return: RE_NOERROR: Success (`*p_stream' is the new stream, to be destroyed using `re_stream_destroy(3R)')
+ * @return: RE_ESPACE:  Out of memory
+ * @return: RE_ENOSYS:  `code' can't be matched by a stream */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1, 2)) re_errno_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_STREAM_NEW)(struct re_stream **__restrict p_stream,
+                                             struct re_code const *__restrict code,
+                                             unsigned int eflags);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1, 2)) re_errno_t
+__NOTHROW_NCX(LIBREGEX_CC re_stream_new)(struct re_stream **__restrict p_stream,
+                                         struct re_code const *__restrict code,
+                                         unsigned int eflags);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Destroy a stream previously created by `re_stream_new(3R)' */
+typedef __ATTR_NONNULL_T((1)) void
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_STREAM_DESTROY)(struct re_stream *__restrict self);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_NONNULL((1)) void
+__NOTHROW_NCX(LIBREGEX_CC re_stream_destroy)(struct re_stream *__restrict self);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Append `size' bytes from `data' to the input of `self' (`data' is copied, and
+ * needn't remain valid after this returns). Must not be called after `re_stream_finish(3R)'
+ * @return: RE_NOERROR: Success
+ * @return: RE_ESPACE:  Out of memory */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1)) re_errno_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_STREAM_FEED)(struct re_stream *__restrict self,
+                                              void const *__data, __size_t __size);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1)) re_errno_t
+__NOTHROW_NCX(LIBREGEX_CC re_stream_feed)(struct re_stream *__restrict self,
+                                          void const *__data, __size_t __size);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Mark the end of the input of `self'. After this, `re_stream_next(3R)' returns
+ * all of the remaining matches (including ones that end at the end of input) */
+typedef __ATTR_NONNULL_T((1)) void
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_STREAM_FINISH)(struct re_stream *__restrict self);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_NONNULL((1)) void
+__NOTHROW_NCX(LIBREGEX_CC re_stream_finish)(struct re_stream *__restrict self);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
+/* Return the next match in the input of `self'. Matches are returned in order, never
+ * overlap, and are never empty (s.a. `re_exec_search_noepsilon(3R)', which is what a
+ * search of all input, starting at the end of the previous match, would return).
+ * Group offsets aren't produced.
+ * @param: p_match_start: Set to the absolute offset where the match starts (counting
+ *                        all bytes ever passed to `re_stream_feed(3R)')
+ * @return: > 0:          The # of bytes that were matched
+ * @return: -RE_NOMATCH:  No further match is known yet (after `re_stream_finish(3R)':
+ *                        there are no more matches)
+ * @return: -RE_ENOSYS:   The DFA gave up on input that needed too many states. From
+ *                        then on, all input is kept, and matches are only returned
+ *                        after `re_stream_finish(3R)' (the caller may also give up)
+ * @return: -RE_ESPACE:   Out of memory
+ * @return: -RE_ESIZE:    On-failure stack became too large (or the input that
+ *                        has to be kept doesn't fit into 32 bits). */
+typedef __ATTR_WUNUSED_T __ATTR_NONNULL_T((1, 2)) __ssize_t
+__NOTHROW_NCX_T(LIBREGEX_CC *PRE_STREAM_NEXT)(struct re_stream *__restrict self,
+                                              __uint64_t *__restrict p_match_start);
+#ifdef LIBREGEX_WANT_PROTOTYPES
+LIBREGEX_DECL __ATTR_WUNUSED __ATTR_NONNULL((1, 2)) __ssize_t
+__NOTHROW_NCX(LIBREGEX_CC re_stream_next)(struct re_stream *__restrict self,
+                                          __uint64_t *__restrict p_match_start);
+#endif /* LIBREGEX_WANT_PROTOTYPES */
+
 __DECL_END
 
 #endif /* !_LIBREGEX_REGEXEC_H */
@@ -0,0 +1,250 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGBATCH_C
+#define GUARD_LIBREGEX_REGBATCH_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <bits/os/iovec.h>
+
+#include <alloca.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regdfa.h"
+#include "regexec.h"
+#include "reginterp.h"
+#include "regpike.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+/* Make `input' the only chunk of input of `exec' */
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_exec_setinput(exec, input)             \
+	(void)((exec)->rx_inbase = (input)->iov_base, \
+	       (exec)->rx_insize = (input)->iov_len,  \
+	       (exec)->rx_endoff = (input)->iov_len)
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_exec_setinput(exec, input) \
+	(void)((exec)->rx_iov = (input), (exec)->rx_endoff = (input)->iov_len)
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Create the DFA or pike VM (at most one of them) shared by all inputs of a batch.
+ * Since it's shared, whether or not setting it up is worth it depends on the total
+ * size of all inputs, rather than the size of just one of them.
+ * @return: RE_NOERROR: Success (`*p_dfa' and `*p_pike' may both still be `NULL')
+ * @return: * :         Error of `re_pike_new()' (non-empty inputs can't be matched) */
+PRIVATE WUNUSED NONNULL((1, 3, 4)) re_errno_t
+NOTHROW_NCX(CC re_exec_batch_engine)(struct re_exec *__restrict batch_exec, size_t total,
+                                     struct re_dfa **__restrict p_dfa,
+                                     struct re_pike **__restrict p_pike,
+                                     bool for_search) {
+	re_errno_t error = RE_NOERROR;
+	size_t endoff = batch_exec->rx_endoff;
+	batch_exec->rx_endoff = total;
+	*p_dfa  = NULL;
+	*p_pike = NULL;
+	if (for_search) {
+		/* Same order as `libre_exec_search()' */
+		*p_pike = re_pike_new(batch_exec, &error);
+		if (*p_pike == NULL && error == RE_NOERROR)
+			*p_dfa = re_dfa_new(batch_exec);
+	} else {
+		/* Same order as `libre_exec_match()' */
+		*p_dfa = re_dfa_new(batch_exec);
+		if (*p_dfa == NULL)
+			*p_pike = re_pike_new(batch_exec, &error);
+	}
+	batch_exec->rx_endoff = endoff;
+	return error;
+}
+
+/* Match or search (`for_search') `exec->rx_code' in each of `inputs'
+ * An error for one input doesn't stop the batch: every input gets its own `results[i]'
+ * @return: * : The # of inputs that were matched, or the first error (other than
+ *              `-RE_NOMATCH') in `results' (if any input couldn't be matched) */
+PRIVATE WUNUSED NONNULL((1, 4)) ssize_t
+NOTHROW_NCX(CC re_exec_batch)(struct re_exec const *__restrict exec,
+                              struct iovec const *inputs, size_t count,
+                              ssize_t *results, size_t *match_sizes,
+                              bool for_search) {
+	ssize_t result = 0, first_error = 0;
+	re_errno_t error, engine_error;
+	struct re_code const *code = exec->rx_code;
+	struct re_exec batch_exec;
+	struct re_exec_ctx batch_ctx;
+	struct re_interpreter *interp;
+	struct re_dfa *dfa;
+	struct re_pike *pike;
+	re_regmatch_t *groups;
+	size_t i, total;
+
+	/* All inputs share one exec command block, and the on-fail stack, memo bitmap
+	 * and machine code of one input are re-used for the next one by a context
+	 * (unless the caller already gave one) */
+	memcpy(&batch_exec, exec, sizeof(struct re_exec));
+	batch_exec.rx_startoff = 0;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	batch_exec.rx_extra = 0;
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	if (!(exec->rx_eflags & RE_EXEC_CTX)) {
+		re_exec_ctx_init(&batch_ctx);
+		batch_exec.rx_eflags |= RE_EXEC_CTX;
+		batch_exec.rx_ctx = &batch_ctx;
+	}
+	total = 0;
+	for (i = 0; i < count; ++i) {
+		if (OVERFLOW_UADD(total, inputs[i].iov_len, &total)) {
+			total = (size_t)-1;
+			break;
+		}
+	}
+	engine_error = re_exec_batch_engine(&batch_exec, total, &dfa, &pike, for_search);
+
+	/* Setup (for all inputs at once) */
+	groups = NULL;
+	if (exec->rx_nmatch < code->rc_ngrps)
+		groups = (re_regmatch_t *)alloca(code->rc_ngrps * sizeof(re_regmatch_t));
+	interp = re_interpreter_alloc(code->rc_nvars);
+	for (i = 0; i < count; ++i) {
+		ssize_t item_result = -RE_NOMATCH;
+		struct re_dfa *item_dfa;
+		struct re_pike *item_pike;
+		re_exec_setinput(&batch_exec, &inputs[i]);
+		if (exec->rx_nmatch != 0)
+			batch_exec.rx_pmatch = exec->rx_pmatch + i * exec->rx_nmatch;
+		if (inputs[i].iov_len < code->rc_minmatch)
+			goto set_result; /* Input is to small to ever match */
+		if unlikely(engine_error != RE_NOERROR && inputs[i].iov_len != 0) {
+			item_result = -engine_error; /* Same as `libre_exec_match()' / `libre_exec_search()' */
+			goto set_result;
+		}
+		error = re_interpreter_init(interp, &batch_exec);
+		if unlikely(error != RE_NOERROR) {
+			item_result = -error;
+			goto set_result;
+		}
+		/* Same as `re_interpreter_init_match()', but with a group buffer that's shared by all inputs */
+		interp->ri_pmatch = groups ? groups : batch_exec.rx_pmatch;
+		if (exec->rx_nmatch || (code->rc_flags & RE_CODE_FLAG_NEEDGROUPS)) {
+			memsetc(interp->ri_pmatch, RE_REGOFF_UNSET,
+			        code->rc_ngrps * 2, sizeof(re_regoff_t));
+			if (for_search)
+				interp->ri_flags |= RE_INTERPRETER_F_RSGRPS;
+		}
+
+		/* Neither is ever used for epsilon input */
+		item_dfa  = inputs[i].iov_len ? dfa : NULL;
+		item_pike = inputs[i].iov_len ? pike : NULL;
+		if (for_search) {
+			item_result = re_interpreter_search(interp, inputs[i].iov_len - code->rc_minmatch + 1,
+			                                    &item_dfa, &item_pike,
+			                                    match_sizes ? &match_sizes[i] : NULL);
+		} else {
+			item_result = re_interpreter_exec(interp, &item_dfa, &item_pike);
+			if (item_result == -RE_NOERROR) {
+				item_result = (ssize_t)re_interpreter_in_curoffset(interp);
+				re_interpreter_copy_match(interp);
+			}
+		}
+		re_interpreter_fini(interp);
+
+		/* A DFA or pike VM that was created just for this input is destroyed (as it
+		 * would have been by a call for only this input), and if the shared one had
+		 * to give up on this input (and was destroyed), it's set up again. */
+		if (item_dfa != dfa)
+			re_dfa_destroy(item_dfa);
+		if (item_pike != pike)
+			re_pike_destroy(item_pike);
+		if (inputs[i].iov_len && ((dfa && item_dfa != dfa) || (pike && item_pike != pike)))
+			engine_error = re_exec_batch_engine(&batch_exec, total, &dfa, &pike, for_search);
+set_result:
+		results[i] = item_result;
+		if (item_result >= 0) {
+			++result;
+		} else if (item_result != -RE_NOMATCH && first_error == 0) {
+			first_error = item_result;
+		}
+	}
+
+	/* Cleanup */
+	re_pike_destroy(pike);
+	re_dfa_destroy(dfa);
+	if (!(exec->rx_eflags & RE_EXEC_CTX))
+		libre_exec_ctx_fini(&batch_ctx);
+	if unlikely(first_error != 0)
+		result = first_error;
+	return result;
+}
+
+/* Same as calling `re_exec_match(3R)' for each of `inputs' */
+INTERN WUNUSED NONNULL((1, 4)) ssize_t
+NOTHROW_NCX(CC libre_exec_match_batch)(struct re_exec const *__restrict exec,
+                                       struct iovec const *inputs, size_t count,
+                                       ssize_t *results) {
+	return re_exec_batch(exec, inputs, count, results, NULL, false);
+}
+
+/* Same as calling `re_exec_search(3R)' for each of `inputs' */
+INTERN WUNUSED NONNULL((1, 4)) ssize_t
+NOTHROW_NCX(CC libre_exec_search_batch)(struct re_exec const *__restrict exec,
+                                        struct iovec const *inputs, size_t count,
+                                        ssize_t *results, size_t *match_sizes) {
+	return re_exec_batch(exec, inputs, count, results, match_sizes, true);
+}
+
+#undef re_exec_setinput
+#undef HAVE_TRACE
+#undef TRACE
+
+DEFINE_PUBLIC_ALIAS(re_exec_match_batch, libre_exec_match_batch);
+DEFINE_PUBLIC_ALIAS(re_exec_search_batch, libre_exec_search_batch);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGBATCH_C */
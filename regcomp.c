@@ -80,6 +80,13 @@
 #define ALTERNATION_PREFIX_MAXLEN 16
 #endif /* !ALTERNATION_PREFIX_MAXLEN */
 
+/* Min # of alternatives that an alternation  whose alternatives are all
+ * literals must have before it is compiled as `REOP_TRIE' (rather  than
+ * as a chain of `REOP_JMP_ONFAIL', with one literal match for each). */
+#ifndef ALTERNATION_TRIE_MINCOUNT
+#define ALTERNATION_TRIE_MINCOUNT 8
+#endif /* !ALTERNATION_TRIE_MINCOUNT */
+
 /* Must # of  ASCII characters that  should appear in  the
  * operand of `REOP_[N]CONTAINS_UTF8', before the compiler
  * should produce a `REOP_[N]CS_UTF8'-sequence instead. */
@@ -87,6 +94,19 @@
 #define REOP_CONTAINS_UTF8_MAX_ASCII_COUNT 4
 #endif /* !REOP_CONTAINS_UTF8_MAX_ASCII_COUNT */
 
+/* Min # of unicode characters listed by a charset, before  the
+ * compiler encodes them as `RECS_CONTAINS_SORTED' (rather than
+ * `REOP_[N]CONTAINS_UTF8' or `RECS_CONTAINS') */
+#ifndef RECS_CONTAINS_SORTED_MIN_COUNT
+#define RECS_CONTAINS_SORTED_MIN_COUNT 16
+#endif /* !RECS_CONTAINS_SORTED_MIN_COUNT */
+
+/* Max # of byte-range sequences that a `REOP_[N]CS_UTF8'-charset may
+ * need before it is no longer re-encoded as `REOP_[N]SEQ_UTF8'. */
+#ifndef REOP_SEQ_UTF8_MAX_SEQUENCES
+#define REOP_SEQ_UTF8_MAX_SEQUENCES 32
+#endif /* !REOP_SEQ_UTF8_MAX_SEQUENCES */
+
 /* Regex syntax test functions */
 /*[[[deemon
 local SYNTAX_OPTIONS = {
@@ -360,6 +380,37 @@ PRIVATE uint8_t const ctype_c_trait_masks[] = {
 #undef DEF_CTYPE_TRAIT_MASK
 };
 
+/* Mapping from `RECS_ISxxx - RECS_ISX_MIN' to `__UNICODE_IS*' (s.a. `RECS_ISX_MASK') */
+PRIVATE uint16_t const unicode_trait_masks[] = {
+#ifdef __GNUC__
+#define DEF_UNICODE_TRAIT_MASK(opcode, mask) [(opcode - RECS_ISX_MIN)] = mask
+#else /* __GNUC__ */
+#define DEF_UNICODE_TRAIT_MASK(opcode, mask) /*[(opcode - RECS_ISX_MIN)] =*/ mask
+#endif /* !__GNUC__ */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISCNTRL, __UNICODE_ISCNTRL),     /* `unicode_iscntrl(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISSPACE, __UNICODE_ISSPACE),     /* `unicode_isspace(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISUPPER, __UNICODE_ISUPPER),     /* `unicode_isupper(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISLOWER, __UNICODE_ISLOWER),     /* `unicode_islower(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISALPHA, __UNICODE_ISALPHA),     /* `unicode_isalpha(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISDIGIT, __UNICODE_ISDIGIT),     /* `unicode_isdigit(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISXDIGIT, __UNICODE_ISXDIGIT),   /* `unicode_isxdigit(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISALNUM, __UNICODE_ISALNUM),     /* `unicode_isalnum(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISPUNCT, __UNICODE_ISPUNCT),     /* `unicode_ispunct(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISGRAPH, __UNICODE_ISGRAPH),     /* `unicode_isgraph(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISPRINT, __UNICODE_ISPRINT),     /* `unicode_isprint(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISBLANK, __UNICODE_ISBLANK),     /* `unicode_isblank(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISSYMSTRT, __UNICODE_ISSYMSTRT), /* `unicode_issymstrt(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISSYMCONT, __UNICODE_ISSYMCONT), /* `unicode_issymcont(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISTAB, __UNICODE_ISTAB),         /* `unicode_istab(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISWHITE, __UNICODE_ISWHITE),     /* `unicode_iswhite(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISEMPTY, __UNICODE_ISEMPTY),     /* `unicode_isempty(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISLF, __UNICODE_ISLF),           /* `unicode_islf(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISHEX, __UNICODE_ISHEX),         /* `unicode_ishex(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISTITLE, __UNICODE_ISTITLE),     /* `unicode_istitle(ch)' */
+	DEF_UNICODE_TRAIT_MASK(RECS_ISNUMERIC, __UNICODE_ISNUMERIC), /* `unicode_isnumeric(ch)' */
+#undef DEF_UNICODE_TRAIT_MASK
+};
+
 
 
 
@@ -1008,10 +1059,52 @@ NOTHROW_NCX(CC re_compiler_putn)(struct re_compiler *__restrict self,
 	return false;
 }
 
+/* Same as `re_compiler_putn()', but write ASCII letters in lower-case (s.a. `REOP_EXACT_ASCII_ICASE') */
+PRIVATE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_compiler_putn_asciilower)(struct re_compiler *__restrict self,
+                                            char const *p, size_t n) {
+	if likely(re_compiler_require(self, n)) {
+		for (; n; --n) {
+			byte_t b = (byte_t)*p++;
+			if (b >= 'A' && b <= 'Z')
+				b += 'a' - 'A';
+			*self->rec_cpos++ = b;
+		}
+		return true;
+	}
+	return false;
+}
+
+/* Append the first `nchars' utf-8 characters from `p', with each of them
+ * folded to lower-case (s.a. `REOP_EXACT_UTF8_ICASE'). Characters  that
+ * don't change are copied as-is, and so are non-ascii characters  whose
+ * lower-case is ascii (e.g. U+212A), so that the leading byte of what is
+ * written is still a valid hint for `rc_fmap'.
+ * @return: * :   Pointer after the last character read from `p'
+ * @return: NULL: Out of memory */
+PRIVATE WUNUSED NONNULL((1, 2)) char const *
+NOTHROW_NCX(CC re_compiler_putn_utf8lower)(struct re_compiler *__restrict self,
+                                           char const *p, size_t nchars) {
+	for (; nchars; --nchars) {
+		char const *start = p;
+		char32_t ch       = unicode_readutf8(&p);
+		char32_t lower    = unicode_tolower(ch);
+		if (lower == ch || (ch >= 0x80 && lower < 0x80)) {
+			if unlikely(!re_compiler_putn(self, start, (size_t)(p - start)))
+				return NULL;
+		} else {
+			if unlikely(!re_compiler_require(self, UNICODE_UTF8_CURLEN))
+				return NULL;
+			self->rec_cpos = (byte_t *)unicode_writeutf8((char *)self->rec_cpos, lower);
+		}
+	}
+	return p;
+}
+
 /* Return a pointer to the start of the utf-8 character that contains `cptr' */
 PRIVATE ATTR_PURE ATTR_RETNONNULL WUNUSED NONNULL((1)) char *
 NOTHROW_NCX(CC utf8_baseptr)(char const *__restrict cptr) {
-	while (unicode_utf8seqlen[(unsigned char)*cptr] == 0)
+	while (((unsigned char)*cptr & 0xc0) == 0x80)
 		--cptr; /* Seek backwards until we hit a non-follow-up byte. */
 	return (char *)cptr;
 }
@@ -1058,9 +1151,11 @@ NOTHROW_NCX(CC libre_opcode_next)(byte_t const *__restrict p_instr) {
 		} while (--count);
 	}	break;
 
-	case REOP_CS_BYTE:
 	case REOP_CS_UTF8:
-	case REOP_NCS_UTF8: {
+	case REOP_NCS_UTF8:
+		p_instr += 16;
+		ATTR_FALLTHROUGH
+	case REOP_CS_BYTE: {
 		byte_t cs_opcode;
 		while ((cs_opcode = *p_instr++) != RECS_DONE) {
 			switch (cs_opcode) {
@@ -1096,6 +1191,12 @@ NOTHROW_NCX(CC libre_opcode_next)(byte_t const *__restrict p_instr) {
 					} while (--count);
 				}
 			}	break;
+			case RECS_ISX_MASK:
+				p_instr += 2;
+				break;
+			case RECS_CONTAINS_SORTED:
+				p_instr += 2 + UNALIGNED_GET16(p_instr);
+				break;
 			default: break;
 			}
 		}
@@ -1118,6 +1219,10 @@ NOTHROW_NCX(CC libre_opcode_next)(byte_t const *__restrict p_instr) {
 	case REOP_JMP:
 	case REOP_JMP_ONFAIL:
 	case REOP_JMP_AND_RETURN_ONFAIL:
+	case REOP_SPAN:
+	case REOP_SPAN_AND_RETURN_ONFAIL:
+	case REOP_SPAN_LIT:
+	case REOP_SPAN_LIT_AND_RETURN_ONFAIL:
 	case REOP_SETVAR:
 	case REOP_MAYBE_POP_ONFAIL:
 	case REOP_POP_ONFAIL_AT:
@@ -1130,6 +1235,22 @@ NOTHROW_NCX(CC libre_opcode_next)(byte_t const *__restrict p_instr) {
 		p_instr += 3;
 		break;
 
+	case REOP_BITSET:
+		p_instr += 32;
+		break;
+
+	case REOP_SEQ_UTF8:
+	case REOP_NSEQ_UTF8: {
+		byte_t seqlen;
+		p_instr += 16;
+		while ((seqlen = *p_instr++) != 0)
+			p_instr += seqlen * 2;
+	}	break;
+
+	case REOP_TRIE:
+		p_instr += 2 + UNALIGNED_GET16(p_instr);
+		break;
+
 	default:
 		break;
 	}
@@ -1166,11 +1287,15 @@ dispatch:
 	case REOP_NBYTE2:
 	case REOP_RANGE:
 	case REOP_NRANGE:
+	case REOP_BITSET:
 	case REOP_CONTAINS_UTF8:
 	case REOP_NCONTAINS_UTF8:
 	case REOP_CS_UTF8:
 	case REOP_CS_BYTE:
 	case REOP_NCS_UTF8:
+	case REOP_SEQ_UTF8:
+	case REOP_NSEQ_UTF8:
+	case REOP_TRIE:
 	case REOP_GROUP_MATCH: /* If it was an epsilon-match, `REOP_GROUP_MATCH_Jn' would have been used. */
 		return false;
 
@@ -1198,7 +1323,11 @@ dispatch:
 		goto dispatch;
 
 	case REOP_JMP_ONFAIL:
-	case REOP_JMP_AND_RETURN_ONFAIL: {
+	case REOP_JMP_AND_RETURN_ONFAIL:
+	case REOP_SPAN:
+	case REOP_SPAN_AND_RETURN_ONFAIL:
+	case REOP_SPAN_LIT:
+	case REOP_SPAN_LIT_AND_RETURN_ONFAIL: {
 		int16_t delta;
 		delta = delta16_get(pc);
 		pc += 2;
@@ -1384,9 +1513,9 @@ NOTHROW_NCX(CC re_compiler_compile_unescaped_literal_byte_seq)(struct re_compile
 	/* Select the appropriate `REOP_EXACT' opcode */
 	reop_exact_opcode = REOP_EXACT;
 	if (IF_ICASE(self->rec_parser.rep_syntax)) {
-		/* Can just use the regular code-path, only have the runtime
-		 * use `memcasecmp(3)' instead of the usual `memcmp(3)' when
-		 * comparing input. */
+		/* Can just use the regular code-path, only store the literal in
+		 * lower-case,  so the runtime  only has to fold  the input (s.a.
+		 * `re_compiler_putn_asciilower()') */
 		reop_exact_opcode = REOP_EXACT_ASCII_ICASE;
 	}
 
@@ -1398,7 +1527,9 @@ NOTHROW_NCX(CC re_compiler_compile_unescaped_literal_byte_seq)(struct re_compile
 			goto err_nomem;
 		if (!re_compiler_putc(self, UINT8_MAX))
 			goto err_nomem;
-		if (!re_compiler_putn(self, literal_byte_seq_start, UINT8_MAX))
+		if (!(reop_exact_opcode == REOP_EXACT
+		      ? re_compiler_putn(self, literal_byte_seq_start, UINT8_MAX)
+		      : re_compiler_putn_asciilower(self, literal_byte_seq_start, UINT8_MAX)))
 			goto err_nomem;
 		literal_byte_seq_start += UINT8_MAX;
 		literal_seq_size -= UINT8_MAX;
@@ -1408,7 +1539,9 @@ NOTHROW_NCX(CC re_compiler_compile_unescaped_literal_byte_seq)(struct re_compile
 			goto err_nomem;
 		if (!re_compiler_putc(self, (uint8_t)literal_seq_size))
 			goto err_nomem;
-		if (!re_compiler_putn(self, literal_byte_seq_start, literal_seq_size))
+		if (!(reop_exact_opcode == REOP_EXACT
+		      ? re_compiler_putn(self, literal_byte_seq_start, literal_seq_size)
+		      : re_compiler_putn_asciilower(self, literal_byte_seq_start, literal_seq_size)))
 			goto err_nomem;
 	} else if (literal_seq_size == 1) {
 		return re_compiler_compile_literal_byte(self, literal_byte_seq_start[0]);
@@ -1471,8 +1604,8 @@ NOTHROW_NCX(CC re_compiler_compile_unescaped_literal_seq)(struct re_compiler *__
 			if (!literal_seq_length)
 				break;
 			assert(literal_seq_start < literal_seq_end);
-			num_leading_chars = 0;
 		}
+		num_leading_chars = 0;
 
 		/* Figure out how many unicode characters there are.
 		 *
@@ -1526,7 +1659,7 @@ NOTHROW_NCX(CC re_compiler_compile_unescaped_literal_seq)(struct re_compiler *__
 			goto err_nomem;
 		if (!re_compiler_putc(self, (uint8_t)num_leading_chars))
 			goto err_nomem;
-		if (!re_compiler_putn(self, literal_seq_start, (size_t)(literal_seq_iter - literal_seq_start)))
+		if (!re_compiler_putn_utf8lower(self, literal_seq_start, num_leading_chars))
 			goto err_nomem;
 
 		/* Continue with the remainder */
@@ -2435,6 +2568,424 @@ err_nomem:
 
 
 
+/* Add `[lo,hi]' to the sorted (and merged) list of ranges of a `REOP_[N]SEQ_UTF8'
+ * that is being built (ASCII characters are added to `ascii' instead)
+ * @return: false: Too many ranges, or characters that can't be used in sequences */
+PRIVATE WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC seq_utf8_addrange)(bitset_t *__restrict ascii,
+                                  char32_t (*rangev)[2], size_t *__restrict p_rangec,
+                                  char32_t lo, char32_t hi) {
+	size_t i, j, rangec = *p_rangec;
+	if unlikely(hi > 0x1fffff)
+		return false;
+	for (; lo < 0x80; ++lo) {
+		if (lo > hi)
+			return true;
+		bitset_set(ascii, lo);
+	}
+
+	/* Find ranges that overlap with (or are adjacent to) `[lo,hi]', and merge them */
+	for (i = 0; i < rangec && rangev[i][1] + 1 < lo; ++i)
+		;
+	for (j = i; j < rangec && rangev[j][0] <= hi + 1; ++j) {
+		if (lo > rangev[j][0])
+			lo = rangev[j][0];
+		if (hi < rangev[j][1])
+			hi = rangev[j][1];
+	}
+	if (j == i) {
+		if (rangec >= REOP_SEQ_UTF8_MAX_SEQUENCES)
+			return false;
+		memmoveupc(&rangev[i + 1], &rangev[i], rangec - i, sizeof(*rangev));
+		++rangec;
+	} else {
+		memmovedownc(&rangev[i + 1], &rangev[j], rangec - j, sizeof(*rangev));
+		rangec -= (j - i) - 1;
+	}
+	rangev[i][0] = lo;
+	rangev[i][1] = hi;
+	*p_rangec = rangec;
+	return true;
+}
+
+/* Append byte-range sequences that match the shortest utf-8 encodings of
+ * all characters from `[lo,hi]' (with `lo >= 0x80') to `seqv' (this is
+ * done  by splitting the range until the encodings of its bounds differ
+ * only in bytes that can take on any follow-up byte's value)
+ * @return: false: More than `REOP_SEQ_UTF8_MAX_SEQUENCES' sequences are needed */
+PRIVATE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC seq_utf8_split)(byte_t (*seqv)[1 + 4 * 2], size_t *__restrict p_seqc,
+                               char32_t lo, char32_t hi) {
+	static char32_t const maxchar_for_seqlen[] = { 0x7ff, 0xffff };
+	byte_t lo_utf8[UNICODE_UTF8_CURLEN];
+	byte_t hi_utf8[UNICODE_UTF8_CURLEN];
+	byte_t *seq, seqlen;
+	unsigned int i;
+	assert(lo >= 0x80 && lo <= hi && hi <= 0x1fffff);
+
+	/* Both bounds must be encoded using the same # of bytes */
+	for (i = 0; i < lengthof(maxchar_for_seqlen); ++i) {
+		char32_t maxchar = maxchar_for_seqlen[i];
+		if (lo <= maxchar && hi > maxchar) {
+			return seq_utf8_split(seqv, p_seqc, lo, maxchar) &&
+			       seq_utf8_split(seqv, p_seqc, maxchar + 1, hi);
+		}
+	}
+
+	/* Trailing bytes that differ must cover all of `[0x80,0xbf]' */
+	for (i = 1; i < 4; ++i) {
+		char32_t mask = ((char32_t)1 << (6 * i)) - 1;
+		if ((lo & ~mask) != (hi & ~mask)) {
+			if ((lo & mask) != 0) {
+				return seq_utf8_split(seqv, p_seqc, lo, lo | mask) &&
+				       seq_utf8_split(seqv, p_seqc, (lo | mask) + 1, hi);
+			}
+			if ((hi & mask) != mask) {
+				return seq_utf8_split(seqv, p_seqc, lo, (hi & ~mask) - 1) &&
+				       seq_utf8_split(seqv, p_seqc, hi & ~mask, hi);
+			}
+		}
+	}
+	if (*p_seqc >= REOP_SEQ_UTF8_MAX_SEQUENCES)
+		return false;
+	seqlen = (byte_t)((byte_t *)unicode_writeutf8((char *)lo_utf8, lo) - lo_utf8);
+	(void)unicode_writeutf8((char *)hi_utf8, hi);
+	assert(seqlen >= 2 && seqlen <= 4);
+	seq    = seqv[(*p_seqc)++];
+	*seq++ = seqlen;
+	for (i = 0; i < seqlen; ++i) {
+		*seq++ = lo_utf8[i];
+		*seq++ = hi_utf8[i];
+	}
+	return true;
+}
+
+/* Check if `ch' is already matched by the leading ASCII-bitset, or by `traits' */
+#define cs_utf8_char_covered(ch, traits) \
+	((ch) < 0x80 || (__unicode_descriptor(ch)->__ut_flags & (traits)) != 0)
+
+/* Max # of characters in a `RECS_RANGE' that are checked for being covered by traits */
+#define CS_UTF8_RANGE_COVER_MAXCHARS 0x10000
+
+/* Pack the `REOP_[N]CS_UTF8'-charset at `self->rec_cbase + start_offset' (which must be
+ * the last thing that was written):
+ * - Insert the 128-bit bitset of ASCII characters matched by the charset in front of its
+ *   `RECS_*' sequence, so ASCII input never has to evaluate the sequence.
+ * - Remove `RECS_BITSET_*' (which only ever match ASCII characters)
+ * - Merge all `RECS_IS*' into a single, leading `RECS_ISX_MASK', such that all traits
+ *   only take a single lookup. Characters and ranges that are already covered by those
+ *   traits are removed (e.g. "[[:alpha:]äöü]" -> "[[:alpha:]]").
+ * @return: false: Out of memory */
+PRIVATE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_compiler_pack_cs_utf8)(struct re_compiler *__restrict self,
+                                         size_t start_offset) {
+	bitset_t bitset_decl(ascii, 128);
+	byte_t *bits, *pc, *dst;
+	uint16_t traits = 0;
+	byte_t cs_opcode;
+	size_t i;
+	if unlikely(!re_compiler_require(self, 16 + 2))
+		return false;
+	bits = self->rec_cbase + start_offset + 1;
+	memmoveup(bits + 16, bits, (size_t)(self->rec_cpos - bits));
+	bitset_clearall(ascii, 128);
+
+	/* Gather ASCII characters and traits. */
+	pc = bits + 16;
+	while ((cs_opcode = *pc++) != RECS_DONE) {
+		byte_t count;
+		char32_t lo, hi;
+		switch (cs_opcode) {
+
+		case_RECS_BITSET_MIN_to_MAX_UTF8: {
+			uint8_t bitset_minch = RECS_BITSET_GETBASE(cs_opcode);
+			uint8_t bitset_size  = RECS_BITSET_GETBYTES(cs_opcode);
+			for (i = 0; i < bitset_size * 8u; ++i) {
+				if ((pc[i / 8] & (1 << (i % 8))) != 0)
+					bitset_set(ascii, bitset_minch + i);
+			}
+			pc += bitset_size;
+		}	break;
+
+		case RECS_CHAR:
+		case RECS_CHAR2:
+		case RECS_CONTAINS:
+			count = cs_opcode == RECS_CHAR ? 1 : cs_opcode == RECS_CHAR2 ? 2 : *pc++;
+			do {
+				lo = unicode_readutf8((char const **)&pc);
+				if (lo < 0x80)
+					bitset_set(ascii, lo);
+			} while (--count);
+			break;
+
+		case RECS_CONTAINS_SORTED: {
+			byte_t const *end = pc + 2 + UNALIGNED_GET16(pc);
+			pc += 2;
+			do {
+				lo = unicode_readutf8((char const **)&pc);
+				if (lo < 0x80)
+					bitset_set(ascii, lo);
+			} while (pc < end);
+		}	break;
+
+		case RECS_RANGE:
+		case RECS_RANGE_ICASE:
+			lo = unicode_readutf8((char const **)&pc);
+			hi = unicode_readutf8((char const **)&pc);
+			for (i = 0; i < 0x80; ++i) {
+				char32_t ch = (char32_t)i;
+				if (cs_opcode == RECS_RANGE_ICASE)
+					ch = unicode_tolower(ch);
+				if (ch >= lo && ch <= hi)
+					bitset_set(ascii, i);
+			}
+			break;
+
+		case_RECS_ISX_MIN_to_MAX:
+			traits |= unicode_trait_masks[cs_opcode - RECS_ISX_MIN];
+			break;
+
+		default: __builtin_unreachable();
+		}
+	}
+	for (i = 0; i < 0x80; ++i) {
+		if ((__unicode_descriptor((char32_t)i)->__ut_flags & traits) != 0)
+			bitset_set(ascii, i);
+	}
+
+	/* Only keep what can still match non-ASCII characters. */
+	pc  = bits + 16;
+	dst = pc;
+	for (;;) {
+		byte_t *cs_start = pc;
+		bool keep = true;
+		cs_opcode = *pc++;
+		switch (cs_opcode) {
+
+		case_RECS_BITSET_MIN_to_MAX_UTF8:
+			pc += RECS_BITSET_GETBYTES(cs_opcode);
+			keep = false;
+			break;
+
+		case RECS_DONE:
+			break;
+
+		case RECS_CHAR:
+		case RECS_CHAR2:
+		case RECS_CONTAINS:
+		case RECS_CONTAINS_SORTED: {
+			byte_t *chars, *end;
+			size_t nkeep = 0, nkeep_bytes = 0;
+			if (cs_opcode == RECS_CONTAINS_SORTED) {
+				end = pc + 2 + UNALIGNED_GET16(pc);
+				pc += 2;
+			} else {
+				byte_t count = cs_opcode == RECS_CHAR ? 1 : cs_opcode == RECS_CHAR2 ? 2 : *pc++;
+				end = (byte_t *)utf8_skipn((char const *)pc, count);
+			}
+			for (chars = pc; chars < end;) {
+				byte_t *ch_start = chars;
+				char32_t ch = unicode_readutf8((char const **)&chars);
+				if (!cs_utf8_char_covered(ch, traits)) {
+					++nkeep;
+					nkeep_bytes += (size_t)(chars - ch_start);
+				}
+			}
+			chars = pc;
+			pc    = end;
+			keep  = false;
+			if (nkeep == 0)
+				break;
+
+			/* Re-write with only the remaining characters. The new header is never
+			 * larger than the old one, so this can be done in-place and in-order. */
+			if (cs_opcode == RECS_CONTAINS_SORTED &&
+			    (nkeep >= RECS_CONTAINS_SORTED_MIN_COUNT || nkeep > 0xff)) {
+				*dst++ = RECS_CONTAINS_SORTED;
+				UNALIGNED_SET16(dst, (uint16_t)nkeep_bytes);
+				dst += 2;
+			} else if (nkeep == 1) {
+				*dst++ = RECS_CHAR;
+			} else if (nkeep == 2) {
+				*dst++ = RECS_CHAR2;
+			} else {
+				*dst++ = RECS_CONTAINS;
+				*dst++ = (byte_t)nkeep;
+			}
+			while (chars < end) {
+				byte_t *ch_start = chars;
+				char32_t ch = unicode_readutf8((char const **)&chars);
+				if (!cs_utf8_char_covered(ch, traits)) {
+					memmovedown(dst, ch_start, (size_t)(chars - ch_start));
+					dst += (size_t)(chars - ch_start);
+				}
+			}
+		}	break;
+
+		case RECS_RANGE: {
+			char32_t lo, hi;
+			lo = unicode_readutf8((char const **)&pc);
+			hi = unicode_readutf8((char const **)&pc);
+			if (lo < 0x80)
+				lo = 0x80;
+			if (lo > hi) {
+				keep = false;
+			} else if (traits != 0 && (hi - lo) < CS_UTF8_RANGE_COVER_MAXCHARS) {
+				keep = false;
+				for (; lo <= hi; ++lo) {
+					if (!cs_utf8_char_covered(lo, traits)) {
+						keep = true;
+						break;
+					}
+				}
+			}
+		}	break;
+
+		case RECS_RANGE_ICASE:
+			/* Non-ASCII characters may lower-case into ASCII ranges (e.g. U+212A -> 'k') */
+			pc += unicode_utf8seqlen[*pc];
+			pc += unicode_utf8seqlen[*pc];
+			break;
+
+		case_RECS_ISX_MIN_to_MAX:
+			keep = false;
+			break;
+
+		default: __builtin_unreachable();
+		}
+		if (keep) {
+			memmovedown(dst, cs_start, (size_t)(pc - cs_start));
+			dst += (size_t)(pc - cs_start);
+		}
+		if (cs_opcode == RECS_DONE)
+			break;
+	}
+
+	/* Put merged traits first (they're what most non-ASCII characters are matched by) */
+	if (traits != 0) {
+		memmoveup(bits + 16 + 3, bits + 16, (size_t)(dst - (bits + 16)));
+		bits[16] = RECS_ISX_MASK;
+		UNALIGNED_SET16(bits + 17, traits);
+		dst += 3;
+	}
+	static_assert(sizeof(*ascii) == sizeof(byte_t));
+	memcpy(bits, ascii, 16);
+	self->rec_cpos = dst;
+	return true;
+}
+
+/* Write `REOP_[N]CS_UTF8' for a charset made up of only `trait' (e.g. "\\w" is "[[:symcont:]]")
+ * @return: false: Out of memory */
+PRIVATE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_compiler_put_cs_utf8_trait)(struct re_compiler *__restrict self,
+                                              bool negate, byte_t trait) {
+	size_t start_offset = (size_t)(self->rec_cpos - self->rec_cbase);
+	if (!re_compiler_putc(self, negate ? (byte_t)REOP_NCS_UTF8 : (byte_t)REOP_CS_UTF8))
+		return false;
+	if (!re_compiler_putc(self, trait))
+		return false;
+	if (!re_compiler_putc(self, RECS_DONE))
+		return false;
+	return re_compiler_pack_cs_utf8(self, start_offset);
+}
+
+/* Finish the `REOP_[N]CS_UTF8'-charset at `self->rec_cbase + start_offset' (which must be
+ * the last thing that was written, and still lack its ASCII bitset). When possible, it is
+ * re-encoded as `REOP_[N]SEQ_UTF8', such that it can be matched without having to decode
+ * input. Charsets that use traits or case-folding ranges (which can only be tested  for
+ * decoded characters) are only packed (s.a. `re_compiler_pack_cs_utf8()')
+ * @return: false: Out of memory */
+PRIVATE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_compiler_finish_cs_utf8)(struct re_compiler *__restrict self,
+                                           size_t start_offset) {
+	bitset_t bitset_decl(ascii, 128);
+	char32_t rangev[REOP_SEQ_UTF8_MAX_SEQUENCES][2];
+	byte_t seqv[REOP_SEQ_UTF8_MAX_SEQUENCES][1 + 4 * 2];
+	size_t i, rangec = 0, seqc = 0;
+	byte_t const *pc = self->rec_cbase + start_offset;
+	byte_t opcode = *pc++;
+	assert(opcode == REOP_CS_UTF8 || opcode == REOP_NCS_UTF8);
+	bitset_clearall(ascii, 128);
+	for (;;) {
+		byte_t cs_opcode = *pc++;
+		byte_t count;
+		char32_t lo, hi;
+		switch (cs_opcode) {
+
+		case_RECS_BITSET_MIN_to_MAX_UTF8: {
+			uint8_t bitset_minch = RECS_BITSET_GETBASE(cs_opcode);
+			uint8_t bitset_size  = RECS_BITSET_GETBYTES(cs_opcode);
+			for (i = 0; i < bitset_size * 8u; ++i) {
+				if ((pc[i / 8] & (1 << (i % 8))) != 0)
+					bitset_set(ascii, bitset_minch + i);
+			}
+			pc += bitset_size;
+			continue;
+		}
+
+		case RECS_DONE:
+			break;
+
+		case RECS_CHAR:
+		case RECS_CHAR2:
+		case RECS_CONTAINS:
+			count = cs_opcode == RECS_CHAR ? 1 : cs_opcode == RECS_CHAR2 ? 2 : *pc++;
+			do {
+				lo = unicode_readutf8((char const **)&pc);
+				if (!seq_utf8_addrange(ascii, rangev, &rangec, lo, lo))
+					goto put_packed;
+			} while (--count);
+			continue;
+
+		case RECS_CONTAINS_SORTED: {
+			byte_t const *end = pc + 2 + UNALIGNED_GET16(pc);
+			pc += 2;
+			do {
+				lo = unicode_readutf8((char const **)&pc);
+				if (!seq_utf8_addrange(ascii, rangev, &rangec, lo, lo))
+					goto put_packed;
+			} while (pc < end);
+			continue;
+		}
+
+		case RECS_RANGE:
+			lo = unicode_readutf8((char const **)&pc);
+			hi = unicode_readutf8((char const **)&pc);
+			if (!seq_utf8_addrange(ascii, rangev, &rangec, lo, hi))
+				goto put_packed;
+			continue;
+
+		default:
+			goto put_packed;
+		}
+		break;
+	}
+	for (i = 0; i < rangec; ++i) {
+		if (!seq_utf8_split(seqv, &seqc, rangev[i][0], rangev[i][1]))
+			goto put_packed;
+	}
+
+	/* Re-write the charset */
+	self->rec_cpos = self->rec_cbase + start_offset;
+	if (!re_compiler_putc(self, opcode == REOP_CS_UTF8 ? (byte_t)REOP_SEQ_UTF8
+	                                                   : (byte_t)REOP_NSEQ_UTF8))
+		goto err_nomem;
+	static_assert(sizeof(*ascii) == sizeof(byte_t));
+	if (!re_compiler_putn(self, ascii, 16))
+		goto err_nomem;
+	for (i = 0; i < seqc; ++i) {
+		if (!re_compiler_putn(self, seqv[i], 1 + seqv[i][0] * 2))
+			goto err_nomem;
+	}
+	if (!re_compiler_putc(self, 0))
+		goto err_nomem;
+	return true;
+err_nomem:
+	return false;
+put_packed:
+	return re_compiler_pack_cs_utf8(self, start_offset);
+}
+
 PRIVATE WUNUSED NONNULL((1)) re_errno_t
 NOTHROW_NCX(CC re_compiler_compile_charset)(struct re_compiler *__restrict self) {
 	re_errno_t result;
@@ -2510,6 +3061,7 @@ check_bytes_only_ascii:
 			if ((self->rec_cpos == self->rec_cbase + start_offset + 1)) {
 				size_t nbytes = bitset_popcount(cs.rc_bytes, 256);
 				if ((nbytes <= REOP_CONTAINS_UTF8_MAX_ASCII_COUNT) &&
+				    ((count + nbytes) < RECS_CONTAINS_SORTED_MIN_COUNT) &&
 				    ((count + nbytes) <= 0xff)) {
 					/* Yes: we can use `REOP_[N]CONTAINS_UTF8'! */
 					self->rec_cpos[-1] = cs.rc_negate ? (byte_t)REOP_NCONTAINS_UTF8
@@ -2532,33 +3084,52 @@ check_bytes_only_ascii:
 				}
 			}
 
-			while (count > 0xff) {
-				/* Must encode in multiple sets. */
-				char *new_basep;
-				new_basep = utf8_skipn(basep, 255);
-				if (!re_compiler_putc(self, RECS_CONTAINS))
-					goto err_nomem;
-				if (!re_compiler_putc(self, 255))
-					goto err_nomem;
-				if (!re_compiler_putn(self, basep, (size_t)(new_basep - basep)))
-					goto err_nomem;
-				basep = new_basep;
-				count -= 0xff;
-			}
-			if (count == 2) {
-				if (!re_compiler_putc(self, RECS_CHAR2))
-					goto err_nomem;
-			} else if (count == 1) {
-				if (!re_compiler_putc(self, RECS_CHAR))
-					goto err_nomem;
+			if (count >= RECS_CONTAINS_SORTED_MIN_COUNT) {
+				/* Long list: encode for binary search (split  into
+				 * multiple sets if it doesn't fit into 16 bits). */
+				while (basep < cs.rc_uchars.ucs_endp) {
+					size_t nbytes = (size_t)(cs.rc_uchars.ucs_endp - basep);
+					if (nbytes > 0xffff)
+						nbytes = (size_t)(utf8_baseptr(basep + 0xffff) - basep);
+					if (!re_compiler_putc(self, RECS_CONTAINS_SORTED))
+						goto err_nomem;
+					if (!re_compiler_require(self, 2))
+						goto err_nomem;
+					UNALIGNED_SET16(self->rec_cpos, (uint16_t)nbytes);
+					self->rec_cpos += 2;
+					if (!re_compiler_putn(self, basep, nbytes))
+						goto err_nomem;
+					basep += nbytes;
+				}
 			} else {
-				if (!re_compiler_putc(self, RECS_CONTAINS))
-					goto err_nomem;
-				if (!re_compiler_putc(self, (byte_t)count))
+				while (count > 0xff) {
+					/* Must encode in multiple sets. */
+					char *new_basep;
+					new_basep = utf8_skipn(basep, 255);
+					if (!re_compiler_putc(self, RECS_CONTAINS))
+						goto err_nomem;
+					if (!re_compiler_putc(self, 255))
+						goto err_nomem;
+					if (!re_compiler_putn(self, basep, (size_t)(new_basep - basep)))
+						goto err_nomem;
+					basep = new_basep;
+					count -= 0xff;
+				}
+				if (count == 2) {
+					if (!re_compiler_putc(self, RECS_CHAR2))
+						goto err_nomem;
+				} else if (count == 1) {
+					if (!re_compiler_putc(self, RECS_CHAR))
+						goto err_nomem;
+				} else {
+					if (!re_compiler_putc(self, RECS_CONTAINS))
+						goto err_nomem;
+					if (!re_compiler_putc(self, (byte_t)count))
+						goto err_nomem;
+				}
+				if (!re_compiler_putn(self, basep, (size_t)(cs.rc_uchars.ucs_endp - basep)))
 					goto err_nomem;
 			}
-			if (!re_compiler_putn(self, basep, (size_t)(cs.rc_uchars.ucs_endp - basep)))
-				goto err_nomem;
 		}
 	}
 
@@ -2653,6 +3224,17 @@ check_bytes_only_ascii:
 		goto put_terminator;
 	}
 
+	/* Byte-based charsets are always just a bitset -> use `REOP_BITSET',
+	 * so matching a byte only ever takes a single bit-test. */
+	if (self->rec_cbase[start_offset] == REOP_CS_BYTE &&
+	    self->rec_cpos == self->rec_cbase + start_offset + 1) {
+		self->rec_cpos[-1] = REOP_BITSET;
+		static_assert(sizeof(*cs.rc_bytes) == sizeof(byte_t));
+		if (!re_compiler_putn(self, cs.rc_bytes, 32))
+			goto err_nomem;
+		goto done;
+	}
+
 	/* No special encoding is possible -> must instead use `RECS_BITSET_MIN'! */
 	{
 		byte_t cs_opcode;
@@ -2679,6 +3261,11 @@ check_bytes_only_ascii:
 put_terminator:
 	if (!re_compiler_putc(self, RECS_DONE))
 		goto err_nomem;
+	if (self->rec_cbase[start_offset] == REOP_CS_UTF8 ||
+	    self->rec_cbase[start_offset] == REOP_NCS_UTF8) {
+		if (!re_compiler_finish_cs_utf8(self, start_offset))
+			goto err_nomem;
+	}
 done:
 	re_charset_fini(&cs);
 	return result;
@@ -2715,6 +3302,8 @@ NOTHROW_NCX(CC re_compiler_compile_prefix)(struct re_compiler *__restrict self)
 			if (!re_compiler_putn(self, alternation_prefix, alternation_prefix_len)) \
 				goto err_nomem;                                                      \
 			alternation_prefix_wanted = false;                                       \
+			alternation_prefix_len    = 0;                                           \
+			self->rec_estart = self->rec_cpos; /* Not part of the expression */      \
 		}                                                                            \
 	}	__WHILE0
 #else /* ALTERNATION_PREFIX_MAXLEN > 0 */
@@ -2742,6 +3331,8 @@ again:
 	case RE_TOKEN_ENDGROUP:    /* ')'-token (let the caller deal with this) */
 	case RE_TOKEN_ALTERNATION: /* '|'-token (let the caller deal with this) */
 		self->rec_parser.rep_pos = tokstart;
+		/* Location assertions (e.g. `^$') may not be followed by anything */
+		alternation_prefix_dump();
 		return RE_NOERROR;
 
 	case RE_TOKEN_UNMATCHED_BK: /* Unmatched '\' */
@@ -2819,7 +3410,12 @@ again:
 		 *    - "b": @0x000a
 		 *
 		 * NOTE: Only do this if the base-expression starts with
-		 *       a  group that contains  at least 1 alternation! */
+		 *       a  group that contains  at least 1 alternation!
+		 *
+		 * Location assertions that came before the group are written out as-is, though.
+		 * Were they copied into every alternative, a suffix like in "\b(a|b){1,3}" would
+		 * repeat them along with the group. */
+		alternation_prefix_dump();
 		expr_start_offset = (size_t)(self->rec_estart - self->rec_cbase);
 #if ALTERNATION_PREFIX_MAXLEN > 0
 		if (alternation_prefix_wanted) {
@@ -2897,8 +3493,9 @@ do_group_start_without_alternation:
 	case RE_TOKEN_BK_W: {
 		if (IF_NO_UTF8(self->rec_parser.rep_syntax)) {
 			static byte_t const issymcont_y_code[] = {
-				REOP_CS_BYTE,
-				RECS_BITSET_BUILD(0x20, 12),
+				REOP_BITSET,
+				/* 00-0F */ 0x00, 0x00,
+				/* 10-1F */ 0x00, 0x00,
 				/* 20-27 */ 0x00 | (1 << (0x24 % 8)), /* $ */
 				/* 28-2F */ 0x00,
 				/* 30-37 */ 0x00 | (1 << (0x30 % 8))  /* 0 */
@@ -2964,11 +3561,17 @@ do_group_start_without_alternation:
 				/* 78-7F */ 0x00 | (1 << (0x78 % 8))  /* x */
 				/*            */ | (1 << (0x79 % 8))  /* y */
 				/*            */ | (1 << (0x7a % 8)), /* z */
-				RECS_DONE
+				/* 80-8F */ 0x00, 0x00,
+				/* 90-9F */ 0x00, 0x00,
+				/* A0-AF */ 0x00, 0x00,
+				/* B0-BF */ 0x00, 0x00,
+				/* C0-CF */ 0x00, 0x00,
+				/* D0-DF */ 0x00, 0x00,
+				/* E0-EF */ 0x00, 0x00,
+				/* F0-FF */ 0x00, 0x00
 			};
 			static byte_t const issymcont_n_code[] = {
-				REOP_CS_BYTE,
-				RECS_BITSET_BUILD(0x00, 32),
+				REOP_BITSET,
 				/* 00-0F */ 0xff, 0xff,
 				/* 10-1F */ 0xff, 0xff,
 				/* 20-27 */ 0xff & ~(1 << (0x24 % 8)), /* $ */
@@ -3043,9 +3646,10 @@ do_group_start_without_alternation:
 				/* C0-CF */ 0xff, 0xff,
 				/* D0-DF */ 0xff, 0xff,
 				/* E0-EF */ 0xff, 0xff,
-				/* F0-FF */ 0xff, 0xff,
-				RECS_DONE
+				/* F0-FF */ 0xff, 0xff
 			};
+			static_assert(sizeof(issymcont_y_code) == 1 + 32);
+			static_assert(sizeof(issymcont_n_code) == 1 + 32);
 			if (tok == RE_TOKEN_BK_W) {
 				if unlikely(!re_compiler_putn(self, issymcont_n_code, sizeof(issymcont_n_code)))
 					goto err_nomem;
@@ -3054,12 +3658,7 @@ do_group_start_without_alternation:
 					goto err_nomem;
 			}
 		} else {
-			if (!re_compiler_putc(self, tok == RE_TOKEN_BK_W ? (byte_t)REOP_NCS_UTF8
-			                                                 : (byte_t)REOP_CS_UTF8))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_ISSYMCONT))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_DONE))
+			if (!re_compiler_put_cs_utf8_trait(self, (tok == RE_TOKEN_BK_W), RECS_ISSYMCONT))
 				goto err_nomem;
 		}
 		goto done_prefix;
@@ -3069,8 +3668,7 @@ do_group_start_without_alternation:
 	case RE_TOKEN_BK_S: {
 		if (IF_NO_UTF8(self->rec_parser.rep_syntax)) {
 			static byte_t const isspace_y_code[] = {
-				REOP_CS_BYTE,
-				RECS_BITSET_BUILD(0x00, 5),
+				REOP_BITSET,
 				/* 00-07 */ 0x00,
 				/* 08-0F */ 0x00 | (1 << (0x09 % 8))
 				/*            */ | (1 << (0x0A % 8))
@@ -3080,11 +3678,23 @@ do_group_start_without_alternation:
 				/* 10-17 */ 0x00,
 				/* 18-1F */ 0x00,
 				/* 20-27 */ 0x00 | (1 << (0x20 % 8)),
-				RECS_DONE
+				/* 28-2F */ 0x00,
+				/* 30-3F */ 0x00, 0x00,
+				/* 40-4F */ 0x00, 0x00,
+				/* 50-5F */ 0x00, 0x00,
+				/* 60-6F */ 0x00, 0x00,
+				/* 70-7F */ 0x00, 0x00,
+				/* 80-8F */ 0x00, 0x00,
+				/* 90-9F */ 0x00, 0x00,
+				/* A0-AF */ 0x00, 0x00,
+				/* B0-BF */ 0x00, 0x00,
+				/* C0-CF */ 0x00, 0x00,
+				/* D0-DF */ 0x00, 0x00,
+				/* E0-EF */ 0x00, 0x00,
+				/* F0-FF */ 0x00, 0x00
 			};
 			static byte_t const isspace_n_code[] = {
-				REOP_CS_BYTE,
-				RECS_BITSET_BUILD(0x00, 32),
+				REOP_BITSET,
 				/* 00-0F */ 0xff, 0xff & ~(1 << (0x09 % 8))
 				/*                  */ & ~(1 << (0x0A % 8))
 				/*                  */ & ~(1 << (0x0B % 8))
@@ -3104,9 +3714,10 @@ do_group_start_without_alternation:
 				/* C0-CF */ 0xff, 0xff,
 				/* D0-DF */ 0xff, 0xff,
 				/* E0-EF */ 0xff, 0xff,
-				/* F0-FF */ 0xff, 0xff,
-				RECS_DONE
+				/* F0-FF */ 0xff, 0xff
 			};
+			static_assert(sizeof(isspace_y_code) == 1 + 32);
+			static_assert(sizeof(isspace_n_code) == 1 + 32);
 			if (tok == RE_TOKEN_BK_W) {
 				if unlikely(!re_compiler_putn(self, isspace_n_code, sizeof(isspace_n_code)))
 					goto err_nomem;
@@ -3115,12 +3726,7 @@ do_group_start_without_alternation:
 					goto err_nomem;
 			}
 		} else {
-			if (!re_compiler_putc(self, (tok == RE_TOKEN_BK_W) ? (byte_t)REOP_NCS_UTF8
-			                                                   : (byte_t)REOP_CS_UTF8))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_ISSPACE))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_DONE))
+			if (!re_compiler_put_cs_utf8_trait(self, (tok == RE_TOKEN_BK_W), RECS_ISSPACE))
 				goto err_nomem;
 		}
 		goto done_prefix;
@@ -3137,12 +3743,7 @@ do_group_start_without_alternation:
 			if (!re_compiler_putc(self, (byte_t)0x39)) /* '9' */
 				goto err_nomem;
 		} else {
-			if (!re_compiler_putc(self, (tok == RE_TOKEN_BK_D) ? (byte_t)REOP_NCS_UTF8
-			                                                   : (byte_t)REOP_CS_UTF8))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_ISDIGIT))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_DONE))
+			if (!re_compiler_put_cs_utf8_trait(self, (tok == RE_TOKEN_BK_D), RECS_ISDIGIT))
 				goto err_nomem;
 		}
 		goto done_prefix;
@@ -3159,12 +3760,7 @@ do_group_start_without_alternation:
 			if (!re_compiler_putc(self, (byte_t)0x0d)) /* '\r' */
 				goto err_nomem;
 		} else {
-			if (!re_compiler_putc(self, (tok == RE_TOKEN_BK_N) ? (byte_t)REOP_NCS_UTF8
-			                                                   : (byte_t)REOP_CS_UTF8))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_ISLF))
-				goto err_nomem;
-			if (!re_compiler_putc(self, RECS_DONE))
+			if (!re_compiler_put_cs_utf8_trait(self, (tok == RE_TOKEN_BK_N), RECS_ISLF))
 				goto err_nomem;
 		}
 		goto done_prefix;
@@ -3919,6 +4515,297 @@ NOTHROW_NCX(CC re_compiler_thread_fwd_jump)(byte_t *__restrict p_jmp_instruction
 }
 
 
+/* Wrap the alternative that was just compiled at `branch_startoff' (up until the
+ * current position) in `REOP_JMP_ONFAIL' + `REOP_MAYBE_POP_ONFAIL' + `REOP_JMP',
+ * so that the next alternative can be compiled after it.
+ * @return: false: Out of memory */
+PRIVATE WUNUSED NONNULL((1, 3, 4)) bool
+NOTHROW_NCX(CC re_compiler_wrap_alternation)(struct re_compiler *__restrict self,
+                                             size_t branch_startoff,
+                                             size_t *__restrict p_initial_jmpoff,
+                                             size_t *__restrict p_previous_deltaoff) {
+	byte_t *current_alternation_startptr;
+	size_t current_alternation_size;
+
+	/* Ensure that we've got enough memory for `REOP_JMP_ONFAIL', `REOP_MAYBE_POP_ONFAIL', and `REOP_JMP' */
+	if unlikely(!re_compiler_require(self, 9))
+		return false;
+	current_alternation_startptr = self->rec_cbase + branch_startoff;
+	current_alternation_size     = (size_t)(self->rec_cpos - current_alternation_startptr);
+	memmoveup(current_alternation_startptr + 3,
+	          current_alternation_startptr,
+	          current_alternation_size);
+
+	/* Insert the leading `REOP_JMP_ONFAIL' that points to the next alternation */
+	*current_alternation_startptr++ = REOP_JMP_ONFAIL;
+	delta16_set(current_alternation_startptr, current_alternation_size + 6);
+	current_alternation_startptr += 2;
+	current_alternation_startptr += current_alternation_size;
+	*current_alternation_startptr++ = REOP_MAYBE_POP_ONFAIL;
+	current_alternation_startptr += 2;
+
+	/* Write  the `REOP_JMP' instruction after the alternation
+	 * Note that the offset of this instruction will be filled
+	 * after the next alternation has been compiled. */
+	if (*p_initial_jmpoff == (size_t)-1) {
+		/* Remember the first jump location so we can jump-thread-optimize it later! */
+		*p_initial_jmpoff = (size_t)(current_alternation_startptr - self->rec_cbase);
+	}
+
+	/* Fill in the delta of the `REOP_JMP ...' from a preceding alternation. */
+	if (*p_previous_deltaoff != (size_t)-1) {
+		byte_t *previous_alternation_deltaptr;
+		int16_t previous_alternation_skipdelta;
+		previous_alternation_deltaptr  = self->rec_cbase + *p_previous_deltaoff;
+		previous_alternation_skipdelta = (int16_t)(current_alternation_startptr - (previous_alternation_deltaptr + 2));
+		assert(previous_alternation_skipdelta >= 0);
+		delta16_set(previous_alternation_deltaptr, previous_alternation_skipdelta);
+	}
+
+	*current_alternation_startptr++ = REOP_JMP;
+	*p_previous_deltaoff = (size_t)(current_alternation_startptr - self->rec_cbase);
+	DBG_memset(current_alternation_startptr, 0xcc, 2); /* UNDEFINED! (filled later) */
+	current_alternation_startptr += 2;
+	self->rec_cpos = current_alternation_startptr;
+	return true;
+}
+
+
+/* Literal alternatives put aside by `re_compiler_compile_alternation()' (until
+ * it is known if they can be turned into a `REOP_TRIE', or have to be compiled
+ * as normal alternatives after all) */
+struct re_altlits {
+	byte_t *ral_base;  /* [0..ral_size][owned] Records: `[size_t N][N bytes of code][pad to size_t]' */
+	size_t  ral_size;  /* Used size of `ral_base' */
+	size_t  ral_alloc; /* Allocated size of `ral_base' */
+	size_t  ral_count; /* # of records */
+};
+#define re_altlits_init(self)  bzero(self, sizeof(struct re_altlits))
+#define re_altlits_fini(self)  free((self)->ral_base)
+#define re_altlits_recsize(n)  CEIL_ALIGN(sizeof(size_t) + (n), sizeof(size_t))
+
+/* Append a record for `n' bytes of `code' to `self'
+ * @return: false: Out of memory */
+PRIVATE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_altlits_append)(struct re_altlits *__restrict self,
+                                  void const *code, size_t n) {
+	size_t recsize = re_altlits_recsize(n);
+	if (self->ral_alloc - self->ral_size < recsize) {
+		byte_t *new_base;
+		size_t new_alloc = self->ral_alloc * 2;
+		if (new_alloc < self->ral_size + recsize)
+			new_alloc = self->ral_size + recsize;
+		new_base = (byte_t *)realloc(self->ral_base, new_alloc);
+		if unlikely(!new_base)
+			return false;
+		self->ral_base  = new_base;
+		self->ral_alloc = new_alloc;
+	}
+	memcpy(self->ral_base + self->ral_size, &n, sizeof(size_t));
+	memcpy(self->ral_base + self->ral_size + sizeof(size_t), code, n);
+	self->ral_size += recsize;
+	++self->ral_count;
+	return true;
+}
+
+/* Check if `n' bytes of `code' only match a (non-empty) literal */
+PRIVATE ATTR_PURE WUNUSED bool
+NOTHROW_NCX(CC re_code_isliteral)(byte_t const *code, size_t n) {
+	byte_t const *end = code + n;
+	if (code >= end)
+		return false;
+	while (code < end) {
+		if (*code == REOP_BYTE) {
+			code += 2;
+		} else if (*code == REOP_EXACT) {
+			code += 2 + code[1];
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Compile all alternatives from `lits' as normal alternatives (s.a. `re_compiler_wrap_alternation()')
+ * @return: false: Out of memory */
+PRIVATE WUNUSED NONNULL((1, 2, 5, 6)) bool
+NOTHROW_NCX(CC re_compiler_replay_altlits)(struct re_compiler *__restrict self,
+                                           struct re_altlits const *__restrict lits,
+                                           void const *alternation_prefix,
+                                           size_t alternation_prefix_size,
+                                           size_t *__restrict p_initial_jmpoff,
+                                           size_t *__restrict p_previous_deltaoff) {
+	size_t i, recoff = 0;
+	for (i = 0; i < lits->ral_count; ++i) {
+		size_t n, startoff;
+		memcpy(&n, lits->ral_base + recoff, sizeof(size_t));
+		startoff = (size_t)(self->rec_cpos - self->rec_cbase);
+		if (!re_compiler_putn(self, alternation_prefix, alternation_prefix_size))
+			return false;
+		if (!re_compiler_putn(self, lits->ral_base + recoff + sizeof(size_t), n))
+			return false;
+		if (!re_compiler_wrap_alternation(self, startoff, p_initial_jmpoff, p_previous_deltaoff))
+			return false;
+		recoff += re_altlits_recsize(n);
+	}
+	return true;
+}
+
+struct re_trielit {
+	byte_t const *tl_str; /* [1..tl_len] Literal */
+	size_t        tl_len; /* Length of `tl_str' */
+};
+
+PRIVATE WUNUSED NONNULL((1, 2)) int
+NOTHROW_NCX(__LIBCCALL compare_re_trielit)(void const *a, void const *b) {
+	struct re_trielit const *lhs = (struct re_trielit const *)a;
+	struct re_trielit const *rhs = (struct re_trielit const *)b;
+	int result = memcmp(lhs->tl_str, rhs->tl_str, MIN(lhs->tl_len, rhs->tl_len));
+	if (result == 0) {
+		if (lhs->tl_len < rhs->tl_len)
+			return -1;
+		if (lhs->tl_len > rhs->tl_len)
+			return 1;
+	}
+	return result;
+}
+
+/* Compile the trie node for the sorted (and de-duplicated) literals `lits[lo:hi]',
+ * all of which share their first `depth' bytes (which were already matched)
+ * @param: trieoff: Offset of the `REOP_TRIE' opcode
+ * @return: false: Out of memory (or code became too large) */
+PRIVATE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_compiler_compile_trie_node)(struct re_compiler *__restrict self,
+                                              struct re_trielit const *lits,
+                                              size_t lo, size_t hi, size_t depth,
+                                              size_t trieoff) {
+	for (;;) {
+		byte_t hdr = RETRIE_LEAF;
+		size_t i, run, count, labelsoff;
+		assert(lo < hi);
+		if (lits[lo].tl_len == depth) {
+			/* A literal ends here (since literals are sorted, it can only be the first one) */
+			hdr |= RETRIE_ACCEPT;
+			++lo;
+		}
+		if (lo >= hi)
+			return re_compiler_putc(self, hdr);
+
+		/* Bytes shared by all remaining literals (the first and last of which
+		 * differ the most) become a run. */
+		run = MIN(lits[lo].tl_len, lits[hi - 1].tl_len) - depth;
+		if (run > RETRIE_RUNMASK)
+			run = RETRIE_RUNMASK;
+		for (i = 0; i < run; ++i) {
+			if (lits[lo].tl_str[depth + i] != lits[hi - 1].tl_str[depth + i])
+				break;
+		}
+		if (i != 0) {
+			if (!re_compiler_putc(self, hdr | RETRIE_RUN | (byte_t)i))
+				return false;
+			if (!re_compiler_putn(self, lits[lo].tl_str + depth, i))
+				return false;
+			depth += i;
+			continue;
+		}
+
+		/* Remaining literals differ in their next byte -> branch */
+		for (i = lo + 1, count = 1; i < hi; ++i) {
+			if (lits[i].tl_str[depth] != lits[i - 1].tl_str[depth])
+				++count;
+		}
+		assert(count >= 2 && count <= 256);
+		if (!re_compiler_putc(self, hdr | RETRIE_BRANCH))
+			return false;
+		if (!re_compiler_putc(self, (byte_t)(count - 1)))
+			return false;
+		if (!re_compiler_require(self, count * 3))
+			return false;
+		labelsoff = (size_t)(self->rec_cpos - self->rec_cbase);
+		self->rec_cpos += count * 3;
+		for (i = 0; lo < hi; ++i) {
+			size_t end = lo + 1;
+			byte_t label = lits[lo].tl_str[depth];
+			byte_t *labels;
+			while (end < hi && lits[end].tl_str[depth] == label)
+				++end;
+			labels = self->rec_cbase + labelsoff;
+			labels[i] = label;
+			UNALIGNED_SET16(labels + count + i * 2,
+			                (uint16_t)((size_t)(self->rec_cpos - self->rec_cbase) - trieoff));
+			if (!re_compiler_compile_trie_node(self, lits, lo, end, depth + 1, trieoff))
+				return false;
+			lo = end;
+		}
+		assert(i == count);
+		return true;
+	}
+}
+
+/* Compile the literals from `lits' (which must all be
+ * non-empty, and at least 1) as a `REOP_TRIE' opcode. */
+PRIVATE WUNUSED NONNULL((1, 2)) re_errno_t
+NOTHROW_NCX(CC re_compiler_compile_trie)(struct re_compiler *__restrict self,
+                                         struct re_altlits *__restrict lits) {
+	struct re_trielit *litv;
+	size_t i, j, count, recoff, trieoff;
+	litv = (struct re_trielit *)malloc(lits->ral_count * sizeof(struct re_trielit));
+	if unlikely(!litv)
+		goto err_nomem;
+
+	/* Convert code into literals (in-place; literals are always shorter than their code) */
+	for (i = 0, recoff = 0; i < lits->ral_count; ++i) {
+		size_t n;
+		byte_t *reader, *writer, *end;
+		memcpy(&n, lits->ral_base + recoff, sizeof(size_t));
+		reader = writer = lits->ral_base + recoff + sizeof(size_t);
+		end    = reader + n;
+		while (reader < end) {
+			if (*reader == REOP_BYTE) {
+				*writer++ = reader[1];
+				reader += 2;
+			} else {
+				byte_t len = reader[1];
+				assert(*reader == REOP_EXACT);
+				memmovedown(writer, reader + 2, len);
+				writer += len;
+				reader += 2 + len;
+			}
+		}
+		litv[i].tl_str = lits->ral_base + recoff + sizeof(size_t);
+		litv[i].tl_len = (size_t)(writer - litv[i].tl_str);
+		recoff += re_altlits_recsize(n);
+	}
+
+	/* Sort + remove duplicates */
+	qsort(litv, lits->ral_count, sizeof(struct re_trielit), &compare_re_trielit);
+	for (i = j = 0; i < lits->ral_count; ++i) {
+		if (j == 0 || compare_re_trielit(&litv[j - 1], &litv[i]) != 0)
+			litv[j++] = litv[i];
+	}
+	count = j;
+
+	/* Generate code */
+	trieoff = (size_t)(self->rec_cpos - self->rec_cbase);
+	if (!re_compiler_putc(self, REOP_TRIE))
+		goto err_nomem_litv;
+	if (!re_compiler_require(self, 2))
+		goto err_nomem_litv;
+	self->rec_cpos += 2;
+	assert((size_t)(self->rec_cpos - self->rec_cbase) == trieoff + RETRIE_ROOT);
+	if (!re_compiler_compile_trie_node(self, litv, 0, count, 0, trieoff))
+		goto err_nomem_litv;
+	UNALIGNED_SET16(self->rec_cbase + trieoff + 1,
+	                (uint16_t)((size_t)(self->rec_cpos - self->rec_cbase) - (trieoff + RETRIE_ROOT)));
+	free(litv);
+	return RE_NOERROR;
+err_nomem_litv:
+	free(litv);
+err_nomem:
+	return RE_ESPACE;
+}
+
+
 /* Compile a sequence of prefix/suffix expressions, as well as '|'
  * @param: alternation_prefix: A code-blob that is inserted before
  *                             the  body  of  every   alternation.
@@ -3939,9 +4826,22 @@ NOTHROW_NCX(CC _re_compiler_compile_alternation)(struct re_compiler *__restrict
 	size_t current_alternation_startoff;
 	re_token_t tok;
 	char const *tokstart;
+	struct re_altlits lits;
+	bool lits_wanted;
+#if ALTERNATION_PREFIX_MAXLEN <= 0
+	void const *alternation_prefix = NULL;
+	size_t alternation_prefix_size = 0;
+#endif /* ALTERNATION_PREFIX_MAXLEN <= 0 */
 	initial_alternation_jmpoff    = (size_t)-1;
 	previous_alternation_deltaoff = (size_t)-1;
 
+	/* Alternatives that are literals are put aside, such that they can be turned
+	 * into a `REOP_TRIE' if all of them end up being literals. But don't do this
+	 * if  the first match should be  returned, since a trie  tries the longest
+	 * literal first (rather than  the one that  appears first in the  pattern). */
+	re_altlits_init(&lits);
+	lits_wanted = !IF_NO_POSIX_BACKTRACKING(self->rec_parser.rep_syntax);
+
 again:
 	current_alternation_startoff = (size_t)(self->rec_cpos - self->rec_cbase);
 
@@ -3976,6 +4876,54 @@ again:
 	/* Check what's the next token */
 	tokstart = self->rec_parser.rep_pos;
 	tok      = re_compiler_yield(self);
+
+	if (lits_wanted) {
+		byte_t *body = self->rec_cbase + current_alternation_startoff + alternation_prefix_size;
+		size_t body_size = (size_t)(self->rec_cpos - body);
+		if (re_code_isliteral(body, body_size) &&
+		    (tok == RE_TOKEN_ALTERNATION || lits.ral_count + 1 >= ALTERNATION_TRIE_MINCOUNT)) {
+			/* Put the literal aside */
+			if (!re_altlits_append(&lits, body, body_size))
+				goto err_nomem;
+			self->rec_cpos = self->rec_cbase + current_alternation_startoff;
+			if (tok == RE_TOKEN_ALTERNATION)
+				goto again;
+
+			/* All alternatives are literals -> compile them as a trie */
+			self->rec_parser.rep_pos = tokstart;
+			if (!re_compiler_putn(self, alternation_prefix, alternation_prefix_size))
+				goto err_nomem;
+			error = re_compiler_compile_trie(self, &lits);
+			if unlikely(error != RE_NOERROR)
+				goto err;
+			re_altlits_fini(&lits);
+			return RE_NOERROR;
+		}
+
+		/* No trie after all -> compile alternatives that were put aside normally */
+		if (lits.ral_count != 0) {
+			size_t current_alternation_size;
+			current_alternation_size = (size_t)(self->rec_cpos - (self->rec_cbase + current_alternation_startoff));
+			if (!re_altlits_append(&lits, self->rec_cbase + current_alternation_startoff, current_alternation_size))
+				goto err_nomem;
+			self->rec_cpos = self->rec_cbase + current_alternation_startoff;
+			--lits.ral_count; /* The current alternative is restored below */
+			if (!re_compiler_replay_altlits(self, &lits, alternation_prefix, alternation_prefix_size,
+			                                &initial_alternation_jmpoff,
+			                                &previous_alternation_deltaoff))
+				goto err_nomem;
+			current_alternation_startoff = (size_t)(self->rec_cpos - self->rec_cbase);
+			if (!re_compiler_putn(self, lits.ral_base + lits.ral_size -
+			                            re_altlits_recsize(current_alternation_size) +
+			                            sizeof(size_t),
+			                      current_alternation_size))
+				goto err_nomem;
+		}
+		re_altlits_fini(&lits);
+		re_altlits_init(&lits);
+		lits_wanted = false;
+	}
+
 	if (tok != RE_TOKEN_ALTERNATION) {
 		/* Rewind to start of token */
 		self->rec_parser.rep_pos = tokstart;
@@ -3989,49 +4937,10 @@ again:
 			delta16_set(previous_alternation_deltaptr, previous_alternation_skipdelta);
 		}
 	} else {
-		byte_t *current_alternation_startptr;
-		size_t current_alternation_size;
-
-		/* Ensure that we've got enough memory for `REOP_JMP_ONFAIL', `REOP_MAYBE_POP_ONFAIL', and `REOP_JMP' */
-		if unlikely(!re_compiler_require(self, 9))
+		if (!re_compiler_wrap_alternation(self, current_alternation_startoff,
+		                                  &initial_alternation_jmpoff,
+		                                  &previous_alternation_deltaoff))
 			goto err_nomem;
-		current_alternation_startptr = self->rec_cbase + current_alternation_startoff;
-		current_alternation_size     = (size_t)(self->rec_cpos - current_alternation_startptr);
-		memmoveup(current_alternation_startptr + 3,
-		          current_alternation_startptr,
-		          current_alternation_size);
-
-		/* Insert the leading `REOP_JMP_ONFAIL' that points to the next alternation */
-		*current_alternation_startptr++ = REOP_JMP_ONFAIL;
-		delta16_set(current_alternation_startptr, current_alternation_size + 6);
-		current_alternation_startptr += 2;
-		current_alternation_startptr += current_alternation_size;
-		*current_alternation_startptr++ = REOP_MAYBE_POP_ONFAIL;
-		current_alternation_startptr += 2;
-
-		/* Write  the `REOP_JMP' instruction after the alternation
-		 * Note that the offset of this instruction will be filled
-		 * after the next alternation has been compiled. */
-		if (initial_alternation_jmpoff == (size_t)-1) {
-			/* Remember the first jump location so we can jump-thread-optimize it later! */
-			initial_alternation_jmpoff = (size_t)(current_alternation_startptr - self->rec_cbase);
-		}
-
-		/* Fill in the delta of the `REOP_JMP ...' from a preceding alternation. */
-		if (previous_alternation_deltaoff != (size_t)-1) {
-			byte_t *previous_alternation_deltaptr;
-			int16_t previous_alternation_skipdelta;
-			previous_alternation_deltaptr  = self->rec_cbase + previous_alternation_deltaoff;
-			previous_alternation_skipdelta = (int16_t)(current_alternation_startptr - (previous_alternation_deltaptr + 2));
-			assert(previous_alternation_skipdelta >= 0);
-			delta16_set(previous_alternation_deltaptr, previous_alternation_skipdelta);
-		}
-
-		*current_alternation_startptr++ = REOP_JMP;
-		previous_alternation_deltaoff = (size_t)(current_alternation_startptr - self->rec_cbase);
-		DBG_memset(current_alternation_startptr, 0xcc, 2); /* UNDEFINED! (filled later) */
-		current_alternation_startptr += 2;
-		self->rec_cpos = current_alternation_startptr;
 		goto again;
 	}
 
@@ -4066,10 +4975,11 @@ again:
 	}
 
 	return RE_NOERROR;
+err_nomem:
+	error = RE_ESPACE;
 err:
+	re_altlits_fini(&lits);
 	return error;
-err_nomem:
-	return RE_ESPACE;
 }
 
 
@@ -4279,6 +5189,62 @@ NOTHROW_NCX(CC libre_code_disasm)(struct re_code const *__restrict self,
 			       (size_t)1, pc + 1);
 		}	break;
 
+		case REOP_BITSET:
+		case REOP_SEQ_UTF8:
+		case REOP_NSEQ_UTF8: {
+			unsigned int nbits = 256;
+			bool isfirst = true;
+			if (opcode == REOP_BITSET) {
+				PRINT("bitset [");
+			} else {
+				printf("%sseq_utf8 [", opcode == REOP_NSEQ_UTF8 ? "n" : "");
+				nbits = 128;
+			}
+			for (i = 0; i < nbits;) {
+				char repr[3];
+				unsigned int endi, rangec;
+				if ((pc[i / 8] & (1 << (i % 8))) == 0) {
+					++i;
+					continue;
+				}
+				endi = i + 1;
+				while (endi < nbits && (pc[endi / 8] & (1 << (endi % 8))) != 0)
+					++endi;
+				rangec = endi - i;
+				if (rangec > 3) {
+					repr[0] = (char)i;
+					repr[1] = '-';
+					repr[2] = (char)(endi - 1);
+					rangec  = 3;
+				} else {
+					repr[0] = (char)(i + 0);
+					repr[1] = (char)(i + 1);
+					repr[2] = (char)(i + 2);
+				}
+				printf("%#$q", (size_t)rangec, repr);
+				isfirst = false;
+				i = endi;
+			}
+			if (opcode != REOP_BITSET) {
+				/* Multi-byte sequences */
+				byte_t seqlen;
+				pc += 16;
+				while ((seqlen = *pc++) != 0) {
+					if (!isfirst)
+						PRINT(", ");
+					isfirst = false;
+					for (; seqlen; --seqlen, pc += 2) {
+						if (pc[0] == pc[1]) {
+							printf("%#$q", (size_t)1, &pc[0]);
+						} else {
+							printf("[%#$q-%#$q]", (size_t)1, &pc[0], (size_t)1, &pc[1]);
+						}
+					}
+				}
+			}
+			PRINT("]");
+		}	break;
+
 		case REOP_CONTAINS_UTF8:
 		case REOP_NCONTAINS_UTF8: {
 			++pc;
@@ -4306,7 +5272,13 @@ NOTHROW_NCX(CC libre_code_disasm)(struct re_code const *__restrict self,
 			}
 			printf("%s [", opcode_repr);
 			isfirst = true;
+			if (opcode != REOP_CS_BYTE) {
+				/* Print the leading ASCII bitset like a `RECS_BITSET_*' */
+				cs_opcode = RECS_BITSET_BUILD(0x00, 16);
+				goto do_cs_opcode;
+			}
 			while ((cs_opcode = *pc++) != RECS_DONE) {
+do_cs_opcode:
 				if (!isfirst)
 					PRINT(", ");
 				isfirst = false;
@@ -4435,6 +5407,19 @@ NOTHROW_NCX(CC libre_code_disasm)(struct re_code const *__restrict self,
 					printf("is%s", cs_name);
 				}	break;
 
+				case RECS_ISX_MASK:
+					printf("traits %#.4" PRIx16, (uint16_t)UNALIGNED_GET16(pc));
+					pc += 2;
+					break;
+
+				case RECS_CONTAINS_SORTED: {
+					uint16_t len = UNALIGNED_GET16(pc);
+					pc += 2;
+					PRINT("contains_sorted ");
+					printf("%$q", (size_t)len, pc);
+					pc += len;
+				}	break;
+
 				default:
 					if (cs_opcode >= RECS_BITSET_MIN &&
 					    cs_opcode <= (opcode == REOP_CS_BYTE ? RECS_BITSET_MAX_BYTE
@@ -4482,6 +5467,11 @@ do_cs_bitset:
 			assertf(pc == nextpc, "pc - nextpc = %Id", pc - nextpc);
 		}	break;
 
+		case REOP_TRIE: {
+			uint16_t size = UNALIGNED_GET16(pc);
+			printf("trie [%" PRIu16 " bytes]", size);
+		}	break;
+
 		case REOP_GROUP_MATCH: {
 			uint8_t gid = *pc++;
 			printf("group_match %" PRIu8, gid);
@@ -4536,6 +5526,26 @@ do_cs_bitset:
 			printf("jmp_and_return_onfail @%#.4" PRIxSIZ, (size_t)(jmp - self->rc_code));
 		}	break;
 
+		case REOP_SPAN: {
+			byte_t const *jmp = pc + 2 + delta16_get(pc);
+			printf("span @%#.4" PRIxSIZ, (size_t)(jmp - self->rc_code));
+		}	break;
+
+		case REOP_SPAN_AND_RETURN_ONFAIL: {
+			byte_t const *jmp = pc + 2 + delta16_get(pc);
+			printf("span_and_return_onfail @%#.4" PRIxSIZ, (size_t)(jmp - self->rc_code));
+		}	break;
+
+		case REOP_SPAN_LIT: {
+			byte_t const *jmp = pc + 2 + delta16_get(pc);
+			printf("span_lit @%#.4" PRIxSIZ, (size_t)(jmp - self->rc_code));
+		}	break;
+
+		case REOP_SPAN_LIT_AND_RETURN_ONFAIL: {
+			byte_t const *jmp = pc + 2 + delta16_get(pc);
+			printf("span_lit_and_return_onfail @%#.4" PRIxSIZ, (size_t)(jmp - self->rc_code));
+		}	break;
+
 		case REOP_DEC_JMP: {
 			uint8_t varid     = *pc++;
 			byte_t const *jmp = pc + 2 + delta16_get(pc);
@@ -0,0 +1,1053 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGDFA_C
+#define GUARD_LIBREGEX_REGDFA_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <hybrid/align.h>
+#include <hybrid/unaligned.h>
+
+#include <kos/types.h>
+
+#include <assert.h>
+#include <ctype.h>
+#include <inttypes.h>
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unicode.h>
+
+#include <libregex/regcomp.h>
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regcomp.h"
+#include "regdfa.h"
+#include "reginterp.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+/* When the caller doesn't want group offsets, the longest match of code that
+ * doesn't use back-references, variables, or first-match semantics can also
+ * be found by following all paths through the code at once: the set of live
+ * threads (program counters) after some input was consumed only depends  on
+ * the set from before and the byte that was consumed. Such sets are  turned
+ * into the states of a DFA, which is built lazily while input is scanned (so
+ * only states that are actually needed are ever constructed), and cached so
+ * that each further byte of input only costs a table lookup.
+ *
+ * The DFA gives up (and the caller falls back to `libre_interp_exec()') if
+ * its state cache keeps on being flushed without much input being scanned,
+ * or if a utf-8 opcode encounters malformed utf-8.
+ *
+ * Code where the peephole optimizer made the interpreter prune alternatives
+ * (`RE_CODE_FLAG_POPPRUNES') is never run by the DFA, since results have to
+ * be the same no matter which of the two ends up being used. (Streams still
+ * use a DFA for such code, but only to tell when threads have died, which
+ * pruning can only make happen sooner; s.a. `re_stream_walk()') */
+
+/* Min # of input bytes that must have been scanned per cached state when the
+ * cache becomes full. If fewer were scanned, the DFA is just being rebuilt for
+ * every byte of input, and it is better to give up. */
+#define RE_DFA_MINSCAN_PER_STATE 8
+
+/* Max # of bits in byte class signatures (if more would be needed, every byte
+ * is given its own class). Set DFAs allow as many as fit into their cache. */
+#define RE_DFA_MAXSIGBITS 1024
+
+/* Special value for the `inject' argument of `re_dfa_closure()' */
+#define RE_DFA_INJECT_SET ((size_t)-2) /* Start a new thread for every pattern of a set DFA */
+
+/* Set the bits of all bytes that appear in the `REOP_TRIE' at `pc' in `bytes'
+ * @return: * : The # of distinct bytes */
+PRIVATE NONNULL((1, 2)) size_t
+NOTHROW_NCX(CC re_dfa_triebytes)(byte_t const *__restrict pc, byte_t bytes[32]) {
+	byte_t const *node = pc + RETRIE_ROOT;
+	byte_t const *end  = libre_opcode_next(pc);
+	size_t i, result = 0;
+	bzero(bytes, 32);
+	while (node < end) {
+		byte_t const *labels;
+		size_t count;
+		if (*node & RETRIE_RUN) {
+			count  = *node & RETRIE_RUNMASK;
+			labels = node + 1;
+			node   = labels + count;
+		} else if (*node & RETRIE_BRANCH) {
+			count  = (size_t)node[1] + 1;
+			labels = node + 2;
+			node   = labels + count * 3;
+		} else {
+			++node;
+			continue;
+		}
+		for (i = 0; i < count; ++i) {
+			byte_t b = labels[i];
+			if (!(bytes[b / 8] & (1 << (b % 8)))) {
+				bytes[b / 8] |= 1 << (b % 8);
+				++result;
+			}
+		}
+	}
+	return result;
+}
+
+/* Return the thread for the node at `nodeoff' of the `REOP_TRIE' at `pc'
+ * (threads at leaves immediately move on to the opcode after the trie) */
+PRIVATE WUNUSED NONNULL((1, 2)) re_dfa_thread_t
+NOTHROW_NCX(CC re_dfa_triethread)(byte_t const *__restrict code,
+                                  byte_t const *__restrict pc,
+                                  size_t nodeoff) {
+	if (!(pc[nodeoff] & (RETRIE_RUN | RETRIE_BRANCH)))
+		return RE_DFA_THREAD(libre_opcode_next(pc) - code, 0);
+	return RE_DFA_THREAD(pc - code, RE_DFA_AUX(0, 0, nodeoff));
+}
+
+/* If `thread' is at a node of `REOP_TRIE' where a literal ends (but from where
+ * longer literals continue), return the offset of the opcode after the trie.
+ * Otherwise, return `(size_t)-1' */
+INTERN ATTR_PURE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_dfa_trieaccept)(byte_t const *__restrict code,
+                                  re_dfa_thread_t thread) {
+	byte_t const *pc = code + RE_DFA_THREAD_PCOFF(thread);
+	uint64_t aux = RE_DFA_THREAD_AUX(thread);
+	if (*pc != REOP_TRIE || aux == 0 || RE_DFA_AUX_PROGRESS(aux) != 0)
+		return (size_t)-1;
+	if (!(pc[RE_DFA_AUX_UTF8(aux)] & RETRIE_ACCEPT))
+		return (size_t)-1;
+	return (size_t)(libre_opcode_next(pc) - code);
+}
+
+/* Return the context flags for the current position of `interp' */
+INTERN WUNUSED NONNULL((1, 2)) uint8_t
+NOTHROW_NCX(CC re_dfa_getctx)(struct re_dfa const *__restrict self,
+                              struct re_interpreter *__restrict interp) {
+	byte_t prevbyte;
+	if (re_interpreter_is_soi(interp))
+		return RE_DFA_CTX_SOI & self->df_ctxmask;
+	prevbyte = re_interpreter_prevbyte(interp);
+	return re_dfa_ctxof(self, prevbyte);
+}
+
+/* Compute the byte classes of `self' (bytes of the same class are
+ * indistinguishable for the code, and share DFA transitions)
+ * @param: fmap:    The fast-map used to start new threads (or `NULL' if threads
+ *                  are always started at the beginning of code, as in set DFAs)
+ * @param: sigbits: The # of per-opcode bits needed in signatures
+ * @param: utf8:    True if the code contains utf-8 opcodes */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC re_dfa_init_classes)(struct re_dfa *__restrict self, byte_t const *fmap,
+                                    size_t sigbits, bool utf8) {
+	byte_t const *pc, *end;
+	byte_t *sigv, sigflags = 0;
+	size_t sigsize, bit;
+	uint32_t sighash[256];
+	byte_t reprv[256]; /* Representative byte of every class */
+	unsigned int ch, cls;
+	sigsize = 2 + CEILDIV(sigbits, 8);
+	if (self->df_setc != 0 ? 256 * sigsize > (size_t)(self->df_cacheend - self->df_cachebase)
+	                       : sigbits > RE_DFA_MAXSIGBITS) {
+		for (ch = 0; ch < 256; ++ch)
+			self->df_classes[ch] = (byte_t)ch;
+		self->df_nclasses = 256;
+		return;
+	}
+
+	/* Bytes of the same class must produce identical context flags */
+	if (self->df_ctxmask & RE_DFA_CTX_LF)
+		sigflags |= 0x01;
+	if (self->df_ctxmask & RE_DFA_CTX_SYM)
+		sigflags |= 0x02;
+
+	/* Signatures are: [fmap, flags, opcode bits...]
+	 * The state cache isn't in use yet, so it can be used to store them. */
+	sigv = self->df_cachebase;
+	assert(256 * sigsize <= (size_t)(self->df_cacheend - self->df_cachebase));
+	bzero(sigv, 256 * sigsize);
+	for (ch = 0; ch < 256; ++ch) {
+		byte_t *sig = sigv + ch * sigsize;
+		sig[0] = fmap ? fmap[ch] : 0;
+		if (sigflags & 0x01)
+			sig[1] |= ascii_islf(ch) ? 0x01 : 0;
+		if (sigflags & 0x02)
+			sig[1] |= issymcont(ch) ? 0x02 : 0;
+	}
+#define SETBIT(cond) ((cond) ? (void)(sigv[ch * sigsize + 2 + bit / 8] |= 1 << (bit % 8)) : (void)0)
+	end = self->df_code + self->df_codesize;
+	for (pc = self->df_code, bit = 0; pc < end; pc = libre_opcode_next(pc)) {
+		switch (re_dfa_opkind(*pc)) {
+
+		case RE_DFA_OP_EXACT: {
+			byte_t i;
+			for (i = 0; i < pc[1]; ++i, ++bit) {
+				for (ch = 0; ch < 256; ++ch) {
+					SETBIT(*pc == REOP_EXACT ? ch == pc[2 + i]
+					                         : tolower(ch) == tolower(pc[2 + i]));
+				}
+			}
+		}	break;
+
+		case RE_DFA_OP_EXACT_UTF8: {
+			byte_t count = pc[1];
+			byte_t const *reader = pc + 2;
+			do {
+				char32_t expected = unicode_readutf8((char const **)&reader);
+				for (ch = 0; ch < 0x80; ++ch)
+					SETBIT(ch == expected || unicode_tolower(ch) == unicode_tolower(expected));
+				++bit;
+			} while (--count);
+		}	break;
+
+		case RE_DFA_OP_BYTE:
+			for (ch = 0; ch < 256; ++ch)
+				SETBIT(re_dfa_matchbyte(pc, (byte_t)ch));
+			++bit;
+			break;
+
+		case RE_DFA_OP_UTF8:
+			for (ch = 0; ch < 0x80; ++ch)
+				SETBIT(re_dfa_matchchar(pc, (char32_t)ch));
+			++bit;
+			break;
+
+		case RE_DFA_OP_TRIE: {
+			byte_t bytes[32];
+			unsigned int b;
+			(void)re_dfa_triebytes(pc, bytes);
+			for (b = 0; b < 256; ++b) {
+				if (!(bytes[b / 8] & (1 << (b % 8))))
+					continue;
+				for (ch = 0; ch < 256; ++ch)
+					SETBIT(ch == b);
+				++bit;
+			}
+		}	break;
+
+		default:
+			break;
+		}
+	}
+#undef SETBIT
+	assert(bit == sigbits);
+
+	/* Assign classes. With utf-8 opcodes, bytes >= 0x80 can be part of multi-byte
+	 * characters that can't be told apart by looking at a single byte, so those
+	 * always get classes of their own. */
+	for (ch = 0; ch < 256; ++ch) {
+		byte_t const *sig = sigv + ch * sigsize;
+		uint32_t hash = 2166136261u;
+		for (bit = 0; bit < sigsize; ++bit)
+			hash = (hash ^ sig[bit]) * 16777619u;
+		sighash[ch] = hash;
+	}
+	self->df_nclasses = 0;
+	for (ch = 0; ch < 256; ++ch) {
+		if (!utf8 || ch < 0x80) {
+			for (cls = 0; cls < self->df_nclasses; ++cls) {
+				byte_t other = reprv[cls];
+				if ((!utf8 || other < 0x80) && sighash[other] == sighash[ch] &&
+				    bcmp(sigv + other * sigsize, sigv + ch * sigsize, sigsize) == 0)
+					break;
+			}
+			if (cls < self->df_nclasses) {
+				self->df_classes[ch] = (byte_t)cls;
+				continue;
+			}
+		}
+		cls = self->df_nclasses++;
+		reprv[cls] = (byte_t)ch;
+		self->df_classes[ch] = (byte_t)cls;
+	}
+}
+
+/* Check that the DFA supports all opcodes that appear in `code', and
+ * gather what the DFA needs to know about them (added to `*p_sigbits',
+ * `*p_utf8' and `*p_ctxmask', which are left unchanged upon failure)
+ * NOTE: `RE_CODE_FLAG_POPPRUNES' isn't checked for (callers that want the DFA
+ *       to produce the same matches as the interpreter must do that themselves)
+ * @return: * : The size of `code->rc_code' (including the final `REOP_MATCHED')
+ * @return: 0 : The DFA can't be used for `code' */
+INTERN WUNUSED NONNULL((1, 2, 3, 4)) size_t
+NOTHROW_NCX(CC re_dfa_scancode)(struct re_code const *__restrict code,
+                                size_t *__restrict p_sigbits, bool *__restrict p_utf8,
+                                uint8_t *__restrict p_ctxmask) {
+	byte_t const *pc;
+	size_t sigbits  = *p_sigbits;
+	bool utf8       = *p_utf8;
+	uint8_t ctxmask = *p_ctxmask;
+	if (code->rc_flags & RE_CODE_FLAG_NEEDGROUPS)
+		return 0; /* Code uses back-references */
+	for (pc = code->rc_code;; pc = libre_opcode_next(pc)) {
+		switch (re_dfa_opkind(*pc)) {
+
+		case RE_DFA_OP_UNSUPPORTED:
+			return 0;
+
+		case RE_DFA_OP_EXACT:
+			sigbits += pc[1];
+			break;
+
+		case RE_DFA_OP_EXACT_UTF8:
+			sigbits += pc[1];
+			utf8 = true;
+			break;
+
+		case RE_DFA_OP_BYTE:
+			++sigbits;
+			break;
+
+		case RE_DFA_OP_UTF8:
+			++sigbits;
+			utf8 = true;
+			break;
+
+		case RE_DFA_OP_TRIE: {
+			byte_t bytes[32];
+			sigbits += re_dfa_triebytes(pc, bytes);
+		}	break;
+
+		case RE_DFA_OP_MATCHED:
+			*p_sigbits = sigbits;
+			*p_utf8    = utf8;
+			*p_ctxmask = ctxmask;
+			return (size_t)(pc - code->rc_code) + 1;
+
+		default:
+			switch (*pc) {
+			case REOP_AT_SOI:
+				ctxmask |= RE_DFA_CTX_SOI;
+				break;
+			case REOP_AT_SOL:
+			case REOP_AT_SOXL:
+				ctxmask |= RE_DFA_CTX_SOI | RE_DFA_CTX_LF;
+				break;
+			case REOP_AT_EOL:
+			case REOP_AT_EOXL:
+				/* Next byte must be  classified as line-feed (only
+				 * needed for signatures, but doesn't hurt either) */
+				ctxmask |= RE_DFA_CTX_LF;
+				break;
+			case REOP_AT_WOB:
+			case REOP_AT_WOB_NOT:
+			case REOP_AT_SOW:
+			case REOP_AT_EOW:
+				ctxmask |= RE_DFA_CTX_SYM;
+				break;
+			default:
+				break;
+			}
+			break;
+		}
+	}
+}
+
+/* Allocate a DFA for `codesize' bytes of code, with `extra' additional bytes
+ * for the caller (at `result->df_cacheend') and a state cache of `cachesize'
+ * bytes. The caller must fill in `df_exec', `df_code', the `df_set*' fields,
+ * and call `re_dfa_init_classes()'.
+ * @return: NULL: Out of memory */
+INTERN WUNUSED struct re_dfa *
+NOTHROW_NCX(CC re_dfa_alloc)(size_t codesize, uint8_t ctxmask,
+                             size_t cachesize, size_t extra) {
+	struct re_dfa *result;
+	size_t maxthreads;
+
+	/* Alive threads are (at most): 1 per opcode, 1 per byte of `REOP_EXACT*' operands,
+	 * and  for every utf-8 opcode, 1 per # of bytes read from an incomplete character. */
+	maxthreads = codesize * 5;
+	result = (struct re_dfa *)malloc(sizeof(struct re_dfa) +
+	                                 maxthreads * 2 * sizeof(re_dfa_thread_t) +
+	                                 codesize * 2 * sizeof(uint32_t) +
+	                                 cachesize + extra);
+	if unlikely(!result)
+		return NULL;
+	result->df_codesize   = codesize;
+	result->df_setc       = 0;
+	result->df_maxthreads = maxthreads;
+	result->df_kernel     = (re_dfa_thread_t *)(result + 1);
+	result->df_closure    = result->df_kernel + maxthreads;
+	result->df_stack      = (uint32_t *)(result->df_closure + maxthreads);
+	result->df_mark       = result->df_stack + codesize;
+	result->df_markgen    = 0;
+	result->df_ctxmask    = ctxmask;
+	result->df_cachebase  = (byte_t *)(result->df_mark + codesize);
+	result->df_cachebase  = (byte_t *)CEIL_ALIGN((uintptr_t)result->df_cachebase, sizeof(re_dfa_thread_t));
+	result->df_cacheend   = (byte_t *)(result->df_mark + codesize) + cachesize;
+	result->df_cachepos   = result->df_cachebase;
+	result->df_nstates    = 0;
+	result->df_scanned    = 0;
+	bzero(result->df_mark, codesize * sizeof(uint32_t));
+	bzero(result->df_buckets, sizeof(result->df_buckets));
+	return result;
+}
+
+/* Create a new DFA for `exec'
+ * @return: NULL: The DFA can't be used for `exec' (or out of memory) */
+INTERN WUNUSED NONNULL((1)) struct re_dfa *
+NOTHROW_NCX(CC re_dfa_new)(struct re_exec const *__restrict exec) {
+	struct re_code const *code = exec->rx_code;
+	struct re_dfa *result;
+	size_t insize, codesize, sigbits = 0;
+	uint8_t ctxmask = 0;
+	bool utf8 = false;
+	if (exec->rx_nmatch != 0)
+		return NULL; /* Caller wants group offsets */
+	if (OVERFLOW_USUB(exec->rx_endoff, exec->rx_startoff, &insize) || insize < RE_DFA_MININPUT)
+		return NULL; /* Not worth it */
+	if (code->rc_flags & RE_CODE_FLAG_POPPRUNES)
+		return NULL; /* Interpreter semantics differ from a plain NFA */
+	codesize = re_dfa_scancode(code, &sigbits, &utf8, &ctxmask);
+	if (codesize == 0)
+		return NULL;
+	if unlikely(codesize > RE_DFA_PCOFF_MAX)
+		return NULL;
+	result = re_dfa_alloc(codesize, ctxmask, RE_DFA_CACHESIZE, 0);
+	if unlikely(!result)
+		return NULL;
+	result->df_exec = exec;
+	result->df_code = code->rc_code;
+	re_dfa_init_classes(result, code->rc_fmap, sigbits, utf8);
+	return result;
+}
+
+/* Follow all epsilon-transitions from threads in `kernel' (and from a new thread
+ * at `inject', unless that is `(size_t)-1'), and store the resulting threads that
+ * are about to consume input in `self->df_closure'. For set DFAs, `inject' may be
+ * `RE_DFA_INJECT_SET' (start a new thread for every pattern), and the patterns
+ * whose `REOP_MATCHED' is reached are written to `self->df_setmatch'.
+ * @param: where_ctx:  Context flags for the current position
+ * @param: where_eoi:  True if at the end of input (`re_interpreter_is_eoi()')
+ * @param: where_eoiX: True if at the end of input (`re_interpreter_is_eoiX()')
+ * @param: where_next: [valid_if(!where_eoiX)] The next byte of input
+ * @param: p_matched:  Set to true if `REOP_MATCHED' is reached
+ * @return: * : The # of threads written to `self->df_closure' */
+PRIVATE NONNULL((1, 9)) size_t
+NOTHROW_NCX(CC re_dfa_closure)(struct re_dfa *__restrict self,
+                               re_dfa_thread_t const *kernel, size_t count,
+                               size_t inject, uint8_t where_ctx,
+                               bool where_eoi, bool where_eoiX, byte_t where_next,
+                               bool *__restrict p_matched) {
+	byte_t const *code = self->df_code;
+	uint32_t *stack = self->df_stack;
+	size_t i, sp = 0, result = 0;
+	uint32_t gen = ++self->df_markgen;
+	if unlikely(gen == 0) {
+		bzero(self->df_mark, self->df_codesize * sizeof(uint32_t));
+		gen = self->df_markgen = 1;
+	}
+#define PUSH(pcoff)                                 \
+	(self->df_mark[pcoff] != gen                    \
+	 ? (void)(self->df_mark[pcoff] = gen,           \
+	          stack[sp++] = (uint32_t)(pcoff))      \
+	 : (void)0)
+	for (i = 0; i < count; ++i) {
+		re_dfa_thread_t thread = kernel[i];
+		if (RE_DFA_THREAD_AUX(thread) != 0) {
+			/* Thread is in the middle of an opcode */
+			size_t next = re_dfa_trieaccept(code, thread);
+			self->df_closure[result++] = thread;
+			if (next != (size_t)-1)
+				PUSH(next);
+		} else {
+			PUSH(RE_DFA_THREAD_PCOFF(thread));
+		}
+	}
+	if (inject == RE_DFA_INJECT_SET) {
+		for (i = 0; i < self->df_setc; ++i)
+			PUSH(self->df_setstart[i]);
+	} else if (inject != (size_t)-1) {
+		PUSH(inject);
+	}
+	if (self->df_setc != 0)
+		self->df_setmatch[0] = 0;
+	while (sp) {
+		size_t pcoff = stack[--sp];
+		byte_t const *pc = code + pcoff;
+		bool previs, nextis;
+		switch (*pc) {
+
+		case REOP_AT_SOI:
+			if (!(where_ctx & RE_DFA_CTX_SOI))
+				continue;
+			break;
+
+		case REOP_AT_EOI:
+			if (!where_eoi)
+				continue;
+			break;
+
+		case REOP_AT_SOL:
+			if (!(where_ctx & (RE_DFA_CTX_SOI | RE_DFA_CTX_LF)))
+				continue;
+			break;
+
+		case REOP_AT_SOXL:
+			if ((where_ctx & RE_DFA_CTX_SOI)
+			    ? (self->df_exec->rx_eflags & RE_EXEC_NOTBOL) != 0
+			    : !(where_ctx & RE_DFA_CTX_LF))
+				continue;
+			break;
+
+		case REOP_AT_EOL:
+			if (!where_eoiX && !ascii_islf(where_next))
+				continue;
+			break;
+
+		case REOP_AT_EOXL:
+			if (where_eoiX ? (self->df_exec->rx_eflags & RE_EXEC_NOTEOL) != 0
+			               : !ascii_islf(where_next))
+				continue;
+			break;
+
+		case REOP_AT_WOB:
+		case REOP_AT_WOB_NOT:
+		case REOP_AT_SOW:
+		case REOP_AT_EOW:
+			previs = (where_ctx & RE_DFA_CTX_SYM) != 0;
+			nextis = where_eoiX ? false : !!issymcont(where_next);
+			if (*pc == REOP_AT_WOB ? previs == nextis
+			    : *pc == REOP_AT_WOB_NOT ? previs != nextis
+			    : *pc == REOP_AT_SOW ? (previs || !nextis)
+			    : (!previs || nextis))
+				continue;
+			break;
+
+		case REOP_JMP:
+			PUSH((size_t)((pc + 3 + delta16_get(pc + 1)) - code));
+			continue;
+
+		case REOP_JMP_ONFAIL:
+		case REOP_JMP_AND_RETURN_ONFAIL:
+		case REOP_SPAN:
+		case REOP_SPAN_AND_RETURN_ONFAIL:
+		case REOP_SPAN_LIT:
+		case REOP_SPAN_LIT_AND_RETURN_ONFAIL:
+			PUSH(pcoff + 3);
+			PUSH((size_t)((pc + 3 + delta16_get(pc + 1)) - code));
+			continue;
+
+		case REOP_MATCHED:
+			*p_matched = true;
+			if (self->df_setc != 0) {
+				/* Every pattern ends with (exactly) one `REOP_MATCHED' */
+				size_t lo = 0, hi = self->df_setc;
+				while (hi - lo > 1) {
+					size_t mid = (lo + hi) / 2;
+					if (self->df_setstart[mid] <= pcoff) {
+						lo = mid;
+					} else {
+						hi = mid;
+					}
+				}
+				self->df_setmatch[1 + self->df_setmatch[0]++] = self->df_setindex[lo];
+			}
+			continue;
+
+		default:
+			if (re_dfa_opkind(*pc) != RE_DFA_OP_EPSILON) {
+				/* Opcode consumes input */
+				self->df_closure[result++] = RE_DFA_THREAD(pcoff, 0);
+				continue;
+			}
+			break;
+		}
+		PUSH((size_t)(libre_opcode_next(pc) - code));
+	}
+#undef PUSH
+	assert(result <= self->df_maxthreads);
+	return result;
+}
+
+/* Return the thread resulting from the `RE_DFA_OP_UTF8' or `RE_DFA_OP_EXACT_UTF8'
+ * thread at `pc' (with `aux') having read `ch' (or `RE_DFA_THREAD_DEAD') */
+PRIVATE WUNUSED NONNULL((1, 2)) re_dfa_thread_t
+NOTHROW_NCX(CC re_dfa_stepchar)(byte_t const *__restrict code,
+                                byte_t const *__restrict pc,
+                                uint64_t aux, char32_t ch) {
+	if (*pc == REOP_EXACT_UTF8_ICASE) {
+		byte_t const *reader = pc + 2 + RE_DFA_AUX_PROGRESS(aux);
+		byte_t const *end;
+		char32_t expected = unicode_readutf8((char const **)&reader);
+		if (ch != expected && unicode_tolower(ch) != unicode_tolower(expected))
+			return RE_DFA_THREAD_DEAD;
+		end = libre_opcode_next(pc);
+		if (reader < end)
+			return RE_DFA_THREAD(pc - code, RE_DFA_AUX(reader - (pc + 2), 0, 0));
+		return RE_DFA_THREAD(end - code, 0);
+	}
+	if (re_dfa_matchchar(pc, ch))
+		return RE_DFA_THREAD(libre_opcode_next(pc) - code, 0);
+	return RE_DFA_THREAD_DEAD;
+}
+
+/* Decode the first `len' bytes of a utf-8 character stored in `utf8' (as per `RE_DFA_AUX_UTF8()') */
+PRIVATE ATTR_CONST WUNUSED char32_t
+NOTHROW_NCX(CC re_dfa_decode)(uint32_t utf8, unsigned int len) {
+	char buf[4], *reader = buf;
+	unsigned int i;
+	for (i = 0; i < len; ++i)
+		buf[i] = (char)(byte_t)(utf8 >> (i * 8));
+	return unicode_readutf8_n((char const **)&reader, buf + len);
+}
+
+PRIVATE WUNUSED NONNULL((1, 2)) int
+NOTHROW_NCX(__LIBCCALL compare_re_dfa_thread_t)(void const *a, void const *b) {
+	re_dfa_thread_t lhs = *(re_dfa_thread_t const *)a;
+	re_dfa_thread_t rhs = *(re_dfa_thread_t const *)b;
+	if (lhs < rhs)
+		return -1;
+	if (lhs > rhs)
+		return 1;
+	return 0;
+}
+
+/* Have `thread' (which must be about to consume input) consume `ch'
+ * @return: * :                    The resulting thread
+ * @return: RE_DFA_THREAD_DEAD:   `thread' doesn't accept `ch'
+ * @return: RE_DFA_THREAD_ILLSEQ: Malformed utf-8 (the caller has to give up) */
+INTERN WUNUSED NONNULL((1)) re_dfa_thread_t
+NOTHROW_NCX(CC re_dfa_stepthread)(byte_t const *__restrict code,
+                                  re_dfa_thread_t thread, byte_t ch) {
+	size_t pcoff = RE_DFA_THREAD_PCOFF(thread);
+	uint64_t aux = RE_DFA_THREAD_AUX(thread);
+	byte_t const *pc = code + pcoff;
+	switch (re_dfa_opkind(*pc)) {
+
+	case RE_DFA_OP_EXACT: {
+		uint32_t progress = RE_DFA_AUX_PROGRESS(aux);
+		byte_t expected = pc[2 + progress];
+		if (*pc == REOP_EXACT ? ch != expected
+		                      : tolower(ch) != tolower(expected))
+			break;
+		++progress;
+		if (progress < pc[1])
+			return RE_DFA_THREAD(pcoff, RE_DFA_AUX(progress, 0, 0));
+		return RE_DFA_THREAD(pcoff + 2 + pc[1], 0);
+	}	break;
+
+	case RE_DFA_OP_BYTE:
+		if (re_dfa_matchbyte(pc, ch))
+			return RE_DFA_THREAD(libre_opcode_next(pc) - code, 0);
+		break;
+
+	case RE_DFA_OP_TRIE: {
+		size_t nodeoff = aux ? RE_DFA_AUX_UTF8(aux) : RETRIE_ROOT;
+		byte_t const *node = pc + nodeoff;
+		if (*node & RETRIE_RUN) {
+			uint32_t progress = RE_DFA_AUX_PROGRESS(aux);
+			byte_t len = *node & RETRIE_RUNMASK;
+			if (ch != node[1 + progress])
+				break;
+			++progress;
+			if (progress < len)
+				return RE_DFA_THREAD(pcoff, RE_DFA_AUX(progress, 0, nodeoff));
+			nodeoff += 1 + len;
+		} else {
+			assert(*node & RETRIE_BRANCH);
+			nodeoff = re_trie_branch(node, ch);
+			if (!nodeoff)
+				break;
+		}
+		return re_dfa_triethread(code, pc, nodeoff);
+	}	break;
+
+	default: {
+		/* utf-8 opcode */
+		uint32_t utf8 = RE_DFA_AUX_UTF8(aux);
+		unsigned int len = RE_DFA_AUX_UTF8LEN(aux);
+		uint8_t seqlen;
+		if (len == 0) {
+			seqlen = unicode_utf8seqlen[ch];
+			if (seqlen <= 1) /* Single-byte character (or dangling follow-up byte) */
+				return re_dfa_stepchar(code, pc, aux, ch);
+			if unlikely(seqlen > 4)
+				return RE_DFA_THREAD_ILLSEQ;
+		} else {
+			if unlikely((ch & 0xc0) != 0x80)
+				return RE_DFA_THREAD_ILLSEQ; /* Not a follow-up byte */
+			seqlen = unicode_utf8seqlen[utf8 & 0xff];
+		}
+		utf8 |= (uint32_t)ch << (len * 8);
+		++len;
+		if (len < seqlen)
+			return RE_DFA_THREAD(pcoff, RE_DFA_AUX(RE_DFA_AUX_PROGRESS(aux), len, utf8));
+		return re_dfa_stepchar(code, pc, aux, re_dfa_decode(utf8, len));
+	}	break;
+	}
+	return RE_DFA_THREAD_DEAD;
+}
+
+/* Return `thread' as it is at the end of input (or `RE_DFA_THREAD_DEAD').
+ * An incomplete utf-8 character at the end of input is still read (as far
+ * as it goes), but threads in the middle of other multi-byte opcodes would
+ * need more input. */
+INTERN WUNUSED NONNULL((1)) re_dfa_thread_t
+NOTHROW_NCX(CC re_dfa_stepeoi)(byte_t const *__restrict code,
+                               re_dfa_thread_t thread) {
+	uint64_t aux = RE_DFA_THREAD_AUX(thread);
+	unsigned int len;
+	if (aux == 0)
+		return thread;
+	if (code[RE_DFA_THREAD_PCOFF(thread)] == REOP_TRIE) {
+		size_t next = re_dfa_trieaccept(code, thread);
+		if (next == (size_t)-1)
+			return RE_DFA_THREAD_DEAD;
+		return RE_DFA_THREAD(next, 0);
+	}
+	len = RE_DFA_AUX_UTF8LEN(aux);
+	if (len == 0)
+		return RE_DFA_THREAD_DEAD;
+	return re_dfa_stepchar(code, code + RE_DFA_THREAD_PCOFF(thread), aux,
+	                       re_dfa_decode(RE_DFA_AUX_UTF8(aux), len));
+}
+
+/* Have all threads from `self->df_closure[0..count-1]' consume `ch', and store
+ * the (sorted and de-duplicated) threads that survive in `self->df_kernel'.
+ * @return: * :         The # of threads written to `self->df_kernel'
+ * @return: (size_t)-1: Malformed utf-8 (the DFA has to give up) */
+PRIVATE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_dfa_step)(struct re_dfa *__restrict self,
+                            size_t count, byte_t ch) {
+	re_dfa_thread_t *out = self->df_kernel;
+	size_t i, j, result = 0;
+	for (i = 0; i < count; ++i) {
+		re_dfa_thread_t thread;
+		thread = re_dfa_stepthread(self->df_code, self->df_closure[i], ch);
+		if (thread == RE_DFA_THREAD_DEAD)
+			continue;
+		if unlikely(thread == RE_DFA_THREAD_ILLSEQ)
+			return (size_t)-1;
+		out[result++] = thread;
+	}
+	assert(result <= self->df_maxthreads);
+
+	/* Sort + remove duplicates */
+	if (result <= 16) {
+		for (i = 1; i < result; ++i) {
+			re_dfa_thread_t thread = out[i];
+			for (j = i; j > 0 && out[j - 1] > thread; --j)
+				out[j] = out[j - 1];
+			out[j] = thread;
+		}
+	} else {
+		qsort(out, result, sizeof(re_dfa_thread_t), &compare_re_dfa_thread_t);
+	}
+	for (i = j = 0; i < result; ++i) {
+		if (j == 0 || out[j - 1] != out[i])
+			out[j++] = out[i];
+	}
+	return j;
+}
+
+/* Flush the state cache of `self' */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC re_dfa_flush)(struct re_dfa *__restrict self) {
+	TRACE("re_dfa_flush: %" PRIuSIZ " states, %" PRIuSIZ " bytes\n",
+	      self->df_nstates, self->df_scanned);
+	bzero(self->df_buckets, sizeof(self->df_buckets));
+	self->df_cachepos = self->df_cachebase;
+	self->df_nstates  = 0;
+	self->df_scanned  = 0;
+}
+
+/* Return the (possibly new) cached state with threads `self->df_kernel[0..count-1]'
+ * and context flags `ctx'. If the state cache has to be flushed for this, set
+ * `*p_flushed' to true (all states previously returned then become invalid)
+ * @return: NULL: The DFA has to give up */
+INTERN WUNUSED NONNULL((1, 4)) struct re_dfa_state *
+NOTHROW_NCX(CC re_dfa_getstate)(struct re_dfa *__restrict self, size_t count,
+                                uint8_t ctx, bool *__restrict p_flushed) {
+	struct re_dfa_state *result, **p_bucket;
+	size_t i, threads_offset, size;
+	uint32_t hash = 2166136261u ^ ctx;
+	for (i = 0; i < count; ++i) {
+		re_dfa_thread_t thread = self->df_kernel[i];
+		hash = (hash ^ (uint32_t)thread) * 16777619u;
+		hash = (hash ^ (uint32_t)(thread >> 32)) * 16777619u;
+	}
+	p_bucket = &self->df_buckets[hash & (RE_DFA_BUCKETS - 1)];
+	for (result = *p_bucket; result; result = result->ds_hnext) {
+		if (result->ds_hash == hash && result->ds_ctx == ctx &&
+		    result->ds_count == count &&
+		    bcmp(result->ds_threads, self->df_kernel, count * sizeof(re_dfa_thread_t)) == 0)
+			return result;
+	}
+
+	/* Allocate a new state */
+	threads_offset = offsetof(struct re_dfa_state, ds_next) +
+	                 self->df_nclasses * sizeof(struct re_dfa_state *);
+	if (self->df_setc != 0)
+		threads_offset += self->df_nclasses * sizeof(uint32_t *); /* ds_matches */
+	threads_offset = CEIL_ALIGN(threads_offset, sizeof(re_dfa_thread_t));
+	size = threads_offset + count * sizeof(re_dfa_thread_t);
+	if ((size_t)(self->df_cacheend - self->df_cachepos) < size) {
+		if unlikely((size_t)(self->df_cacheend - self->df_cachebase) < size)
+			return NULL; /* State is too large for the cache */
+		if (self->df_scanned < self->df_nstates * RE_DFA_MINSCAN_PER_STATE)
+			return NULL; /* Cache is thrashing */
+		re_dfa_flush(self);
+		*p_flushed = true;
+		p_bucket   = &self->df_buckets[hash & (RE_DFA_BUCKETS - 1)];
+	}
+	result = (struct re_dfa_state *)self->df_cachepos;
+	self->df_cachepos += size;
+	result->ds_threads = (re_dfa_thread_t *)((byte_t *)result + threads_offset);
+	result->ds_count   = count;
+	result->ds_hash    = hash;
+	result->ds_ctx     = ctx;
+	memcpy(result->ds_threads, self->df_kernel, count * sizeof(re_dfa_thread_t));
+	bzero(result->ds_accept, sizeof(result->ds_accept));
+	bzero(result->ds_next, self->df_nclasses * sizeof(struct re_dfa_state *));
+	result->ds_matches = NULL;
+	if (self->df_setc != 0) {
+		result->ds_matches = (uint32_t **)(result->ds_next + self->df_nclasses);
+		bzero(result->ds_matches, self->df_nclasses * sizeof(uint32_t *));
+	}
+	result->ds_hnext = *p_bucket;
+	*p_bucket = result;
+	++self->df_nstates;
+	return result;
+}
+
+/* Compute (and cache) the transition of `state' when followed by `ch'
+ * For set DFAs, the patterns whose matches end before `ch' are left in
+ * `self->df_setmatch'.
+ * @param: p_accept: Set to true if a match ends before `ch'
+ * @return: NULL:    The DFA has to give up */
+INTERN WUNUSED NONNULL((1, 2, 4)) struct re_dfa_state *
+NOTHROW_NCX(CC re_dfa_transition)(struct re_dfa *__restrict self,
+                                  struct re_dfa_state *__restrict state,
+                                  byte_t ch, bool *__restrict p_accept) {
+	struct re_dfa_state *result;
+	size_t count, inject = (size_t)-1;
+	bool matched = false, flushed = false;
+	uint8_t ctx = state->ds_ctx;
+	if (ctx & RE_DFA_CTX_SEARCH) {
+		/* A new match may start here. */
+		if (self->df_setc != 0) {
+			inject = RE_DFA_INJECT_SET;
+		} else {
+			byte_t fmap = self->df_exec->rx_code->rc_fmap[ch];
+			if (fmap != 0xff)
+				inject = fmap;
+		}
+	}
+	count = re_dfa_closure(self, state->ds_threads, state->ds_count, inject,
+	                       ctx, false, false, ch, &matched);
+	count = re_dfa_step(self, count, ch);
+	if unlikely(count == (size_t)-1)
+		return NULL;
+	result = re_dfa_getstate(self, count, (ctx & RE_DFA_CTX_SEARCH) | re_dfa_ctxof(self, ch), &flushed);
+	if likely(result && !flushed) {
+		byte_t cls = self->df_classes[ch];
+		if (matched && self->df_setc != 0) {
+			/* Also remember which patterns matched (if there is enough space left) */
+			size_t size = (1 + self->df_setmatch[0]) * sizeof(uint32_t);
+			if ((size_t)(self->df_cacheend - self->df_cachepos) < CEIL_ALIGN(size, sizeof(re_dfa_thread_t)))
+				goto done;
+			state->ds_matches[cls] = (uint32_t *)memcpy(self->df_cachepos, self->df_setmatch, size);
+			self->df_cachepos += CEIL_ALIGN(size, sizeof(re_dfa_thread_t));
+		}
+		state->ds_next[cls] = result;
+		if (matched)
+			state->ds_accept[cls / 8] |= 1 << (cls % 8);
+	}
+done:
+	*p_accept = matched;
+	return result;
+}
+
+/* Check if `state' accepts at the end of input (which `interp' must be at) */
+INTERN WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_dfa_accepts_eoi)(struct re_dfa *__restrict self,
+                                   struct re_dfa_state const *__restrict state,
+                                   struct re_interpreter *__restrict interp) {
+	size_t i, count = 0;
+	bool eoiX, matched = false;
+	for (i = 0; i < state->ds_count; ++i) {
+		re_dfa_thread_t thread = re_dfa_stepeoi(self->df_code, state->ds_threads[i]);
+		if (thread != RE_DFA_THREAD_DEAD)
+			self->df_kernel[count++] = thread;
+	}
+	eoiX = re_interpreter_is_eoiX(interp);
+	(void)re_dfa_closure(self, self->df_kernel, count, (size_t)-1, state->ds_ctx,
+	                     true, eoiX, eoiX ? 0 : re_interpreter_nextbyte(interp),
+	                     &matched);
+	return matched;
+}
+
+/* Use the DFA to find the longest match at the current position of `interp'.
+ * Same as `libre_interp_exec()', except that no group offsets are produced.
+ * @return: -RE_NOERROR:     Input was matched (`interp' points at the end of the match)
+ * @return: -RE_NOMATCH:     Nothing was matched
+ * @return: RE_DFA_FALLBACK: The DFA gave up (the position of `interp' is undefined) */
+INTERN WUNUSED NONNULL((1, 2)) re_errno_t
+NOTHROW_NCX(CC re_dfa_exec)(struct re_dfa *__restrict self,
+                            struct re_interpreter *__restrict interp) {
+	struct re_code const *code = self->df_exec->rx_code;
+	struct re_interpreter_inptr best;
+	struct re_dfa_state *state;
+	bool matched = false, flushed = false;
+	byte_t fmap;
+
+	/* Same as `libre_interp_exec()': the fast-map decides where execution starts */
+	if (!re_interpreter_in_chunk_cangetc(interp))
+		return code->rc_minmatch > 0 ? -RE_NOMATCH : -RE_NOERROR;
+	fmap = code->rc_fmap[*interp->ri_in_ptr];
+	if (fmap == 0xff)
+		return code->rc_minmatch > 0 ? -RE_NOMATCH : -RE_NOERROR;
+	self->df_kernel[0] = RE_DFA_THREAD(fmap, 0);
+	state = re_dfa_getstate(self, 1, re_dfa_getctx(self, interp), &flushed);
+	if unlikely(!state)
+		return RE_DFA_FALLBACK;
+	for (;;) {
+		struct re_dfa_state *next;
+		byte_t ch, cls;
+		bool accept;
+		if (re_interpreter_is_eoi(interp)) {
+			if (re_dfa_accepts_eoi(self, state, interp))
+				return -RE_NOERROR;
+			break;
+		}
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		if (!re_interpreter_in_chunk_cangetc(interp))
+			re_interpreter_nextchunk(interp);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		ch   = *interp->ri_in_ptr;
+		cls  = self->df_classes[ch];
+		next = state->ds_next[cls];
+		if likely(next) {
+			accept = (state->ds_accept[cls / 8] & (1 << (cls % 8))) != 0;
+		} else {
+			next = re_dfa_transition(self, state, ch, &accept);
+			if unlikely(!next)
+				return RE_DFA_FALLBACK;
+		}
+		if (accept) {
+			best    = interp->ri_in;
+			matched = true;
+		}
+		++interp->ri_in_ptr;
+		++self->df_scanned;
+		state = next;
+		if (state->ds_count == 0)
+			break; /* Dead state */
+	}
+	if (!matched)
+		return -RE_NOMATCH;
+	interp->ri_in = best;
+	return -RE_NOERROR;
+}
+
+/* Use the DFA to scan input from the current position of `interp' for the end
+ * of the first match that starts within the next `search_range' bytes.  Code
+ * must not be able to match epsilon. Moves the input pointer of `interp'.
+ * @return: * :         Absolute offset where the first such match ends
+ * @return: (size_t)-1: No match starts within the next `search_range' bytes
+ * @return: (size_t)-2: The DFA gave up */
+INTERN WUNUSED NONNULL((1, 2)) size_t
+NOTHROW_NCX(CC re_dfa_search)(struct re_dfa *__restrict self,
+                              struct re_interpreter *__restrict interp,
+                              size_t search_range) {
+	struct re_dfa_state *state;
+	size_t offset, inject_end;
+	bool flushed = false;
+	assert(self->df_exec->rx_code->rc_minmatch != 0);
+	offset     = re_interpreter_in_curoffset(interp);
+	inject_end = offset + search_range;
+	state = re_dfa_getstate(self, 0, RE_DFA_CTX_SEARCH | re_dfa_getctx(self, interp), &flushed);
+	if unlikely(!state)
+		return (size_t)-2;
+	for (;;) {
+		struct re_dfa_state *next;
+		byte_t ch, cls;
+		bool accept;
+		if (state->ds_ctx & RE_DFA_CTX_SEARCH) {
+			if unlikely(offset >= inject_end) {
+				/* No more matches can start from here on. */
+				memcpy(self->df_kernel, state->ds_threads,
+				       state->ds_count * sizeof(re_dfa_thread_t));
+				state = re_dfa_getstate(self, state->ds_count,
+				                        state->ds_ctx & ~RE_DFA_CTX_SEARCH,
+				                        &flushed);
+				if unlikely(!state)
+					return (size_t)-2;
+				if (state->ds_count == 0)
+					return (size_t)-1;
+			}
+		}
+		if (re_interpreter_is_eoi(interp))
+			return re_dfa_accepts_eoi(self, state, interp) ? offset : (size_t)-1;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		if (!re_interpreter_in_chunk_cangetc(interp))
+			re_interpreter_nextchunk(interp);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		ch   = *interp->ri_in_ptr;
+		cls  = self->df_classes[ch];
+		next = state->ds_next[cls];
+		if likely(next) {
+			accept = (state->ds_accept[cls / 8] & (1 << (cls % 8))) != 0;
+		} else {
+			next = re_dfa_transition(self, state, ch, &accept);
+			if unlikely(!next)
+				return (size_t)-2;
+		}
+		if (accept)
+			return offset;
+		++interp->ri_in_ptr;
+		++self->df_scanned;
+		++offset;
+		state = next;
+		if (state->ds_count == 0 && !(state->ds_ctx & RE_DFA_CTX_SEARCH))
+			return (size_t)-1; /* Dead state */
+	}
+}
+
+#undef HAVE_TRACE
+#undef TRACE
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGDFA_C */
@@ -0,0 +1,441 @@
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGDFA_H
+#define GUARD_LIBREGEX_REGDFA_H 1
+
+#include "api.h"
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unicode.h>
+
+#include <libregex/regcomp.h>
+#include <libregex/regexec.h>
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "reginterp.h"
+
+DECL_BEGIN
+
+/* Min # of input bytes before a DFA is used (for less than this, the cost of
+ * setting it up isn't made up for) */
+#ifndef RE_DFA_MININPUT
+#define RE_DFA_MININPUT 128
+#endif /* !RE_DFA_MININPUT */
+
+/* # of match attempts after which searches switch to a DFA (until then, the
+ * search is cheap enough that setting up a DFA wouldn't be made up for) */
+#ifndef RE_DFA_MINATTEMPTS
+#define RE_DFA_MINATTEMPTS 32
+#endif /* !RE_DFA_MINATTEMPTS */
+
+/* Size of the state cache of a DFA (in bytes) */
+#ifndef RE_DFA_CACHESIZE
+#define RE_DFA_CACHESIZE 0x10000
+#endif /* !RE_DFA_CACHESIZE */
+
+/* # of hash-buckets for cached DFA states (must be a power of 2) */
+#define RE_DFA_BUCKETS 256
+
+/* Special return value of `re_dfa_exec()': the DFA gave up */
+#define RE_DFA_FALLBACK 1
+
+/* Context flags of DFA states */
+#define RE_DFA_CTX_SOI    0x01 /* At start of input (`re_interpreter_is_soi()') */
+#define RE_DFA_CTX_LF     0x02 /* Preceding byte is `ascii_islf()' */
+#define RE_DFA_CTX_SYM    0x04 /* Preceding byte is `issymcont()' */
+#define RE_DFA_CTX_SEARCH 0x08 /* A new thread is started before every byte (s.a. `re_dfa_search()') */
+
+/* DFA thread: `(PC_OFFSET << 40) | AUX', where `AUX' is:
+ *  - bits  0-23: already read bytes of an incomplete utf-8 character
+ *                (or for `REOP_TRIE': the offset of the current node)
+ *  - bits 24-26: # of already read bytes of an incomplete utf-8 character
+ *  - bits 27-39: progress into the operand of `REOP_EXACT*' (in bytes)
+ *                (or for `REOP_TRIE': progress into the `RETRIE_RUN' of the current node)
+ * Threads at the root node of `REOP_TRIE' have `AUX == 0'.
+ * Thread lists of states are sorted, so states can be compared with `bcmp()' */
+typedef uint64_t re_dfa_thread_t;
+#define RE_DFA_THREAD(pcoff, aux)     (((re_dfa_thread_t)(pcoff) << 40) | (aux))
+#define RE_DFA_THREAD_PCOFF(self)     ((size_t)((self) >> 40))
+#define RE_DFA_THREAD_AUX(self)       ((self) & UINT64_C(0xffffffffff))
+#define RE_DFA_AUX(progress, n, utf8) (((uint64_t)(progress) << 27) | ((uint64_t)(n) << 24) | (uint64_t)(utf8))
+#define RE_DFA_AUX_UTF8(self)         ((uint32_t)(self) & UINT32_C(0xffffff))
+#define RE_DFA_AUX_UTF8LEN(self)      (((uint32_t)(self) >> 24) & 7)
+#define RE_DFA_AUX_PROGRESS(self)     ((uint32_t)((self) >> 27))
+#define RE_DFA_PCOFF_MAX              UINT32_C(0xffffff)
+
+/* Special results of `re_dfa_stepthread()' (never valid threads, since
+ * `RE_DFA_PCOFF_MAX' is never a valid program counter offset) */
+#define RE_DFA_THREAD_DEAD   ((re_dfa_thread_t)-1) /* Thread doesn't survive */
+#define RE_DFA_THREAD_ILLSEQ ((re_dfa_thread_t)-2) /* Malformed utf-8 */
+
+struct re_dfa_state {
+	struct re_dfa_state  *ds_hnext;      /* [0..1] Next state with the same hash */
+	re_dfa_thread_t      *ds_threads;    /* [ds_count][const] Sorted threads of this state */
+	size_t                ds_count;      /* [const] # of threads (0 in dead states) */
+	uint32_t              ds_hash;       /* [const] Hash of `ds_threads' and `ds_ctx' */
+	uint8_t               ds_ctx;        /* [const] Context flags (set of `RE_DFA_CTX_*') */
+	byte_t                ds_accept[32]; /* Bitset of byte classes for which `ds_next' is an accepting transition
+	                                      * (meaning that a match ends before a byte of that class) */
+	uint32_t            **ds_matches;    /* [0..1][struct re_dfa::df_nclasses][valid_if(struct re_dfa::df_setc != 0)]
+	                                      * `[count, pattern indices...]' of patterns whose matches end at accepting transitions */
+	COMPILER_FLEXIBLE_ARRAY(struct re_dfa_state *, ds_next); /* [0..1][struct re_dfa::df_nclasses] Transitions (NULL if not yet known) */
+};
+
+struct re_dfa {
+	struct re_exec const *df_exec;       /* [1..1][const] Exec command block (for set DFAs: that of the current call) */
+	byte_t const         *df_code;       /* [1..1][const][== df_exec->rx_code->rc_code] (for set DFAs: the code of all patterns) */
+	size_t                df_codesize;   /* [const] Size of `df_code' (including the final `REOP_MATCHED') */
+	size_t                df_setc;       /* [const] # of patterns of a set DFA (s.a. `re_set_dfa_new()'), or `0' */
+	uint32_t             *df_setstart;   /* [df_setc][const] Ascending offsets of the code of every pattern in `df_code' */
+	uint32_t             *df_setindex;   /* [df_setc][const] Index of every pattern in `struct re_set::rs_codev' */
+	uint32_t             *df_setmatch;   /* [1 + df_setc] Scratch buffer: `[count, pattern indices...]' of
+	                                      * patterns whose `REOP_MATCHED' was reached by the last closure */
+	size_t                df_maxthreads; /* [const] Max # of threads that can be alive at once */
+	re_dfa_thread_t      *df_kernel;     /* [0..df_maxthreads] Scratch buffer: threads of new states */
+	re_dfa_thread_t      *df_closure;    /* [0..df_maxthreads] Scratch buffer: threads that are about to consume input */
+	uint32_t             *df_stack;      /* [0..df_codesize] Scratch buffer: program counters yet to be visited */
+	uint32_t             *df_mark;       /* [df_codesize] Program counters visited by the current closure (`== df_markgen') */
+	uint32_t              df_markgen;    /* Marker of the current closure */
+	uint16_t              df_nclasses;   /* [const][<= 256] # of byte classes */
+	uint8_t               df_ctxmask;    /* [const] Mask of `RE_DFA_CTX_*' flags that are relevant to the code */
+	byte_t                df_classes[256]; /* [const] Byte -> byte class */
+	byte_t               *df_cachebase;  /* [1..1][const] Base of the state cache */
+	byte_t               *df_cachepos;   /* [1..1] Next free byte in the state cache */
+	byte_t               *df_cacheend;   /* [1..1][const] End of the state cache */
+	size_t                df_nstates;    /* # of states in the state cache */
+	size_t                df_scanned;    /* # of input bytes scanned since the state cache was last flushed */
+	struct re_dfa_state  *df_buckets[RE_DFA_BUCKETS]; /* [0..1][*] Hash-buckets of cached states */
+};
+
+#define re_dfa_destroy(self) free(self)
+
+/* Opcode kinds (as seen by the DFA) */
+#define RE_DFA_OP_UNSUPPORTED 0 /* Opcode can't be handled by the DFA */
+#define RE_DFA_OP_EPSILON     1 /* Opcode doesn't consume input */
+#define RE_DFA_OP_BYTE        2 /* Opcode consumes 1 byte (s.a. `re_dfa_matchbyte()') */
+#define RE_DFA_OP_UTF8        3 /* Opcode consumes 1 utf-8 character (s.a. `re_dfa_matchchar()') */
+#define RE_DFA_OP_EXACT       4 /* `REOP_EXACT' or `REOP_EXACT_ASCII_ICASE' */
+#define RE_DFA_OP_EXACT_UTF8  5 /* `REOP_EXACT_UTF8_ICASE' */
+#define RE_DFA_OP_MATCHED     6 /* `REOP_MATCHED' */
+#define RE_DFA_OP_TRIE        7 /* `REOP_TRIE' */
+LOCAL ATTR_CONST WUNUSED uint8_t
+NOTHROW_NCX(CC re_dfa_opkind)(byte_t opcode) {
+	switch (opcode) {
+
+	case REOP_EXACT:
+	case REOP_EXACT_ASCII_ICASE:
+		return RE_DFA_OP_EXACT;
+
+	case REOP_EXACT_UTF8_ICASE:
+		return RE_DFA_OP_EXACT_UTF8;
+
+	case REOP_TRIE:
+		return RE_DFA_OP_TRIE;
+
+#ifdef REOP_ANY
+	case REOP_ANY:
+#endif /* REOP_ANY */
+#ifdef REOP_ANY_NOTLF
+	case REOP_ANY_NOTLF:
+#endif /* REOP_ANY_NOTLF */
+#ifdef REOP_ANY_NOTNUL
+	case REOP_ANY_NOTNUL:
+#endif /* REOP_ANY_NOTNUL */
+#ifdef REOP_ANY_NOTNUL_UTF8
+	case REOP_ANY_NOTNUL_UTF8: /* Consumes a byte (s.a. `libre_interp_exec()') */
+#endif /* REOP_ANY_NOTNUL_UTF8 */
+#ifdef REOP_ANY_NOTNUL_NOTLF
+	case REOP_ANY_NOTNUL_NOTLF:
+#endif /* REOP_ANY_NOTNUL_NOTLF */
+	case REOP_BYTE:
+	case REOP_NBYTE:
+	case REOP_BYTE2:
+	case REOP_NBYTE2:
+	case REOP_RANGE:
+	case REOP_NRANGE:
+	case REOP_BITSET:
+	case REOP_CS_BYTE:
+		return RE_DFA_OP_BYTE;
+
+#ifdef REOP_ANY_UTF8
+	case REOP_ANY_UTF8:
+#endif /* REOP_ANY_UTF8 */
+#ifdef REOP_ANY_NOTLF_UTF8
+	case REOP_ANY_NOTLF_UTF8:
+#endif /* REOP_ANY_NOTLF_UTF8 */
+#ifdef REOP_ANY_NOTNUL_NOTLF_UTF8
+	case REOP_ANY_NOTNUL_NOTLF_UTF8:
+#endif /* REOP_ANY_NOTNUL_NOTLF_UTF8 */
+	case REOP_CONTAINS_UTF8:
+	case REOP_NCONTAINS_UTF8:
+	case REOP_CS_UTF8:
+	case REOP_NCS_UTF8:
+	case REOP_SEQ_UTF8:
+	case REOP_NSEQ_UTF8:
+		return RE_DFA_OP_UTF8;
+
+	case REOP_AT_SOI:
+	case REOP_AT_EOI:
+	case REOP_AT_SOL:
+	case REOP_AT_EOL:
+	case REOP_AT_SOXL:
+	case REOP_AT_EOXL:
+	case REOP_AT_WOB:
+	case REOP_AT_WOB_NOT:
+	case REOP_AT_SOW:
+	case REOP_AT_EOW:
+	case REOP_GROUP_START:
+	case REOP_GROUP_END:
+	case_REOP_GROUP_END_JMIN_to_JMAX: /* The epsilon-skip only avoids re-entering a loop at the same offset */
+	case REOP_POP_ONFAIL:
+	case REOP_POP_ONFAIL_AT:
+	case REOP_JMP_ONFAIL:
+	case REOP_JMP_ONFAIL_DUMMY_AT:
+	case REOP_JMP_ONFAIL_DUMMY:
+	case REOP_JMP:
+	case REOP_JMP_AND_RETURN_ONFAIL:
+	case REOP_SPAN:
+	case REOP_SPAN_AND_RETURN_ONFAIL:
+	case REOP_SPAN_LIT:
+	case REOP_SPAN_LIT_AND_RETURN_ONFAIL:
+	case REOP_NOP:
+		return RE_DFA_OP_EPSILON;
+
+	case REOP_MATCHED:
+		return RE_DFA_OP_MATCHED;
+
+	default:
+		break;
+	}
+	return RE_DFA_OP_UNSUPPORTED;
+}
+
+/* Check if the `RE_DFA_OP_BYTE'-opcode at `pc' accepts `ch' */
+LOCAL ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_dfa_matchbyte)(byte_t const *__restrict pc, byte_t ch) {
+	switch (pc[0]) {
+#ifdef REOP_ANY
+	case REOP_ANY:
+		return true;
+#endif /* REOP_ANY */
+#ifdef REOP_ANY_NOTLF
+	case REOP_ANY_NOTLF:
+		return !ascii_islf(ch);
+#endif /* REOP_ANY_NOTLF */
+#if defined(REOP_ANY_NOTNUL) || defined(REOP_ANY_NOTNUL_UTF8)
+#ifdef REOP_ANY_NOTNUL
+	case REOP_ANY_NOTNUL:
+#endif /* REOP_ANY_NOTNUL */
+#ifdef REOP_ANY_NOTNUL_UTF8
+	case REOP_ANY_NOTNUL_UTF8:
+#endif /* REOP_ANY_NOTNUL_UTF8 */
+		return ch != '\0';
+#endif /* REOP_ANY_NOTNUL || REOP_ANY_NOTNUL_UTF8 */
+#ifdef REOP_ANY_NOTNUL_NOTLF
+	case REOP_ANY_NOTNUL_NOTLF:
+		return ch != '\0' && !ascii_islf(ch);
+#endif /* REOP_ANY_NOTNUL_NOTLF */
+	case REOP_BYTE:
+		return ch == pc[1];
+	case REOP_NBYTE:
+		return ch != pc[1];
+	case REOP_BYTE2:
+		return ch == pc[1] || ch == pc[2];
+	case REOP_NBYTE2:
+		return ch != pc[1] && ch != pc[2];
+	case REOP_RANGE:
+		return ch >= pc[1] && ch <= pc[2];
+	case REOP_NRANGE:
+		return ch < pc[1] || ch > pc[2];
+	case REOP_BITSET:
+		return (pc[1 + ch / 8] & (1 << (ch % 8))) != 0;
+	case REOP_CS_BYTE:
+		return CS_BYTE_contains(pc + 1, ch);
+	default: __builtin_unreachable();
+	}
+}
+
+/* Check if the `RE_DFA_OP_UTF8'-opcode at `pc' accepts `ch' */
+LOCAL ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_dfa_matchchar)(byte_t const *__restrict pc, char32_t ch) {
+	switch (pc[0]) {
+#ifdef REOP_ANY_UTF8
+	case REOP_ANY_UTF8:
+		return true;
+#endif /* REOP_ANY_UTF8 */
+#ifdef REOP_ANY_NOTLF_UTF8
+	case REOP_ANY_NOTLF_UTF8:
+		return !re_unicode_islf(ch);
+#endif /* REOP_ANY_NOTLF_UTF8 */
+#ifdef REOP_ANY_NOTNUL_NOTLF_UTF8
+	case REOP_ANY_NOTNUL_NOTLF_UTF8:
+		return ch != '\0' && !re_unicode_islf(ch);
+#endif /* REOP_ANY_NOTNUL_NOTLF_UTF8 */
+	case REOP_CONTAINS_UTF8:
+	case REOP_NCONTAINS_UTF8: {
+		byte_t count = pc[1];
+		byte_t const *reader = pc + 2;
+		do {
+			if (ch == unicode_readutf8((char const **)&reader))
+				return pc[0] == REOP_CONTAINS_UTF8;
+		} while (--count);
+		return pc[0] != REOP_CONTAINS_UTF8;
+	}
+	case REOP_CS_UTF8:
+		return CS_UTF8_contains(pc + 1, ch);
+	case REOP_NCS_UTF8:
+		return !CS_UTF8_contains(pc + 1, ch);
+	case REOP_SEQ_UTF8:
+		return SEQ_UTF8_containschar(pc + 1, ch);
+	case REOP_NSEQ_UTF8:
+		return !SEQ_UTF8_containschar(pc + 1, ch);
+	default: __builtin_unreachable();
+	}
+}
+
+/* Return the context flags for a position following `ch' */
+#define re_dfa_ctxof(self, ch)                        \
+	(((ascii_islf(ch) ? RE_DFA_CTX_LF : 0) |          \
+	  (issymcont(ch) ? RE_DFA_CTX_SYM : 0)) &         \
+	 (self)->df_ctxmask)
+
+/* If `thread' is at a node of `REOP_TRIE' where a literal ends (but from where
+ * longer literals continue), return the offset of the opcode after the trie.
+ * Otherwise, return `(size_t)-1' */
+INTDEF ATTR_PURE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_dfa_trieaccept)(byte_t const *__restrict code,
+                                  re_dfa_thread_t thread);
+
+/* Return the context flags for the current position of `interp' */
+INTDEF WUNUSED NONNULL((1, 2)) uint8_t
+NOTHROW_NCX(CC re_dfa_getctx)(struct re_dfa const *__restrict self,
+                              struct re_interpreter *__restrict interp);
+
+/* Compute the byte classes of `self' (bytes of the same class are
+ * indistinguishable for the code, and share DFA transitions)
+ * @param: fmap:    The fast-map used to start new threads (or `NULL' if threads
+ *                  are always started at the beginning of code, as in set DFAs)
+ * @param: sigbits: The # of per-opcode bits needed in signatures
+ * @param: utf8:    True if the code contains utf-8 opcodes */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC re_dfa_init_classes)(struct re_dfa *__restrict self, byte_t const *fmap,
+                                    size_t sigbits, bool utf8);
+
+/* Check that the DFA supports all opcodes that appear in `code', and
+ * gather what the DFA needs to know about them (added to `*p_sigbits',
+ * `*p_utf8' and `*p_ctxmask', which are left unchanged upon failure)
+ * NOTE: `RE_CODE_FLAG_POPPRUNES' isn't checked for (callers that want the DFA
+ *       to produce the same matches as the interpreter must do that themselves)
+ * @return: * : The size of `code->rc_code' (including the final `REOP_MATCHED')
+ * @return: 0 : The DFA can't be used for `code' */
+INTDEF WUNUSED NONNULL((1, 2, 3, 4)) size_t
+NOTHROW_NCX(CC re_dfa_scancode)(struct re_code const *__restrict code,
+                                size_t *__restrict p_sigbits, bool *__restrict p_utf8,
+                                uint8_t *__restrict p_ctxmask);
+
+/* Allocate a DFA for `codesize' bytes of code, with `extra' additional bytes
+ * for the caller (at `result->df_cacheend') and a state cache of `cachesize'
+ * bytes. The caller must fill in `df_exec', `df_code', the `df_set*' fields,
+ * and call `re_dfa_init_classes()'.
+ * @return: NULL: Out of memory */
+INTDEF WUNUSED struct re_dfa *
+NOTHROW_NCX(CC re_dfa_alloc)(size_t codesize, uint8_t ctxmask,
+                             size_t cachesize, size_t extra);
+
+/* Create a new DFA for `exec'
+ * @return: NULL: The DFA can't be used for `exec' (or out of memory) */
+INTDEF WUNUSED NONNULL((1)) struct re_dfa *
+NOTHROW_NCX(CC re_dfa_new)(struct re_exec const *__restrict exec);
+
+/* Have `thread' (which must be about to consume input) consume `ch'
+ * @return: * :                    The resulting thread
+ * @return: RE_DFA_THREAD_DEAD:   `thread' doesn't accept `ch'
+ * @return: RE_DFA_THREAD_ILLSEQ: Malformed utf-8 (the caller has to give up) */
+INTDEF WUNUSED NONNULL((1)) re_dfa_thread_t
+NOTHROW_NCX(CC re_dfa_stepthread)(byte_t const *__restrict code,
+                                  re_dfa_thread_t thread, byte_t ch);
+
+/* Return `thread' as it is at the end of input (or `RE_DFA_THREAD_DEAD').
+ * An incomplete utf-8 character at the end of input is still read (as far
+ * as it goes), but threads in the middle of other multi-byte opcodes would
+ * need more input. */
+INTDEF WUNUSED NONNULL((1)) re_dfa_thread_t
+NOTHROW_NCX(CC re_dfa_stepeoi)(byte_t const *__restrict code,
+                               re_dfa_thread_t thread);
+
+/* Flush the state cache of `self' */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC re_dfa_flush)(struct re_dfa *__restrict self);
+
+/* Return the (possibly new) cached state with threads `self->df_kernel[0..count-1]'
+ * and context flags `ctx'. If the state cache has to be flushed for this, set
+ * `*p_flushed' to true (all states previously returned then become invalid)
+ * @return: NULL: The DFA has to give up */
+INTDEF WUNUSED NONNULL((1, 4)) struct re_dfa_state *
+NOTHROW_NCX(CC re_dfa_getstate)(struct re_dfa *__restrict self, size_t count,
+                                uint8_t ctx, bool *__restrict p_flushed);
+
+/* Compute (and cache) the transition of `state' when followed by `ch'
+ * For set DFAs, the patterns whose matches end before `ch' are left in
+ * `self->df_setmatch'.
+ * @param: p_accept: Set to true if a match ends before `ch'
+ * @return: NULL:    The DFA has to give up */
+INTDEF WUNUSED NONNULL((1, 2, 4)) struct re_dfa_state *
+NOTHROW_NCX(CC re_dfa_transition)(struct re_dfa *__restrict self,
+                                  struct re_dfa_state *__restrict state,
+                                  byte_t ch, bool *__restrict p_accept);
+
+/* Check if `state' accepts at the end of input (which `interp' must be at) */
+INTDEF WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_dfa_accepts_eoi)(struct re_dfa *__restrict self,
+                                   struct re_dfa_state const *__restrict state,
+                                   struct re_interpreter *__restrict interp);
+
+/* Use the DFA to find the longest match at the current position of `interp'.
+ * Same as `libre_interp_exec()', except that no group offsets are produced.
+ * @return: -RE_NOERROR:     Input was matched (`interp' points at the end of the match)
+ * @return: -RE_NOMATCH:     Nothing was matched
+ * @return: RE_DFA_FALLBACK: The DFA gave up (the position of `interp' is undefined) */
+INTDEF WUNUSED NONNULL((1, 2)) re_errno_t
+NOTHROW_NCX(CC re_dfa_exec)(struct re_dfa *__restrict self,
+                            struct re_interpreter *__restrict interp);
+
+/* Use the DFA to scan input from the current position of `interp' for the end
+ * of the first match that starts within the next `search_range' bytes.  Code
+ * must not be able to match epsilon. Moves the input pointer of `interp'.
+ * @return: * :         Absolute offset where the first such match ends
+ * @return: (size_t)-1: No match starts within the next `search_range' bytes
+ * @return: (size_t)-2: The DFA gave up */
+INTDEF WUNUSED NONNULL((1, 2)) size_t
+NOTHROW_NCX(CC re_dfa_search)(struct re_dfa *__restrict self,
+                              struct re_interpreter *__restrict interp,
+                              size_t search_range);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGDFA_H */
@@ -0,0 +1,1572 @@
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifdef __INTELLISENSE__
+#include "regexec.c"
+#define DEFINE_libre_interp_exec_jit
+#endif /* __INTELLISENSE__ */
+
+#if (defined(DEFINE_libre_interp_exec) + defined(DEFINE_libre_interp_exec_jit)) != 1
+#error "Must #define exactly one of these macros"
+#endif /* ... */
+
+DECL_BEGIN
+
+#ifdef DEFINE_libre_interp_exec_jit
+#define LOCAL_libre_interp_exec libre_interp_exec_jit
+#define LOCAL_WITH_JIT
+#else /* DEFINE_libre_interp_exec_jit */
+#define LOCAL_libre_interp_exec libre_interp_exec
+#endif /* !DEFINE_libre_interp_exec_jit */
+
+/* Machine code may take over at any opcode, so the version using it always goes through
+ * the check at `dispatch', while the other one jumps between handlers directly. */
+#if defined(HAVE_THREADED_DISPATCH) && !defined(LOCAL_WITH_JIT)
+#define LOCAL_THREADED_DISPATCH
+#endif /* HAVE_THREADED_DISPATCH && !LOCAL_WITH_JIT */
+
+/* Execute the regex interpreter (`libre_interp_exec_jit()': with the help of `self->ri_jit').
+ * NOTE: The caller is  responsible for loading  a non-empty  chunk,
+ *       unless the entire input buffer is empty. iow: this function
+ *       is  allowed to  assume that  the current  chunk being empty
+ *       also means that the entire input buffer is empty.
+ *
+ * @return: -RE_NOERROR: Input was matched.
+ * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+PRIVATE WUNUSED NONNULL((1)) re_errno_t
+NOTHROW_NCX(CC LOCAL_libre_interp_exec)(__register struct re_interpreter *__restrict self) {
+	__register byte_t opcode;
+	__register byte_t const *pc;
+	byte_t const *codebase = self->ri_exec->rx_code->rc_code;
+	struct re_interpreter_inptr startin;
+	byte_t const *startpc      = NULL;
+	re_regmatch_t *startgroups = NULL;
+#ifdef LOCAL_WITH_JIT
+	struct re_jit *jit = self->ri_jit;
+	assert(jit != NULL);
+#endif /* LOCAL_WITH_JIT */
+
+	/* Initialize program counter. */
+	{
+		struct re_code const *code;
+		code = self->ri_exec->rx_code;
+		pc   = code->rc_code;
+
+		/* Try to do a quick can-check via the fast-map */
+		if (re_interpreter_in_chunk_cangetc(self)) {
+			byte_t fmap;
+			fmap = *self->ri_in_ptr;
+			fmap = code->rc_fmap[fmap];
+			if (fmap == 0xff) {
+				/* Initial character never matches, but are we able to match epsilon?
+				 * If so, still have to execute the code from the start, since that
+				 * epsilon match may depend on assertions (e.g. "^$" or "\\<") */
+				if (code->rc_minmatch > 0)
+					return -RE_NOMATCH;
+			} else {
+				pc += fmap;
+			}
+		} else if (code->rc_minmatch > 0) {
+			/* Input buffer is epsilon, but regex has a non-  zero
+			 * minimal match length -> regex can't possibly match! */
+			return -RE_NOMATCH;
+		}
+		/* Else: input buffer is epsilon, and we can match epsilon. Whether we
+		 *       actually do still depends on assertions (e.g. "\\<" never does,
+		 *       and "^" doesn't when `RE_EXEC_NOTBOL' is set), and optional groups
+		 *       (e.g. "(|foo(b)ar)") must remain UNSET, so execute the code. */
+	}
+
+	/* Only marks left behind by attempts that failed remain valid for later ones
+	 * (nothing that can be reached from those pairs leads to a match) */
+	if (self->ri_flags & RE_INTERPRETER_F_MEMODIRTY) {
+		if (self->ri_memo != NULL)
+			bzero(self->ri_memo, self->ri_memo_size);
+	}
+	self->ri_flags &= ~(RE_INTERPRETER_F_MEMOUSED | RE_INTERPRETER_F_MEMOOFF);
+	self->ri_flags |= RE_INTERPRETER_F_MEMODIRTY;
+	if (self->ri_onfailc != 0 || (self->ri_memo == NULL && self->ri_memo_wait == 0)) {
+		/* Not remembering anything (also when items were left behind by the previous
+		 * attempt, since those could lead to matches that started somewhere else) */
+		self->ri_flags |= RE_INTERPRETER_F_MEMOOFF;
+	} else {
+		/* Save what's needed to start over (s.a. `memo_redo') */
+		startin     = self->ri_in;
+		startpc     = pc;
+		startgroups = (re_regmatch_t *)alloca(self->ri_exec->rx_code->rc_ngrps * sizeof(re_regmatch_t));
+		memcpyc(startgroups, self->ri_pmatch, self->ri_exec->rx_code->rc_ngrps, sizeof(re_regmatch_t));
+	}
+memo_restart:
+	/* Initialize the best match as not-matched-yet */
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	self->ri_bmatch.ri_in_ptr = NULL;
+#define best_match_isvalid() (self->ri_bmatch.ri_in_ptr != NULL)
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	self->ri_bmatch.ri_in_ptr  = (byte_t *)1;
+	self->ri_bmatch.ri_in_cend = (byte_t *)0;
+#define best_match_isvalid() (self->ri_bmatch.ri_in_ptr <= self->ri_bmatch.ri_in_cend)
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+	/* Helper macros */
+#ifdef LOCAL_THREADED_DISPATCH
+#define DISPATCH()     do { opcode = getb(); goto *dispatch_targets[opcode]; } __WHILE0
+#define THREADED_LABEL(name) name:
+#else /* LOCAL_THREADED_DISPATCH */
+#define DISPATCH()     goto dispatch
+#define THREADED_LABEL(name) /* nothing */
+#endif /* !LOCAL_THREADED_DISPATCH */
+#ifdef HAVE_TRACE
+#define ONFAIL()       do{ TRACE("ONFAIL: %d\n", __LINE__); goto onfail; }__WHILE0
+#define TARGET(opcode) __IF0 { case opcode: THREADED_LABEL(target_##opcode) TRACE("%#.4" PRIxSIZ ": %s\n", (size-t)((pc - 1) - self->ri_exec->rx_code->rc_code), #opcode); }
+#define XTARGET(range) __IF0 {       range: THREADED_LABEL(target_##range) TRACE("%#.4" PRIxSIZ ": %s\n", (size-t)((pc - 1) - self->ri_exec->rx_code->rc_code), #opcode); }
+#else /* HAVE_TRACE */
+#define ONFAIL()       goto onfail
+#define TARGET(opcode) case opcode: THREADED_LABEL(target_##opcode)
+#define XTARGET(range) range: THREADED_LABEL(target_##range)
+#endif /* !HAVE_TRACE */
+#define PCOFF(pc)                 ((uint16_t)((pc) - codebase))
+#define PUSHFAIL(pc)              do { if unlikely(!re_interpreter_pushfail(self, PCOFF(pc))) goto err_nomem; } __WHILE0
+#define PUSHFAIL_DUMMY(pc)        do { if unlikely(!re_interpreter_pushfail_dummy(self, RE_ONFAILURE_ITEM_DUMMY_AT, 0, PCOFF(pc))) goto err_nomem; } __WHILE0
+#define PUSHFAIL_EX(tag, in, pc)  do { if unlikely(!re_interpreter_pushfail_dummy(self, tag, in, pc)) goto err_nomem; } __WHILE0
+#define getb()              (*pc++)
+#define getw()              (pc += 2, delta16_get(pc - 2))
+
+#ifdef LOCAL_THREADED_DISPATCH
+	/* Handlers of all opcodes that can appear at runtime (s.a. `TARGET()') */
+	static void const *const dispatch_targets[REOP_MAYBE_POP_ONFAIL] = {
+#define DEF_TARGET(opcode) [opcode] = &&target_##opcode
+	DEF_TARGET(REOP_EXACT),
+	DEF_TARGET(REOP_EXACT_ASCII_ICASE),
+	DEF_TARGET(REOP_EXACT_UTF8_ICASE),
+#ifdef REOP_ANY
+	DEF_TARGET(REOP_ANY),
+#endif /* REOP_ANY */
+#ifdef REOP_ANY_UTF8
+	DEF_TARGET(REOP_ANY_UTF8),
+#endif /* REOP_ANY_UTF8 */
+#ifdef REOP_ANY_NOTLF
+	DEF_TARGET(REOP_ANY_NOTLF),
+#endif /* REOP_ANY_NOTLF */
+#ifdef REOP_ANY_NOTLF_UTF8
+	DEF_TARGET(REOP_ANY_NOTLF_UTF8),
+#endif /* REOP_ANY_NOTLF_UTF8 */
+#ifdef REOP_ANY_NOTNUL
+	DEF_TARGET(REOP_ANY_NOTNUL),
+#endif /* REOP_ANY_NOTNUL */
+#ifdef REOP_ANY_NOTNUL_UTF8
+	DEF_TARGET(REOP_ANY_NOTNUL_UTF8),
+#endif /* REOP_ANY_NOTNUL_UTF8 */
+#ifdef REOP_ANY_NOTNUL_NOTLF
+	DEF_TARGET(REOP_ANY_NOTNUL_NOTLF),
+#endif /* REOP_ANY_NOTNUL_NOTLF */
+#ifdef REOP_ANY_NOTNUL_NOTLF_UTF8
+	DEF_TARGET(REOP_ANY_NOTNUL_NOTLF_UTF8),
+#endif /* REOP_ANY_NOTNUL_NOTLF_UTF8 */
+	DEF_TARGET(REOP_BYTE),
+	DEF_TARGET(REOP_NBYTE),
+	DEF_TARGET(REOP_BYTE2),
+	DEF_TARGET(REOP_NBYTE2),
+	DEF_TARGET(REOP_RANGE),
+	DEF_TARGET(REOP_NRANGE),
+	DEF_TARGET(REOP_BITSET),
+	DEF_TARGET(REOP_CONTAINS_UTF8),
+	DEF_TARGET(REOP_NCONTAINS_UTF8),
+	DEF_TARGET(REOP_CS_BYTE),
+	DEF_TARGET(REOP_CS_UTF8),
+	DEF_TARGET(REOP_NCS_UTF8),
+	DEF_TARGET(REOP_SEQ_UTF8),
+	DEF_TARGET(REOP_NSEQ_UTF8),
+	DEF_TARGET(REOP_TRIE),
+	DEF_TARGET(REOP_GROUP_MATCH),
+	[REOP_GROUP_MATCH_JMIN ... REOP_GROUP_MATCH_JMAX] = &&target_case_REOP_GROUP_MATCH_JMIN_to_JMAX,
+	DEF_TARGET(REOP_AT_SOI),
+	DEF_TARGET(REOP_AT_EOI),
+	DEF_TARGET(REOP_AT_SOL),
+	DEF_TARGET(REOP_AT_SOL_UTF8),
+	DEF_TARGET(REOP_AT_EOL),
+	DEF_TARGET(REOP_AT_EOL_UTF8),
+	DEF_TARGET(REOP_AT_SOXL),
+	DEF_TARGET(REOP_AT_SOXL_UTF8),
+	DEF_TARGET(REOP_AT_EOXL),
+	DEF_TARGET(REOP_AT_EOXL_UTF8),
+	DEF_TARGET(REOP_AT_WOB),
+	DEF_TARGET(REOP_AT_WOB_UTF8),
+	DEF_TARGET(REOP_AT_WOB_NOT),
+	DEF_TARGET(REOP_AT_WOB_UTF8_NOT),
+	DEF_TARGET(REOP_AT_SOW),
+	DEF_TARGET(REOP_AT_SOW_UTF8),
+	DEF_TARGET(REOP_AT_EOW),
+	DEF_TARGET(REOP_AT_EOW_UTF8),
+	DEF_TARGET(REOP_AT_SOS_UTF8),
+	DEF_TARGET(REOP_GROUP_START),
+	DEF_TARGET(REOP_GROUP_END),
+	[REOP_GROUP_END_JMIN ... REOP_GROUP_END_JMAX] = &&target_case_REOP_GROUP_END_JMIN_to_JMAX,
+	DEF_TARGET(REOP_POP_ONFAIL),
+	DEF_TARGET(REOP_POP_ONFAIL_AT),
+	DEF_TARGET(REOP_JMP_ONFAIL),
+	DEF_TARGET(REOP_JMP_ONFAIL_DUMMY_AT),
+	DEF_TARGET(REOP_JMP_ONFAIL_DUMMY),
+	DEF_TARGET(REOP_JMP),
+	DEF_TARGET(REOP_JMP_AND_RETURN_ONFAIL),
+	DEF_TARGET(REOP_SPAN),
+	DEF_TARGET(REOP_SPAN_AND_RETURN_ONFAIL),
+	DEF_TARGET(REOP_SPAN_LIT),
+	DEF_TARGET(REOP_SPAN_LIT_AND_RETURN_ONFAIL),
+	DEF_TARGET(REOP_DEC_JMP),
+	DEF_TARGET(REOP_DEC_JMP_AND_RETURN_ONFAIL),
+	DEF_TARGET(REOP_SETVAR),
+	DEF_TARGET(REOP_NOP),
+	DEF_TARGET(REOP_MATCHED),
+	DEF_TARGET(REOP_MATCHED_PERFECT),
+#undef DEF_TARGET
+	};
+#endif /* LOCAL_THREADED_DISPATCH */
+
+	/* The main dispatch loop */
+#ifndef LOCAL_THREADED_DISPATCH
+dispatch:
+#endif /* !LOCAL_THREADED_DISPATCH */
+#ifdef LOCAL_WITH_JIT
+	{
+		/* Run machine code for as long as it can go on by itself (it always gives
+		 * opcodes that it can't execute back to us, and needs all remaining input
+		 * to be in the current chunk) */
+		uint32_t entry = jit->rj_entries[PCOFF(pc)];
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		if (entry != 0)
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		if (entry != 0 && re_interpreter_in_islastchunk(self))
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		{
+			int32_t pcoff = re_jit_run(jit, self, entry);
+			if (pcoff < 0)
+				ONFAIL();
+			pc = codebase + pcoff;
+		}
+	}
+#endif /* LOCAL_WITH_JIT */
+	opcode = getb();
+	switch (opcode) {
+
+		TARGET(REOP_EXACT) {
+			byte_t count = getb();
+			assert(count >= 2);
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+			{
+				size_t avail = re_interpreter_in_chunkleft(self);
+				if (avail < (size_t)count)
+					ONFAIL();
+				if (bcmp(self->ri_in_ptr, pc, count) != 0)
+					ONFAIL();
+				self->ri_in_ptr += count;
+				pc += count;
+			}
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+			for (;;) {
+				size_t avail = re_interpreter_in_chunkleft(self);
+				if (avail == 0) {
+					if (re_interpreter_is_eoi_at_end_of_chunk(self))
+						ONFAIL();
+					re_interpreter_nextchunk(self);
+					avail = re_interpreter_in_chunkleft(self);
+				}
+				assert(avail >= 1);
+				if likely(avail >= count) {
+					/* Everything left to compare is in the current chunk */
+					if (bcmp(self->ri_in_ptr, pc, count) != 0)
+						ONFAIL();
+					self->ri_in_ptr += count;
+					pc += count;
+					break;
+				} else {
+					/* Input string spans across multiple chunks */
+					if (bcmp(self->ri_in_ptr, pc, avail) != 0)
+						ONFAIL();
+					self->ri_in_ptr += avail;
+					pc += avail;
+					count -= avail;
+				}
+			}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+			DISPATCH();
+		}
+
+		TARGET(REOP_EXACT_ASCII_ICASE) {
+			byte_t count = getb();
+			assert(count >= 2);
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+			{
+				size_t avail = re_interpreter_in_chunkleft(self);
+				if (avail < (size_t)count)
+					ONFAIL();
+				if (!re_memcaseeq_folded(self->ri_in_ptr, pc, count))
+					ONFAIL();
+				self->ri_in_ptr += count;
+				pc += count;
+			}
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+			for (;;) {
+				size_t avail = re_interpreter_in_chunkleft(self);
+				if (avail == 0) {
+					if (re_interpreter_is_eoi_at_end_of_chunk(self))
+						ONFAIL();
+					re_interpreter_nextchunk(self);
+					avail = re_interpreter_in_chunkleft(self);
+				}
+				assert(avail >= 1);
+				if likely(avail >= count) {
+					/* Everything left to compare is in the current chunk */
+					if (!re_memcaseeq_folded(self->ri_in_ptr, pc, count))
+						ONFAIL();
+					self->ri_in_ptr += count;
+					pc += count;
+					break;
+				} else {
+					/* Input string spans across multiple chunks */
+					if (!re_memcaseeq_folded(self->ri_in_ptr, pc, avail))
+						ONFAIL();
+					self->ri_in_ptr += avail;
+					pc += avail;
+					count -= avail;
+				}
+			}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+			DISPATCH();
+		}
+
+		TARGET(REOP_EXACT_UTF8_ICASE) {
+			byte_t count = getb();
+			byte_t const *newpc = pc;
+			assert(count >= 1);
+			do {
+				char32_t expected, actual;
+				if (re_interpreter_is_eoi(self))
+					ONFAIL();
+				actual   = re_interpreter_readutf8(self);
+				expected = unicode_readutf8((char const **)&newpc);
+				if (actual != expected) {
+					/* `expected' was already folded by the compiler */
+					if (actual >= 'A' && actual <= 'Z') {
+						actual += 'a' - 'A';
+					} else if (actual >= 0x80) {
+						actual = unicode_tolower(actual);
+					}
+					if (actual != expected) {
+						/* Non-ascii characters whose lower-case is ascii aren't folded */
+						if (expected < 0x80 || actual != unicode_tolower(expected))
+							ONFAIL();
+					}
+				}
+			} while (--count);
+			pc = newpc;
+			DISPATCH();
+		}
+
+#ifdef REOP_ANY
+		TARGET(REOP_ANY) {
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			(void)re_interpreter_readbyte(self);
+			DISPATCH();
+		}
+#endif /* REOP_ANY */
+
+#ifdef REOP_ANY_UTF8
+		TARGET(REOP_ANY_UTF8) {
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			(void)re_interpreter_readutf8(self);
+			DISPATCH();
+		}
+#endif /* REOP_ANY_UTF8 */
+
+#ifdef REOP_ANY_NOTLF
+		TARGET(REOP_ANY_NOTLF) {
+			byte_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readbyte(self);
+			if (ascii_islf(ch))
+				ONFAIL();
+			DISPATCH();
+		}
+#endif /* REOP_ANY_NOTLF */
+
+#ifdef REOP_ANY_NOTLF_UTF8
+		TARGET(REOP_ANY_NOTLF_UTF8) {
+			char32_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readutf8(self);
+			if (re_unicode_islf(ch))
+				ONFAIL();
+			DISPATCH();
+		}
+#endif /* REOP_ANY_NOTLF_UTF8 */
+
+#ifdef REOP_ANY_NOTNUL
+		TARGET(REOP_ANY_NOTNUL) {
+			byte_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readbyte(self);
+			if (ch == '\0')
+				ONFAIL();
+			DISPATCH();
+		}
+#endif /* REOP_ANY_NOTNUL */
+
+#ifdef REOP_ANY_NOTNUL_UTF8
+		TARGET(REOP_ANY_NOTNUL_UTF8) {
+			char32_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readbyte(self);
+			if (ch == (char32_t)'\0')
+				ONFAIL();
+			DISPATCH();
+		}
+#endif /* REOP_ANY_NOTNUL_UTF8 */
+
+#ifdef REOP_ANY_NOTNUL_NOTLF
+		TARGET(REOP_ANY_NOTNUL_NOTLF) {
+			byte_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readbyte(self);
+			if (ch == '\0' || ascii_islf(ch))
+				ONFAIL();
+			DISPATCH();
+		}
+#endif /* REOP_ANY_NOTNUL_NOTLF */
+
+#ifdef REOP_ANY_NOTNUL_NOTLF_UTF8
+		TARGET(REOP_ANY_NOTNUL_NOTLF_UTF8) {
+			char32_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readutf8(self);
+			if (ch == '\0' || re_unicode_islf(ch))
+				ONFAIL();
+			DISPATCH();
+		}
+#endif /* REOP_ANY_NOTNUL_NOTLF_UTF8 */
+
+		TARGET(REOP_BYTE) {
+			/* Followed by 1 byte that must be matched exactly */
+			byte_t ch, b;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			b  = getb();
+			ch = re_interpreter_readbyte(self);
+			if (ch == b)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_NBYTE) {
+			/* Followed by 1 byte that must not be matched exactly */
+			byte_t ch, b;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			b  = getb();
+			ch = re_interpreter_readbyte(self);
+			if (ch != b)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_BYTE2) {
+			/* Followed by 2 bytes, one of which must be matched exactly (for "[ab]" or "a" -> "[aA]" in ICASE-mode) */
+			byte_t ch, b1, b2;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			b1 = getb();
+			b2 = getb();
+			ch = re_interpreter_readbyte(self);
+			if (ch == b1 || ch == b2)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_NBYTE2) {
+			/* Followed by 2 bytes, neither of which may be matched */
+			byte_t ch, b1, b2;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			b1 = getb();
+			b2 = getb();
+			ch = re_interpreter_readbyte(self);
+			if (ch != b1 && ch != b2)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_RANGE) {
+			/* Followed by 2 bytes, with input having to match `ch >= pc[0] && ch <= pc[1]' */
+			byte_t ch, lo, hi;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			lo = getb();
+			hi = getb();
+			ch = re_interpreter_readbyte(self);
+			if (ch >= lo && ch <= hi)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_NRANGE) {
+			/* Followed by 2 bytes, with input having to match `ch >= pc[0] && ch <= pc[1]' */
+			byte_t ch, lo, hi;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			lo = getb();
+			hi = getb();
+			ch = re_interpreter_readbyte(self);
+			if (ch < lo || ch > hi)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_BITSET) {
+			/* Followed by a 256-bit bitset, with input having to match `pc[ch / 8] & (1 << (ch % 8))' */
+			byte_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readbyte(self);
+			if ((pc[ch / 8] & (1 << (ch % 8))) == 0)
+				ONFAIL();
+			pc += 32;
+			DISPATCH();
+		}
+
+		TARGET(REOP_CONTAINS_UTF8) {
+			byte_t count = getb();
+			char32_t ch;
+			byte_t const *newpc;
+			assert(count >= 2);
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readutf8(self);
+			newpc = pc;
+			for (;;) {
+				char32_t other_ch;
+				other_ch = unicode_readutf8((char const **)&newpc);
+				--count;
+				if (ch == other_ch)
+					break;
+				if (!count)
+					ONFAIL();
+			}
+			/* Consume remaining characters */
+			for (; count; --count)
+				newpc += unicode_utf8seqlen[(unsigned char)*newpc];
+			pc = newpc;
+			DISPATCH();
+		}
+
+		TARGET(REOP_NCONTAINS_UTF8) {
+			byte_t count = getb();
+			char32_t ch;
+			byte_t const *newpc;
+			assert(count >= 1);
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readutf8(self);
+			newpc = pc;
+			do {
+				char32_t other_ch;
+				other_ch = unicode_readutf8((char const **)&newpc);
+				if (ch == other_ch)
+					ONFAIL();
+			} while (--count);
+			pc = newpc;
+			DISPATCH();
+		}
+
+
+
+		/************************************************************************/
+		/* BITSET OPCODES                                                       */
+		/************************************************************************/
+		TARGET(REOP_CS_BYTE) {
+			byte_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readbyte(self);
+REOP_CS_BYTE_dispatch:
+			opcode = getb();
+			switch (opcode) {
+
+			case_RECS_BITSET_MIN_to_MAX_BYTE: {
+				uint8_t bitset_minch = RECS_BITSET_GETBASE(opcode);
+				uint8_t bitset_size  = RECS_BITSET_GETBYTES(opcode);
+				byte_t bitset_rel_ch;
+				if (!OVERFLOW_USUB(ch, bitset_minch, &bitset_rel_ch)) {
+					unsigned int bitset_bits = bitset_size * 8;
+					if (bitset_rel_ch < bitset_bits) {
+						if ((pc[bitset_rel_ch / 8] & (1 << (bitset_rel_ch % 8))) != 0) {
+							pc += bitset_size;
+							goto REOP_CS_BYTE_onmatch;
+						}
+					}
+				}
+				pc += bitset_size;
+				goto REOP_CS_BYTE_dispatch;
+			}
+
+			case RECS_DONE:
+				/* Reached the end of the char-set without any match */
+				ONFAIL();
+				__builtin_unreachable();
+
+			case RECS_CHAR: {
+				byte_t match = getb();
+				if (ch == match)
+					goto REOP_CS_BYTE_onmatch;
+				goto REOP_CS_BYTE_dispatch;
+			}
+
+			case RECS_CHAR2: {
+				byte_t match1 = getb();
+				byte_t match2 = getb();
+				if (ch == match1 || ch == match2)
+					goto REOP_CS_BYTE_onmatch;
+				goto REOP_CS_BYTE_dispatch;
+			}
+
+			case RECS_RANGE: {
+				byte_t match_lo = getb();
+				byte_t match_hi = getb();
+				if (ch >= match_lo && ch <= match_hi)
+					goto REOP_CS_BYTE_onmatch;
+				goto REOP_CS_BYTE_dispatch;
+			}
+
+			case RECS_CONTAINS: {
+				byte_t len = getb();
+				if (memchr(pc, ch, len) != NULL) {
+					pc += len;
+					goto REOP_CS_BYTE_onmatch;
+				}
+				pc += len;
+				goto REOP_CS_BYTE_dispatch;
+			}
+
+			/* No need to handle trait opcodes (those aren't valid in byte-mode) */
+
+			default: __builtin_unreachable();
+			}
+REOP_CS_BYTE_onmatch:
+			pc = CS_BYTE_seek_end(pc);
+			DISPATCH();
+		}
+
+		TARGET(REOP_CS_UTF8) {
+			char32_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readutf8(self);
+			if likely(ch < 0x80) {
+				/* ASCII characters are looked up in the leading bitset */
+				if ((pc[ch / 8] & (1 << (ch % 8))) == 0)
+					ONFAIL();
+				pc += 16;
+				goto REOP_CS_UTF8_onmatch;
+			}
+			pc += 16;
+REOP_CS_UTF8_dispatch:
+			opcode = getb();
+			switch (opcode) {
+
+			case RECS_DONE:
+				/* Reached the end of the char-set without any match */
+				ONFAIL();
+				__builtin_unreachable();
+
+			case RECS_CHAR: {
+				byte_t const *newpc = pc;
+				char32_t match;
+				match = unicode_readutf8((char const **)&newpc);
+				pc    = newpc;
+				if (ch == match)
+					goto REOP_CS_UTF8_onmatch;
+				goto REOP_CS_UTF8_dispatch;
+			}
+
+			case RECS_CHAR2: {
+				byte_t const *newpc = pc;
+				char32_t match1, match2;
+				match1 = unicode_readutf8((char const **)&newpc);
+				match2 = unicode_readutf8((char const **)&newpc);
+				pc     = newpc;
+				if (ch == match1 || ch == match2)
+					goto REOP_CS_UTF8_onmatch;
+				goto REOP_CS_UTF8_dispatch;
+			}
+
+			case RECS_RANGE: {
+				byte_t const *newpc = pc;
+				char32_t match_lo, match_hi;
+				match_lo = unicode_readutf8((char const **)&newpc);
+				match_hi = unicode_readutf8((char const **)&newpc);
+				pc       = newpc;
+				if (ch >= match_lo && ch <= match_hi)
+					goto REOP_CS_UTF8_onmatch;
+				goto REOP_CS_UTF8_dispatch;
+			}
+
+			case RECS_RANGE_ICASE: {
+				byte_t const *newpc = pc;
+				char32_t match_lo, match_hi, lower_ch;
+				match_lo = unicode_readutf8((char const **)&newpc);
+				match_hi = unicode_readutf8((char const **)&newpc);
+				pc       = newpc;
+				lower_ch = unicode_tolower(ch);
+				if (lower_ch >= match_lo && lower_ch <= match_hi)
+					goto REOP_CS_UTF8_onmatch;
+				goto REOP_CS_UTF8_dispatch;
+			}
+
+			case RECS_CONTAINS: {
+				byte_t len = getb();
+				byte_t const *newpc = pc;
+				assert(len >= 3);
+				do {
+					char32_t expected_ch;
+					--len;
+					expected_ch = unicode_readutf8((char const **)&newpc);
+					if (ch == expected_ch) {
+						while (len) {
+							newpc += unicode_utf8seqlen[*newpc];
+							--len;
+						}
+						pc = newpc;
+						goto REOP_CS_UTF8_onmatch;
+					}
+				} while (len);
+				pc = newpc;
+				goto REOP_CS_UTF8_dispatch;
+			}
+
+			case RECS_ISX_MASK: {
+				uint16_t traits = UNALIGNED_GET16(pc);
+				pc += 2;
+				if ((__unicode_descriptor(ch)->__ut_flags & traits) != 0)
+					goto REOP_CS_UTF8_onmatch;
+				goto REOP_CS_UTF8_dispatch;
+			}
+
+			case RECS_CONTAINS_SORTED: {
+				byte_t const *end = pc + 2 + UNALIGNED_GET16(pc);
+				bool found = utf8_sorted_contains(pc + 2, end, ch);
+				pc = end;
+				if (found)
+					goto REOP_CS_UTF8_onmatch;
+				goto REOP_CS_UTF8_dispatch;
+			}
+
+			default: __builtin_unreachable();
+			}
+REOP_CS_UTF8_onmatch:
+			pc = CS_UTF8_seek_end(pc);
+			DISPATCH();
+		}
+
+		TARGET(REOP_NCS_UTF8) {
+			char32_t ch;
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			ch = re_interpreter_readutf8(self);
+			if likely(ch < 0x80) {
+				/* ASCII characters are looked up in the leading bitset */
+				if ((pc[ch / 8] & (1 << (ch % 8))) != 0)
+					ONFAIL();
+				pc = CS_UTF8_seek_end(pc + 16);
+				DISPATCH();
+			}
+			pc += 16;
+REOP_NCS_UTF8_dispatch:
+			opcode = getb();
+			switch (opcode) {
+
+			case RECS_DONE:
+				/* Reached the end of the char-set without a miss-match */
+				DISPATCH();
+
+			case RECS_CHAR: {
+				byte_t const *newpc = pc;
+				char32_t match;
+				match = unicode_readutf8((char const **)&newpc);
+				pc    = newpc;
+				if (ch == match)
+					ONFAIL();
+				goto REOP_NCS_UTF8_dispatch;
+			}
+
+			case RECS_CHAR2: {
+				byte_t const *newpc = pc;
+				char32_t match1, match2;
+				match1 = unicode_readutf8((char const **)&newpc);
+				match2 = unicode_readutf8((char const **)&newpc);
+				pc     = newpc;
+				if (ch == match1 || ch == match2)
+					ONFAIL();
+				goto REOP_NCS_UTF8_dispatch;
+			}
+
+			case RECS_RANGE: {
+				byte_t const *newpc = pc;
+				char32_t match_lo, match_hi;
+				match_lo = unicode_readutf8((char const **)&newpc);
+				match_hi = unicode_readutf8((char const **)&newpc);
+				pc       = newpc;
+				if (ch >= match_lo && ch <= match_hi)
+					ONFAIL();
+				goto REOP_NCS_UTF8_dispatch;
+			}
+
+			case RECS_RANGE_ICASE: {
+				byte_t const *newpc = pc;
+				char32_t match_lo, match_hi, lower_ch;
+				match_lo = unicode_readutf8((char const **)&newpc);
+				match_hi = unicode_readutf8((char const **)&newpc);
+				pc       = newpc;
+				lower_ch = unicode_tolower(ch);
+				if (lower_ch >= match_lo && lower_ch <= match_hi)
+					ONFAIL();
+				goto REOP_NCS_UTF8_dispatch;
+			}
+
+			case RECS_CONTAINS: {
+				byte_t len = getb();
+				byte_t const *newpc = pc;
+				assert(len >= 3);
+				do {
+					char32_t expected_ch;
+					--len;
+					expected_ch = unicode_readutf8((char const **)&newpc);
+					if (ch == expected_ch)
+						ONFAIL();
+				} while (len);
+				pc = newpc;
+				goto REOP_NCS_UTF8_dispatch;
+			}
+
+			case RECS_ISX_MASK: {
+				uint16_t traits = UNALIGNED_GET16(pc);
+				pc += 2;
+				if ((__unicode_descriptor(ch)->__ut_flags & traits) != 0)
+					ONFAIL();
+				goto REOP_NCS_UTF8_dispatch;
+			}
+
+			case RECS_CONTAINS_SORTED: {
+				byte_t const *end = pc + 2 + UNALIGNED_GET16(pc);
+				if (utf8_sorted_contains(pc + 2, end, ch))
+					ONFAIL();
+				pc = end;
+				goto REOP_NCS_UTF8_dispatch;
+			}
+
+			default: __builtin_unreachable();
+			}
+			__builtin_unreachable();
+		}
+
+		TARGET(REOP_SEQ_UTF8)
+		TARGET(REOP_NSEQ_UTF8) {
+			if (re_interpreter_is_eoi(self))
+				ONFAIL();
+			if (re_interpreter_readseq(self, pc) != (opcode == REOP_SEQ_UTF8))
+				ONFAIL();
+			pc = SEQ_UTF8_seek_end(pc);
+			DISPATCH();
+		}
+
+		TARGET(REOP_TRIE) {
+			/* Walk the trie along input. Whenever a literal ends, the one before (which is
+			 * shorter) is pushed as an on-fail item, so that longer literals are tried first. */
+			byte_t const *trie = pc - 1;
+			byte_t const *node = trie + RETRIE_ROOT;
+			byte_t const *next_pc = pc + 2 + UNALIGNED_GET16(pc);
+			size_t accept = (size_t)-1;
+			for (;;) {
+				byte_t hdr = *node;
+				if (hdr & RETRIE_ACCEPT) {
+					if (accept != (size_t)-1)
+						PUSHFAIL_EX(RE_ONFAILURE_ITEM_RESUME, (uint32_t)(accept - self->ri_exec->rx_startoff), PCOFF(next_pc));
+					accept = re_interpreter_in_curoffset(self);
+				}
+				if (hdr & RETRIE_RUN) {
+					byte_t i, len = hdr & RETRIE_RUNMASK;
+					for (i = 1; i <= len; ++i) {
+						if (re_interpreter_is_eoi(self))
+							goto REOP_TRIE_done;
+						if (re_interpreter_readbyte(self) != node[i])
+							goto REOP_TRIE_done;
+					}
+					node += 1 + len;
+				} else if (hdr & RETRIE_BRANCH) {
+					uint16_t child;
+					if (re_interpreter_is_eoi(self))
+						goto REOP_TRIE_done;
+					child = re_trie_branch(node, re_interpreter_readbyte(self));
+					if (!child)
+						goto REOP_TRIE_done;
+					node = trie + child;
+				} else {
+					break; /* Leaf */
+				}
+			}
+REOP_TRIE_done:
+			if (accept == (size_t)-1)
+				ONFAIL();
+			re_interpreter_setoffset(self, accept);
+			pc = next_pc;
+			DISPATCH();
+		}
+
+
+
+		/************************************************************************/
+		/* Group repetition                                                     */
+		/************************************************************************/
+		TARGET(REOP_GROUP_MATCH) {
+			byte_t gid = getb();
+			re_regmatch_t match;
+			assert(gid < self->ri_exec->rx_code->rc_ngrps);
+			match = self->ri_pmatch[gid];
+			if (match.rm_so == RE_REGOFF_UNSET ||
+			    match.rm_eo == RE_REGOFF_UNSET)
+				ONFAIL();
+			assertf(self->ri_pmatch[gid].rm_so <= self->ri_pmatch[gid].rm_eo,
+			        "self->ri_pmatch[%1$" PRIu8 "].rm_so = %2$" PRIuSIZ "\n"
+			        "self->ri_pmatch[%1$" PRIu8 "].rm_eo = %3$" PRIuSIZ,
+			        gid, (size_t)match.rm_so, (size_t)match.rm_eo);
+			if (match.rm_so < match.rm_eo) {
+				if (!re_interpreter_consume_repeat(self, match.rm_so,
+				                                   match.rm_eo - match.rm_so))
+					ONFAIL();
+			}
+			DISPATCH();
+		}
+
+		XTARGET(case_REOP_GROUP_MATCH_JMIN_to_JMAX) {
+			byte_t gid = getb();
+			re_regmatch_t match;
+			assert(gid < self->ri_exec->rx_code->rc_ngrps);
+			match = self->ri_pmatch[gid];
+			if (match.rm_so == RE_REGOFF_UNSET ||
+			    match.rm_eo == RE_REGOFF_UNSET)
+				ONFAIL();
+			assertf(self->ri_pmatch[gid].rm_so <= self->ri_pmatch[gid].rm_eo,
+			        "self->ri_pmatch[%1$" PRIu8 "].rm_so = %2$" PRIuSIZ "\n"
+			        "self->ri_pmatch[%1$" PRIu8 "].rm_eo = %3$" PRIuSIZ,
+			        gid, (size_t)match.rm_so, (size_t)match.rm_eo);
+			if (match.rm_so < match.rm_eo) {
+				if (!re_interpreter_consume_repeat(self, match.rm_so,
+				                                   match.rm_eo - match.rm_so))
+					ONFAIL();
+			} else {
+				/* Empty group -> do a custom jump-ahead */
+				pc += REOP_GROUP_MATCH_Joff(opcode);
+			}
+			DISPATCH();
+		}
+
+
+
+		/************************************************************************/
+		/* Opcodes for asserting the current position in input (these don't consume anything) */
+		/************************************************************************/
+		TARGET(REOP_AT_SOI) {
+			/* Start-of-input */
+			if (!re_interpreter_is_soi(self))
+				ONFAIL();
+			DISPATCH();
+		}
+
+		TARGET(REOP_AT_EOI) {
+			/* End-of-input */
+			if (!re_interpreter_is_eoi(self))
+				ONFAIL();
+			DISPATCH();
+		}
+
+		TARGET(REOP_AT_SOL) {
+			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
+			if (re_interpreter_is_soi(self)) {
+				DISPATCH();
+			} else {
+				byte_t prevbyte;
+				prevbyte = re_interpreter_prevbyte(self);
+				if (ascii_islf(prevbyte))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_SOL_UTF8) {
+			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
+			if (re_interpreter_is_soi(self)) {
+				DISPATCH();
+			} else {
+				char32_t prevchar;
+				prevchar = re_interpreter_prevutf8(self);
+				if (re_unicode_islf(prevchar))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_EOL) {
+			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
+			if (re_interpreter_is_eoiX(self)) {
+				DISPATCH();
+			} else {
+				byte_t nextbyte;
+				nextbyte = re_interpreter_nextbyte(self);
+				if (ascii_islf(nextbyte))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_EOL_UTF8) {
+			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
+			if (re_interpreter_is_eoiX(self)) {
+				DISPATCH();
+			} else {
+				char32_t nextchar;
+				nextchar = re_interpreter_nextutf8(self);
+				if (re_unicode_islf(nextchar))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_SOXL) {
+			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
+			if (re_interpreter_is_soi(self)) {
+				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTBOL))
+					DISPATCH();
+			} else {
+				byte_t prevbyte;
+				prevbyte = re_interpreter_prevbyte(self);
+				if (ascii_islf(prevbyte))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_SOXL_UTF8) {
+			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
+			if (re_interpreter_is_soi(self)) {
+				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTBOL))
+					DISPATCH();
+			} else {
+				char32_t prevchar;
+				prevchar = re_interpreter_prevutf8(self);
+				if (re_unicode_islf(prevchar))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_EOXL) {
+			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
+			if (re_interpreter_is_eoiX(self)) {
+				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTEOL))
+					DISPATCH();
+			} else {
+				byte_t nextbyte;
+				nextbyte = re_interpreter_nextbyte(self);
+				if (ascii_islf(nextbyte))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_EOXL_UTF8) {
+			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
+			if (re_interpreter_is_eoiX(self)) {
+				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTEOL))
+					DISPATCH();
+			} else {
+				char32_t nextchar;
+				nextchar = re_interpreter_nextutf8(self);
+				if (re_unicode_islf(nextchar))
+					DISPATCH();
+			}
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_WOB)     /* WOrdBoundary (preceding and next character have non-equal `issymcont(ch)'; OOB counts as `issymcont == false') */
+		TARGET(REOP_AT_WOB_NOT) /* NOT WOrdBoundary (preceding and next character have equal `issymcont(ch)'; OOB counts as `issymcont == false') */
+		TARGET(REOP_AT_SOW)     /* StartOfWord (preceding and next character are `!issymcont(lhs) && issymcont(rhs)'; OOB counts as `issymcont == false') */
+		TARGET(REOP_AT_EOW)     /* EndOfWord (preceding and next character are `issymcont(lhs) && !issymcont(rhs)'; OOB counts as `issymcont == false') */
+		{
+			bool previs = re_interpreter_is_soi(self) ? false : !!issymcont(re_interpreter_prevbyte(self));
+			bool nextis = re_interpreter_is_eoiX(self) ? false : !!issymcont(re_interpreter_nextbyte(self));
+			bool ismatch;
+			switch (opcode) {
+			case REOP_AT_WOB:
+				ismatch = previs != nextis;
+				break;
+			case REOP_AT_WOB_NOT:
+				ismatch = previs == nextis;
+				break;
+			case REOP_AT_SOW:
+				ismatch = !previs && nextis;
+				break;
+			case REOP_AT_EOW:
+				ismatch = previs && !nextis;
+				break;
+			default: __builtin_unreachable();
+			}
+			if (ismatch)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_WOB_UTF8)     /* WOrdBoundary (preceding and next character have non-equal `issymcont(ch)'; OOB counts as `issymcont == false') */
+		TARGET(REOP_AT_WOB_UTF8_NOT) /* NOT WOrdBoundary (preceding and next character have equal `issymcont(ch)'; OOB counts as `issymcont == false') */
+		TARGET(REOP_AT_SOW_UTF8)     /* StartOfWord (preceding and next character are `!issymcont(lhs) && issymcont(rhs)'; OOB counts as `issymcont == false') */
+		TARGET(REOP_AT_EOW_UTF8)     /* EndOfWord (preceding and next character are `issymcont(lhs) && !issymcont(rhs)'; OOB counts as `issymcont == false') */
+		{
+			bool previs = re_interpreter_is_soi(self) ? false : !!unicode_issymcont(re_interpreter_prevutf8(self));
+			bool nextis = re_interpreter_is_eoiX(self) ? false : !!unicode_issymcont(re_interpreter_nextutf8(self));
+			bool ismatch;
+			switch (opcode) {
+			case REOP_AT_WOB_UTF8:
+				ismatch = previs != nextis;
+				break;
+			case REOP_AT_WOB_UTF8_NOT:
+				ismatch = previs == nextis;
+				break;
+			case REOP_AT_SOW_UTF8:
+				ismatch = !previs && nextis;
+				break;
+			case REOP_AT_EOW_UTF8:
+				ismatch = previs && !nextis;
+				break;
+			default: __builtin_unreachable();
+			}
+			if (ismatch)
+				DISPATCH();
+			ONFAIL();
+		}
+
+		TARGET(REOP_AT_SOS_UTF8) {
+			/* StartOfSymbol (preceding and next character are `!issymcont(lhs) && issymstrt(rhs)'; OOB counts as `issymcont[/strt] == false') */
+			bool previs = re_interpreter_is_soi(self) ? false : !!unicode_issymcont(re_interpreter_prevutf8(self));
+			bool nextis = re_interpreter_is_eoiX(self) ? false : !!unicode_issymstrt(re_interpreter_nextutf8(self));
+			if (!previs && nextis)
+				DISPATCH();
+			ONFAIL();
+		}
+
+
+
+
+		/************************************************************************/
+		/* Opcodes for expression logic and processing.                         */
+		/************************************************************************/
+		TARGET(REOP_GROUP_START) {
+			byte_t gid = getb();
+			if unlikely(!re_interpreter_setgroup(self, gid, true))
+				goto err_nomem;
+			DISPATCH();
+		}
+
+		TARGET(REOP_GROUP_END) {
+			byte_t gid = getb();
+			if unlikely(!re_interpreter_setgroup(self, gid, false))
+				goto err_nomem;
+			DISPATCH();
+		}
+
+		XTARGET(case_REOP_GROUP_END_JMIN_to_JMAX) {
+			byte_t gid = getb();
+			if unlikely(!re_interpreter_setgroup(self, gid, false))
+				goto err_nomem;
+			if (self->ri_pmatch[gid].rm_so >= self->ri_pmatch[gid].rm_eo) {
+				/* Group matched epsilon -> must skip ahead a little bit */
+				pc += REOP_GROUP_END_Joff(opcode);
+			}
+			DISPATCH();
+		}
+
+		TARGET(REOP_POP_ONFAIL) {
+			if (self->ri_onfailc > 0) { /* Can be `0' because of the fmap */
+				do {
+					--self->ri_onfailc;
+				} while (self->ri_onfailc && /* vvv keep popping until the stack becomes empty,
+				                              *     of we removed a non-group-restore  element. */
+				         RE_ONFAILURE_ITEM_TRANSPARENT_CHECK(self->ri_onfailv[self->ri_onfailc].rof_tag));
+			}
+			DISPATCH();
+		}
+
+		TARGET(REOP_POP_ONFAIL_AT) {
+			int16_t delta = getw();
+			uint16_t target_pc;
+			target_pc = PCOFF(pc + delta);
+			while (self->ri_onfailc > 0) { /* pc might not exist because of the fmap */
+				--self->ri_onfailc;
+				if (self->ri_onfailv[self->ri_onfailc].rof_pc == target_pc &&
+				    RE_ONFAILURE_ITEM_HASPC_CHECK(self->ri_onfailv[self->ri_onfailc].rof_tag))
+					break;
+			}
+			DISPATCH();
+		}
+
+		TARGET(REOP_JMP_ONFAIL) {
+			int16_t delta = getw();
+			PUSHFAIL(pc + delta);
+			DISPATCH();
+		}
+
+		TARGET(REOP_JMP_ONFAIL_DUMMY_AT) {
+			int16_t delta = getw();
+			PUSHFAIL_DUMMY(pc + delta);
+			DISPATCH();
+		}
+
+		TARGET(REOP_JMP_ONFAIL_DUMMY) {
+			PUSHFAIL_EX(RE_ONFAILURE_ITEM_DUMMY, 0, 0);
+			DISPATCH();
+		}
+
+		TARGET(REOP_JMP) {
+			int16_t delta = getw();
+			pc += delta;
+			DISPATCH();
+		}
+
+		TARGET(REOP_JMP_AND_RETURN_ONFAIL) {
+			int16_t delta = getw();
+			PUSHFAIL(pc);
+			pc += delta;
+			DISPATCH();
+		}
+
+		TARGET(REOP_SPAN)
+		TARGET(REOP_SPAN_AND_RETURN_ONFAIL)
+		TARGET(REOP_SPAN_LIT)
+		TARGET(REOP_SPAN_LIT_AND_RETURN_ONFAIL) {
+			byte_t const *loop_pc;
+			uint32_t startoff, endoff;
+			bool done, retonfail;
+			int16_t delta = getw();
+			loop_pc   = pc + delta;
+			startoff  = re_interpreter_in_reloffset(self);
+			retonfail = opcode == REOP_SPAN_AND_RETURN_ONFAIL ||
+			            opcode == REOP_SPAN_LIT_AND_RETURN_ONFAIL;
+			done      = re_interpreter_span(self, loop_pc);
+			if (done && (opcode == REOP_SPAN_LIT || opcode == REOP_SPAN_LIT_AND_RETURN_ONFAIL)) {
+				/* Go straight to the last place where the literal that follows appears. */
+				if (!re_interpreter_span_seek(self, loop_pc, pc,
+				                              retonfail ? self->ri_exec->rx_startoff + startoff
+				                                        : re_interpreter_in_curoffset(self)))
+					ONFAIL();
+			}
+			endoff = re_interpreter_in_reloffset(self);
+			if (retonfail && endoff > startoff) {
+				/* Every  offset in `startoff...endoff' must  be tried when code after
+				 * the loop fails. Rather than pushing 1 item for each of them, push
+				 * the offset of the last one tried, and let `onfail' give back one
+				 * character at a time (s.a. `RE_ONFAILURE_ITEM_SPAN'). */
+				PUSHFAIL_EX(RE_ONFAILURE_ITEM_RESUME, endoff, PCOFF(pc));
+				PUSHFAIL_EX(RE_ONFAILURE_ITEM_SPAN, startoff, PCOFF(loop_pc));
+			}
+			if (!done) {
+				/* Stopped early -> match the next repetition the normal way. */
+				PUSHFAIL(pc);
+				pc = loop_pc;
+				DISPATCH();
+			}
+
+			/* Same as resuming the item that a normal loop would have pushed last. */
+			if (!(self->ri_flags & RE_INTERPRETER_F_MEMOOFF)) {
+				size_t memo = re_interpreter_memo_index(self, pc);
+				if (memo != (size_t)-1) {
+					self->ri_flags |= RE_INTERPRETER_F_MEMOUSED;
+					if (re_interpreter_memo_test(self, memo))
+						ONFAIL();
+					PUSHFAIL_EX(RE_ONFAILURE_ITEM_MEMO, (uint32_t)memo, 0);
+				}
+			}
+			DISPATCH();
+		}
+
+		TARGET(REOP_DEC_JMP) {
+			byte_t varid = getb();
+			int16_t delta = getw();
+			assert(varid < self->ri_exec->rx_code->rc_nvars);
+			if (self->ri_vars[varid] != 0) {
+				--self->ri_vars[varid];
+				pc += delta;
+				DISPATCH();
+			}
+			DISPATCH();
+		}
+
+		TARGET(REOP_DEC_JMP_AND_RETURN_ONFAIL) {
+			byte_t varid = getb();
+			int16_t delta = getw();
+			assert(varid < self->ri_exec->rx_code->rc_nvars);
+			if (self->ri_vars[varid] != 0) {
+				--self->ri_vars[varid];
+				PUSHFAIL(pc);
+				pc += delta;
+				DISPATCH();
+			}
+			DISPATCH();
+		}
+
+		TARGET(REOP_SETVAR) {
+			byte_t varid = getb();
+			byte_t value = getb();
+			assert(varid < self->ri_exec->rx_code->rc_nvars);
+			/* Assign value to variable */
+			self->ri_vars[varid] = value;
+			DISPATCH();
+		}
+
+		TARGET(REOP_NOP) {
+			DISPATCH();
+		}
+
+		TARGET(REOP_MATCHED) {
+			/* Which paths to this opcode were skipped matters when group offsets are wanted */
+			if ((self->ri_flags & RE_INTERPRETER_F_MEMOUSED) && self->ri_exec->rx_nmatch != 0)
+				goto memo_redo;
+
+			/* Compare with a previous match. */
+			if (self->ri_onfailc != 0) {
+				/* Check if our current match is the best it can get. */
+				if (re_interpreter_is_eoi(self)) {
+					/* No need to keep going! -- It can't get any better than this.
+					 *
+					 * BUT: if the caller  also wants  group matches, we  have to  find
+					 *      the best one of those, also (so no early exit in that case) */
+					if (self->ri_exec->rx_nmatch == 0)
+						return -RE_NOERROR;
+				}
+
+				/* Still have to roll back in order test more code-paths
+				 * -> In  this case,  check if  the current  match is better
+				 *    than the previous best match, and replace the previous
+				 *    one if the new one is better. */
+				if (!best_match_isvalid() ||
+				    ((re_interpreter_in_curoffset_or_ptr(self) > re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch)) ||
+				     (re_interpreter_in_curoffset_or_ptr(self) == re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch) &&
+				      (self->ri_exec->rx_nmatch && is_regmatch_better(self->ri_pmatch, self->ri_bmatch_g,
+				                                                      self->ri_exec->rx_code->rc_ngrps))))) {
+					struct re_exec const *exec;
+					/* Check if also have to  save the current state of  group-matches
+					 * This is only necessary if the caller wants us to produce group-
+					 * range match offsets. */
+					exec = self->ri_exec;
+					if (exec->rx_nmatch) {
+						if (!best_match_isvalid()) {
+							self->ri_bmatch_g = (re_regmatch_t *)alloca(exec->rx_code->rc_ngrps *
+							                                            sizeof(re_regmatch_t));
+						}
+						memcpyc(self->ri_bmatch_g, self->ri_pmatch,
+						        exec->rx_code->rc_ngrps,
+						        sizeof(re_regmatch_t));
+					}
+					self->ri_bmatch = self->ri_in;
+				}
+				ONFAIL();
+			}
+
+			/* No more on-fail branches
+			 * -> check  if the current match is better than the best. If
+			 *    it isn't, then restore the best match before returning. */
+			if (best_match_isvalid() &&
+			    ((re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch) > re_interpreter_in_curoffset_or_ptr(self)) ||
+			     (re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch) == re_interpreter_in_curoffset_or_ptr(self) &&
+			      (self->ri_exec->rx_nmatch && is_regmatch_better(self->ri_bmatch_g, self->ri_pmatch,
+			                                                      self->ri_exec->rx_code->rc_ngrps))))) {
+return_best_match:
+				self->ri_in = self->ri_bmatch;
+				if (self->ri_exec->rx_nmatch) {
+					/* Must also restore the current state of group-matches */
+					memcpyc(self->ri_pmatch, self->ri_bmatch_g,
+					        self->ri_exec->rx_code->rc_ngrps,
+					        sizeof(re_regmatch_t));
+				}
+			}
+			/* Fallthru to the PERFECT_MATCH opcode */
+			return -RE_NOERROR;
+		}
+
+		TARGET(REOP_MATCHED_PERFECT) {
+			/* The first match found depends on which paths were skipped */
+			if (self->ri_flags & RE_INTERPRETER_F_MEMOUSED)
+				goto memo_redo;
+
+			/* Just indicate success for the current match! */
+			return -RE_NOERROR;
+		}
+
+	default:
+		__builtin_unreachable();
+		break;
+	}
+	__builtin_unreachable();
+	{
+		struct re_onfailure_item *item;
+		size_t memo;
+onfail:
+		if (self->ri_onfailc <= 0) {
+			/* If there was a match, then return it. */
+			if (best_match_isvalid())
+				goto return_best_match;
+			if (self->ri_flags & RE_INTERPRETER_F_RSGRPS) {
+				/* Regular match fail while doing a search -> must reset groups. */
+				memsetc(self->ri_pmatch, RE_REGOFF_UNSET,
+				        self->ri_exec->rx_code->rc_ngrps * 2,
+				        sizeof(re_regoff_t));
+			}
+			self->ri_flags &= ~RE_INTERPRETER_F_MEMODIRTY;
+			return -RE_NOMATCH;
+		}
+		item = &self->ri_onfailv[--self->ri_onfailc];
+		/* Check for special on-fail stack items. */
+		if (RE_ONFAILURE_ITEM_SPECIAL_CHECK(item->rof_tag)) {
+			re_regoff_t regoff;
+			uint8_t gid;
+			if (item->rof_tag == RE_ONFAILURE_ITEM_DUMMY ||
+			    item->rof_tag == RE_ONFAILURE_ITEM_DUMMY_AT)
+				goto onfail; /* Skip dummy on-fail stack element. */
+			if (item->rof_tag == RE_ONFAILURE_ITEM_MEMO) {
+				/* Everything reachable from a (pc, offset) pair was tried. */
+				if (!(self->ri_flags & RE_INTERPRETER_F_MEMOOFF))
+					re_interpreter_memo_set(self, item->rof_in);
+				goto onfail;
+			}
+			if (item->rof_tag == RE_ONFAILURE_ITEM_SPAN) {
+				/* Give back (at least) 1 character of a `REOP_SPAN[_LIT]_AND_RETURN_ONFAIL' */
+				struct re_onfailure_item *resume = item - 1;
+				byte_t const *loop_pc = codebase + item->rof_pc;
+				assert(self->ri_onfailc >= 1);
+				assert(resume->rof_tag == RE_ONFAILURE_ITEM_RESUME);
+				pc = codebase + resume->rof_pc;
+				if (resume->rof_in > item->rof_in) {
+					re_interpreter_setreloffset(self, resume->rof_in);
+					re_interpreter_span_unget(self, loop_pc);
+					if (pc[-3] != REOP_SPAN_LIT_AND_RETURN_ONFAIL ||
+					    re_interpreter_span_seek(self, loop_pc, pc, self->ri_exec->rx_startoff + item->rof_in)) {
+						resume->rof_in = re_interpreter_in_reloffset(self);
+						++self->ri_onfailc;
+						if (!(self->ri_flags & RE_INTERPRETER_F_MEMOOFF)) {
+							memo = re_interpreter_memo_index(self, pc);
+							if (memo != (size_t)-1) {
+								self->ri_flags |= RE_INTERPRETER_F_MEMOUSED;
+								if (re_interpreter_memo_test(self, memo))
+									goto onfail;
+								PUSHFAIL_EX(RE_ONFAILURE_ITEM_MEMO, (uint32_t)memo, 0);
+							}
+						}
+						DISPATCH();
+					}
+				}
+				--self->ri_onfailc; /* Every offset was tried */
+				goto onfail;
+			}
+
+			/* Restore group start/end offset. */
+			gid = RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(item->rof_tag);
+			assert(gid < self->ri_exec->rx_code->rc_ngrps);
+			regoff = (re_regoff_t)item->rof_in;
+			if (RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(item->rof_tag)) {
+				TRACE("%d: ri_pmatch[%" PRIu8 "].rm_so = %d\n", __LINE__, gid, (int)(re_sregoff_t)regoff);
+				self->ri_pmatch[gid].rm_so = regoff;
+			} else {
+				TRACE("%d: ri_pmatch[%" PRIu8 "].rm_eo = %d\n", __LINE__, gid, (int)(re_sregoff_t)regoff);
+				self->ri_pmatch[gid].rm_eo = regoff;
+			}
+			goto onfail;
+		}
+		pc = codebase + item->rof_pc;
+		re_interpreter_setreloffset(self, item->rof_in);
+		/* Don't resume at a (pc, offset) pair from where everything was already tried.
+		 * Otherwise, replace the item with one that remembers the pair once that's the
+		 * case (or forgets about it if the pair's code pops items from below it). */
+		if (!(self->ri_flags & RE_INTERPRETER_F_MEMOOFF)) {
+			memo = re_interpreter_memo_index(self, pc);
+			if (memo != (size_t)-1) {
+				self->ri_flags |= RE_INTERPRETER_F_MEMOUSED;
+				if (re_interpreter_memo_test(self, memo))
+					goto onfail;
+				item->rof_in  = (uint32_t)memo;
+				item->rof_tag = RE_ONFAILURE_ITEM_MEMO;
+				++self->ri_onfailc;
+			}
+		}
+		DISPATCH();
+	}
+	__builtin_unreachable();
+memo_redo:
+	/* A match was found after paths were skipped by the memo. That's fine when only
+	 * the longest match is wanted (everything skipped is already known to end in the
+	 * same places), but which match gets produced otherwise depends on exactly what
+	 * was tried before it -> do it all again, but without skipping anything. */
+	self->ri_flags &= ~RE_INTERPRETER_F_MEMOUSED;
+	self->ri_flags |= RE_INTERPRETER_F_MEMOOFF;
+	self->ri_onfailc = 0;
+	self->ri_in      = startin;
+	pc               = startpc;
+	memcpyc(self->ri_pmatch, startgroups, self->ri_exec->rx_code->rc_ngrps, sizeof(re_regmatch_t));
+	goto memo_restart;
+	__builtin_unreachable();
+err_nomem:
+	/* Check for special case: on-fail stack got too large. */
+	if (self->ri_onfailc >= self->ri_onfaila &&
+	    self->ri_onfailc > 0 &&
+	    self->ri_onfaila >= get_re_max_failures())
+		return -RE_ESIZE;
+	return -RE_ESPACE;
+#undef PUSHFAIL_EX
+#undef PUSHFAIL_DUMMY
+#undef PUSHFAIL
+#undef XTARGET
+#undef TARGET
+#undef ONFAIL
+#undef DISPATCH
+#undef THREADED_LABEL
+#undef getw
+#undef getb
+}
+
+#undef LOCAL_THREADED_DISPATCH
+#undef LOCAL_WITH_JIT
+#undef LOCAL_libre_interp_exec
+
+DECL_END
+
+#undef DEFINE_libre_interp_exec_jit
+#undef DEFINE_libre_interp_exec
@@ -33,6 +33,7 @@ options["COMPILE.language"] = "c";
 #ifndef LIBREGEX_NO_SYSTEM_INCLUDES
 #include <hybrid/compiler.h>
 
+#include <hybrid/align.h>
 #include <hybrid/minmax.h>
 #include <hybrid/overflow.h>
 #include <hybrid/unaligned.h>
@@ -47,6 +48,7 @@ options["COMPILE.language"] = "c";
 #include <malloc.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unicode.h>
 
@@ -60,16 +62,26 @@ options["COMPILE.language"] = "c";
 #endif
 #endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
 
+#include "regcomp.h"
+#include "regdfa.h"
 #include "regexec.h"
+#include "reginterp.h"
+#include "regjit.h"
+#include "regpike.h"
 
 #ifndef TRACE
 #undef HAVE_TRACE
 #define TRACE(...) (void)0
 #endif /* !TRACE */
 
-DECL_BEGIN
+/* Every handler of `libre_interp_exec()' jumps to the next opcode's handler by itself,
+ * rather than going through a shared `switch' (s.a. `DISPATCH()'). That way, the CPU
+ * gets to predict the next opcode separately for every opcode that came before it. */
+#if defined(__GNUC__) && !defined(LIBREGEX_REGEXEC_NO_THREADED_DISPATCH)
+#define HAVE_THREADED_DISPATCH
+#endif /* __GNUC__ && !LIBREGEX_REGEXEC_NO_THREADED_DISPATCH */
 
-#define ascii_islf(ch) ((ch) == '\r' || (ch) == '\n')
+DECL_BEGIN
 
 #if !defined(NDEBUG) && !defined(NDEBUG_FINI)
 #define DBG_memset(p, c, n) memset(p, c, n)
@@ -77,573 +89,37 @@ DECL_BEGIN
 #define DBG_memset(p, c, n) (void)0
 #endif /* NDEBUG || NDEBUG_FINI */
 
-#define delta16_get(p) ((int16_t)UNALIGNED_GET16(p))
-
-#define RE_ONFAILURE_ITEM_DUMMY_INPTR                         ((byte_t const *)512) /* == 256 * 2 (256 being the max # of groups per pattern, and 2 being the # of offsets per group) */
-#define RE_ONFAILURE_ITEM_SPECIAL_CHECK(inptr)                ((uintptr_t)(inptr) <= (uintptr_t)RE_ONFAILURE_ITEM_DUMMY_INPTR)
-#define RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(inptr)          ((uintptr_t)(inptr) < (uintptr_t)RE_ONFAILURE_ITEM_DUMMY_INPTR)
-#define RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(inptr)        ((uintptr_t)(inptr) & 1)
-#define RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(inptr)         ((uint8_t)((uintptr_t)(inptr) >> 1))
-#define RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE(is_start, gid) ((byte_t const *)(uintptr_t)(((gid) << 1) | (is_start)))
-
-struct re_onfailure_item {
-	byte_t const *rof_in; /* [0..1] Input data pointer to restore (points into some input buffer)
-	                       * - Set to `RE_ONFAILURE_ITEM_DUMMY_INPTR' for dummy on-fail items.
-	                       * - Set to `RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE()' if `rof_pc' encodes
-	                       *   the start- or end-offset that should be restored for a group on fail. */
-	byte_t const *rof_pc; /* [1..1] Program counter to restore
-	                       * NOTE: only used for identification when `rof_in == RE_ONFAILURE_ITEM_DUMMY_INPTR' */
-};
-
-struct re_interpreter_inptr {
-	byte_t const       *ri_in_ptr;    /* [<= ri_in_cend] Current input pointer. */
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-	byte_t const       *ri_in_cend;   /* End of the current input chunk */
-	byte_t const       *ri_in_cbase;  /* [0..1] Original base pointer of current input IOV chunk */
-	byte_t const       *ri_in_vbase;  /* [0..1] Virtual base pointer of current input IOV chunk (such that `ri_in_ptr - ri_in_vbase'
-	                                   * produces offsets compatible with `struct re_exec::rx_startoff' and the like, including  the
-	                                   * start/end offsets stored in `ri_pmatch') */
-	struct iovec const *ri_in_miov;   /* [0..*] Further input chunks that have yet to be loaded. (current chunk originates from `ri_in_miov[-1]') */
-	size_t              ri_in_mcnt;   /* # of remaining bytes in buffers described by `ri_in_miov[*]' */
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-};
-
-struct re_interpreter {
-	union {
-		struct re_interpreter_inptr ri_in;        /* Input pointer controller. */
-		struct {
-			byte_t const           *ri_in_ptr;    /* [<= ri_in_cend] Current input pointer. */
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-			byte_t const           *ri_in_cend;   /* End of the current input chunk */
-			byte_t const           *ri_in_cbase;  /* [0..1] Original base pointer of current input IOV chunk */
-			byte_t const           *ri_in_vbase;  /* [0..1] Virtual base pointer of current input IOV chunk (such that `ri_in_ptr - ri_in_vbase'
-			                                       * produces offsets compatible with `struct re_exec::rx_startoff' and the like, including  the
-			                                       * start/end offsets stored in `ri_pmatch') */
-			struct iovec const     *ri_in_miov;   /* [0..*] Further input chunks that have yet to be loaded. (current chunk originates from `ri_in_miov[-1]') */
-			size_t                  ri_in_mcnt;   /* # of remaining bytes in buffers described by `ri_in_miov[*]' */
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-		}; /* TODO: Support for no-transparent-struct */
-	};     /* TODO: Support for no-transparent-union */
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define ri_in_vbase ri_in_cbase
-	byte_t const                   *ri_in_cbase;  /* [== ri_exec->rx_inbase] */
-	byte_t const                   *ri_in_cend;   /* [== ri_exec->rx_inbase + ri_exec->rx_endoff] */
-	byte_t const                   *ri_in_vend;   /* [== ri_exec->rx_inbase + ri_exec->rx_insize] */
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-	struct iovec const             *ri_in_biov;   /* [0..*][<= ri_in_miov][const] Initial iov vector base (== `struct re_exec::rx_iov') */
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-	struct re_exec const           *ri_exec;      /* [1..1][const] Regex exec command block. */
-	re_regmatch_t                  *ri_pmatch;    /* [1..ri_exec->rx_code->rc_ngrps][const] Group match start/end offset register buffer (owned if caller-provided buffer is too small). */
-	struct re_onfailure_item       *ri_onfailv;   /* [0..ri_onfailc][owned(free)] On-failure stack */
-	size_t                          ri_onfailc;   /* [<= ri_onfaila] # of elements on the on-failure stack */
-	size_t                          ri_onfaila;   /* Allocated # of elements of `ri_onfailv' */
-	struct re_interpreter_inptr     ri_bmatch;    /* USED INTERNALLY: pending best match */
-	re_regmatch_t                  *ri_bmatch_g;  /* [1..ri_exec->rx_code->rc_ngrps]
-	                                               * [valid_if(best_match_isvalid() && ri_exec->rx_nmatch != 0)]
-	                                               * Group match buffer for `ri_bmatch' */
-	byte_t                          ri_flags;     /* Execution flags (set of `RE_INTERPRETER_F_*') */
-#define RE_INTERPRETER_F_NORMAL     0x00          /* NORMAL flags */
-#define RE_INTERPRETER_F_RSGRPS     0x01          /* ResetGRouPS (on fail) -- must be set when wanting to re-use the interpreter in searches */
-	COMPILER_FLEXIBLE_ARRAY(byte_t, ri_vars);     /* [ri_exec->rx_code->rc_nvars] Space for variables used by code. */
-};
-
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_inptr_in_advance1(self)  (++(self)->ri_in_ptr)
-#define re_interpreter_inptr_in_reverse1(self)  (--(self)->ri_in_ptr)
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_inptr_in_advance1(self)                                                           \
-	(unlikely((self)->ri_in_ptr >= (self)->ri_in_cend) ? re_interpreter_inptr_nextchunk(self) : (void)0, \
-	 ++(self)->ri_in_ptr)
-#define re_interpreter_inptr_in_reverse1(self)                                                            \
-	(unlikely((self)->ri_in_ptr <= (self)->ri_in_cbase) ? re_interpreter_inptr_prevchunk(self) : (void)0, \
-	 --(self)->ri_in_ptr)
-#define re_interpreter_in_chunkcontains(self, inptr) \
-	((inptr) >= re_interpreter_in_chunkbase(self) && \
-	 (inptr) <= re_interpreter_in_chunkend(self)) /* yes: '<=', because inptr == end-of-chunk means epsilon (in case of the last chunk) */
-#define re_interpreter_in_isfirstchunk(self)    ((self)->ri_in_miov <= (self)->ri_in_biov + 1)           /* True if in first chunk */
-#define re_interpreter_in_islastchunk(self)     ((self)->ri_in_mcnt <= 0)                                /* True if in last chunk */
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-#define re_interpreter_in_chunk_cangetc(self)   ((self)->ri_in_ptr < (self)->ri_in_cend)                 /* True if not at end of current chunk */
-#define re_interpreter_in_chunk_canungetc(self) ((self)->ri_in_ptr > (self)->ri_in_cbase)                /* True if not at start of current chunk */
-#define re_interpreter_in_chunkdone(self)       ((size_t)((self)->ri_in_ptr - (self)->ri_in_cbase))      /* Bytes already processed from current chunk */
-#define re_interpreter_in_chunkleft(self)       ((size_t)((self)->ri_in_cend - (self)->ri_in_ptr))       /* Bytes left to read from current chunk */
-#define re_interpreter_in_chunkbase(self)       ((self)->ri_in_cbase)                                    /* Current chunk base pointer */
-#define re_interpreter_in_chunkend(self)        ((self)->ri_in_cend)                                     /* Current chunk end pointer */
-#define re_interpreter_in_chunksize(self)       ((size_t)((self)->ri_in_cend - (self)->ri_in_cbase))     /* Total size of current chunk */
-#define re_interpreter_in_chunkoffset(self)     ((size_t)((self)->ri_in_cbase - (self)->ri_in_vbase))    /* Offset of the currently loaded chunk */
-#define re_interpreter_in_chunkendoffset(self)  ((size_t)((self)->ri_in_cend - (self)->ri_in_vbase))     /* Offset at the end of the currently loaded chunk */
-#define re_interpreter_in_curoffset(self)       ((size_t)((self)->ri_in_ptr - (self)->ri_in_vbase))      /* Current offset from start of initial chunk */
-#define re_interpreter_in_totalleft(self)       (re_interpreter_in_chunkleft(self) + (self)->ri_in_mcnt) /* Total # of bytes of input left */
-#define re_interpreter_in_totalleftX(self)      (re_interpreter_in_totalleft(self) + (self)->ri_exec->rx_extra)
-
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_in_curoffset_or_ptr(self) (self)->ri_in_ptr
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_in_curoffset_or_ptr(self) re_interpreter_in_curoffset(self)
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_is_soi(self)  ((self)->ri_in_ptr <= (self)->ri_in_vbase)
-#define re_interpreter_is_eoi(self)  ((self)->ri_in_ptr >= (self)->ri_in_cend)
-#define re_interpreter_is_eoiX(self) ((self)->ri_in_ptr >= (self)->ri_in_vend)
-#define re_interpreter_is_eoi_at_end_of_chunk re_interpreter_is_eoi
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_is_soi(self)  ((self)->ri_in_ptr == (self)->ri_in_vbase) /* Must compare `==' in case `ri_in_vbase' had an underflow (`<' w/o underflow would already be an illegal state!) */
-#define re_interpreter_is_eoi(self)  ((self)->ri_in_ptr >= (self)->ri_in_cend && (self)->ri_in_mcnt <= 0)
-#define re_interpreter_is_eoiX(self) ((self)->ri_in_ptr >= (self)->ri_in_cend && (self)->ri_in_mcnt <= 0 && (self)->ri_exec->rx_extra <= 0)
-#define re_interpreter_is_eoi_at_end_of_chunk(self) ((self)->ri_in_mcnt <= 0)
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-static_assert(offsetof(struct re_interpreter_inptr, ri_in_ptr) == offsetof(struct re_interpreter_inptr, ri_in_ptr));
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-static_assert(offsetof(struct re_interpreter_inptr, ri_in_cend) == offsetof(struct re_interpreter_inptr, ri_in_cend));
-static_assert(offsetof(struct re_interpreter_inptr, ri_in_cbase) == offsetof(struct re_interpreter_inptr, ri_in_cbase));
-static_assert(offsetof(struct re_interpreter_inptr, ri_in_vbase) == offsetof(struct re_interpreter_inptr, ri_in_vbase));
-static_assert(offsetof(struct re_interpreter_inptr, ri_in_miov) == offsetof(struct re_interpreter_inptr, ri_in_miov));
-static_assert(offsetof(struct re_interpreter_inptr, ri_in_mcnt) == offsetof(struct re_interpreter_inptr, ri_in_mcnt));
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Load the next chunk into `self' */
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_nextchunk(self) \
-	re_interpreter_inptr_nextchunk(&(self)->ri_in)
-PRIVATE NONNULL((1)) void
-NOTHROW_NCX(CC re_interpreter_inptr_nextchunk)(struct re_interpreter_inptr *__restrict self) {
-	struct iovec nextchunk;
-	size_t old_chunk_endoffset;
-	/* vvv This wouldn't account for `struct re_exec::rx_extra'! */
-	/*assertf(self->ri_in_mcnt != 0, "No further chunks can be loaded");*/
-	old_chunk_endoffset = re_interpreter_in_chunkendoffset(self);
-	do {
-		nextchunk = *self->ri_in_miov++;
-	} while (nextchunk.iov_len == 0); /* Skip over empty chunks */
-	if (nextchunk.iov_len > self->ri_in_mcnt)
-		nextchunk.iov_len = self->ri_in_mcnt;
-	self->ri_in_mcnt -= nextchunk.iov_len;
-	self->ri_in_ptr   = (byte_t const *)nextchunk.iov_base;
-	self->ri_in_cend  = (byte_t const *)nextchunk.iov_base + nextchunk.iov_len;
-	self->ri_in_cbase = (byte_t const *)nextchunk.iov_base;
-	self->ri_in_vbase = (byte_t const *)nextchunk.iov_base - old_chunk_endoffset;
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Load the previous chunk into `self' */
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_prevchunk(self) \
-	re_interpreter_inptr_prevchunk(&(self)->ri_in)
-PRIVATE NONNULL((1)) void
-NOTHROW_NCX(CC re_interpreter_inptr_prevchunk)(struct re_interpreter_inptr *__restrict self) {
-	struct iovec prevchunk;
-	size_t old_chunk_startoffset;
-	size_t new_chunk_startoffset;
-	old_chunk_startoffset = re_interpreter_in_chunkoffset(self);
-	self->ri_in_mcnt += re_interpreter_in_chunksize(self);
-	do {
-		prevchunk = self->ri_in_miov[-2]; /* [-1] would be the current chunk... */
-		--self->ri_in_miov;
-	} while (prevchunk.iov_len == 0); /* Skip over empty chunks */
-	new_chunk_startoffset = old_chunk_startoffset - prevchunk.iov_len;
-	self->ri_in_ptr   = (byte_t const *)prevchunk.iov_base + prevchunk.iov_len;
-	self->ri_in_cend  = (byte_t const *)prevchunk.iov_base + prevchunk.iov_len;
-	self->ri_in_cbase = (byte_t const *)prevchunk.iov_base;
-	self->ri_in_vbase = (byte_t const *)prevchunk.iov_base - new_chunk_startoffset;
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_advance(self, num_bytes)       (void)((self)->ri_in_ptr += (num_bytes))
-#define re_interpreter_inptr_advance(self, num_bytes) (void)((self)->ri_in_ptr += (num_bytes))
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_advance(self, num_bytes) \
-	re_interpreter_inptr_advance(&(self)->ri_in, num_bytes)
-PRIVATE NONNULL((1)) void
-NOTHROW_NCX(CC re_interpreter_inptr_advance)(struct re_interpreter_inptr *__restrict self,
-                                             size_t num_bytes) {
-again:
-	if likely(num_bytes <= re_interpreter_in_chunkleft(self)) {
-		self->ri_in_ptr += num_bytes;
-	} else {
-		num_bytes -= re_interpreter_in_chunkleft(self);
-		re_interpreter_inptr_nextchunk(self);
-		goto again;
-	}
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_reverse(self, num_bytes)       (void)((self)->ri_in_ptr -= (num_bytes))
-#define re_interpreter_inptr_reverse(self, num_bytes) (void)((self)->ri_in_ptr -= (num_bytes))
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_reverse(self, num_bytes) \
-	re_interpreter_inptr_reverse(&(self)->ri_in, num_bytes)
-PRIVATE NONNULL((1)) void
-NOTHROW_NCX(CC re_interpreter_inptr_reverse)(struct re_interpreter_inptr *__restrict self,
-                                             size_t num_bytes) {
-again:
-	if likely(num_bytes <= re_interpreter_in_chunkdone(self)) {
-		self->ri_in_ptr -= num_bytes;
-	} else {
-		num_bytes -= re_interpreter_in_chunkdone(self);
-		re_interpreter_inptr_prevchunk(self);
-		goto again;
-	}
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-
-/* Return the previous byte from input */
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_prevbyte(self)       (self)->ri_in_ptr[-1]
-#define re_interpreter_inptr_prevbyte(self) (self)->ri_in_ptr[-1]
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_prevbyte(self) \
-	(likely(re_interpreter_in_chunk_canungetc(self)) ? (self)->ri_in_ptr[-1] : _re_interpreter_inptr_prevbyte(&(self)->ri_in))
-#define re_interpreter_inptr_prevbyte(self) \
-	(likely(re_interpreter_in_chunk_canungetc(self)) ? (self)->ri_in_ptr[-1] : _re_interpreter_inptr_prevbyte(self))
-PRIVATE WUNUSED NONNULL((1)) byte_t
-NOTHROW_NCX(CC _re_interpreter_inptr_prevbyte)(struct re_interpreter_inptr const *__restrict self) {
-	struct iovec const *iov;
-	iov = self->ri_in_miov - 2; /* -1 would be the current chunk */
-	while (iov->iov_len == 0)
-		--iov; /* Skip over empty chunks */
-	return ((byte_t const *)iov->iov_base)[iov->iov_len - 1];
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Return the next byte that will be read from input */
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_nextbyte(self)       (*(self)->ri_in_ptr)
-#define re_interpreter_inptr_nextbyte(self) (*(self)->ri_in_ptr)
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_nextbyte(self) \
-	(likely(re_interpreter_in_chunk_cangetc(self)) ? *(self)->ri_in_ptr : _re_interpreter_inptr_nextbyte(&(self)->ri_in))
-#define re_interpreter_inptr_nextbyte(self) \
-	(likely(re_interpreter_in_chunk_cangetc(self)) ? *(self)->ri_in_ptr : _re_interpreter_inptr_nextbyte(self))
-PRIVATE WUNUSED NONNULL((1)) byte_t
-NOTHROW_NCX(CC _re_interpreter_inptr_nextbyte)(struct re_interpreter_inptr const *__restrict self) {
-	struct iovec const *iov;
-	/* vvv This wouldn't account for `struct re_exec::rx_extra'! */
-	/*assertf(self->ri_in_mcnt != 0, "No further chunks can be loaded");*/
-	iov = self->ri_in_miov;
-	while (iov->iov_len == 0)
-		++iov; /* Skip over empty chunks */
-	return *(byte_t const *)iov->iov_base;
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Peek memory that has been read in the past, copying up to `max_bytes' bytes of it into `buf'. */
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-PRIVATE WUNUSED NONNULL((1)) size_t
-NOTHROW_NCX(CC re_interpreter_peekmem_bck)(struct re_interpreter const *__restrict self,
-                                           void *buf, size_t max_bytes) {
-	size_t avail, result;
-	size_t total_prev = re_interpreter_in_curoffset(self);
-	byte_t *dst = (byte_t *)buf + max_bytes;
-	if (max_bytes > total_prev)
-		max_bytes = total_prev;
-	result = max_bytes;
-	avail  = re_interpreter_in_chunkdone(self);
-	if (avail > max_bytes)
-		avail = max_bytes;
-	dst -= avail;
-	max_bytes -= avail;
-	memcpy(dst, self->ri_in_ptr, avail);
-	if (max_bytes) {
-		struct iovec const *iov = self->ri_in_miov - 2; /* -1 would be the current chunk */
-		do {
-			avail = iov->iov_len;
-			if (avail > max_bytes)
-				avail = max_bytes;
-			dst -= avail;
-			memcpy(dst, (byte_t *)iov->iov_base + iov->iov_len - avail, avail);
-			max_bytes -= avail;
-			++iov;
-		} while (max_bytes);
-	}
-	if (dst > (byte_t *)buf)
-		memmovedown(dst, buf, max_bytes);
-	return result;
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Peek memory that will be read in the future, copying up to `max_bytes' bytes of it into `buf'.
- * NOTE: This function also allows access to trailing `rx_extra' extra bytes. */
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-PRIVATE WUNUSED NONNULL((1)) size_t
-NOTHROW_NCX(CC re_interpreter_peekmem_fwd)(struct re_interpreter const *__restrict self,
-                                           void *buf, size_t max_bytes) {
-	size_t avail, result;
-	size_t total_left = re_interpreter_in_totalleftX(self);
-	if (max_bytes > total_left)
-		max_bytes = total_left;
-	result = max_bytes;
-	avail  = re_interpreter_in_chunkleft(self);
-	if (avail > max_bytes)
-		avail = max_bytes;
-	buf = mempcpy(buf, self->ri_in_ptr, avail);
-	max_bytes -= avail;
-	if (max_bytes) {
-		struct iovec const *iov = self->ri_in_miov;
-		do {
-			avail = iov->iov_len;
-			if (avail > max_bytes)
-				avail = max_bytes;
-			buf = mempcpy(buf, iov->iov_base, avail);
-			max_bytes -= avail;
-			++iov;
-		} while (max_bytes);
-	}
-	return result;
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Return the previous utf-8 character from input */
-PRIVATE WUNUSED NONNULL((1)) char32_t
-NOTHROW_NCX(CC re_interpreter_prevutf8)(struct re_interpreter const *__restrict self) {
-	if likely(re_interpreter_in_chunk_canungetc(self)) {
-		byte_t prevbyte = self->ri_in_ptr[-1];
-		if likely(prevbyte < 0x80)
-			return prevbyte;
-		if likely((self->ri_in_ptr - UNICODE_UTF8_CURLEN) <= self->ri_in_cbase) {
-			/* Can just read the entire character from the current chunk */
-			char const *reader = (char const *)self->ri_in_ptr;
-			return unicode_readutf8_rev(&reader);
-		}
-	}
-
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-	if likely(re_interpreter_in_isfirstchunk(self))
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-	{
-		/* First chunk -> just read a restricted-length unicode character */
-		char const *reader = (char const *)self->ri_in_ptr;
-		assert(reader > (char const *)self->ri_in_cbase);
-		return unicode_readutf8_rev_n(&reader, (char const *)self->ri_in_cbase);
-	}
-
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-	/* Fallback: copy memory into a temporary buffer. */
-	{
-		size_t utf8_len;
-		char utf8[UNICODE_UTF8_CURLEN], *reader;
-		utf8_len = re_interpreter_peekmem_bck(self, utf8, sizeof(utf8));
-		reader   = utf8 + utf8_len;
-		assert(utf8_len != 0);
-		return unicode_readutf8_rev_n((char const **)&reader, utf8);
-	}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-}
-
-/* Return the next utf-8 character that will be read from input */
-PRIVATE WUNUSED NONNULL((1)) char32_t
-NOTHROW_NCX(CC re_interpreter_nextutf8)(struct re_interpreter const *__restrict self) {
-	if likely(re_interpreter_in_chunk_cangetc(self)) {
-		uint8_t seqlen;
-		byte_t nextbyte = *self->ri_in_ptr;
-		if likely(nextbyte < 0x80)
-			return nextbyte;
-		seqlen = unicode_utf8seqlen[nextbyte];
-		if unlikely(!seqlen)
-			return nextbyte; /* Dangling follow-up byte? */
-		if likely((self->ri_in_ptr + seqlen) <= self->ri_in_cend) {
-			/* Can just read the entire character from the current chunk */
-			char const *reader = (char const *)self->ri_in_ptr;
-			return unicode_readutf8(&reader);
-		}
-	}
-
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-	if likely(re_interpreter_in_islastchunk(self))
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-	{
-		/* Last chunk -> just read a restricted-length unicode character */
-		char const *reader = (char const *)self->ri_in_ptr;
-		assert(reader < (char const *)self->ri_in_cend);
-		return unicode_readutf8_n(&reader, (char const *)self->ri_in_cend);
-	}
-
-#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-	/* Fallback: copy memory into a temporary buffer. */
-	{
-		size_t utf8_len;
-		char utf8[UNICODE_UTF8_CURLEN], *reader;
-		utf8_len = re_interpreter_peekmem_fwd(self, utf8, sizeof(utf8));
-		reader   = utf8;
-		assert(utf8_len != 0);
-		return unicode_readutf8_n((char const **)&reader, utf8 + utf8_len);
-	}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-}
-
-
-/* Read a byte whilst advancing the input pointer. */
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_readbyte(self)       (*(self)->ri_in_ptr++)
-#define re_interpreter_inptr_readbyte(self) (*(self)->ri_in_ptr++)
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-#define re_interpreter_readbyte(self)                                                              \
-	(unlikely((self)->ri_in_ptr >= (self)->ri_in_cend) ? re_interpreter_nextchunk(self) : (void)0, \
-	 *(self)->ri_in_ptr++)
-#define re_interpreter_inptr_readbyte(self)                                                              \
-	(unlikely((self)->ri_in_ptr >= (self)->ri_in_cend) ? re_interpreter_inptr_nextchunk(self) : (void)0, \
-	 *(self)->ri_in_ptr++)
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Read a utf-8 character whilst advancing the input pointer. */
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_readutf8(self) \
-	unicode_readutf8_n((char const **)&(self)->ri_in_ptr, (char const *)(self)->ri_in_cend)
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-PRIVATE NONNULL((1)) char32_t
-NOTHROW_NCX(CC re_interpreter_readutf8)(struct re_interpreter *__restrict self) {
-	uint8_t seqlen;
-	byte_t nextbyte;
-	if unlikely(!re_interpreter_in_chunk_cangetc(self))
-		re_interpreter_inptr_nextchunk(&self->ri_in);
-
-	nextbyte = *self->ri_in_ptr;
-	if likely(nextbyte < 0x80) {
-		++self->ri_in_ptr;
-		return nextbyte;
-	}
-	seqlen = unicode_utf8seqlen[nextbyte];
-	if unlikely(!seqlen) {
-		++self->ri_in_ptr;
-		return nextbyte; /* Dangling follow-up byte? */
-	}
-	if likely((self->ri_in_ptr + seqlen) <= self->ri_in_cend) {
-		/* Can just read the entire character from the current chunk */
-		return unicode_readutf8((char const **)&self->ri_in_ptr);
-	}
-	if likely(re_interpreter_in_islastchunk(self)) {
-		/* Last chunk -> just read a restricted-length unicode character */
-		assert((char const *)self->ri_in_ptr < (char const *)self->ri_in_cend);
-		return unicode_readutf8_n((char const **)&self->ri_in_ptr, (char const *)self->ri_in_cend);
-	}
-
-	/* Unicode character is spread across multiple chunks */
-	{
-		size_t firstchunk, missing, left;
-		char utf8[UNICODE_UTF8_CURLEN], *dst, *reader;
-		firstchunk = re_interpreter_in_chunkleft(self);
-		assert(seqlen > firstchunk);
-		dst     = (char *)mempcpy(utf8, self->ri_in_ptr, firstchunk);
-		missing = seqlen - firstchunk;
-		re_interpreter_inptr_nextchunk(&self->ri_in);
-		left = re_interpreter_in_totalleft(self);
-		if (missing > left)
-			missing = left;
-		if (missing) {
-			for (;;) {
-				size_t avail = re_interpreter_in_chunkleft(self);
-				if (avail > missing)
-					avail = missing;
-				dst = (char *)mempcpy(dst, self->ri_in_ptr, avail);
-				missing -= avail;
-				self->ri_in_ptr += avail;
-				if (!missing)
-					break;
-				re_interpreter_inptr_nextchunk(&self->ri_in);
-			}
-		}
-		reader = utf8;
-		return unicode_readutf8_n((char const **)&reader, dst);
-	}
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-
-
-
-/* Given an `inptr' that points into some unknown input data chunk,
- * load said chunk and set the input pointer of `self' to  `inptr'.
- *
- * Behavior is undefined when `inptr' isn't a valid input pointer. */
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-#define re_interpreter_setinptr(self, inptr) (void)((self)->ri_in_ptr = (inptr))
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-PRIVATE NONNULL((1, 2)) void
-NOTHROW_NCX(CC re_interpreter_setinptr)(struct re_interpreter *__restrict self,
-                                        byte_t const *inptr) {
-	if (re_interpreter_in_chunkcontains(self, inptr)) {
-		/* Simple case: don't need to change chunks */
-		self->ri_in_ptr = inptr;
-	} else {
-		/* Complex case: need to find the chunk that `inptr' belongs to.
-		 * -> First off: assume that it's from a past chunk. */
-		size_t curr_chunk_start_offset = re_interpreter_in_chunkoffset(self);
-		size_t prev_chunk_end_offset   = curr_chunk_start_offset;
-		struct iovec const *prev_chunk = self->ri_in_miov - 2;
-		while (prev_chunk >= self->ri_in_biov) {
-			byte_t *prev_chunk_end = (byte_t *)prev_chunk->iov_base + prev_chunk->iov_len;
-			if (inptr >= (byte_t *)prev_chunk->iov_base && inptr <= prev_chunk_end) {
-				size_t inptr_offset;
-
-				/* Found the chunk that the given inptr belongs to -> now load it! */
-				inptr_offset = prev_chunk_end_offset;
-				inptr_offset -= prev_chunk->iov_len;
-				inptr_offset += (size_t)(inptr - (byte_t *)prev_chunk->iov_base);
-				self->ri_in_mcnt += re_interpreter_in_chunkendoffset(self);
-				self->ri_in_mcnt -= prev_chunk_end_offset;
-				self->ri_in_ptr   = inptr;
-				self->ri_in_cend  = prev_chunk_end;
-				self->ri_in_cbase = (byte_t *)prev_chunk->iov_base;
-				self->ri_in_vbase = inptr - inptr_offset;
-				self->ri_in_miov  = prev_chunk + 1;
-				return;
-			}
-
-			prev_chunk_end_offset -= prev_chunk->iov_len;
-			--prev_chunk;
-		}
-
-		/* Pointer must be located some a future chunk. Seek until we find it! */
-		do {
-			re_interpreter_nextchunk(self);
-		} while (!re_interpreter_in_chunkcontains(self, inptr));
-		self->ri_in_ptr = inptr;
-	}
-}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-
-/* Set the absolute offset of `self' */
 #ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
-PRIVATE NONNULL((1)) void
-NOTHROW_NCX(CC re_interpreter_inptr_setoffset)(struct re_interpreter_inptr *__restrict self,
-                                               size_t offset) {
-	size_t curr_chunk_start_offset = re_interpreter_in_chunkoffset(self);
-	size_t curr_chunk_end_offset   = re_interpreter_in_chunkendoffset(self);
-	if (offset >= curr_chunk_start_offset &&
-	    offset <= curr_chunk_end_offset) { /* <<< yes: "<=" (in case `offset' points to the end of  the
-	                                        *     input buffer, we mustn't load an out-of-bounds chunk) */
-		/* Simple case: don't need to change chunks */
-		self->ri_in_ptr = self->ri_in_cbase + (offset - curr_chunk_start_offset);
-	} else {
-		size_t curr_offset = re_interpreter_in_curoffset(self);
-		if (offset >= curr_chunk_end_offset) {
-			/* Skip ahead */
-			assert(offset > curr_offset);
-			re_interpreter_inptr_advance(self, offset - curr_offset);
-		} else {
-			/* Rewind backwards */
-			assert(offset < curr_chunk_start_offset);
-			assert(offset < curr_offset);
-			re_interpreter_inptr_reverse(self, curr_offset - offset);
-		}
-	}
-}
+/* Used as input chunk for epsilon input (when there also aren't any extra bytes) */
+INTERN struct iovec const re_interpreter_empty_iov = { NULL, 0 };
 #endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
 
-
-
-/* Allocate a new regex interpreter */
-#define re_interpreter_alloc(nvars) \
-	((struct re_interpreter *)alloca(offsetof(struct re_interpreter, ri_vars) + (nvars) * sizeof(byte_t)))
+/* The # of on-fail items that have to be resumed during a single match or
+ * search before the interpreter starts remembering the (pc, offset) pairs
+ * from where that happened (so that code which already failed at some
+ * offset isn't executed there a second time) */
+#ifndef RE_MEMO_MINRESUMES
+#define RE_MEMO_MINRESUMES 256
+#endif /* !RE_MEMO_MINRESUMES */
+
+/* Max size (in bytes) of the bitmap used to remember (pc, offset) pairs.
+ * If more would be needed (for the # of bytes in code times the # of bytes
+ * of input), the interpreter just backtracks without one. */
+#ifndef RE_MEMO_MAXSIZE
+#define RE_MEMO_MAXSIZE 0x40000
+#endif /* !RE_MEMO_MAXSIZE */
+
+#ifdef HAVE_JIT
+/* The # of times that code has to be executed by the interpreter (during a single
+ * search, or by calls that share a `RE_EXEC_CTX') before it is translated into
+ * machine code (for the remaining attempts, and later calls with the same context) */
+#ifndef RE_JIT_MINATTEMPTS
+#define RE_JIT_MINATTEMPTS 64
+#endif /* !RE_JIT_MINATTEMPTS */
+#endif /* HAVE_JIT */
 
 /* Initialize a given regex */
-#define re_interpreter_fini(self) free((self)->ri_onfailv)
-PRIVATE WUNUSED NONNULL((1, 2)) re_errno_t
+INTERN WUNUSED NONNULL((1, 2)) re_errno_t
 NOTHROW_NCX(CC re_interpreter_init)(struct re_interpreter *__restrict self,
                                     struct re_exec const *__restrict exec) {
 #ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
@@ -653,6 +129,12 @@ NOTHROW_NCX(CC re_interpreter_init)(struct re_interpreter *__restrict self,
 #endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
 	size_t startoff = exec->rx_startoff;
 	size_t endoff   = exec->rx_endoff;
+#if __SIZEOF_SIZE_T__ > 4
+	/* Input offsets are stored on the on-fail stack as 32-bit integers relative
+	 * to `startoff', so every offset of the searched window must fit into one. */
+	if unlikely(startoff < endoff && endoff - startoff > (uint32_t)-1)
+		return RE_ESIZE;
+#endif /* __SIZEOF_SIZE_T__ > 4 */
 #ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
 	self->ri_in_cbase = (byte_t const *)exec->rx_inbase;
 	self->ri_in_cend  = (byte_t const *)exec->rx_inbase + endoff;
@@ -666,14 +148,13 @@ NOTHROW_NCX(CC re_interpreter_init)(struct re_interpreter *__restrict self,
 	}
 #else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
 	if unlikely(startoff >= endoff) {
-		static struct iovec const empty_iov = { NULL, 0 };
 		/* Special case: input buffer is epsilon. */
 		chunkoff = startoff; /* `startoff' is still needed to get the size of epsilon matches right! */
 		endoff   = 0;
 		startoff = 0;
 		if (exec->rx_extra != 0)
 			goto load_normal_iov;
-		iov              = &empty_iov;
+		iov              = &re_interpreter_empty_iov;
 		self->ri_in_biov = iov;
 	} else {
 		/* Seek ahead until the first relevant chunk */
@@ -713,53 +194,87 @@ done_in_init:
 	}
 #endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
 	self->ri_exec    = exec;
+	self->ri_ctx     = NULL;
 	self->ri_onfailv = NULL;
 	self->ri_onfailc = 0;
 	self->ri_onfaila = 0;
+	self->ri_memo    = NULL;
+	if (exec->rx_eflags & RE_EXEC_CTX) {
+		/* Re-use the on-fail stack of a previous call */
+		self->ri_ctx     = exec->rx_ctx;
+		self->ri_onfailv = (struct re_onfailure_item *)self->ri_ctx->rxc_onfailv;
+		self->ri_onfaila = self->ri_ctx->rxc_onfaila;
+	}
 	self->ri_flags   = RE_INTERPRETER_F_NORMAL;
+#ifdef HAVE_JIT
+	self->ri_jit      = NULL;
+	self->ri_jit_wait = RE_JIT_MINATTEMPTS;
+	if (self->ri_ctx != NULL) {
+		/* Continue from where previous calls with the same pattern left off */
+		struct re_exec_ctx *ctx = self->ri_ctx;
+		if (ctx->rxc_jit != NULL && re_jit_iscode((struct re_jit *)ctx->rxc_jit, exec->rx_code)) {
+			self->ri_jit = (struct re_jit *)ctx->rxc_jit;
+		} else if (ctx->rxc_jitcode == exec->rx_code) {
+			self->ri_jit_wait = ctx->rxc_jitwait;
+		}
+	}
+#endif /* HAVE_JIT */
+	/* Remembering (pc, offset) pairs only works when the outcome of code at some
+	 * offset doesn't also depend on back-references or variables. */
+	self->ri_memo_wait = 0;
+	if (!(exec->rx_code->rc_flags & RE_CODE_FLAG_NEEDGROUPS) && exec->rx_code->rc_nvars == 0)
+		self->ri_memo_wait = RE_MEMO_MINRESUMES;
 	DBG_memset(self->ri_vars, 0xcc, exec->rx_code->rc_nvars * sizeof(byte_t));
 	return RE_NOERROR;
 }
 
-/* Initialize the match-buffer of `self' */
-#define re_interpreter_init_match(self, exec, for_search)                                 \
-	do {                                                                                  \
-		uint16_t _ngrp;                                                                   \
-		(self)->ri_pmatch = (exec)->rx_pmatch;                                            \
-		_ngrp             = (exec)->rx_code->rc_ngrps;                                    \
-		if ((exec)->rx_nmatch >= _ngrp) {                                                 \
-			/* Able to use user-provided register buffer. */                              \
-		} else {                                                                          \
-			/* Need to use our own group start/end-offset buffer.                         \
-			 * NOTE: stack-allocated, because max size is 256*8 = 2048 bytes. */          \
-			(self)->ri_pmatch = (re_regmatch_t *)alloca(_ngrp * sizeof(re_regmatch_t));   \
-		}                                                                                 \
-		/* Set all offsets to RE_REGOFF_UNSET (if they're written back at the end,        \
-		 * or if the code being executed expects unset groups to be marked properly) */   \
-		if ((exec)->rx_nmatch || ((exec)->rx_code->rc_flags & RE_CODE_FLAG_NEEDGROUPS)) { \
-			memsetc((self)->ri_pmatch, RE_REGOFF_UNSET,                                   \
-			        _ngrp * 2, sizeof(re_regoff_t));                                      \
-			if (for_search) {                                                             \
-				/* Interpreter is used for searching and needs groups (reset on fail) */  \
-				(self)->ri_flags |= RE_INTERPRETER_F_RSGRPS;                              \
-			}                                                                             \
-		}                                                                                 \
-	}	__WHILE0
-
-/* Copy the matches produced by `self' back into the caller-provided
- * buffer, unless it was the caller-provided buffer that was used by
- * the interpreter. */
-#define re_interpreter_copy_match(self)                                       \
-	do {                                                                      \
-		if ((self)->ri_pmatch != (self)->ri_exec->rx_pmatch) {                \
-			/* Must copy over match information into user-provided buffer. */ \
-			memcpyc((self)->ri_exec->rx_pmatch,                               \
-			        (self)->ri_pmatch,                                        \
-			        (self)->ri_exec->rx_nmatch,                               \
-			        sizeof(re_regmatch_t));                                   \
-		}                                                                     \
-	}	__WHILE0
+/* Finalize a given regex interpreter */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC re_interpreter_fini)(struct re_interpreter *__restrict self) {
+	struct re_exec_ctx *ctx = self->ri_ctx;
+	if (ctx == NULL) {
+#ifdef HAVE_JIT
+		if (self->ri_jit != NULL)
+			re_jit_destroy(self->ri_jit);
+#endif /* HAVE_JIT */
+		free(self->ri_onfailv);
+		free(self->ri_memo);
+		return;
+	}
+
+#ifdef HAVE_JIT
+	/* Keep machine code (in place of that of another pattern), or the
+	 * # of attempts that are still needed before it gets created. */
+	if (self->ri_jit != NULL && self->ri_jit != (struct re_jit *)ctx->rxc_jit) {
+		if (ctx->rxc_jit != NULL)
+			re_jit_destroy((struct re_jit *)ctx->rxc_jit);
+		ctx->rxc_jit = self->ri_jit;
+	}
+	ctx->rxc_jitcode = self->ri_exec->rx_code;
+	ctx->rxc_jitwait = self->ri_jit_wait;
+#endif /* HAVE_JIT */
+
+	/* Leave buffers behind for the next call (the on-fail stack is
+	 * only ever grown, so it's never smaller than it was before) */
+	ctx->rxc_onfailv = self->ri_onfailv;
+	ctx->rxc_onfaila = self->ri_onfaila;
+	if (self->ri_memo != NULL && self->ri_memo != (byte_t *)ctx->rxc_memov) {
+		free(ctx->rxc_memov);
+		ctx->rxc_memov = self->ri_memo;
+		ctx->rxc_memoa = self->ri_memo_size;
+	}
+}
 
+/* Free all buffers of a context (s.a. `RE_EXEC_CTX') */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC libre_exec_ctx_fini)(struct re_exec_ctx *__restrict self) {
+#ifdef HAVE_JIT
+	if (self->rxc_jit != NULL)
+		re_jit_destroy((struct re_jit *)self->rxc_jit);
+#endif /* HAVE_JIT */
+	free(self->rxc_onfailv);
+	free(self->rxc_memov);
+}
 
 /* The min number of regex failures that are always allowed
  *
@@ -829,9 +344,9 @@ NOTHROW_NCX(CC re_interpreter_resize)(struct re_interpreter *__restrict self) {
 	return true;
 }
 
-PRIVATE WUNUSED NONNULL((1, 2)) bool
+PRIVATE WUNUSED NONNULL((1)) bool
 NOTHROW_NCX(CC re_interpreter_pushfail)(struct re_interpreter *__restrict self,
-                                        byte_t const *pc) {
+                                        uint16_t pcoff) {
 	struct re_onfailure_item *item;
 	assert(self->ri_onfailc <= self->ri_onfaila);
 	if unlikely(self->ri_onfailc >= self->ri_onfaila) {
@@ -839,14 +354,15 @@ NOTHROW_NCX(CC re_interpreter_pushfail)(struct re_interpreter *__restrict self,
 			return false;
 	}
 	item = &self->ri_onfailv[self->ri_onfailc++];
-	item->rof_in = self->ri_in_ptr;
-	item->rof_pc = pc;
+	item->rof_in  = re_interpreter_in_reloffset(self);
+	item->rof_pc  = pcoff;
+	item->rof_tag = RE_ONFAILURE_ITEM_RESUME;
 	return true;
 }
 
 PRIVATE WUNUSED NONNULL((1)) bool
 NOTHROW_NCX(CC re_interpreter_pushfail_dummy)(struct re_interpreter *__restrict self,
-                                              byte_t const *in, byte_t const *pc) {
+                                              uint16_t tag, uint32_t in, uint16_t pcoff) {
 	struct re_onfailure_item *item;
 	assert(self->ri_onfailc <= self->ri_onfaila);
 	if unlikely(self->ri_onfailc >= self->ri_onfaila) {
@@ -854,11 +370,109 @@ NOTHROW_NCX(CC re_interpreter_pushfail_dummy)(struct re_interpreter *__restrict
 			return false;
 	}
 	item = &self->ri_onfailv[self->ri_onfailc++];
-	item->rof_in = in;
-	item->rof_pc = pc;
+	item->rof_in  = in;
+	item->rof_pc  = pcoff;
+	item->rof_tag = tag;
+	return true;
+}
+
+/* Set the start- (`is_start') or end-offset of group `gid' to the current offset,
+ * pushing (or overriding an old) on-fail item to restore the old one, if needed.
+ * @return: false: Out of memory (nothing was changed) */
+INTERN WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_interpreter_setgroup)(struct re_interpreter *__restrict self,
+                                        uint8_t gid, bool is_start) {
+	re_regoff_t *p_regoff, curoff;
+	assert(gid < self->ri_exec->rx_code->rc_ngrps);
+	p_regoff = is_start ? &self->ri_pmatch[gid].rm_so : &self->ri_pmatch[gid].rm_eo;
+	curoff   = (re_regoff_t)re_interpreter_in_curoffset(self);
+	if (self->ri_onfailc && /* No need to make a backup if it can't be restored */
+	    (*p_regoff != curoff)) {
+		/* Must push (or override an old) on-fail item to restore old group offset */
+		size_t i = self->ri_onfailc;
+		do {
+			uint16_t oldtag;
+			--i;
+			oldtag = self->ri_onfailv[i].rof_tag;
+			if (RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(oldtag)) {
+				/* Check if we can override this on-fail item. */
+				if (!RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(oldtag) == !is_start &&
+				    RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(oldtag) == gid) {
+					self->ri_onfailv[i].rof_in = *p_regoff;
+					goto set_regoff;
+				}
+			} else {
+				/* Must actually push an new on-fail item. */
+				break;
+			}
+		} while (i);
+		/* Push a new on-fail item. */
+		if unlikely(!re_interpreter_pushfail_dummy(self, RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE(is_start ? 1 : 0, gid),
+		                                           *p_regoff, 0))
+			return false;
+	}
+set_regoff:
+	*p_regoff = curoff;
+	assertf(self->ri_pmatch[gid].rm_so <= self->ri_pmatch[gid].rm_eo || is_start,
+	        "self->ri_pmatch[%1$" PRIu8 "].rm_so = %2$" PRIuSIZ "\n"
+	        "self->ri_pmatch[%1$" PRIu8 "].rm_eo = %3$" PRIuSIZ,
+	        gid,
+	        (size_t)self->ri_pmatch[gid].rm_so,
+	        (size_t)self->ri_pmatch[gid].rm_eo);
 	return true;
 }
 
+/* Allocate the (pc, offset) bitmap `self->ri_memo'
+ * @return: true:  Success
+ * @return: false: The bitmap would be too large (or out of memory) */
+PRIVATE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_interpreter_memo_alloc)(struct re_interpreter *__restrict self) {
+	struct re_exec const *exec = self->ri_exec;
+	byte_t const *pc;
+	size_t codesize, nbits;
+	for (pc = exec->rx_code->rc_code; *pc != REOP_MATCHED && *pc != REOP_MATCHED_PERFECT;)
+		pc = libre_opcode_next(pc);
+	codesize = (size_t)(pc - exec->rx_code->rc_code) + 1;
+	if (OVERFLOW_USUB(exec->rx_endoff, exec->rx_startoff, &self->ri_memo_cols))
+		self->ri_memo_cols = 0;
+	++self->ri_memo_cols; /* Items can also be resumed at `rx_endoff' */
+	if (OVERFLOW_UMUL(codesize, self->ri_memo_cols, &nbits) ||
+	    nbits > RE_MEMO_MAXSIZE * 8 ||
+	    nbits > (uint32_t)-1) /* Bit indices must fit into `struct re_onfailure_item::rof_in' */
+		return false;
+	self->ri_memo_size = CEILDIV(nbits, 8);
+	if (self->ri_ctx != NULL && self->ri_ctx->rxc_memoa >= self->ri_memo_size) {
+		/* Re-use the bitmap of a previous call */
+		self->ri_memo = (byte_t *)self->ri_ctx->rxc_memov;
+		bzero(self->ri_memo, self->ri_memo_size);
+		return true;
+	}
+	self->ri_memo = (byte_t *)calloc(self->ri_memo_size, sizeof(byte_t));
+	return self->ri_memo != NULL;
+}
+
+/* Return the index of the bit in `self->ri_memo' for `pc' at the current offset
+ * of `self', or `(size_t)-1' if the interpreter doesn't remember that pair. */
+PRIVATE WUNUSED NONNULL((1, 2)) size_t
+NOTHROW_NCX(CC re_interpreter_memo_index)(struct re_interpreter *__restrict self,
+                                          byte_t const *pc) {
+	size_t index;
+	if (self->ri_memo == NULL) {
+		if (self->ri_memo_wait == 0)
+			return (size_t)-1;
+		if (--self->ri_memo_wait != 0)
+			return (size_t)-1;
+		if (!re_interpreter_memo_alloc(self))
+			return (size_t)-1; /* Keep on backtracking without it */
+	}
+	if (OVERFLOW_USUB(re_interpreter_in_curoffset(self), self->ri_exec->rx_startoff, &index) ||
+	    index >= self->ri_memo_cols)
+		return (size_t)-1;
+	return index + (size_t)(pc - self->ri_exec->rx_code->rc_code) * self->ri_memo_cols;
+}
+#define re_interpreter_memo_test(self, index) ((self)->ri_memo[(index) / 8] & (1 << ((index) % 8)))
+#define re_interpreter_memo_set(self, index)  (void)((self)->ri_memo[(index) / 8] |= (1 << ((index) % 8)))
+
 /* Consume a repetition of bytes from `offset...+=num_bytes'
  * - Upon success (repeat was matched), return `true' and leave
  *   the current input pointer of `self' pointing to the end of
@@ -892,6 +506,8 @@ NOTHROW_NCX(CC re_interpreter_consume_repeat)(struct re_interpreter *__restrict
 		}
 		cur_bytes = re_interpreter_in_chunkleft(self);
 		if (!cur_bytes) {
+			if (re_interpreter_in_islastchunk(self))
+				return false; /* Input ends before the repetition does */
 			re_interpreter_nextchunk(self);
 			cur_bytes = re_interpreter_in_chunkleft(self);
 		}
@@ -900,49 +516,17 @@ NOTHROW_NCX(CC re_interpreter_consume_repeat)(struct re_interpreter *__restrict
 		/* Compare memory */
 		if (bcmp(srcptr.ri_in_ptr, self->ri_in_ptr, com_bytes) != 0)
 			return false;
+		self->ri_in_ptr += com_bytes;
 		num_bytes -= com_bytes;
 		if (!num_bytes)
 			break;
 		srcptr.ri_in_ptr += com_bytes;
-		self->ri_in_ptr += com_bytes;
 	}
 	return true;
 #endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
 }
 
 
-/* Map `X - RECS_ISX_MIN' to `__UNICODE_IS*' flags. */
-#define __libre_unicode_traits_defined
-INTERN_CONST uint16_t const libre_unicode_traits[] = {
-#ifdef __GNUC__
-#define DEF_TRAIT(opcode, mask) [(opcode - RECS_ISX_MIN)] = mask
-#else /* __GNUC__ */
-#define DEF_TRAIT(opcode, mask) /*[(opcode - RECS_ISX_MIN)] =*/ mask
-#endif /* !__GNUC__ */
-	DEF_TRAIT(RECS_ISCNTRL, __UNICODE_ISCNTRL),     /* `unicode_iscntrl(ch)' */
-	DEF_TRAIT(RECS_ISSPACE, __UNICODE_ISSPACE),     /* `unicode_isspace(ch)' */
-	DEF_TRAIT(RECS_ISUPPER, __UNICODE_ISUPPER),     /* `unicode_isupper(ch)' */
-	DEF_TRAIT(RECS_ISLOWER, __UNICODE_ISLOWER),     /* `unicode_islower(ch)' */
-	DEF_TRAIT(RECS_ISALPHA, __UNICODE_ISALPHA),     /* `unicode_isalpha(ch)' */
-	DEF_TRAIT(RECS_ISDIGIT, __UNICODE_ISDIGIT),     /* `unicode_isdigit(ch)' */
-	DEF_TRAIT(RECS_ISXDIGIT, __UNICODE_ISXDIGIT),   /* `unicode_isxdigit(ch)' */
-	DEF_TRAIT(RECS_ISALNUM, __UNICODE_ISALNUM),     /* `unicode_isalnum(ch)' */
-	DEF_TRAIT(RECS_ISPUNCT, __UNICODE_ISPUNCT),     /* `unicode_ispunct(ch)' */
-	DEF_TRAIT(RECS_ISGRAPH, __UNICODE_ISGRAPH),     /* `unicode_isgraph(ch)' */
-	DEF_TRAIT(RECS_ISPRINT, __UNICODE_ISPRINT),     /* `unicode_isprint(ch)' */
-	DEF_TRAIT(RECS_ISBLANK, __UNICODE_ISBLANK),     /* `unicode_isblank(ch)' */
-	DEF_TRAIT(RECS_ISSYMSTRT, __UNICODE_ISSYMSTRT), /* `unicode_issymstrt(ch)' */
-	DEF_TRAIT(RECS_ISSYMCONT, __UNICODE_ISSYMCONT), /* `unicode_issymcont(ch)' */
-	DEF_TRAIT(RECS_ISTAB, __UNICODE_ISTAB),         /* `unicode_istab(ch)' */
-	DEF_TRAIT(RECS_ISWHITE, __UNICODE_ISWHITE),     /* `unicode_iswhite(ch)' */
-	DEF_TRAIT(RECS_ISEMPTY, __UNICODE_ISEMPTY),     /* `unicode_isempty(ch)' */
-	DEF_TRAIT(RECS_ISLF, __UNICODE_ISLF),           /* `unicode_islf(ch)' */
-	DEF_TRAIT(RECS_ISHEX, __UNICODE_ISHEX),         /* `unicode_ishex(ch)' */
-	DEF_TRAIT(RECS_ISTITLE, __UNICODE_ISTITLE),     /* `unicode_istitle(ch)' */
-	DEF_TRAIT(RECS_ISNUMERIC, __UNICODE_ISNUMERIC), /* `unicode_isnumeric(ch)' */
-#undef DEF_TRAIT
-};
-
 PRIVATE ATTR_PURE ATTR_RETNONNULL WUNUSED NONNULL((1)) byte_t const *
 NOTHROW_NCX(CC CS_BYTE_seek_end)(__register byte_t const *__restrict pc) {
 	__register byte_t cs_opcode;
@@ -980,6 +564,28 @@ again:
 	return pc;
 }
 
+/* Binary search for `ch' in the sorted utf-8 string `[lo,hi)' (s.a. `RECS_CONTAINS_SORTED') */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC utf8_sorted_contains)(byte_t const *lo, byte_t const *hi, char32_t ch) {
+	while (lo < hi) {
+		byte_t const *mid = lo + ((size_t)(hi - lo) >> 1);
+		byte_t const *next;
+		char32_t mid_ch;
+		while ((*mid & 0xc0) == 0x80)
+			--mid; /* Seek back to the start of the character */
+		next   = mid;
+		mid_ch = unicode_readutf8((char const **)&next);
+		if (ch < mid_ch) {
+			hi = mid;
+		} else if (ch > mid_ch) {
+			lo = next;
+		} else {
+			return true;
+		}
+	}
+	return false;
+}
+
 PRIVATE ATTR_PURE ATTR_RETNONNULL WUNUSED NONNULL((1)) byte_t const *
 NOTHROW_NCX(CC CS_UTF8_seek_end)(__register byte_t const *__restrict pc) {
 	__register byte_t cs_opcode;
@@ -987,10 +593,6 @@ again:
 	cs_opcode = *pc++;
 	switch (cs_opcode) {
 
-	case_RECS_BITSET_MIN_to_MAX_UTF8:
-		pc += RECS_BITSET_GETBYTES(cs_opcode);
-		goto again;
-
 	case RECS_DONE:
 		break;
 
@@ -1014,7 +616,12 @@ again:
 		goto again;
 	}
 
-	case_RECS_ISX_MIN_to_MAX:
+	case RECS_ISX_MASK:
+		pc += 2;
+		goto again;
+
+	case RECS_CONTAINS_SORTED:
+		pc += 2 + UNALIGNED_GET16(pc);
 		goto again;
 
 	default: __builtin_unreachable();
@@ -1022,1340 +629,941 @@ again:
 	return pc;
 }
 
-/* Check if reg-match `a' is better than `b' */
-PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2)) bool
-NOTHROW_NCX(CC is_regmatch_better)(re_regmatch_t const *__restrict a,
-                                   re_regmatch_t const *__restrict b,
-                                   uint16_t nregs) {
-	uint16_t i;
-	for (i = 0; i < nregs; ++i) {
-		re_sregoff_t a_startoff, a_endoff;
-		re_sregoff_t b_startoff, b_endoff;
+/* Return the offset (from `REOP_TRIE') of the child of the `RETRIE_BRANCH'
+ * node at `node' that follows after `ch' (or `0' if there is none) */
+INTERN ATTR_PURE WUNUSED NONNULL((1)) uint16_t
+NOTHROW_NCX(CC re_trie_branch)(byte_t const *__restrict node, byte_t ch) {
+	unsigned int count = (unsigned int)node[1] + 1;
+	byte_t const *labels = node + 2;
+	byte_t const *label = (byte_t const *)memchr(labels, ch, count);
+	if (!label)
+		return 0;
+	return UNALIGNED_GET16(labels + count + (size_t)(label - labels) * 2);
+}
 
-		/* We prefer groups that end later. */
-		a_endoff = (re_sregoff_t)a[i].rm_eo;
-		b_endoff = (re_sregoff_t)b[i].rm_eo;
-		if (a_endoff > b_endoff)
+/* Check if `ch' is matched by the `RECS_*' sequence at `pc' (the operand of `REOP_CS_BYTE') */
+INTERN ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC CS_BYTE_contains)(__register byte_t const *__restrict pc, byte_t ch) {
+	__register byte_t cs_opcode;
+again:
+	cs_opcode = *pc++;
+	switch (cs_opcode) {
+
+	case_RECS_BITSET_MIN_to_MAX_BYTE: {
+		uint8_t bitset_minch = RECS_BITSET_GETBASE(cs_opcode);
+		uint8_t bitset_size  = RECS_BITSET_GETBYTES(cs_opcode);
+		byte_t bitset_rel_ch;
+		if (!OVERFLOW_USUB(ch, bitset_minch, &bitset_rel_ch) &&
+		    bitset_rel_ch < bitset_size * 8 &&
+		    (pc[bitset_rel_ch / 8] & (1 << (bitset_rel_ch % 8))) != 0)
 			return true;
-		if (a_endoff < b_endoff)
-			return false;
+		pc += bitset_size;
+		goto again;
+	}
 
-		/* We prefer groups that start earlier. */
-		a_startoff = (re_sregoff_t)a[i].rm_so;
-		b_startoff = (re_sregoff_t)b[i].rm_so;
-		if (a_startoff < b_startoff)
+	case RECS_DONE:
+		break;
+
+	case RECS_CHAR:
+		if (ch == pc[0])
 			return true;
-		if (a_startoff > b_startoff)
-			return false;
+		pc += 1;
+		goto again;
+
+	case RECS_CHAR2:
+		if (ch == pc[0] || ch == pc[1])
+			return true;
+		pc += 2;
+		goto again;
+
+	case RECS_RANGE:
+		if (ch >= pc[0] && ch <= pc[1])
+			return true;
+		pc += 2;
+		goto again;
+
+	case RECS_CONTAINS: {
+		byte_t len = *pc++;
+		if (memchr(pc, ch, len) != NULL)
+			return true;
+		pc += len;
+		goto again;
 	}
 
-	/* The group matches are identical (but indicate `false'
-	 * since that  allows our  caller  to skip  some  stuff) */
+	default: __builtin_unreachable();
+	}
 	return false;
 }
 
+/* Check if `ch' is matched by the operand `pc' of `REOP_CS_UTF8' */
+INTERN ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC CS_UTF8_contains)(byte_t const *__restrict pc, char32_t ch) {
+	__register byte_t cs_opcode;
+	if (ch < 0x80)
+		return (pc[ch / 8] & (1 << (ch % 8))) != 0;
+	pc += 16;
+again:
+	cs_opcode = *pc++;
+	switch (cs_opcode) {
 
-/* Execute the regex interpreter.
- * NOTE: The caller is  responsible for loading  a non-empty  chunk,
- *       unless the entire input buffer is empty. iow: this function
- *       is  allowed to  assume that  the current  chunk being empty
- *       also means that the entire input buffer is empty.
- *
- * @return: -RE_NOERROR: Input was matched.
- * @return: -RE_NOMATCH: Nothing was matched
- * @return: -RE_ESPACE:  Out of memory
- * @return: -RE_ESIZE:   On-failure stack became too large. */
-PRIVATE WUNUSED NONNULL((1)) re_errno_t
-NOTHROW_NCX(CC libre_interp_exec)(__register struct re_interpreter *__restrict self) {
-	__register byte_t opcode;
-	__register byte_t const *pc;
-
-	/* Initialize program counter. */
-	{
-		struct re_code const *code;
-		code = self->ri_exec->rx_code;
-		pc   = code->rc_code;
-
-		/* Try to do a quick can-check via the fast-map */
-		if (re_interpreter_in_chunk_cangetc(self)) {
-			byte_t fmap;
-			fmap = *self->ri_in_ptr;
-			fmap = code->rc_fmap[fmap];
-			if (fmap == 0xff) {
-				/* Initial character never matches, but are we able to match epsilon? */
-				if (code->rc_minmatch == 0)
-					goto do_epsilon_match; /* epsilon match! */
-				return -RE_NOMATCH;
-			}
-			pc += fmap;
-		} else if (code->rc_minmatch > 0) {
-			/* Input buffer is epsilon, but regex has a non-  zero
-			 * minimal match length -> regex can't possibly match! */
-			return -RE_NOMATCH;
-		} else {
-			/* Input buffer is epsilon, and we can match epsilon
-			 *
-			 * In  this case, simply set the start/end-offsets of
-			 * all groups to the base-offset of the input buffer. */
-			static_assert(sizeof(re_regmatch_t) == 2 * sizeof(re_regoff_t));
-do_epsilon_match:
-			if (self->ri_exec->rx_nmatch == 0) {
-				/* Caller doesn't care about matches -> don't have to fill in groups properly! */
-				return -RE_NOERROR;
-			} else if (code->rc_flags & RE_CODE_FLAG_OPTGROUPS) {
-				/* Special case: when the code contains optional groups (e.g. "(|foo(b)ar)"),
-				 *               then we can't just blindly fill all groups in as matching at
-				 *               offset=rx_startoff.  In the given example. group[0] needs to
-				 *               have those offsets, but group[1] needs to remain UNSET!
-				 * -> As such, fallthru to below and actually execute the regex code, so it
-				 *    can go down the epsilon-match path  and fill in exactly those  groups
-				 *    that should be filled in. */
-			} else {
-				/* Code doesn't have optional group; i.e. all offsets of all groups can
-				 * simply be set to the start-offset */
-				memsetc(self->ri_pmatch,
-				        (re_regoff_t)self->ri_exec->rx_startoff,
-				        code->rc_ngrps * 2, sizeof(re_regoff_t));
-				return -RE_NOERROR;
-			}
-		}
-	}
-
-	/* Initialize the best match as not-matched-yet */
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-	self->ri_bmatch.ri_in_ptr = NULL;
-#define best_match_isvalid() (self->ri_bmatch.ri_in_ptr != NULL)
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-	self->ri_bmatch.ri_in_ptr  = (byte_t *)1;
-	self->ri_bmatch.ri_in_cend = (byte_t *)0;
-#define best_match_isvalid() (self->ri_bmatch.ri_in_ptr <= self->ri_bmatch.ri_in_cend)
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	case RECS_DONE:
+		break;
 
-	/* Helper macros */
-#define DISPATCH()     goto dispatch
-#ifdef HAVE_TRACE
-#define ONFAIL()       do{ TRACE("ONFAIL: %d\n", __LINE__); goto onfail; }__WHILE0
-#define TARGET(opcode) __IF0 { case opcode: TRACE("%#.4" PRIxSIZ ": %s\n", (size-t)((pc - 1) - self->ri_exec->rx_code->rc_code), #opcode); }
-#define XTARGET(range) __IF0 {       range: TRACE("%#.4" PRIxSIZ ": %s\n", (size-t)((pc - 1) - self->ri_exec->rx_code->rc_code), #opcode); }
-#else /* HAVE_TRACE */
-#define ONFAIL()       goto onfail
-#define TARGET(opcode) case opcode:
-#define XTARGET(range) range:
-#endif /* !HAVE_TRACE */
-#define PUSHFAIL(pc)        do { if unlikely(!re_interpreter_pushfail(self, pc)) goto err_nomem; } __WHILE0
-#define PUSHFAIL_DUMMY(pc)  do { if unlikely(!re_interpreter_pushfail_dummy(self, RE_ONFAILURE_ITEM_DUMMY_INPTR, pc)) goto err_nomem; } __WHILE0
-#define PUSHFAIL_EX(in, pc) do { if unlikely(!re_interpreter_pushfail_dummy(self, in, pc)) goto err_nomem; } __WHILE0
-#define getb()              (*pc++)
-#define getw()              (pc += 2, delta16_get(pc - 2))
-
-	/* The main dispatch loop */
-dispatch:
-	opcode = getb();
-	switch (opcode) {
+	case RECS_CHAR:
+		if (ch == unicode_readutf8((char const **)&pc))
+			return true;
+		goto again;
 
-		TARGET(REOP_EXACT) {
-			byte_t count = getb();
-			assert(count >= 2);
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-			{
-				size_t avail = re_interpreter_in_chunkleft(self);
-				if (avail < (size_t)count)
-					ONFAIL();
-				if (bcmp(self->ri_in_ptr, pc, count) != 0)
-					ONFAIL();
-				self->ri_in_ptr += count;
-				pc += count;
-			}
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-			for (;;) {
-				size_t avail = re_interpreter_in_chunkleft(self);
-				if (avail == 0) {
-					if (re_interpreter_is_eoi_at_end_of_chunk(self))
-						ONFAIL();
-					re_interpreter_nextchunk(self);
-					avail = re_interpreter_in_chunkleft(self);
-				}
-				assert(avail >= 1);
-				if likely(avail >= count) {
-					/* Everything left to compare is in the current chunk */
-					if (bcmp(self->ri_in_ptr, pc, count) != 0)
-						ONFAIL();
-					self->ri_in_ptr += count;
-					pc += count;
-					break;
-				} else {
-					/* Input string spans across multiple chunks */
-					if (bcmp(self->ri_in_ptr, pc, avail) != 0)
-						ONFAIL();
-					self->ri_in_ptr += avail;
-					pc += avail;
-					count -= avail;
-				}
-			}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-			DISPATCH();
-		}
+	case RECS_CHAR2: {
+		char32_t match1, match2;
+		match1 = unicode_readutf8((char const **)&pc);
+		match2 = unicode_readutf8((char const **)&pc);
+		if (ch == match1 || ch == match2)
+			return true;
+		goto again;
+	}
 
-		TARGET(REOP_EXACT_ASCII_ICASE) {
-			byte_t count = getb();
-			assert(count >= 2);
-#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
-			{
-				size_t avail = re_interpreter_in_chunkleft(self);
-				if (avail < (size_t)count)
-					ONFAIL();
-				if (memcasecmp(self->ri_in_ptr, pc, count) != 0)
-					ONFAIL();
-				self->ri_in_ptr += count;
-				pc += count;
-			}
-#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
-			for (;;) {
-				size_t avail = re_interpreter_in_chunkleft(self);
-				if (avail == 0) {
-					if (re_interpreter_is_eoi_at_end_of_chunk(self))
-						ONFAIL();
-					re_interpreter_nextchunk(self);
-					avail = re_interpreter_in_chunkleft(self);
-				}
-				assert(avail >= 1);
-				if likely(avail >= count) {
-					/* Everything left to compare is in the current chunk */
-					if (memcasecmp(self->ri_in_ptr, pc, count) != 0)
-						ONFAIL();
-					self->ri_in_ptr += count;
-					pc += count;
-					break;
-				} else {
-					/* Input string spans across multiple chunks */
-					if (memcasecmp(self->ri_in_ptr, pc, avail) != 0)
-						ONFAIL();
-					self->ri_in_ptr += avail;
-					pc += avail;
-					count -= avail;
-				}
-			}
-#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
-			DISPATCH();
-		}
+	case RECS_RANGE: {
+		char32_t match_lo, match_hi;
+		match_lo = unicode_readutf8((char const **)&pc);
+		match_hi = unicode_readutf8((char const **)&pc);
+		if (ch >= match_lo && ch <= match_hi)
+			return true;
+		goto again;
+	}
 
-		TARGET(REOP_EXACT_UTF8_ICASE) {
-			byte_t count = getb();
-			byte_t const *newpc = pc;
-			assert(count >= 1);
-			do {
-				char32_t expected, actual;
-				if (re_interpreter_is_eoi(self))
-					ONFAIL();
-				actual   = re_interpreter_readutf8(self);
-				expected = unicode_readutf8((char const **)&newpc);
-				if (actual != expected) {
-					actual   = unicode_tolower(actual);
-					expected = unicode_tolower(expected);
-					if (actual != expected)
-						ONFAIL();
-				}
-			} while (--count);
-			pc = newpc;
-			DISPATCH();
-		}
+	case RECS_RANGE_ICASE: {
+		char32_t match_lo, match_hi, lower_ch;
+		match_lo = unicode_readutf8((char const **)&pc);
+		match_hi = unicode_readutf8((char const **)&pc);
+		lower_ch = unicode_tolower(ch);
+		if (lower_ch >= match_lo && lower_ch <= match_hi)
+			return true;
+		goto again;
+	}
 
-#ifdef REOP_ANY
-		TARGET(REOP_ANY) {
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			(void)re_interpreter_readbyte(self);
-			DISPATCH();
-		}
-#endif /* REOP_ANY */
+	case RECS_CONTAINS: {
+		byte_t len = *pc++;
+		do {
+			if (ch == unicode_readutf8((char const **)&pc))
+				return true;
+		} while (--len);
+		goto again;
+	}
 
-#ifdef REOP_ANY_UTF8
-		TARGET(REOP_ANY_UTF8) {
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			(void)re_interpreter_readutf8(self);
-			DISPATCH();
-		}
-#endif /* REOP_ANY_UTF8 */
+	case RECS_ISX_MASK: {
+		uint16_t traits = UNALIGNED_GET16(pc);
+		pc += 2;
+		if ((__unicode_descriptor(ch)->__ut_flags & traits) != 0)
+			return true;
+		goto again;
+	}
 
-#ifdef REOP_ANY_NOTLF
-		TARGET(REOP_ANY_NOTLF) {
-			byte_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readbyte(self);
-			if (ascii_islf(ch))
-				ONFAIL();
-			DISPATCH();
-		}
-#endif /* REOP_ANY_NOTLF */
+	case RECS_CONTAINS_SORTED: {
+		byte_t const *end = pc + 2 + UNALIGNED_GET16(pc);
+		if (utf8_sorted_contains(pc + 2, end, ch))
+			return true;
+		pc = end;
+		goto again;
+	}
 
-#ifdef REOP_ANY_NOTLF_UTF8
-		TARGET(REOP_ANY_NOTLF_UTF8) {
-			char32_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readutf8(self);
-			if (unicode_islf(ch))
-				ONFAIL();
-			DISPATCH();
-		}
-#endif /* REOP_ANY_NOTLF_UTF8 */
+	default: __builtin_unreachable();
+	}
+	return false;
+}
 
-#ifdef REOP_ANY_NOTNUL
-		TARGET(REOP_ANY_NOTNUL) {
-			byte_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readbyte(self);
-			if (ch == '\0')
-				ONFAIL();
-			DISPATCH();
-		}
-#endif /* REOP_ANY_NOTNUL */
+/* Return the end of the `REOP_[N]SEQ_UTF8'-operand at `pc' */
+PRIVATE ATTR_PURE ATTR_RETNONNULL WUNUSED NONNULL((1)) byte_t const *
+NOTHROW_NCX(CC SEQ_UTF8_seek_end)(__register byte_t const *__restrict pc) {
+	__register byte_t seqlen;
+	pc += 16;
+	while ((seqlen = *pc++) != 0)
+		pc += seqlen * 2;
+	return pc;
+}
 
-#ifdef REOP_ANY_NOTNUL_UTF8
-		TARGET(REOP_ANY_NOTNUL_UTF8) {
-			char32_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readbyte(self);
-			if (ch == (char32_t)'\0')
-				ONFAIL();
-			DISPATCH();
-		}
-#endif /* REOP_ANY_NOTNUL_UTF8 */
+/* Check if the shortest  utf-8 encoding `utf8' (of  a character `>= 0x80') is  matched
+ * by one of the byte-range sequences of the `REOP_[N]SEQ_UTF8'-operand at `pc'. Because
+ * `utf8' is the shortest encoding, its lead byte also determines its length. */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC SEQ_UTF8_contains)(byte_t const *__restrict pc,
+                                  byte_t const *__restrict utf8) {
+	byte_t seqlen;
+	pc += 16;
+	while ((seqlen = *pc++) != 0) {
+		byte_t i;
+		if (utf8[0] < pc[0])
+			break; /* Sequences are sorted by their lead bytes */
+		for (i = 0; utf8[i] >= pc[i * 2] && utf8[i] <= pc[i * 2 + 1];) {
+			if (++i >= seqlen)
+				return true;
+		}
+		pc += seqlen * 2;
+	}
+	return false;
+}
 
-#ifdef REOP_ANY_NOTNUL_NOTLF
-		TARGET(REOP_ANY_NOTNUL_NOTLF) {
-			byte_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readbyte(self);
-			if (ch == '\0' || ascii_islf(ch))
-				ONFAIL();
-			DISPATCH();
-		}
-#endif /* REOP_ANY_NOTNUL_NOTLF */
+/* Check if `ch' is matched by the `REOP_[N]SEQ_UTF8'-operand at `pc' (ignoring the `N') */
+INTERN ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC SEQ_UTF8_containschar)(byte_t const *__restrict pc, char32_t ch) {
+	byte_t utf8[UNICODE_UTF8_CURLEN];
+	if (ch < 0x80)
+		return (pc[ch / 8] & (1 << (ch % 8))) != 0;
+	if (ch > 0x1fffff)
+		return false; /* Never matched by sequences */
+	(void)unicode_writeutf8((char *)utf8, ch);
+	return SEQ_UTF8_contains(pc, utf8);
+}
 
-#ifdef REOP_ANY_NOTNUL_NOTLF_UTF8
-		TARGET(REOP_ANY_NOTNUL_NOTLF_UTF8) {
-			char32_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readutf8(self);
-			if (ch == '\0' || unicode_islf(ch))
-				ONFAIL();
-			DISPATCH();
-		}
-#endif /* REOP_ANY_NOTNUL_NOTLF_UTF8 */
+/* Return the length of the well-formed, shortest utf-8 encoding of a
+ * character `>= 0x80' at `ptr', or `0' if there isn't one before `end'
+ * (in which case the character has to be decoded the normal way). */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2)) size_t
+NOTHROW_NCX(CC utf8_shortestlen)(byte_t const *__restrict ptr,
+                                 byte_t const *__restrict end) {
+	byte_t lead = ptr[0];
+	size_t i, seqlen;
+	if (lead < 0xc2 || lead > 0xf7)
+		return 0; /* Follow-up byte, overlong 2-byte sequence, or 5/6-byte sequence */
+	seqlen = lead < 0xe0 ? 2 : lead < 0xf0 ? 3 : 4;
+	if (seqlen > (size_t)(end - ptr))
+		return 0;
+	for (i = 1; i < seqlen; ++i) {
+		if ((ptr[i] & 0xc0) != 0x80)
+			return 0;
+	}
+	if ((lead == 0xe0 && ptr[1] < 0xa0) || (lead == 0xf0 && ptr[1] < 0x90))
+		return 0; /* Overlong */
+	return seqlen;
+}
 
-		TARGET(REOP_BYTE) {
-			/* Followed by 1 byte that must be matched exactly */
-			byte_t ch, b;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			b  = getb();
-			ch = re_interpreter_readbyte(self);
-			if (ch == b)
-				DISPATCH();
-			ONFAIL();
-		}
+/* Read the next utf-8 character and check if it is matched by the `REOP_[N]SEQ_UTF8'-operand
+ * at `pc' (ignoring the `N'). Characters that are  well-formed and fit into the current  chunk
+ * are matched as-is; anything else is decoded, and its shortest encoding is matched instead. */
+INTERN WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_interpreter_readseq)(struct re_interpreter *__restrict self,
+                                       byte_t const *__restrict pc) {
+	size_t seqlen;
+	byte_t lead = re_interpreter_readbyte(self);
+	if likely(lead < 0x80)
+		return (pc[lead / 8] & (1 << (lead % 8))) != 0;
+	seqlen = utf8_shortestlen(self->ri_in_ptr - 1, self->ri_in_cend);
+	if likely(seqlen != 0) {
+		bool result = SEQ_UTF8_contains(pc, self->ri_in_ptr - 1);
+		self->ri_in_ptr += seqlen - 1;
+		return result;
+	}
+	--self->ri_in_ptr;
+	return SEQ_UTF8_containschar(pc, re_interpreter_readutf8(self));
+}
 
-		TARGET(REOP_NBYTE) {
-			/* Followed by 1 byte that must not be matched exactly */
-			byte_t ch, b;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			b  = getb();
-			ch = re_interpreter_readbyte(self);
-			if (ch != b)
-				DISPATCH();
-			ONFAIL();
-		}
+/* Compare `num_bytes' of input at `in' with the `REOP_EXACT_ASCII_ICASE'-string
+ * `folded' (whose ASCII letters are  already lower-case). The input is  compared
+ * `sizeof(size_t)' bytes at a time, by OR-ing 0x20 into those bytes of the input
+ * where `folded' has a letter.
+ * @return: true:  Input matches
+ * @return: false: Input doesn't match */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_memcaseeq_folded)(byte_t const *in,
+                                    byte_t const *folded,
+                                    size_t num_bytes) {
+	while (num_bytes >= sizeof(size_t)) {
+		size_t iword, fword;
+		memcpy(&iword, in, sizeof(size_t));
+		memcpy(&fword, folded, sizeof(size_t));
+		if ((iword | (RE_WORD_LOWERBYTES(fword) >> 2)) != fword)
+			return false;
+		in += sizeof(size_t);
+		folded += sizeof(size_t);
+		num_bytes -= sizeof(size_t);
+	}
+	for (; num_bytes; --num_bytes, ++in, ++folded) {
+		byte_t ch = *in;
+		if (ch >= 'A' && ch <= 'Z')
+			ch += 'a' - 'A';
+		if (ch != *folded)
+			return false;
+	}
+	return true;
+}
 
-		TARGET(REOP_BYTE2) {
-			/* Followed by 2 bytes, one of which must be matched exactly (for "[ab]" or "a" -> "[aA]" in ICASE-mode) */
-			byte_t ch, b1, b2;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			b1 = getb();
-			b2 = getb();
-			ch = re_interpreter_readbyte(self);
-			if (ch == b1 || ch == b2)
-				DISPATCH();
-			ONFAIL();
-		}
+/* Check if reg-match `a' is better than `b' */
+INTERN ATTR_PURE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC is_regmatch_better)(re_regmatch_t const *__restrict a,
+                                   re_regmatch_t const *__restrict b,
+                                   uint16_t nregs) {
+	uint16_t i;
+	for (i = 0; i < nregs; ++i) {
+		re_sregoff_t a_startoff, a_endoff;
+		re_sregoff_t b_startoff, b_endoff;
 
-		TARGET(REOP_NBYTE2) {
-			/* Followed by 2 bytes, neither of which may be matched */
-			byte_t ch, b1, b2;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			b1 = getb();
-			b2 = getb();
-			ch = re_interpreter_readbyte(self);
-			if (ch != b1 && ch != b2)
-				DISPATCH();
-			ONFAIL();
-		}
+		/* We prefer groups that end later. */
+		a_endoff = (re_sregoff_t)a[i].rm_eo;
+		b_endoff = (re_sregoff_t)b[i].rm_eo;
+		if (a_endoff > b_endoff)
+			return true;
+		if (a_endoff < b_endoff)
+			return false;
 
-		TARGET(REOP_RANGE) {
-			/* Followed by 2 bytes, with input having to match `ch >= pc[0] && ch <= pc[1]' */
-			byte_t ch, lo, hi;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			lo = getb();
-			hi = getb();
-			ch = re_interpreter_readbyte(self);
-			if (ch >= lo && ch <= hi)
-				DISPATCH();
-			ONFAIL();
-		}
+		/* We prefer groups that start earlier. */
+		a_startoff = (re_sregoff_t)a[i].rm_so;
+		b_startoff = (re_sregoff_t)b[i].rm_so;
+		if (a_startoff < b_startoff)
+			return true;
+		if (a_startoff > b_startoff)
+			return false;
+	}
 
-		TARGET(REOP_NRANGE) {
-			/* Followed by 2 bytes, with input having to match `ch >= pc[0] && ch <= pc[1]' */
-			byte_t ch, lo, hi;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			lo = getb();
-			hi = getb();
-			ch = re_interpreter_readbyte(self);
-			if (ch < lo || ch > hi)
-				DISPATCH();
-			ONFAIL();
-		}
+	/* The group matches are identical (but indicate `false'
+	 * since that  allows our  caller  to skip  some  stuff) */
+	return false;
+}
 
-		TARGET(REOP_CONTAINS_UTF8) {
-			byte_t count = getb();
-			char32_t ch;
-			byte_t const *newpc;
-			assert(count >= 2);
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readutf8(self);
-			newpc = pc;
-			for (;;) {
-				char32_t other_ch;
-				other_ch = unicode_readutf8((char const **)&newpc);
-				--count;
-				if (ch == other_ch)
-					break;
-				if (!count)
-					ONFAIL();
-			}
-			/* Consume remaining characters */
-			for (; count; --count)
-				newpc += unicode_utf8seqlen[(unsigned char)*newpc];
-			pc = newpc;
-			DISPATCH();
-		}
+/* Consume repetitions of single-character opcodes in one go (s.a. `REOP_SPAN') */
+PRIVATE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_interpreter_span)(struct re_interpreter *__restrict self,
+                                    byte_t const *__restrict pc);
+PRIVATE NONNULL((1, 2)) void
+NOTHROW_NCX(CC re_interpreter_span_unget)(struct re_interpreter *__restrict self,
+                                          byte_t const *__restrict pc);
+PRIVATE WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_interpreter_span_seek)(struct re_interpreter *__restrict self,
+                                         byte_t const *__restrict loop_pc,
+                                         byte_t const *__restrict pc,
+                                         size_t minoff);
+
+
+#ifndef __INTELLISENSE__
+#define DEFINE_libre_interp_exec
+#include "regexec-interp.c.inl"
+#ifdef HAVE_JIT
+#define DEFINE_libre_interp_exec_jit
+#include "regexec-interp.c.inl"
+#endif /* HAVE_JIT */
+#endif /* !__INTELLISENSE__ */
+
+/* Execute `self' (using its machine code, if it has some) */
+#ifdef HAVE_JIT
+#define re_interpreter_run(self) \
+	((self)->ri_jit != NULL ? libre_interp_exec_jit(self) : libre_interp_exec(self))
+#else /* HAVE_JIT */
+#define re_interpreter_run(self) libre_interp_exec(self)
+#endif /* !HAVE_JIT */
+
+
+/* Return the end of the run of ASCII characters starting at `iter' (and ending no later
+ * than `end') that are accepted by  the `RE_DFA_OP_UTF8'-opcode at `pc'. Input that  is
+ * always accepted is skipped `sizeof(size_t)' bytes at a time. */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2, 3)) byte_t const *
+NOTHROW_NCX(CC re_span_ascii)(byte_t const *__restrict pc,
+                              byte_t const *iter,
+                              byte_t const *end) {
+	switch (pc[0]) {
 
-		TARGET(REOP_NCONTAINS_UTF8) {
-			byte_t count = getb();
-			char32_t ch;
-			byte_t const *newpc;
-			assert(count >= 1);
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readutf8(self);
-			newpc = pc;
-			do {
-				char32_t other_ch;
-				other_ch = unicode_readutf8((char const **)&newpc);
-				if (ch == other_ch)
-					ONFAIL();
-			} while (--count);
-			pc = newpc;
-			DISPATCH();
+#ifdef REOP_ANY_UTF8
+	case REOP_ANY_UTF8:
+		for (; (size_t)(end - iter) >= sizeof(size_t); iter += sizeof(size_t)) {
+			size_t word;
+			memcpy(&word, iter, sizeof(size_t));
+			if (word & RE_WORD_HIGHS)
+				break;
 		}
+		while (iter < end && *iter < 0x80)
+			++iter;
+		break;
+#endif /* REOP_ANY_UTF8 */
 
-
-
-		/************************************************************************/
-		/* BITSET OPCODES                                                       */
-		/************************************************************************/
-		TARGET(REOP_CS_BYTE) {
-			byte_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readbyte(self);
-REOP_CS_BYTE_dispatch:
-			opcode = getb();
-			switch (opcode) {
-
-			case_RECS_BITSET_MIN_to_MAX_BYTE: {
-				uint8_t bitset_minch = RECS_BITSET_GETBASE(opcode);
-				uint8_t bitset_size  = RECS_BITSET_GETBYTES(opcode);
-				byte_t bitset_rel_ch;
-				if (!OVERFLOW_USUB(ch, bitset_minch, &bitset_rel_ch)) {
-					unsigned int bitset_bits = bitset_size * 8;
-					if (bitset_rel_ch < bitset_bits) {
-						if ((pc[bitset_rel_ch / 8] & (1 << (bitset_rel_ch % 8))) != 0) {
-							pc += bitset_size;
-							goto REOP_CS_BYTE_onmatch;
-						}
-					}
-				}
-				pc += bitset_size;
-				goto REOP_CS_BYTE_dispatch;
-			}
-
-			case RECS_DONE:
-				/* Reached the end of the char-set without any match */
-				ONFAIL();
-				__builtin_unreachable();
-
-			case RECS_CHAR: {
-				byte_t match = getb();
-				if (ch == match)
-					goto REOP_CS_BYTE_onmatch;
-				goto REOP_CS_BYTE_dispatch;
-			}
-
-			case RECS_CHAR2: {
-				byte_t match1 = getb();
-				byte_t match2 = getb();
-				if (ch == match1 || ch == match2)
-					goto REOP_CS_BYTE_onmatch;
-				goto REOP_CS_BYTE_dispatch;
-			}
-
-			case RECS_RANGE: {
-				byte_t match_lo = getb();
-				byte_t match_hi = getb();
-				if (ch >= match_lo && ch <= match_hi)
-					goto REOP_CS_BYTE_onmatch;
-				goto REOP_CS_BYTE_dispatch;
-			}
-
-			case RECS_CONTAINS: {
-				byte_t len = getb();
-				if (memchr(pc, ch, len) != NULL) {
-					pc += len;
-					goto REOP_CS_BYTE_onmatch;
-				}
-				pc += len;
-				goto REOP_CS_BYTE_dispatch;
-			}
-
-			/* No need to handle trait opcodes (those aren't valid in byte-mode) */
-
-			default: __builtin_unreachable();
-			}
-REOP_CS_BYTE_onmatch:
-			pc = CS_BYTE_seek_end(pc);
-			DISPATCH();
+#if defined(REOP_ANY_NOTLF_UTF8) || defined(REOP_ANY_NOTNUL_NOTLF_UTF8)
+#ifdef REOP_ANY_NOTLF_UTF8
+	case REOP_ANY_NOTLF_UTF8:
+#endif /* REOP_ANY_NOTLF_UTF8 */
+#ifdef REOP_ANY_NOTNUL_NOTLF_UTF8
+	case REOP_ANY_NOTNUL_NOTLF_UTF8:
+#endif /* REOP_ANY_NOTNUL_NOTLF_UTF8 */
+		/* Printable ASCII characters are always accepted */
+		for (; (size_t)(end - iter) >= sizeof(size_t); iter += sizeof(size_t)) {
+			size_t word;
+			memcpy(&word, iter, sizeof(size_t));
+			if ((word & RE_WORD_HIGHS) || RE_WORD_CNTRLBYTES(word))
+				break;
 		}
+		while (iter < end && *iter < 0x80 && re_dfa_matchchar(pc, *iter))
+			++iter;
+		break;
+#endif /* REOP_ANY_NOTLF_UTF8 || REOP_ANY_NOTNUL_NOTLF_UTF8 */
 
-		TARGET(REOP_CS_UTF8) {
-			char32_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readutf8(self);
-REOP_CS_UTF8_dispatch:
-			opcode = getb();
-			switch (opcode) {
-
-			case_RECS_BITSET_MIN_to_MAX_UTF8: {
-				uint8_t bitset_minch = RECS_BITSET_GETBASE(opcode);
-				uint8_t bitset_size  = RECS_BITSET_GETBYTES(opcode);
-				byte_t bitset_rel_ch;
-				if (ch < 0x80 && !OVERFLOW_USUB((uint8_t)ch, bitset_minch, &bitset_rel_ch)) {
-					unsigned int bitset_bits = bitset_size * 8;
-					if (bitset_rel_ch < bitset_bits) {
-						if ((pc[bitset_rel_ch / 8] & (1 << (bitset_rel_ch % 8))) != 0) {
-							pc += bitset_size;
-							goto REOP_CS_UTF8_onmatch;
-						}
-					}
-				}
-				pc += bitset_size;
-				goto REOP_CS_UTF8_dispatch;
-			}
-
-			case RECS_DONE:
-				/* Reached the end of the char-set without any match */
-				ONFAIL();
-				__builtin_unreachable();
-
-			case RECS_CHAR: {
-				byte_t const *newpc = pc;
-				char32_t match;
-				match = unicode_readutf8((char const **)&newpc);
-				pc    = newpc;
-				if (ch == match)
-					goto REOP_CS_UTF8_onmatch;
-				goto REOP_CS_UTF8_dispatch;
-			}
-
-			case RECS_CHAR2: {
-				byte_t const *newpc = pc;
-				char32_t match1, match2;
-				match1 = unicode_readutf8((char const **)&newpc);
-				match2 = unicode_readutf8((char const **)&newpc);
-				pc     = newpc;
-				if (ch == match1 || ch == match2)
-					goto REOP_CS_UTF8_onmatch;
-				goto REOP_CS_UTF8_dispatch;
-			}
-
-			case RECS_RANGE: {
-				byte_t const *newpc = pc;
-				char32_t match_lo, match_hi;
-				match_lo = unicode_readutf8((char const **)&newpc);
-				match_hi = unicode_readutf8((char const **)&newpc);
-				pc       = newpc;
-				if (ch >= match_lo && ch <= match_hi)
-					goto REOP_CS_UTF8_onmatch;
-				goto REOP_CS_UTF8_dispatch;
-			}
-
-			case RECS_RANGE_ICASE: {
-				byte_t const *newpc = pc;
-				char32_t match_lo, match_hi, lower_ch;
-				match_lo = unicode_readutf8((char const **)&newpc);
-				match_hi = unicode_readutf8((char const **)&newpc);
-				pc       = newpc;
-				lower_ch = unicode_tolower(ch);
-				if (lower_ch >= match_lo && lower_ch <= match_hi)
-					goto REOP_CS_UTF8_onmatch;
-				goto REOP_CS_UTF8_dispatch;
-			}
+	case REOP_CS_UTF8:
+	case REOP_SEQ_UTF8:
+		/* Look up ASCII characters in the leading bitset */
+		while (iter < end && *iter < 0x80 && (pc[1 + *iter / 8] & (1 << (*iter % 8))) != 0)
+			++iter;
+		break;
 
-			case RECS_CONTAINS: {
-				byte_t len = getb();
-				byte_t const *newpc = pc;
-				assert(len >= 3);
-				do {
-					char32_t expected_ch;
-					--len;
-					expected_ch = unicode_readutf8((char const **)&newpc);
-					if (ch == expected_ch) {
-						while (len) {
-							newpc += unicode_utf8seqlen[*newpc];
-							--len;
-						}
-						pc = newpc;
-						goto REOP_CS_UTF8_onmatch;
-					}
-				} while (len);
-				pc = newpc;
-				goto REOP_CS_UTF8_dispatch;
-			}
+	case REOP_NCS_UTF8:
+	case REOP_NSEQ_UTF8:
+		while (iter < end && *iter < 0x80 && (pc[1 + *iter / 8] & (1 << (*iter % 8))) == 0)
+			++iter;
+		break;
 
-			case_RECS_ISX_MIN_to_MAX: {
-				uint16_t trait    = libre_unicode_traits[opcode - RECS_ISX_MIN];
-				uint16_t ch_flags = __unicode_descriptor(ch)->__ut_flags;
-				uint16_t ch_mask  = ch_flags & trait;
-				if (ch_mask != 0)
-					goto REOP_CS_UTF8_onmatch;
-				goto REOP_CS_UTF8_dispatch;
-			}
+	default:
+		while (iter < end && *iter < 0x80 && re_dfa_matchchar(pc, *iter))
+			++iter;
+		break;
+	}
+	return iter;
+}
 
-			default: __builtin_unreachable();
-			}
-REOP_CS_UTF8_onmatch:
-			pc = CS_UTF8_seek_end(pc);
-			DISPATCH();
+/* Consume as many (further) repetitions of the single-character opcode at `pc' as
+ * possible (s.a. `REOP_SPAN'), but only ever from the current chunk of input.
+ * @return: true:  Stopped because `pc' doesn't match the next character (or at the end of input)
+ * @return: false: Stopped early (at the end of the current chunk, or at a utf-8 sequence that
+ *                 isn't well-formed); the next repetition must be matched the normal way. */
+PRIVATE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_interpreter_span)(struct re_interpreter *__restrict self,
+                                    byte_t const *__restrict pc) {
+	byte_t const *iter = self->ri_in_ptr;
+	byte_t const *end  = self->ri_in_cend;
+	if (re_dfa_opkind(pc[0]) == RE_DFA_OP_BYTE) {
+		switch (pc[0]) {
+#ifdef REOP_ANY
+		case REOP_ANY:
+			iter = end;
+			break;
+#endif /* REOP_ANY */
+#if defined(REOP_ANY_NOTNUL) || defined(REOP_ANY_NOTNUL_UTF8)
+#ifdef REOP_ANY_NOTNUL
+		case REOP_ANY_NOTNUL:
+#endif /* REOP_ANY_NOTNUL */
+#ifdef REOP_ANY_NOTNUL_UTF8
+		case REOP_ANY_NOTNUL_UTF8:
+#endif /* REOP_ANY_NOTNUL_UTF8 */
+			iter = (byte_t const *)memchr(iter, '\0', (size_t)(end - iter));
+			if (iter == NULL)
+				iter = end;
+			break;
+#endif /* REOP_ANY_NOTNUL || REOP_ANY_NOTNUL_UTF8 */
+		case REOP_NBYTE:
+			iter = (byte_t const *)memchr(iter, pc[1], (size_t)(end - iter));
+			if (iter == NULL)
+				iter = end;
+			break;
+		case REOP_BYTE:
+			while (iter < end && *iter == pc[1])
+				++iter;
+			break;
+		case REOP_RANGE: {
+			byte_t lo = pc[1], width = (byte_t)(pc[2] - pc[1]);
+			while (iter < end && (byte_t)(*iter - lo) <= width)
+				++iter;
+		}	break;
+		case REOP_BITSET: {
+			byte_t const *bits = pc + 1;
+			while (iter < end && (bits[*iter / 8] & (1 << (*iter % 8))) != 0)
+				++iter;
+		}	break;
+		default:
+			while (iter < end && re_dfa_matchbyte(pc, *iter))
+				++iter;
+			break;
 		}
-
-		TARGET(REOP_NCS_UTF8) {
+	} else {
+		assert(re_dfa_opkind(pc[0]) == RE_DFA_OP_UTF8);
+		for (;;) {
 			char32_t ch;
-			if (re_interpreter_is_eoi(self))
-				ONFAIL();
-			ch = re_interpreter_readutf8(self);
-REOP_NCS_UTF8_dispatch:
-			opcode = getb();
-			switch (opcode) {
-
-			case_RECS_BITSET_MIN_to_MAX_UTF8: {
-				uint8_t bitset_minch = RECS_BITSET_GETBASE(opcode);
-				uint8_t bitset_size  = RECS_BITSET_GETBYTES(opcode);
-				byte_t bitset_rel_ch;
-				if (ch < 0x80 && !OVERFLOW_USUB((uint8_t)ch, bitset_minch, &bitset_rel_ch)) {
-					unsigned int bitset_bits = bitset_size * 8;
-					if (bitset_rel_ch < bitset_bits) {
-						if ((pc[bitset_rel_ch / 8] & (1 << (bitset_rel_ch % 8))) != 0)
-							ONFAIL();
-					}
-				}
-				pc += bitset_size;
-				goto REOP_NCS_UTF8_dispatch;
-			}
-
-			case RECS_DONE:
-				/* Reached the end of the char-set without a miss-match */
-				DISPATCH();
-
-			case RECS_CHAR: {
-				byte_t const *newpc = pc;
-				char32_t match;
-				match = unicode_readutf8((char const **)&newpc);
-				pc    = newpc;
-				if (ch == match)
-					ONFAIL();
-				goto REOP_NCS_UTF8_dispatch;
-			}
-
-			case RECS_CHAR2: {
-				byte_t const *newpc = pc;
-				char32_t match1, match2;
-				match1 = unicode_readutf8((char const **)&newpc);
-				match2 = unicode_readutf8((char const **)&newpc);
-				pc     = newpc;
-				if (ch == match1 || ch == match2)
-					ONFAIL();
-				goto REOP_NCS_UTF8_dispatch;
-			}
-
-			case RECS_RANGE: {
-				byte_t const *newpc = pc;
-				char32_t match_lo, match_hi;
-				match_lo = unicode_readutf8((char const **)&newpc);
-				match_hi = unicode_readutf8((char const **)&newpc);
-				pc       = newpc;
-				if (ch >= match_lo && ch <= match_hi)
-					ONFAIL();
-				goto REOP_NCS_UTF8_dispatch;
-			}
-
-			case RECS_RANGE_ICASE: {
-				byte_t const *newpc = pc;
-				char32_t match_lo, match_hi, lower_ch;
-				match_lo = unicode_readutf8((char const **)&newpc);
-				match_hi = unicode_readutf8((char const **)&newpc);
-				pc       = newpc;
-				lower_ch = unicode_tolower(ch);
-				if (lower_ch >= match_lo && lower_ch <= match_hi)
-					ONFAIL();
-				goto REOP_NCS_UTF8_dispatch;
-			}
-
-			case RECS_CONTAINS: {
-				byte_t len = getb();
-				byte_t const *newpc = pc;
-				assert(len >= 3);
-				do {
-					char32_t expected_ch;
-					--len;
-					expected_ch = unicode_readutf8((char const **)&newpc);
-					if (ch == expected_ch)
-						ONFAIL();
-				} while (len);
-				pc = newpc;
-				goto REOP_NCS_UTF8_dispatch;
-			}
-
-			case_RECS_ISX_MIN_to_MAX: {
-				uint16_t trait    = libre_unicode_traits[opcode - RECS_ISX_MIN];
-				uint16_t ch_flags = __unicode_descriptor(ch)->__ut_flags;
-				uint16_t ch_mask  = ch_flags & trait;
-				if (ch_mask != 0)
-					ONFAIL();
-				goto REOP_NCS_UTF8_dispatch;
-			}
-
-			default: __builtin_unreachable();
-			}
-			__builtin_unreachable();
-		}
-
-
-
-		/************************************************************************/
-		/* Group repetition                                                     */
-		/************************************************************************/
-		TARGET(REOP_GROUP_MATCH) {
-			byte_t gid = getb();
-			re_regmatch_t match;
-			assert(gid < self->ri_exec->rx_code->rc_ngrps);
-			match = self->ri_pmatch[gid];
-			if (match.rm_so == RE_REGOFF_UNSET ||
-			    match.rm_eo == RE_REGOFF_UNSET)
-				ONFAIL();
-			assertf(self->ri_pmatch[gid].rm_so <= self->ri_pmatch[gid].rm_eo,
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_so = %2$" PRIuSIZ "\n"
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_eo = %3$" PRIuSIZ,
-			        gid, (size_t)match.rm_so, (size_t)match.rm_eo);
-			if (match.rm_so < match.rm_eo) {
-				if (!re_interpreter_consume_repeat(self, match.rm_so,
-				                                   match.rm_eo - match.rm_so))
-					ONFAIL();
-			}
-			DISPATCH();
-		}
-
-		XTARGET(case_REOP_GROUP_MATCH_JMIN_to_JMAX) {
-			byte_t gid = getb();
-			re_regmatch_t match;
-			assert(gid < self->ri_exec->rx_code->rc_ngrps);
-			match = self->ri_pmatch[gid];
-			if (match.rm_so == RE_REGOFF_UNSET ||
-			    match.rm_eo == RE_REGOFF_UNSET)
-				ONFAIL();
-			assertf(self->ri_pmatch[gid].rm_so <= self->ri_pmatch[gid].rm_eo,
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_so = %2$" PRIuSIZ "\n"
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_eo = %3$" PRIuSIZ,
-			        gid, (size_t)match.rm_so, (size_t)match.rm_eo);
-			if (match.rm_so < match.rm_eo) {
-				if (!re_interpreter_consume_repeat(self, match.rm_so,
-				                                   match.rm_eo - match.rm_so))
-					ONFAIL();
-			} else {
-				/* Empty group -> do a custom jump-ahead */
-				pc += REOP_GROUP_MATCH_Joff(opcode);
-			}
-			DISPATCH();
-		}
-
-
-
-		/************************************************************************/
-		/* Opcodes for asserting the current position in input (these don't consume anything) */
-		/************************************************************************/
-		TARGET(REOP_AT_SOI) {
-			/* Start-of-input */
-			if (!re_interpreter_is_soi(self))
-				ONFAIL();
-			DISPATCH();
-		}
-
-		TARGET(REOP_AT_EOI) {
-			/* End-of-input */
-			if (!re_interpreter_is_eoi(self))
-				ONFAIL();
-			DISPATCH();
-		}
-
-		TARGET(REOP_AT_SOL) {
-			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
-			if (re_interpreter_is_soi(self)) {
-				DISPATCH();
-			} else {
-				byte_t prevbyte;
-				prevbyte = re_interpreter_prevbyte(self);
-				if (ascii_islf(prevbyte))
-					DISPATCH();
-			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_SOL_UTF8) {
-			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
-			if (re_interpreter_is_soi(self)) {
-				DISPATCH();
-			} else {
-				char32_t prevchar;
-				prevchar = re_interpreter_prevutf8(self);
-				if (unicode_islf(prevchar))
-					DISPATCH();
-			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_EOL) {
-			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
-			if (re_interpreter_is_eoiX(self)) {
-				DISPATCH();
-			} else {
-				byte_t nextbyte;
-				nextbyte = re_interpreter_nextbyte(self);
-				if (ascii_islf(nextbyte))
-					DISPATCH();
-			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_EOL_UTF8) {
-			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
-			if (re_interpreter_is_eoiX(self)) {
-				DISPATCH();
-			} else {
-				char32_t nextchar;
-				nextchar = re_interpreter_nextutf8(self);
-				if (unicode_islf(nextchar))
-					DISPATCH();
-			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_SOXL) {
-			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
-			if (re_interpreter_is_soi(self)) {
-				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTBOL))
-					DISPATCH();
-			} else {
-				byte_t prevbyte;
-				prevbyte = re_interpreter_prevbyte(self);
-				if (ascii_islf(prevbyte))
-					DISPATCH();
-			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_SOXL_UTF8) {
-			/* Start-of-line (following a line-feed, or `REOP_AT_SOI' unless `RE_EXEC_NOTBOL' was set) */
-			if (re_interpreter_is_soi(self)) {
-				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTBOL))
-					DISPATCH();
-			} else {
-				char32_t prevchar;
-				prevchar = re_interpreter_prevutf8(self);
-				if (unicode_islf(prevchar))
-					DISPATCH();
-			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_EOXL) {
-			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
-			if (re_interpreter_is_eoiX(self)) {
-				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTEOL))
-					DISPATCH();
-			} else {
-				byte_t nextbyte;
-				nextbyte = re_interpreter_nextbyte(self);
-				if (ascii_islf(nextbyte))
-					DISPATCH();
-			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_EOXL_UTF8) {
-			/* End-of-line (preceding a line-feed, or `REOP_AT_EOI' unless `RE_EXEC_NOTEOL' was set) */
-			if (re_interpreter_is_eoiX(self)) {
-				if (!(self->ri_exec->rx_eflags & RE_EXEC_NOTEOL))
-					DISPATCH();
+			byte_t const *next;
+			iter = re_span_ascii(pc, iter, end);
+			if (iter >= end || *iter < 0x80)
+				break;
+			if (pc[0] == REOP_SEQ_UTF8 || pc[0] == REOP_NSEQ_UTF8) {
+				size_t seqlen = utf8_shortestlen(iter, end);
+				if (!seqlen)
+					goto stop_early;
+				if (SEQ_UTF8_contains(pc + 1, iter) != (pc[0] == REOP_SEQ_UTF8))
+					break;
+				iter += seqlen;
+				continue;
 			} else {
-				char32_t nextchar;
-				nextchar = re_interpreter_nextutf8(self);
-				if (unicode_islf(nextchar))
-					DISPATCH();
+				uint8_t i, seqlen = unicode_utf8seqlen[*iter];
+				if (seqlen < 2 || seqlen > (size_t)(end - iter))
+					goto stop_early;
+				for (i = 1; i < seqlen; ++i) {
+					if ((iter[i] & 0xc0) != 0x80)
+						goto stop_early;
+				}
 			}
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_WOB)     /* WOrdBoundary (preceding and next character have non-equal `issymcont(ch)'; OOB counts as `issymcont == false') */
-		TARGET(REOP_AT_WOB_NOT) /* NOT WOrdBoundary (preceding and next character have equal `issymcont(ch)'; OOB counts as `issymcont == false') */
-		TARGET(REOP_AT_SOW)     /* StartOfWord (preceding and next character are `!issymcont(lhs) && issymcont(rhs)'; OOB counts as `issymcont == false') */
-		TARGET(REOP_AT_EOW)     /* EndOfWord (preceding and next character are `issymcont(lhs) && !issymcont(rhs)'; OOB counts as `issymcont == false') */
-		{
-			bool previs = re_interpreter_is_soi(self) ? false : !!issymcont(re_interpreter_prevbyte(self));
-			bool nextis = re_interpreter_is_eoiX(self) ? false : !!issymcont(re_interpreter_nextbyte(self));
-			bool ismatch;
-			switch (opcode) {
-			case REOP_AT_WOB:
-				ismatch = previs != nextis;
-				break;
-			case REOP_AT_WOB_NOT:
-				ismatch = previs == nextis;
-				break;
-			case REOP_AT_SOW:
-				ismatch = !previs && nextis;
+			next = iter;
+			ch   = unicode_readutf8((char const **)&next);
+			if (!re_dfa_matchchar(pc, ch))
 				break;
-			case REOP_AT_EOW:
-				ismatch = previs && !nextis;
-				break;
-			default: __builtin_unreachable();
-			}
-			if (ismatch)
-				DISPATCH();
-			ONFAIL();
+			iter = next;
 		}
+	}
+	self->ri_in_ptr = iter;
+	return iter < end || re_interpreter_is_eoi(self);
+stop_early:
+	self->ri_in_ptr = iter;
+	return false;
+}
 
-		TARGET(REOP_AT_WOB_UTF8)     /* WOrdBoundary (preceding and next character have non-equal `issymcont(ch)'; OOB counts as `issymcont == false') */
-		TARGET(REOP_AT_WOB_UTF8_NOT) /* NOT WOrdBoundary (preceding and next character have equal `issymcont(ch)'; OOB counts as `issymcont == false') */
-		TARGET(REOP_AT_SOW_UTF8)     /* StartOfWord (preceding and next character are `!issymcont(lhs) && issymcont(rhs)'; OOB counts as `issymcont == false') */
-		TARGET(REOP_AT_EOW_UTF8)     /* EndOfWord (preceding and next character are `issymcont(lhs) && !issymcont(rhs)'; OOB counts as `issymcont == false') */
-		{
-			bool previs = re_interpreter_is_soi(self) ? false : !!unicode_issymcont(re_interpreter_prevutf8(self));
-			bool nextis = re_interpreter_is_eoiX(self) ? false : !!unicode_issymcont(re_interpreter_nextutf8(self));
-			bool ismatch;
-			switch (opcode) {
-			case REOP_AT_WOB_UTF8:
-				ismatch = previs != nextis;
-				break;
-			case REOP_AT_WOB_UTF8_NOT:
-				ismatch = previs == nextis;
-				break;
-			case REOP_AT_SOW_UTF8:
-				ismatch = !previs && nextis;
-				break;
-			case REOP_AT_EOW_UTF8:
-				ismatch = previs && !nextis;
+/* Go back by 1 character consumed by `re_interpreter_span()' for the opcode at `pc' */
+PRIVATE NONNULL((1, 2)) void
+NOTHROW_NCX(CC re_interpreter_span_unget)(struct re_interpreter *__restrict self,
+                                          byte_t const *__restrict pc) {
+	size_t offset = re_interpreter_in_curoffset(self) - 1;
+	if (re_dfa_opkind(pc[0]) == RE_DFA_OP_UTF8) {
+		/* `re_interpreter_span()' only consumes well-formed sequences */
+		for (;;) {
+			re_interpreter_setoffset(self, offset);
+			if ((re_interpreter_nextbyte(self) & 0xc0) != 0x80)
 				break;
-			default: __builtin_unreachable();
-			}
-			if (ismatch)
-				DISPATCH();
-			ONFAIL();
-		}
-
-		TARGET(REOP_AT_SOS_UTF8) {
-			/* StartOfSymbol (preceding and next character are `!issymcont(lhs) && issymstrt(rhs)'; OOB counts as `issymcont[/strt] == false') */
-			bool previs = re_interpreter_is_soi(self) ? false : !!unicode_issymcont(re_interpreter_prevutf8(self));
-			bool nextis = re_interpreter_is_eoiX(self) ? false : !!unicode_issymstrt(re_interpreter_nextutf8(self));
-			if (!previs && nextis)
-				DISPATCH();
-			ONFAIL();
+			--offset;
 		}
+	}
+	re_interpreter_setoffset(self, offset);
+}
 
+/* Go back to the last offset in `minoff...re_interpreter_in_curoffset(self)' from where the
+ * literal at `pc' (which follows a `REOP_SPAN_LIT*' for the opcode at `loop_pc') can match,
+ * so that give-backs don't have to try offsets where it doesn't appear one at a time.
+ * @return: true:  Success (the current offset was updated)
+ * @return: false: No offset can match */
+PRIVATE WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_interpreter_span_seek)(struct re_interpreter *__restrict self,
+                                         byte_t const *__restrict loop_pc,
+                                         byte_t const *__restrict pc,
+                                         size_t minoff) {
+	byte_t const *lit;
+	size_t litlen, offset;
+	while (pc[0] == REOP_GROUP_START || pc[0] == REOP_GROUP_END)
+		pc += 2; /* Never fail */
+	if (pc[0] == REOP_BYTE) {
+		lit    = pc + 1;
+		litlen = 1;
+	} else {
+		assert(pc[0] == REOP_EXACT);
+		lit    = pc + 2;
+		litlen = pc[1];
+	}
+	if ((lit[0] & 0xc0) == 0x80 && re_dfa_opkind(loop_pc[0]) == RE_DFA_OP_UTF8)
+		return true; /* Could be part of a multi-byte character */
+	offset = re_interpreter_in_curoffset(self);
+	for (;;) {
+		byte_t const *ptr = self->ri_in_ptr;
+		byte_t const *hit;
+		size_t count, avail = (size_t)(self->ri_in_cend - ptr);
+		if (avail == 0) {
+			if (!re_interpreter_is_eoi(self))
+				return true; /* Literal might be in the next chunk */
+		} else if (ptr[0] == lit[0]) {
+			/* Only compare what's in this chunk (the rest is left to the interpreter) */
+			if (avail > litlen)
+				avail = litlen;
+			if (bcmp(ptr + 1, lit + 1, avail - 1) == 0)
+				return true;
+		}
+		if (offset <= minoff)
+			return false;
+		count = offset - minoff;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		if (count > (size_t)(ptr - self->ri_in_cbase))
+			return true; /* Spans chunks */
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		hit = (byte_t const *)memrchr(ptr - count, lit[0], count);
+		if (hit == NULL)
+			return false;
+		self->ri_in_ptr = hit;
+		offset -= (size_t)(ptr - hit);
+	}
+}
 
-
-
-		/************************************************************************/
-		/* Opcodes for expression logic and processing.                         */
-		/************************************************************************/
-		TARGET(REOP_GROUP_START) {
-			byte_t gid = getb();
-			assert(gid < self->ri_exec->rx_code->rc_ngrps);
-			if (self->ri_onfailc && /* No need to make a backup if it can't be restored */
-			    (self->ri_pmatch[gid].rm_so != re_interpreter_in_curoffset(self))) {
-				/* Must push (or override an old) on-fail item to restore old group start-offset */
-				size_t i = self->ri_onfailc;
-				do {
-					byte_t const *oldin;
-					--i;
-					oldin = self->ri_onfailv[i].rof_in;
-					if (RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(oldin)) {
-						/* Check if we can override this on-fail item. */
-						if (RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(oldin) &&
-						    RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(oldin) == gid) {
-							self->ri_onfailv[i].rof_pc = (byte_t const *)(uintptr_t)self->ri_pmatch[gid].rm_so;
-							goto do_set_group_so_and_dispatch;
-						}
-					} else {
-						/* Must actually push an new on-fail item. */
-						break;
-					}
-				} while (i);
-				/* Push a new on-fail item. */
-				PUSHFAIL_EX(RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE(1, gid),
-				            (byte_t const *)(uintptr_t)self->ri_pmatch[gid].rm_so);
-			}
-do_set_group_so_and_dispatch:
-			/* Set start-of-group offset */
-			self->ri_pmatch[gid].rm_so = re_interpreter_in_curoffset(self);
-			DISPATCH();
+/* Advance the input pointer of `self' to the next offset where input starts
+ * with the literal prefix of `self->ri_exec->rx_code' (which must be  non-
+ * empty), skipping at most `max_skip' bytes in the process.
+ * Prefixes crossing chunk boundaries are always considered candidates.
+ * @return: * : The # of bytes skipped (`>= max_skip' if no candidate exists) */
+PRIVATE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_skip_to_prefix)(struct re_interpreter *__restrict self,
+                                              size_t max_skip) {
+	struct re_code const *code = self->ri_exec->rx_code;
+	byte_t const *prefix = code->rc_code + code->rc_pfxoff;
+	size_t result = 0;
+	assert(code->rc_pfxlen != 0);
+	for (;;) {
+		byte_t const *hit;
+		size_t avail = re_interpreter_in_chunkleft(self);
+		if (avail > max_skip - result)
+			avail = max_skip - result;
+		hit = (byte_t const *)memchr(self->ri_in_ptr, prefix[0], avail);
+		if (hit) {
+			result += (size_t)(hit - self->ri_in_ptr);
+			self->ri_in_ptr = hit;
+			if ((size_t)(self->ri_in_cend - hit) < code->rc_pfxlen ||
+			    bcmp(hit + 1, prefix + 1, code->rc_pfxlen - 1) == 0)
+				break; /* Candidate found */
+			++self->ri_in_ptr;
+			++result;
+		} else {
+			result += avail;
+			self->ri_in_ptr += avail;
 		}
+		if (result >= max_skip)
+			break;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		if (!re_interpreter_in_chunk_cangetc(self))
+			re_interpreter_nextchunk(self);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	}
+	return result;
+}
 
-		TARGET(REOP_GROUP_END) {
-			byte_t gid = getb();
-			assert(gid < self->ri_exec->rx_code->rc_ngrps);
-			if (self->ri_onfailc && /* No need to make a backup if it can't be restored */
-			    (self->ri_pmatch[gid].rm_eo != re_interpreter_in_curoffset(self))) {
-				/* Must push (or override an old) on-fail item to restore old group end-offset */
-				size_t i = self->ri_onfailc;
-				do {
-					byte_t const *oldin;
-					--i;
-					oldin = self->ri_onfailv[i].rof_in;
-					if (RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(oldin)) {
-						/* Check if we can override this on-fail item. */
-						if (!RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(oldin) &&
-						    RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(oldin) == gid) {
-							self->ri_onfailv[i].rof_pc = (byte_t const *)(uintptr_t)self->ri_pmatch[gid].rm_eo;
-							goto do_set_group_eo_and_dispatch;
-						}
-					} else {
-						/* Must actually push an new on-fail item. */
-						break;
-					}
-				} while (i);
-				/* Push a new on-fail item. */
-				PUSHFAIL_EX(RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE(0, gid),
-				            (byte_t const *)(uintptr_t)self->ri_pmatch[gid].rm_eo);
-			}
-do_set_group_eo_and_dispatch:
-			/* Set end-of-group offset */
-			self->ri_pmatch[gid].rm_eo = re_interpreter_in_curoffset(self);
-			assertf(self->ri_pmatch[gid].rm_so <= self->ri_pmatch[gid].rm_eo,
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_so = %2$" PRIuSIZ "\n"
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_eo = %3$" PRIuSIZ,
-			        gid,
-			        (size_t)self->ri_pmatch[gid].rm_so,
-			        (size_t)self->ri_pmatch[gid].rm_eo);
-			DISPATCH();
-		}
+/* Check if one of the literals of `code' (s.a. `rc_mlits') may start at `ptr'.
+ * Literals crossing the end of the chunk at `cend' are always considered candidates. */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_mlits_at)(struct re_code const *__restrict code,
+                            byte_t const *ptr, byte_t const *cend) {
+	size_t i, len = code->rc_mllen;
+	if (len > (size_t)(cend - ptr))
+		len = (size_t)(cend - ptr);
+	for (i = 0; i < code->rc_mlcount; ++i) {
+		if (bcmp(ptr, code->rc_mlits[i], len) == 0)
+			return true;
+	}
+	return false;
+}
 
-		XTARGET(case_REOP_GROUP_END_JMIN_to_JMAX) {
-			byte_t gid = getb();
-			assert(gid < self->ri_exec->rx_code->rc_ngrps);
-			if (self->ri_onfailc && /* No need to make a backup if it can't be restored */
-			    (self->ri_pmatch[gid].rm_eo != re_interpreter_in_curoffset(self))) {
-				/* Must push (or override an old) on-fail item to restore old group end-offset */
-				size_t i = self->ri_onfailc;
-				do {
-					byte_t const *oldin;
-					--i;
-					oldin = self->ri_onfailv[i].rof_in;
-					if (RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(oldin)) {
-						/* Check if we can override this on-fail item. */
-						if (!RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(oldin) &&
-						    RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(oldin) == gid) {
-							self->ri_onfailv[i].rof_pc = (byte_t const *)(uintptr_t)self->ri_pmatch[gid].rm_eo;
-							goto do_set_group_eo_and_dispatch_j;
-						}
-					} else {
-						/* Must actually push an new on-fail item. */
-						break;
+/* Advance the input pointer of `self' to the next offset where input starts with
+ * one of the literals of `self->ri_exec->rx_code' (s.a. `rc_mlits'), skipping at
+ * most `max_skip' bytes in the process. Input is checked for all literals at once
+ * for `sizeof(size_t)' offsets at a time (by comparing their leading bytes in every
+ * byte-lane of a machine word), and only offsets where that finds a possible match
+ * are compared one at a time.
+ * @return: * : The # of bytes skipped (`>= max_skip' if no candidate exists) */
+PRIVATE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_skip_to_mlits)(struct re_interpreter *__restrict self,
+                                             size_t max_skip) {
+	struct re_code const *code = self->ri_exec->rx_code;
+	size_t lanes[RE_CODE_MLITS_MAX][RE_CODE_MLITS_LEN];
+	size_t i, j, count = code->rc_mlcount, len = code->rc_mllen;
+	size_t result = 0;
+	assert(count != 0);
+	assert(len >= 2 && len <= RE_CODE_MLITS_LEN);
+	for (i = 0; i < count; ++i) {
+		for (j = 0; j < len; ++j)
+			lanes[i][j] = RE_WORD_ONES * code->rc_mlits[i][j];
+	}
+	for (;;) {
+		byte_t const *ptr, *end;
+		size_t avail = re_interpreter_in_chunkleft(self);
+		if (avail > max_skip - result)
+			avail = max_skip - result;
+		ptr = self->ri_in_ptr;
+		end = ptr + avail;
+		while (ptr < end) {
+			if ((size_t)(end - ptr) >= sizeof(size_t) &&
+			    (size_t)(self->ri_in_cend - ptr) >= sizeof(size_t) + len - 1) {
+				size_t hits = 0;
+				for (i = 0; i < count; ++i) {
+					size_t lit_hits = (size_t)-1;
+					for (j = 0; j < len; ++j) {
+						size_t word;
+						memcpy(&word, ptr + j, sizeof(size_t));
+						lit_hits &= RE_WORD_ZEROBYTES(word ^ lanes[i][j]);
 					}
-				} while (i);
-				/* Push a new on-fail item. */
-				PUSHFAIL_EX(RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE(0, gid),
-				            (byte_t const *)(uintptr_t)self->ri_pmatch[gid].rm_eo);
-			}
-do_set_group_eo_and_dispatch_j:
-			/* Set end-of-group offset */
-			self->ri_pmatch[gid].rm_eo = re_interpreter_in_curoffset(self);
-			assertf(self->ri_pmatch[gid].rm_so <= self->ri_pmatch[gid].rm_eo,
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_so = %2$" PRIuSIZ "\n"
-			        "self->ri_pmatch[%1$" PRIu8 "].rm_eo = %3$" PRIuSIZ,
-			        gid,
-			        (size_t)self->ri_pmatch[gid].rm_so,
-			        (size_t)self->ri_pmatch[gid].rm_eo);
-			if (self->ri_pmatch[gid].rm_so >= self->ri_pmatch[gid].rm_eo) {
-				/* Group matched epsilon -> must skip ahead a little bit */
-				pc += REOP_GROUP_END_Joff(opcode);
-			}
-			DISPATCH();
-		}
-
-		TARGET(REOP_POP_ONFAIL) {
-			if (self->ri_onfailc > 0) { /* Can be `0' because of the fmap */
-				do {
-					--self->ri_onfailc;
-				} while (self->ri_onfailc && /* vvv keep popping until the stack becomes empty,
-				                              *     of we removed a non-group-restore  element. */
-				         RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(self->ri_onfailv[self->ri_onfailc].rof_in));
-			}
-			DISPATCH();
-		}
-
-		TARGET(REOP_POP_ONFAIL_AT) {
-			int16_t delta = getw();
-			byte_t const *target_pc;
-			target_pc = pc + delta;
-			while (self->ri_onfailc > 0) { /* pc might not exist because of the fmap */
-				--self->ri_onfailc;
-				if (self->ri_onfailv[self->ri_onfailc].rof_pc == target_pc &&
-				    !RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(self->ri_onfailv[self->ri_onfailc].rof_in))
-					break;
+					hits |= lit_hits;
+				}
+				if (hits == 0) {
+					ptr += sizeof(size_t); /* No literal starts at any of these offsets */
+					continue;
+				}
 			}
-			DISPATCH();
-		}
-
-		TARGET(REOP_JMP_ONFAIL) {
-			int16_t delta = getw();
-			PUSHFAIL(pc + delta);
-			DISPATCH();
-		}
-
-		TARGET(REOP_JMP_ONFAIL_DUMMY_AT) {
-			int16_t delta = getw();
-			PUSHFAIL_DUMMY(pc + delta);
-			DISPATCH();
-		}
-
-		TARGET(REOP_JMP_ONFAIL_DUMMY) {
-			PUSHFAIL_DUMMY(NULL);
-			DISPATCH();
-		}
-
-		TARGET(REOP_JMP) {
-			int16_t delta = getw();
-			pc += delta;
-			DISPATCH();
-		}
+			if (re_mlits_at(code, ptr, self->ri_in_cend))
+				break; /* Candidate found */
+			++ptr;
+		}
+		result += (size_t)(ptr - self->ri_in_ptr);
+		self->ri_in_ptr = ptr;
+		if (ptr < end)
+			break; /* Candidate found */
+		if (result >= max_skip)
+			break;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		re_interpreter_nextchunk(self);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	}
+	return result;
+}
 
-		TARGET(REOP_JMP_AND_RETURN_ONFAIL) {
-			int16_t delta = getw();
-			PUSHFAIL(pc);
-			pc += delta;
-			DISPATCH();
-		}
+/* Advance the input pointer of `self' to the next offset whose byte isn't
+ * rejected by the fast-map of `self->ri_exec->rx_code' (which must not be
+ * able to match epsilon), skipping at most `max_skip' bytes.
+ * @return: * : The # of bytes skipped (`>= max_skip' if no candidate exists) */
+PRIVATE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_skip_fmap)(struct re_interpreter *__restrict self,
+                                         size_t max_skip) {
+	byte_t const *fmap = self->ri_exec->rx_code->rc_fmap;
+	size_t result = 0;
+	assert(self->ri_exec->rx_code->rc_minmatch != 0);
+	for (;;) {
+		byte_t const *ptr, *end;
+		size_t avail = re_interpreter_in_chunkleft(self);
+		if (avail > max_skip - result)
+			avail = max_skip - result;
+		ptr = self->ri_in_ptr;
+		end = ptr + avail;
+		while (ptr < end && fmap[*ptr] == 0xff)
+			++ptr;
+		result += (size_t)(ptr - self->ri_in_ptr);
+		self->ri_in_ptr = ptr;
+		if (ptr < end)
+			break; /* Candidate found */
+		if (result >= max_skip)
+			break;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		re_interpreter_nextchunk(self);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	}
+	return result;
+}
 
-		TARGET(REOP_DEC_JMP) {
-			byte_t varid = getb();
-			int16_t delta = getw();
-			assert(varid < self->ri_exec->rx_code->rc_nvars);
-			if (self->ri_vars[varid] != 0) {
-				--self->ri_vars[varid];
-				pc += delta;
-				DISPATCH();
+/* Same as `re_interpreter_skip_fmap()', but move the input pointer backwards. */
+PRIVATE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_rskip_fmap)(struct re_interpreter *__restrict self,
+                                          size_t max_skip) {
+	byte_t const *fmap = self->ri_exec->rx_code->rc_fmap;
+	size_t result = 0;
+	assert(self->ri_exec->rx_code->rc_minmatch != 0);
+	for (;;) {
+		byte_t const *ptr;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		/* Since the code can't match epsilon, there must be more input if we're at the end of a chunk. */
+		if (!re_interpreter_in_chunk_cangetc(self))
+			re_interpreter_nextchunk(self);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		ptr = self->ri_in_ptr;
+		for (;;) {
+			if (fmap[*ptr] != 0xff) {
+				self->ri_in_ptr = ptr;
+				return result; /* Candidate found */
 			}
-			DISPATCH();
-		}
-
-		TARGET(REOP_DEC_JMP_AND_RETURN_ONFAIL) {
-			byte_t varid = getb();
-			int16_t delta = getw();
-			assert(varid < self->ri_exec->rx_code->rc_nvars);
-			if (self->ri_vars[varid] != 0) {
-				--self->ri_vars[varid];
-				PUSHFAIL(pc);
-				pc += delta;
-				DISPATCH();
+			if (++result >= max_skip) {
+				self->ri_in_ptr = ptr;
+				return result;
 			}
-			DISPATCH();
-		}
-
-		TARGET(REOP_SETVAR) {
-			byte_t varid = getb();
-			byte_t value = getb();
-			assert(varid < self->ri_exec->rx_code->rc_nvars);
-			/* Assign value to variable */
-			self->ri_vars[varid] = value;
-			DISPATCH();
+			if (ptr <= self->ri_in_cbase)
+				break;
+			--ptr;
 		}
+		self->ri_in_ptr = ptr;
+		re_interpreter_inptr_in_reverse1(&self->ri_in);
+	}
+}
 
-		TARGET(REOP_NOP) {
-			DISPATCH();
-		}
+/* Skip input that can be proven to never be the start of a match, using either
+ * the literal prefix, the literal starts, or the fast-map of `self->ri_exec->rx_code'.
+ * @return: * : The # of bytes skipped (`>= max_skip' if no candidate exists) */
+INTERN WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_skip_candidates)(struct re_interpreter *__restrict self,
+                                               size_t max_skip) {
+	struct re_code const *code = self->ri_exec->rx_code;
+	if (code->rc_pfxlen != 0)
+		return re_interpreter_skip_to_prefix(self, max_skip);
+	if (code->rc_mlcount != 0)
+		return re_interpreter_skip_to_mlits(self, max_skip);
+	if (code->rc_minmatch != 0)
+		return re_interpreter_skip_fmap(self, max_skip);
+	return 0;
+}
 
-		TARGET(REOP_MATCHED) {
-			/* Compare with a previous match. */
-			if (self->ri_onfailc != 0) {
-				/* Check if our current match is the best it can get. */
-				if (re_interpreter_is_eoi(self)) {
-					/* No need to keep going! -- It can't get any better than this.
-					 *
-					 * BUT: if the caller  also wants  group matches, we  have to  find
-					 *      the best one of those, also (so no early exit in that case) */
-					if (self->ri_exec->rx_nmatch == 0)
-						return -RE_NOERROR;
-				}
+/* Check if the `REOP_AT_*' opcode `opcode' holds at the current position of `self' */
+INTERN WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_interpreter_at)(struct re_interpreter *__restrict self, byte_t opcode) {
+	bool previs, nextis;
+	switch (opcode) {
 
-				/* Still have to roll back in order test more code-paths
-				 * -> In  this case,  check if  the current  match is better
-				 *    than the previous best match, and replace the previous
-				 *    one if the new one is better. */
-				if (!best_match_isvalid() ||
-				    ((re_interpreter_in_curoffset_or_ptr(self) > re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch)) ||
-				     (re_interpreter_in_curoffset_or_ptr(self) == re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch) &&
-				      (self->ri_exec->rx_nmatch && is_regmatch_better(self->ri_pmatch, self->ri_bmatch_g,
-				                                                      self->ri_exec->rx_code->rc_ngrps))))) {
-					struct re_exec const *exec;
-					/* Check if also have to  save the current state of  group-matches
-					 * This is only necessary if the caller wants us to produce group-
-					 * range match offsets. */
-					exec = self->ri_exec;
-					if (exec->rx_nmatch) {
-						if (!best_match_isvalid()) {
-							self->ri_bmatch_g = (re_regmatch_t *)alloca(exec->rx_code->rc_ngrps *
-							                                            sizeof(re_regmatch_t));
-						}
-						memcpyc(self->ri_bmatch_g, self->ri_pmatch,
-						        exec->rx_code->rc_ngrps,
-						        sizeof(re_regmatch_t));
-					}
-					self->ri_bmatch = self->ri_in;
-				}
-				ONFAIL();
-			}
+	case REOP_AT_SOI:
+		return re_interpreter_is_soi(self);
+
+	case REOP_AT_EOI:
+		return re_interpreter_is_eoi(self);
+
+	case REOP_AT_SOL:
+	case REOP_AT_SOXL:
+		if (re_interpreter_is_soi(self))
+			return opcode == REOP_AT_SOL || !(self->ri_exec->rx_eflags & RE_EXEC_NOTBOL);
+		return ascii_islf(re_interpreter_prevbyte(self));
+
+	case REOP_AT_SOL_UTF8:
+	case REOP_AT_SOXL_UTF8:
+		if (re_interpreter_is_soi(self))
+			return opcode == REOP_AT_SOL_UTF8 || !(self->ri_exec->rx_eflags & RE_EXEC_NOTBOL);
+		return unicode_islf(re_interpreter_prevutf8(self));
+
+	case REOP_AT_EOL:
+	case REOP_AT_EOXL:
+		if (re_interpreter_is_eoiX(self))
+			return opcode == REOP_AT_EOL || !(self->ri_exec->rx_eflags & RE_EXEC_NOTEOL);
+		return ascii_islf(re_interpreter_nextbyte(self));
+
+	case REOP_AT_EOL_UTF8:
+	case REOP_AT_EOXL_UTF8:
+		if (re_interpreter_is_eoiX(self))
+			return opcode == REOP_AT_EOL_UTF8 || !(self->ri_exec->rx_eflags & RE_EXEC_NOTEOL);
+		return unicode_islf(re_interpreter_nextutf8(self));
+
+	case REOP_AT_WOB:
+	case REOP_AT_WOB_NOT:
+	case REOP_AT_SOW:
+	case REOP_AT_EOW:
+		previs = re_interpreter_is_soi(self) ? false : !!issymcont(re_interpreter_prevbyte(self));
+		nextis = re_interpreter_is_eoiX(self) ? false : !!issymcont(re_interpreter_nextbyte(self));
+		break;
 
-			/* No more on-fail branches
-			 * -> check  if the current match is better than the best. If
-			 *    it isn't, then restore the best match before returning. */
-			if (best_match_isvalid() &&
-			    ((re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch) > re_interpreter_in_curoffset_or_ptr(self)) ||
-			     (re_interpreter_in_curoffset_or_ptr(&self->ri_bmatch) == re_interpreter_in_curoffset_or_ptr(self) &&
-			      (self->ri_exec->rx_nmatch && is_regmatch_better(self->ri_bmatch_g, self->ri_pmatch,
-			                                                      self->ri_exec->rx_code->rc_ngrps))))) {
-return_best_match:
-				self->ri_in = self->ri_bmatch;
-				if (self->ri_exec->rx_nmatch) {
-					/* Must also restore the current state of group-matches */
-					memcpyc(self->ri_pmatch, self->ri_bmatch_g,
-					        self->ri_exec->rx_code->rc_ngrps,
-					        sizeof(re_regmatch_t));
-				}
-			}
-			/* Fallthru to the PERFECT_MATCH opcode */
-			return -RE_NOERROR;
-		}
+	case REOP_AT_WOB_UTF8:
+	case REOP_AT_WOB_UTF8_NOT:
+	case REOP_AT_SOW_UTF8:
+	case REOP_AT_EOW_UTF8:
+		previs = re_interpreter_is_soi(self) ? false : !!unicode_issymcont(re_interpreter_prevutf8(self));
+		nextis = re_interpreter_is_eoiX(self) ? false : !!unicode_issymcont(re_interpreter_nextutf8(self));
+		break;
 
-		TARGET(REOP_MATCHED_PERFECT) {
-			/* Just indicate success for the current match! */
-			return -RE_NOERROR;
-		}
+	case REOP_AT_SOS_UTF8:
+		previs = re_interpreter_is_soi(self) ? false : !!unicode_issymcont(re_interpreter_prevutf8(self));
+		nextis = re_interpreter_is_eoiX(self) ? false : !!unicode_issymstrt(re_interpreter_nextutf8(self));
+		return !previs && nextis;
 
+	default: __builtin_unreachable();
+	}
+	switch (opcode) {
+	case REOP_AT_WOB:
+	case REOP_AT_WOB_UTF8:
+		return previs != nextis;
+	case REOP_AT_WOB_NOT:
+	case REOP_AT_WOB_UTF8_NOT:
+		return previs == nextis;
+	case REOP_AT_SOW:
+	case REOP_AT_SOW_UTF8:
+		return !previs && nextis;
 	default:
-		__builtin_unreachable();
-		break;
+		return previs && !nextis;
 	}
-	__builtin_unreachable();
-	{
-		struct re_onfailure_item *item;
-onfail:
-		if (self->ri_onfailc <= 0) {
-			/* If there was a match, then return it. */
-			if (best_match_isvalid())
-				goto return_best_match;
-			if (self->ri_flags & RE_INTERPRETER_F_RSGRPS) {
-				/* Regular match fail while doing a search -> must reset groups. */
-				memsetc(self->ri_pmatch, RE_REGOFF_UNSET,
-				        self->ri_exec->rx_code->rc_ngrps * 2,
-				        sizeof(re_regoff_t));
-			}
-			return -RE_NOMATCH;
+}
+
+/* Execute `self', using `*p_dfa' (if non-NULL), or `*p_pike' (if non-NULL)
+ * instead of `libre_interp_exec()'. If the DFA gives up, it is destroyed, and
+ * `*p_dfa' is set to `NULL' (with `RE_EXEC_LINEAR', the pike VM is used next,
+ * and if that gives up as well, `-RE_ENOSYS' is returned).
+ * If the on-fail stack of `libre_interp_exec()' becomes too large, try to
+ * create a DFA (and store it in `*p_dfa') to execute `self' with instead. */
+INTERN WUNUSED NONNULL((1, 2, 3)) re_errno_t
+NOTHROW_NCX(CC re_interpreter_exec)(struct re_interpreter *__restrict self,
+                                    struct re_dfa **__restrict p_dfa,
+                                    struct re_pike **__restrict p_pike) {
+	re_errno_t result;
+	struct re_interpreter_inptr oldin;
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	/* Search loops can leave the input pointer at the end of a chunk (which
+	 * would look like the end of input if it isn't the last one) */
+	if (!re_interpreter_in_chunk_cangetc(self) && !re_interpreter_in_islastchunk(self))
+		re_interpreter_nextchunk(self);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	oldin = self->ri_in;
+	if (*p_dfa != NULL) {
+		result = re_dfa_exec(*p_dfa, self);
+		if likely(result != RE_DFA_FALLBACK)
+			return result;
+		re_dfa_destroy(*p_dfa);
+		*p_dfa = NULL;
+		self->ri_in = oldin;
+		if (*p_pike == NULL) {
+			/* Without `RE_EXEC_LINEAR', this is where the pike VM would come from */
+			*p_pike = re_pike_new(self->ri_exec, &result);
+			if unlikely(result != RE_NOERROR)
+				return -result;
+			if (*p_pike == NULL)
+				return re_interpreter_run(self);
 		}
-		item = &self->ri_onfailv[--self->ri_onfailc];
-		/* Check for special on-fail stack items. */
-		if (RE_ONFAILURE_ITEM_SPECIAL_CHECK(item->rof_in)) {
-			re_regoff_t regoff;
-			uint8_t gid;
-			if (item->rof_in == RE_ONFAILURE_ITEM_DUMMY_INPTR)
-				goto onfail; /* Skip dummy on-fail stack element. */
-
-			/* Restore group start/end offset. */
-			gid = RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(item->rof_in);
-			assert(gid < self->ri_exec->rx_code->rc_ngrps);
-			regoff = (re_regoff_t)(uintptr_t)item->rof_pc;
-			if (RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(item->rof_in)) {
-				TRACE("%d: ri_pmatch[%" PRIu8 "].rm_so = %d\n", __LINE__, gid, (int)(re_sregoff_t)regoff);
-				self->ri_pmatch[gid].rm_so = regoff;
-			} else {
-				TRACE("%d: ri_pmatch[%" PRIu8 "].rm_eo = %d\n", __LINE__, gid, (int)(re_sregoff_t)regoff);
-				self->ri_pmatch[gid].rm_eo = regoff;
-			}
-			goto onfail;
+	}
+	if (*p_pike != NULL) {
+		size_t match_offset;
+		result = re_pike_exec(*p_pike, self, 1, &match_offset);
+		if unlikely(result == RE_DFA_FALLBACK)
+			result = -RE_ENOSYS; /* Malformed utf-8 (only the interpreter could deal with it) */
+		return result;
+	}
+#ifdef HAVE_JIT
+	if (self->ri_jit == NULL && self->ri_jit_wait != 0 && --self->ri_jit_wait == 0)
+		self->ri_jit = re_jit_new(self->ri_exec->rx_code);
+#endif /* HAVE_JIT */
+	result = re_interpreter_run(self);
+	if (result == -RE_ESIZE) {
+		*p_dfa = re_dfa_new(self->ri_exec);
+		if (*p_dfa != NULL) {
+			re_errno_t dfa_result;
+			self->ri_in      = oldin;
+			self->ri_onfailc = 0;
+			dfa_result = re_dfa_exec(*p_dfa, self);
+			if likely(dfa_result != RE_DFA_FALLBACK)
+				return dfa_result;
+			re_dfa_destroy(*p_dfa);
+			*p_dfa = NULL;
 		}
-		pc = item->rof_pc;
-		re_interpreter_setinptr(self, item->rof_in);
-		DISPATCH();
-	}
-	__builtin_unreachable();
-err_nomem:
-	/* Check for special case: on-fail stack got too large. */
-	if (self->ri_onfailc >= self->ri_onfaila &&
-	    self->ri_onfailc > 0 &&
-	    self->ri_onfaila >= get_re_max_failures())
-		return -RE_ESIZE;
-	return -RE_ESPACE;
-#undef PUSHFAIL_EX
-#undef PUSHFAIL_DUMMY
-#undef PUSHFAIL
-#undef XTARGET
-#undef TARGET
-#undef ONFAIL
-#undef DISPATCH
-#undef getw
-#undef getb
+	}
+	return result;
+}
+
+/* Called by searches before their `RE_DFA_MINATTEMPTS'th match attempt:
+ * create a DFA (stored in `*p_dfa') for the remaining attempts, and use it
+ * to find the end of the first match that starts within the next
+ * `*p_search_range' bytes of `self', so later offsets needn't be tried.
+ * The input pointer of `self' is preserved.
+ * @return: true:  `*p_search_range' may have been reduced (or there is no DFA)
+ * @return: false: No match starts within `*p_search_range' */
+INTERN WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_interpreter_search_usedfa)(struct re_interpreter *__restrict self,
+                                             struct re_dfa **__restrict p_dfa,
+                                             size_t *__restrict p_search_range) {
+	struct re_interpreter_inptr oldin;
+	size_t startoff, endoff;
+	*p_dfa = re_dfa_new(self->ri_exec);
+	if (*p_dfa == NULL)
+		return true;
+	if (self->ri_exec->rx_code->rc_minmatch == 0)
+		return true; /* Every offset matches epsilon */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	if (!re_interpreter_in_islastchunk(self))
+		return true;
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	oldin    = self->ri_in;
+	startoff = re_interpreter_in_curoffset(self);
+	endoff   = re_dfa_search(*p_dfa, self, *p_search_range);
+	self->ri_in = oldin;
+	if (endoff == (size_t)-1)
+		return false;
+	if (endoff == (size_t)-2) {
+		re_dfa_destroy(*p_dfa);
+		*p_dfa = NULL;
+	} else if (endoff - startoff < *p_search_range) {
+		/* The match ending here starts before it (matches can't be empty),
+		 * so the left-most match doesn't start at, or after this offset. */
+		*p_search_range = endoff - startoff;
+	}
+	return true;
 }
 
 
 /* Execute a regular expression.
  * @return: >= 0:        The # of bytes starting at `exec->rx_startoff' that got matched.
  * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
  * @return: -RE_ESPACE:  Out of memory
- * @return: -RE_ESIZE:   On-failure stack became too large. */
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
 INTERN WUNUSED NONNULL((1)) ssize_t
 NOTHROW_NCX(CC libre_exec_match)(struct re_exec const *__restrict exec) {
 	ssize_t result;
 	re_errno_t error;
 	struct re_interpreter *interp;
+	struct re_dfa *dfa;
+	struct re_pike *pike;
 
 	/* Quick check: is the given buffer large enough to ever match the pattern? */
 	{
@@ -2374,11 +1582,23 @@ NOTHROW_NCX(CC libre_exec_match)(struct re_exec const *__restrict exec) {
 	re_interpreter_init_match(interp, exec, false);
 
 	/* Execute */
-	result = libre_interp_exec(interp);
+	dfa  = re_dfa_new(exec);
+	pike = NULL;
+	if (dfa == NULL) {
+		pike = re_pike_new(exec, &error);
+		if unlikely(error != RE_NOERROR) {
+			result = -error;
+			goto done;
+		}
+	}
+	result = re_interpreter_exec(interp, &dfa, &pike);
 	if (result == -RE_NOERROR) {
 		result = re_interpreter_in_curoffset(interp) - exec->rx_startoff;
 		re_interpreter_copy_match(interp);
 	}
+done:
+	re_pike_destroy(pike);
+	re_dfa_destroy(dfa);
 	re_interpreter_fini(interp);
 	return result;
 err:
@@ -2386,6 +1606,148 @@ err:
 }
 
 
+/* Return the absolute offset of the first occurrence of the required literal
+ * of `self->ri_exec->rx_code' at, or after `offset', or `(size_t)-1' if  the
+ * remainder of input doesn't contain it. The caller must ensure that all  of
+ * the remaining input is part of the current chunk. */
+PRIVATE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_find_required)(struct re_interpreter const *__restrict self,
+                                             size_t offset) {
+	struct re_code const *code = self->ri_exec->rx_code;
+	size_t chunk_offset = re_interpreter_in_chunkoffset(self);
+	byte_t const *start, *hit;
+	assert(code->rc_mustlen != 0);
+	assert(offset >= chunk_offset);
+	offset -= chunk_offset;
+	if (offset >= re_interpreter_in_chunksize(self))
+		return (size_t)-1;
+	start = self->ri_in_cbase + offset;
+	hit   = (byte_t const *)memmem(start, (size_t)(self->ri_in_cend - start),
+	                               code->rc_code + code->rc_mustoff,
+	                               code->rc_mustlen);
+	if (!hit)
+		return (size_t)-1;
+	return chunk_offset + (size_t)(hit - self->ri_in_cbase);
+}
+
+/* Advance `self' to the next offset where a match might start (as per `re_interpreter_skip_candidates()'),
+ * while also making sure that input at that offset contains the code's required literal (if there is one).
+ * @param: p_must_next: [in|out] Offset from which the  required literal has to be  searched
+ *                      for again (set to `*p_match_offset' before the first call). Because
+ *                      finding the literal can require a lot of input to be scanned,  this
+ *                      way it only needs to be done once for every occurrence.
+ * @return: true:  `self', `*p_search_range' and `*p_match_offset' were updated for the next candidate.
+ * @return: false: No offset within `*p_search_range' can ever produce a match. */
+INTERN WUNUSED NONNULL((1, 2, 3, 4)) bool
+NOTHROW_NCX(CC re_interpreter_search_advance)(struct re_interpreter *__restrict self,
+                                              size_t *__restrict p_search_range,
+                                              size_t *__restrict p_match_offset,
+                                              size_t *__restrict p_must_next) {
+	struct re_code const *code = self->ri_exec->rx_code;
+	size_t skip;
+again:
+	skip = re_interpreter_skip_candidates(self, *p_search_range);
+	if (skip != 0) {
+		if (skip >= *p_search_range)
+			return false;
+		*p_search_range -= skip;
+		*p_match_offset += skip;
+	}
+	if (code->rc_mustlen != 0 && *p_match_offset >= *p_must_next
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	    && re_interpreter_in_islastchunk(self)
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	    ) {
+		size_t hit, first;
+		hit = re_interpreter_find_required(self, *p_match_offset + code->rc_mustmin);
+		if (hit == (size_t)-1)
+			return false; /* Required literal doesn't appear in the rest of input */
+
+		/* Matches starting at offsets up to here contain this occurrence */
+		*p_must_next = (hit - code->rc_mustmin) + 1;
+
+		/* Matches can't start so long before the literal that it's out of reach */
+		if (code->rc_mustmax != RE_CODE_MUSTMAX_UNBOUNDED &&
+		    !OVERFLOW_USUB(hit, code->rc_mustmax, &first) &&
+		    first > *p_match_offset) {
+			skip = first - *p_match_offset;
+			if (skip >= *p_search_range)
+				return false;
+			*p_search_range -= skip;
+			*p_match_offset += skip;
+			re_interpreter_advance(self, skip);
+			goto again;
+		}
+	}
+	return true;
+}
+
+
+/* Search for the left-most match that starts within the next `search_range'
+ * bytes from the current position of `self' (which must be set up for  this
+ * using `re_interpreter_init_match(..., true)'). `*p_dfa' and `*p_pike' are
+ * used for match attempts (if non-NULL), and may be created or destroyed.
+ * @return: >= 0:        The offset where the matched area starts
+ * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  The pike VM gave up (s.a. `RE_EXEC_LINEAR')
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large */
+INTERN WUNUSED NONNULL((1, 3, 4)) ssize_t
+NOTHROW_NCX(CC re_interpreter_search)(struct re_interpreter *__restrict self, size_t search_range,
+                                      struct re_dfa **__restrict p_dfa, struct re_pike **__restrict p_pike,
+                                      size_t *p_match_size) {
+	ssize_t result;
+	struct re_interpreter_inptr used_inptr;
+	size_t match_offset, must_next, attempts;
+
+	/* With `RE_EXEC_LINEAR', all offsets are searched by a single pass of the pike VM */
+	if (*p_pike != NULL) {
+		result = re_pike_exec(*p_pike, self, search_range, &match_offset);
+		if unlikely(result == RE_DFA_FALLBACK)
+			return -RE_ENOSYS; /* Malformed utf-8 (only the interpreter could deal with it) */
+		if likely(result == -RE_NOERROR) {
+			if (p_match_size != NULL)
+				*p_match_size = re_interpreter_in_curoffset(self) - match_offset;
+			result = (ssize_t)match_offset;
+			re_interpreter_copy_match(self);
+		}
+		return result;
+	}
+
+	/* Do the search-loop */
+	attempts     = 0;
+	used_inptr   = self->ri_in;
+	match_offset = re_interpreter_in_curoffset(self);
+	must_next    = match_offset;
+	for (;;) {
+		/* Skip ahead to the next offset where a match might start. */
+		if (!re_interpreter_search_advance(self, &search_range, &match_offset, &must_next))
+			return -RE_NOMATCH;
+		if (++attempts == RE_DFA_MINATTEMPTS && *p_dfa == NULL) {
+			if (!re_interpreter_search_usedfa(self, p_dfa, &search_range))
+				return -RE_NOMATCH;
+		}
+		used_inptr = self->ri_in;
+		result = re_interpreter_exec(self, p_dfa, p_pike);
+		if (result != -RE_NOMATCH) {
+			/* Set success result values if we didn't get here due to an error. */
+			if likely(result == -RE_NOERROR) {
+				if (p_match_size != NULL)
+					*p_match_size = re_interpreter_in_curoffset(self) - match_offset;
+				result = (ssize_t)match_offset;
+				re_interpreter_copy_match(self);
+			}
+			return result;
+		}
+		--search_range;
+		if (search_range == 0)
+			return -RE_NOMATCH;
+		++match_offset;
+		re_interpreter_inptr_in_advance1(&used_inptr);
+		self->ri_in = used_inptr;
+	}
+}
+
 /* Similar to `re_exec_match', try to match a pattern against the given input buffer. Do this
  * with increasing offsets for the first `search_range' bytes, meaning at most `search_range'
  * regex matches will be performed.
@@ -2395,16 +1757,18 @@ err:
  *                       This would have  been the return  value of  `re_exec_match(3R)'.
  * @return: >= 0:        The offset where the matched area starts (in `[exec->rx_startoff, exec->rx_startoff + search_range)').
  * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
  * @return: -RE_ESPACE:  Out of memory
- * @return: -RE_ESIZE:   On-failure stack became too large. */
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
 INTERN WUNUSED NONNULL((1)) ssize_t
 NOTHROW_NCX(CC libre_exec_search)(struct re_exec const *__restrict exec,
                                   size_t search_range, size_t *p_match_size) {
 	ssize_t result;
 	re_errno_t error;
 	struct re_interpreter *interp;
-	struct re_interpreter_inptr used_inptr;
-	size_t match_offset, total_left;
+	struct re_dfa *dfa;
+	struct re_pike *pike;
+	size_t total_left;
 	if (OVERFLOW_USUB(exec->rx_endoff, exec->rx_startoff, &total_left))
 		total_left = 0;
 	if (OVERFLOW_USUB(total_left, exec->rx_code->rc_minmatch, &total_left))
@@ -2423,30 +1787,16 @@ NOTHROW_NCX(CC libre_exec_search)(struct re_exec const *__restrict exec,
 		goto err;
 	re_interpreter_init_match(interp, exec, true);
 
-	/* Do the search-loop */
-	used_inptr   = interp->ri_in;
-	match_offset = exec->rx_startoff;
-	for (;;) {
-		result = libre_interp_exec(interp);
-		if (result != -RE_NOMATCH) {
-			/* Set success result values if we didn't get here due to an error. */
-			if likely(result == -RE_NOERROR) {
-				if (p_match_size != NULL)
-					*p_match_size = re_interpreter_in_curoffset(interp) - match_offset;
-				result = (ssize_t)match_offset;
-				re_interpreter_copy_match(interp);
-			}
-			break;
-		}
-		--search_range;
-		if (search_range == 0)
-			break;
-		++match_offset;
-		re_interpreter_inptr_in_advance1(&used_inptr);
-		interp->ri_in = used_inptr;
-	}
+	/* Do the search */
+	dfa    = NULL;
+	pike   = re_pike_new(exec, &error);
+	result = -error;
+	if likely(error == RE_NOERROR)
+		result = re_interpreter_search(interp, search_range, &dfa, &pike, p_match_size);
 
 	/* Cleanup */
+	re_pike_destroy(pike);
+	re_dfa_destroy(dfa);
 	re_interpreter_fini(interp);
 	return result;
 err:
@@ -2462,7 +1812,9 @@ NOTHROW_NCX(CC libre_exec_search_noepsilon)(struct re_exec const *__restrict exe
 	re_errno_t error;
 	struct re_interpreter *interp;
 	struct re_interpreter_inptr used_inptr;
-	size_t match_offset, total_left;
+	struct re_dfa *dfa;
+	struct re_pike *pike;
+	size_t match_offset, must_next, total_left, attempts;
 	if (OVERFLOW_USUB(exec->rx_endoff, exec->rx_startoff, &total_left))
 		total_left = 0;
 	if (OVERFLOW_USUB(total_left, exec->rx_code->rc_minmatch, &total_left))
@@ -2481,11 +1833,31 @@ NOTHROW_NCX(CC libre_exec_search_noepsilon)(struct re_exec const *__restrict exe
 		goto err;
 	re_interpreter_init_match(interp, exec, true);
 
-	/* Do the search-loop */
+	/* Do the search-loop (with the pike VM, every attempt is executed in linear time) */
+	dfa  = NULL;
+	pike = re_pike_new(exec, &error);
+	if unlikely(error != RE_NOERROR) {
+		result = -error;
+		goto done;
+	}
+	attempts     = 0;
 	used_inptr   = interp->ri_in;
 	match_offset = exec->rx_startoff;
+	must_next    = match_offset;
 	for (;;) {
-		result = libre_interp_exec(interp);
+		/* Skip ahead to the next offset where a match might start. */
+		if (!re_interpreter_search_advance(interp, &search_range, &match_offset, &must_next)) {
+			result = -RE_NOMATCH;
+			break;
+		}
+		if (++attempts == RE_DFA_MINATTEMPTS && dfa == NULL) {
+			if (!re_interpreter_search_usedfa(interp, &dfa, &search_range)) {
+				result = -RE_NOMATCH;
+				break;
+			}
+		}
+		used_inptr = interp->ri_in;
+		result = re_interpreter_exec(interp, &dfa, &pike);
 		if (result != -RE_NOMATCH) {
 			/* Set success result values if we didn't get here due to an error. */
 			if likely(result == -RE_NOERROR) {
@@ -2512,6 +1884,9 @@ advance_one:
 	}
 
 	/* Cleanup */
+done:
+	re_pike_destroy(pike);
+	re_dfa_destroy(dfa);
 	re_interpreter_fini(interp);
 	return result;
 err:
@@ -2530,7 +1905,9 @@ NOTHROW_NCX(CC libre_exec_rsearch)(struct re_exec const *__restrict exec,
 	re_errno_t error;
 	struct re_interpreter *interp;
 	struct re_interpreter_inptr used_inptr;
-	size_t match_offset, total_left;
+	struct re_dfa *dfa;
+	struct re_pike *pike;
+	size_t match_offset, total_left, attempts;
 	if (OVERFLOW_USUB(exec->rx_endoff, exec->rx_startoff, &total_left))
 		total_left = 0;
 	if (OVERFLOW_USUB(total_left, exec->rx_code->rc_minmatch, &total_left))
@@ -2548,13 +1925,47 @@ NOTHROW_NCX(CC libre_exec_rsearch)(struct re_exec const *__restrict exec,
 	if unlikely(error != 0)
 		goto err;
 	re_interpreter_init_match(interp, exec, true);
+	dfa      = NULL;
+	pike     = re_pike_new(exec, &error);
+	attempts = 0;
+	if unlikely(error != RE_NOERROR) {
+		result = -error;
+		goto done;
+	}
+
+	/* Check that the required literal appears in input. */
+	if (exec->rx_code->rc_mustlen != 0
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	    && re_interpreter_in_islastchunk(interp)
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	    ) {
+		if (re_interpreter_find_required(interp, exec->rx_startoff + exec->rx_code->rc_mustmin) == (size_t)-1) {
+			result = -RE_NOMATCH;
+			goto done;
+		}
+	}
 
 	/* Do the search-loop */
 	re_interpreter_inptr_advance(&interp->ri_in, total_left);
 	used_inptr   = interp->ri_in;
 	match_offset = exec->rx_startoff + total_left;
 	for (;;) {
-		result = libre_interp_exec(interp);
+		if (exec->rx_code->rc_minmatch != 0) {
+			/* Skip back to the previous offset where a match might start. */
+			size_t skip = re_interpreter_rskip_fmap(interp, search_range);
+			if (skip != 0) {
+				if (skip >= search_range) {
+					result = -RE_NOMATCH;
+					break;
+				}
+				search_range -= skip;
+				match_offset -= skip;
+				used_inptr = interp->ri_in;
+			}
+		}
+		if (++attempts == RE_DFA_MINATTEMPTS && dfa == NULL)
+			dfa = re_dfa_new(exec);
+		result = re_interpreter_exec(interp, &dfa, &pike);
 		if (result != -RE_NOMATCH) {
 			/* Set success result values if we didn't get here due to an error. */
 			if likely(result == -RE_NOERROR) {
@@ -2574,6 +1985,9 @@ NOTHROW_NCX(CC libre_exec_rsearch)(struct re_exec const *__restrict exec,
 	}
 
 	/* Cleanup */
+done:
+	re_pike_destroy(pike);
+	re_dfa_destroy(dfa);
 	re_interpreter_fini(interp);
 	return result;
 err:
@@ -2582,14 +1996,13 @@ err:
 
 
 
-#undef delta16_get
 #undef DBG_memset
-#undef ascii_islf
 #undef HAVE_TRACE
 #undef TRACE
 
 
 /* Exports */
+DEFINE_PUBLIC_ALIAS(re_exec_ctx_fini, libre_exec_ctx_fini);
 DEFINE_PUBLIC_ALIAS(re_exec_match, libre_exec_match);
 DEFINE_PUBLIC_ALIAS(re_exec_search, libre_exec_search);
 DEFINE_PUBLIC_ALIAS(re_exec_search_noepsilon, libre_exec_search_noepsilon);
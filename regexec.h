@@ -27,16 +27,22 @@
 
 #include <kos/types.h>
 
+#include <libregex/regcomp.h>
 #include <libregex/regexec.h>
 #endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
 
 DECL_BEGIN
 
+/* Free all buffers of a context (s.a. `RE_EXEC_CTX') */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC libre_exec_ctx_fini)(struct re_exec_ctx *__restrict self);
+
 /* Execute a regular expression.
  * @return: >= 0:        The # of bytes starting at `exec->rx_startoff' that got matched.
  * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
  * @return: -RE_ESPACE:  Out of memory
- * @return: -RE_ESIZE:   On-failure stack became too large. */
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
 INTDEF WUNUSED NONNULL((1)) ssize_t
 NOTHROW_NCX(CC libre_exec_match)(struct re_exec const *__restrict exec);
 
@@ -49,8 +55,9 @@ NOTHROW_NCX(CC libre_exec_match)(struct re_exec const *__restrict exec);
  *                       This would have  been the return  value of  `re_exec_match(3R)'.
  * @return: >= 0:        The offset where the matched area starts (in `[exec->rx_startoff, exec->rx_startoff + search_range)').
  * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
  * @return: -RE_ESPACE:  Out of memory
- * @return: -RE_ESIZE:   On-failure stack became too large. */
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
 INTDEF WUNUSED NONNULL((1)) ssize_t
 NOTHROW_NCX(CC libre_exec_search)(struct re_exec const *__restrict exec,
                                   size_t search_range, size_t *p_match_size);
@@ -70,6 +77,134 @@ INTDEF WUNUSED NONNULL((1)) ssize_t
 NOTHROW_NCX(CC libre_exec_rsearch)(struct re_exec const *__restrict exec,
                                    size_t search_range, size_t *p_match_size);
 
+/* Same as `re_exec_search(3R)', but split the range of starting offsets
+ * between up to `nthreads' threads (`0': one per online CPU) */
+INTDEF WUNUSED NONNULL((1)) ssize_t
+NOTHROW_NCX(CC libre_exec_search_parallel)(struct re_exec const *__restrict exec,
+                                           size_t search_range, size_t *p_match_size,
+                                           unsigned int nthreads);
+
+/* Same as calling `re_exec_match(3R)' / `re_exec_search(3R)' for each of `inputs'
+ * (groups of `inputs[i]' are written to `exec->rx_pmatch[i * exec->rx_nmatch]')
+ * @return: * : The # of inputs that were matched, or the first error (other than
+ *              `-RE_NOMATCH') in `results' (which is still written for all inputs) */
+INTDEF WUNUSED NONNULL((1, 4)) ssize_t
+NOTHROW_NCX(CC libre_exec_match_batch)(struct re_exec const *__restrict exec,
+                                       struct iovec const *inputs, size_t count,
+                                       ssize_t *results);
+INTDEF WUNUSED NONNULL((1, 4)) ssize_t
+NOTHROW_NCX(CC libre_exec_search_batch)(struct re_exec const *__restrict exec,
+                                        struct iovec const *inputs, size_t count,
+                                        ssize_t *results, size_t *match_sizes);
+
+/* Create an iterator over all matches of `exec->rx_code' in the input of `exec'
+ * @return: * :   The new iterator (to be destroyed using `re_findall_destroy(3R)')
+ * @return: NULL: Out of memory */
+INTDEF WUNUSED NONNULL((1)) struct re_findall *
+NOTHROW_NCX(CC libre_findall_new)(struct re_exec const *__restrict exec);
+
+/* Destroy an iterator previously created by `re_findall_new(3R)' */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC libre_findall_destroy)(struct re_findall *__restrict self);
+
+/* Return the next match of `self' (what `re_exec_search_noepsilon(3R)' would return
+ * for a search that starts at the end of the previous match, or at `rx_startoff')
+ * @param: p_match_size: When non-NULL, set to the # of bytes that were matched
+ * @return: >= 0:        The offset where the matched area starts
+ * @return: -RE_NOMATCH: There are no more matches
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+INTDEF WUNUSED NONNULL((1)) ssize_t
+NOTHROW_NCX(CC libre_findall_next)(struct re_findall *__restrict self,
+                                   size_t *p_match_size);
+
+/* Create a set of patterns that can all be matched against the same input at
+ * once (in a single pass over input, rather than one per pattern, where possible)
+ * @param: codev: [codec] Patterns of the set (the caller must keep them alive
+ *                until the set is destroyed, but not the vector itself)
+ * @return: * :   The new set (to be destroyed using `re_set_destroy(3R)')
+ * @return: NULL: Out of memory */
+INTDEF WUNUSED NONNULL((1)) struct re_set *
+NOTHROW_NCX(CC libre_set_new)(struct re_code const *const *__restrict codev, size_t codec);
+
+/* Compile `patternv' (each using `syntax', s.a. `re_compiler_init(3R)') and
+ * create a set of them, the same way `re_set_new(3R)' would. Compiled patterns
+ * belong to the set, and are freed by `re_set_destroy(3R)'.
+ * @param: patternv:    [patternc] NUL-terminated patterns of the set
+ * @param: p_errindex:  [0..1] Set to the index of the pattern that didn't compile
+ * @return: RE_NOERROR: Success (`*p_set' is the new set)
+ * @return: RE_ESPACE:  Out of memory
+ * @return: * :         Error of `re_compiler_compile(3R)' for `patternv[*p_errindex]' */
+INTDEF WUNUSED NONNULL((1)) re_errno_t
+NOTHROW_NCX(CC libre_set_compile)(struct re_set **__restrict p_set,
+                                  char const *const *patternv, size_t patternc,
+                                  uintptr_t syntax, size_t *p_errindex);
+
+/* Destroy a set previously created by `re_set_new(3R)' or `re_set_compile(3R)' */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC libre_set_destroy)(struct re_set *__restrict self);
+
+/* Check which patterns of `self' match somewhere in the input of `exec' (with
+ * the same semantics as `re_exec_search(3R)' for an unlimited search range).
+ * `exec->rx_code', `exec->rx_nmatch' and `exec->rx_pmatch' are ignored.
+ * @param: matches: [CEILDIV(codec, 8)] Bitset of patterns that match (bit `i % 8'
+ *                  of `matches[i / 8]' is set if `codev[i]' matches)
+ * @return: >= 0:        The # of patterns that match
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+INTDEF WUNUSED NONNULL((1, 2, 3)) ssize_t
+NOTHROW_NCX(CC libre_set_exec)(struct re_set *__restrict self,
+                               struct re_exec const *__restrict exec,
+                               byte_t *__restrict matches);
+
+/* Same as `re_set_exec(3R)', but only return the index of the pattern whose match
+ * starts first (as per `re_exec_search(3R)'). When more than one pattern matches
+ * at that offset, the one that comes first in `codev' is returned.
+ * @return: >= 0:        Index of the pattern with the leftmost match
+ * @return: -RE_NOMATCH: No pattern matches
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+INTDEF WUNUSED NONNULL((1, 2)) ssize_t
+NOTHROW_NCX(CC libre_set_first)(struct re_set *__restrict self,
+                                struct re_exec const *__restrict exec);
+
+/* Create a stream for searching `code' in input that arrives piece by piece
+ * @param: eflags:      Set of `RE_EXEC_NOTBOL | RE_EXEC_NOTEOL | RE_EXEC_LINEAR'
+ * @return: RE_NOERROR: Success (`*p_stream' is the new stream, to be destroyed using `re_stream_destroy(3R)')
+ * @return: RE_ESPACE:  Out of memory
+ * @return: RE_ENOSYS:  `code' can't be matched by a DFA (s.a. `re_dfa_scancode()') */
+INTDEF WUNUSED NONNULL((1, 2)) re_errno_t
+NOTHROW_NCX(CC libre_stream_new)(struct re_stream **__restrict p_stream,
+                                 struct re_code const *__restrict code,
+                                 unsigned int eflags);
+
+/* Destroy a stream previously created by `re_stream_new(3R)' */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC libre_stream_destroy)(struct re_stream *__restrict self);
+
+/* Append `size' bytes from `data' to the input of `self'
+ * @return: RE_NOERROR: Success
+ * @return: RE_ESPACE:  Out of memory */
+INTDEF WUNUSED NONNULL((1)) re_errno_t
+NOTHROW_NCX(CC libre_stream_feed)(struct re_stream *__restrict self,
+                                  void const *data, size_t size);
+
+/* Mark the end of the input of `self' */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC libre_stream_finish)(struct re_stream *__restrict self);
+
+/* Return the next match in the input of `self'
+ * @param: p_match_start: Set to the absolute offset where the match starts
+ * @return: > 0:          The # of bytes that were matched
+ * @return: -RE_NOMATCH:  No further match is known yet (or ever, after `re_stream_finish(3R)')
+ * @return: -RE_ENOSYS:   The DFA gave up (matches are only known after `re_stream_finish(3R)')
+ * @return: -RE_ESPACE:   Out of memory
+ * @return: -RE_ESIZE:    On-failure stack became too large (or the window doesn't fit into 32 bits) */
+INTDEF WUNUSED NONNULL((1, 2)) ssize_t
+NOTHROW_NCX(CC libre_stream_next)(struct re_stream *__restrict self,
+                                  uint64_t *__restrict p_match_start);
+
 DECL_END
 
 #endif /* !GUARD_LIBREGEX_REGEXEC_H */
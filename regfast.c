@@ -37,6 +37,7 @@ gcc_opt.append("-Os");
 #include <hybrid/compiler.h>
 
 #include <hybrid/bitset.h>
+#include <hybrid/minmax.h>
 #include <hybrid/unaligned.h>
 
 #include <kos/types.h>
@@ -44,6 +45,7 @@ gcc_opt.append("-Os");
 #include <alloca.h>
 #include <assert.h>
 #include <ctype.h>
+#include <malloc.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
@@ -70,11 +72,23 @@ DECL_BEGIN
 
 /* Calculates, and fills in members of `self':
  * - self->rc_fmap
- * - self->rc_minmatch */
+ * - self->rc_minmatch
+ * - self->rc_pfxlen
+ * - self->rc_pfxoff
+ * - self->rc_mustlen
+ * - self->rc_mustoff
+ * - self->rc_mustmin
+ * - self->rc_mustmax
+ * - self->rc_mlcount
+ * - self->rc_mllen
+ * - self->rc_mlits */
 #if defined(__OPTIMIZE_SIZE__) && 0
 INTERN NONNULL((1)) void
 NOTHROW_NCX(CC libre_code_makefast)(struct re_code *__restrict self) {
 	self->rc_minmatch = 0;
+	self->rc_pfxlen   = 0;
+	self->rc_mustlen  = 0;
+	self->rc_mlcount  = 0;
 	bzero(self->rc_fmap, sizeof(self->rc_fmap));
 }
 #else /* __OPTIMIZE_SIZE__ */
@@ -146,15 +160,39 @@ NOTHROW_NCX(CC re_code_setminmatch)(struct re_code *__restrict self,
 		self->rc_minmatch = minmatch;
 }
 
-/* Map `X - RECS_ISX_MIN' to `__UNICODE_IS*' flags. */
-#ifndef __libre_unicode_traits_defined
-#define __libre_unicode_traits_defined
-INTDEF uint16_t const libre_unicode_traits[]; /* from "./regexec.c" */
-#endif /* !__libre_unicode_traits_defined */
-
 INTDEF ATTR_PURE ATTR_RETNONNULL WUNUSED NONNULL((1)) byte_t * /* from "./regcomp.c" */
 NOTHROW_NCX(CC libre_opcode_next)(byte_t const *__restrict p_instr);
 
+/* Lower `*p_min' / raise `*p_max' to the lengths of the shortest / longest literals
+ * that pass through the node at `nodeoff' of the `REOP_TRIE' at `trie' (`depth'
+ * being the # of bytes already matched upon getting there) */
+PRIVATE NONNULL((1, 4, 5)) void
+NOTHROW_NCX(CC trie_lengths)(byte_t const *__restrict trie, size_t nodeoff, size_t depth,
+                             size_t *__restrict p_min, size_t *__restrict p_max) {
+	byte_t const *node = trie + nodeoff;
+	for (;;) {
+		if (*node & RETRIE_ACCEPT) {
+			if (*p_min > depth)
+				*p_min = depth;
+			if (*p_max < depth)
+				*p_max = depth;
+		}
+		if (*node & RETRIE_RUN) {
+			byte_t len = *node & RETRIE_RUNMASK;
+			depth += len;
+			node += 1 + len;
+		} else if (*node & RETRIE_BRANCH) {
+			size_t i, count = (size_t)node[1] + 1;
+			byte_t const *offsets = node + 2 + count;
+			for (i = 0; i < count; ++i)
+				trie_lengths(trie, UNALIGNED_GET16(offsets + i * 2), depth + 1, p_min, p_max);
+			break;
+		} else {
+			break;
+		}
+	}
+}
+
 #define getb() (*pc++)
 #define getw() (pc += 2, (int16_t)UNALIGNED_GET16(pc - 2))
 #define REQUIRE_MY_VARIABLES() \
@@ -230,12 +268,23 @@ again:
 			goto again;
 		}
 
+		TARGET(REOP_TRIE) {
+			size_t min = (size_t)-1, max = 0;
+			trie_lengths(opcode_start, RETRIE_ROOT, 0, &min, &max);
+			curr_minmatch += min;
+			pc = libre_opcode_next(opcode_start);
+			goto again;
+		}
+
 		/* All of these opcode always match (at least) 1 byte. */
 		TARGET(REOP_CONTAINS_UTF8)
 		TARGET(REOP_NCONTAINS_UTF8)
+		TARGET(REOP_BITSET)
 		TARGET(REOP_CS_BYTE)
 		TARGET(REOP_CS_UTF8)
-		TARGET(REOP_NCS_UTF8) {
+		TARGET(REOP_NCS_UTF8)
+		TARGET(REOP_SEQ_UTF8)
+		TARGET(REOP_NSEQ_UTF8) {
 			curr_minmatch += 1;
 			pc = libre_opcode_next(opcode_start);
 			goto again;
@@ -271,7 +320,11 @@ again:
 		}
 
 		TARGET(REOP_JMP_ONFAIL)
-		TARGET(REOP_JMP_AND_RETURN_ONFAIL) {
+		TARGET(REOP_JMP_AND_RETURN_ONFAIL)
+		TARGET(REOP_SPAN)
+		TARGET(REOP_SPAN_AND_RETURN_ONFAIL)
+		TARGET(REOP_SPAN_LIT)
+		TARGET(REOP_SPAN_LIT_AND_RETURN_ONFAIL) {
 			int16_t delta = getw();
 			if (delta <= 0)
 				goto again; /* Ignore backwards offsets (those would mean repetition of an epsilon-block) */
@@ -458,21 +511,24 @@ NOTHROW_NCX(CC cs_gather_matching_bytes)(bitset_t matchend_bytes[],
 			}
 		}	break;
 
-		case_RECS_ISX_MIN_to_MAX: {
-			byte_t i;
-			uint16_t traits;
-			if (!is_unicode)
-				goto do_cs_bitset;
-			traits = libre_unicode_traits[cs_opcode - RECS_ISX_MIN];
+		case RECS_ISX_MASK:
 			assertf(is_unicode, "Trait opcodes are only valid in unicode-mode");
-			for (i = 0; i < 0x80; ++i) {
-				uint16_t ch_flags;
-				ch_flags = __unicode_descriptor((char32_t)i)->__ut_flags;
-				ch_flags &= traits;
-				if (ch_flags != 0) {
-					bitset_set(matchend_bytes, i);
-				}
-			}
+			/* Matching ASCII characters are part of the leading bitset
+			 * of  `REOP_[N]CS_UTF8', so only  lead bytes remain here. */
+			bitset_nset(matchend_bytes, 0xc0, 0xff + 1);
+			pc += 2;
+			break;
+
+		case RECS_CONTAINS_SORTED: {
+			byte_t const *end;
+			assertf(is_unicode, "Sorted lists are only valid in unicode-mode");
+			end = pc + 2 + UNALIGNED_GET16(pc);
+			pc += 2;
+			/* Match all possible utf-8 lead bytes */
+			do {
+				bitset_set(matchend_bytes, (byte_t)*pc);
+				pc += unicode_utf8seqlen[*pc];
+			} while (pc < end);
 		}	break;
 
 		default:
@@ -662,6 +718,17 @@ again:
 			GOTMATCH();
 		}
 
+		TARGET(REOP_BITSET) {
+			unsigned int i;
+			for (i = 0; i < 256; ++i) {
+				if ((pc[i / 8] & (1 << (i % 8))) != 0)
+					fastmap_setpc(fmap, self, (byte_t)i, enter_pc);
+			}
+			minmatch = 1;
+			pc += 32;
+			GOTMATCH();
+		}
+
 		TARGET(REOP_CONTAINS_UTF8) {
 			byte_t count = getb();
 			assert(count >= 2);
@@ -680,7 +747,9 @@ again:
 			bitset_setall(acepted_bytes, 256);
 			assert(count >= 1);
 			do {
-				bitset_clear(acepted_bytes, *pc);
+				/* Only ASCII characters can be excluded (1 lead byte can start many characters) */
+				if (*pc < 0x80)
+					bitset_clear(acepted_bytes, *pc);
 				pc += unicode_utf8seqlen[*pc];
 			} while (--count);
 			bitset_foreach (bitno, acepted_bytes, 256) {
@@ -696,9 +765,13 @@ again:
 			size_t i;
 			bitset_t bitset_decl(matchend_bytes, 256);
 			bitset_clearall(matchend_bytes, 256);
+			if (opcode != REOP_CS_BYTE) {
+				/* Leading bitset of matching ASCII characters */
+				memcpy(matchend_bytes, pc, 16);
+				pc += 16;
+			}
 			pc = cs_gather_matching_bytes(matchend_bytes, pc,
-			                              opcode == REOP_CS_UTF8 ||
-			                              opcode == REOP_NCS_UTF8);
+			                              opcode != REOP_CS_BYTE);
 			switch (opcode) {
 			case REOP_CS_BYTE:
 			case REOP_CS_UTF8:
@@ -718,6 +791,62 @@ again:
 			GOTMATCH();
 		}
 
+		TARGET(REOP_SEQ_UTF8)
+		TARGET(REOP_NSEQ_UTF8) {
+			size_t i;
+			bitset_t bitset_decl(matchend_bytes, 256);
+			bitset_clearall(matchend_bytes, 256);
+			memcpy(matchend_bytes, pc, 16);
+			if (opcode == REOP_SEQ_UTF8) {
+				byte_t seqlen;
+				byte_t const *seq = pc + 16;
+				while ((seqlen = *seq++) != 0) {
+					bitset_nset_r(matchend_bytes, seq[0], seq[1]);
+					seq += seqlen * 2;
+				}
+				/* Input that isn't the shortest encoding of a character is
+				 * matched by whatever character it decodes to, so also:
+				 * - Lead bytes of overlong sequences
+				 * - Dangling bytes (which decode to themselves) */
+				bitset_set(matchend_bytes, 0xc0);
+				bitset_set(matchend_bytes, 0xc1);
+				bitset_set(matchend_bytes, 0xe0);
+				bitset_set(matchend_bytes, 0xf0);
+				if (bitset_test(matchend_bytes, 0xc2))
+					bitset_nset_r(matchend_bytes, 0x80, 0xbf);
+				if (bitset_test(matchend_bytes, 0xc3))
+					bitset_nset_r(matchend_bytes, 0xfe, 0xff);
+			} else {
+				/* Flip the meaning of matched bytes, and match all non-ASCII bytes */
+				bitset_flipall(matchend_bytes, 256);
+			}
+			bitset_foreach (i, matchend_bytes, 256) {
+				fastmap_setpc(fmap, self, (byte_t)i, enter_pc);
+			}
+			pc = libre_opcode_next(opcode_start);
+			minmatch = 1;
+			GOTMATCH();
+		}
+
+		TARGET(REOP_TRIE) {
+			byte_t const *root = opcode_start + RETRIE_ROOT;
+			size_t max = 0;
+			if (*root & RETRIE_RUN) {
+				fastmap_setpc(fmap, self, root[1], enter_pc);
+			} else {
+				byte_t i, count_m1 = root[1];
+				for (i = 0;; ++i) {
+					fastmap_setpc(fmap, self, root[2 + i], enter_pc);
+					if (i >= count_m1)
+						break;
+				}
+			}
+			minmatch = (size_t)-1;
+			trie_lengths(opcode_start, RETRIE_ROOT, 0, &minmatch, &max);
+			pc = libre_opcode_next(opcode_start);
+			GOTMATCH();
+		}
+
 		TARGET(REOP_GROUP_MATCH) {
 			/* We only get here due to epsilon-branches, so
 			 * a  group repeat also always matches epsilon. */
@@ -787,7 +916,11 @@ again:
 			goto again;
 		}
 
-		TARGET(REOP_JMP_AND_RETURN_ONFAIL) {
+		TARGET(REOP_JMP_AND_RETURN_ONFAIL)
+		TARGET(REOP_SPAN)
+		TARGET(REOP_SPAN_AND_RETURN_ONFAIL)
+		TARGET(REOP_SPAN_LIT)
+		TARGET(REOP_SPAN_LIT_AND_RETURN_ONFAIL) {
 			byte_t const *yfail_pc;
 			byte_t const *nfail_pc;
 			int16_t delta = getw();
@@ -880,6 +1013,476 @@ got_match:
 #undef getw
 #undef getb
 
+/* Check if `self' starts with a literal byte-sequence that must
+ * appear at the start of every match, and if so: remember where
+ * it can be found. */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC populate_prefix)(struct re_code *__restrict self) {
+	byte_t const *pc = self->rc_code;
+	self->rc_pfxlen = 0;
+	for (;;) {
+		switch (*pc) {
+
+		case_REOP_AT_MIN_to_MAX:
+		case REOP_NOP:
+			/* These don't consume any input, so they can be skipped */
+			pc += 1;
+			break;
+
+		case REOP_GROUP_START:
+		case REOP_GROUP_END:
+			pc += 2;
+			break;
+
+		case REOP_SETVAR:
+			pc += 3;
+			break;
+
+		case REOP_BYTE:
+			self->rc_pfxlen = 1;
+			self->rc_pfxoff = (uint16_t)((pc + 1) - self->rc_code);
+			return;
+
+		case REOP_EXACT:
+			self->rc_pfxlen = pc[1];
+			self->rc_pfxoff = (uint16_t)((pc + 2) - self->rc_code);
+			return;
+
+		default:
+			/* Anything else can't be used as a literal prefix. */
+			return;
+		}
+	}
+}
+
+/* Min/max # of input bytes consumed by the opcode at `pc' */
+#define MUSTDIST_INF 0xffff
+PRIVATE NONNULL((1, 2, 3)) void
+NOTHROW_NCX(CC opcode_consumes)(byte_t const *__restrict pc,
+                                uint16_t *__restrict p_min,
+                                uint16_t *__restrict p_max) {
+	switch (*pc) {
+
+	case REOP_EXACT:
+	case REOP_EXACT_ASCII_ICASE:
+		*p_min = *p_max = pc[1];
+		break;
+
+	case REOP_EXACT_UTF8_ICASE:
+		*p_min = pc[1];
+		*p_max = MUSTDIST_INF;
+		break;
+
+	case REOP_BYTE:
+	case REOP_NBYTE:
+	case REOP_BYTE2:
+	case REOP_NBYTE2:
+	case REOP_RANGE:
+	case REOP_NRANGE:
+	case REOP_BITSET:
+	case REOP_CS_BYTE:
+		*p_min = *p_max = 1;
+		break;
+
+	case_REOP_ANY_MIN_to_MAX:
+	case REOP_CONTAINS_UTF8:
+	case REOP_NCONTAINS_UTF8:
+	case REOP_CS_UTF8:
+	case REOP_NCS_UTF8:
+	case REOP_SEQ_UTF8:
+	case REOP_NSEQ_UTF8:
+		*p_min = 1;
+		*p_max = MUSTDIST_INF;
+		break;
+
+	case REOP_GROUP_MATCH:
+	case_REOP_GROUP_MATCH_JMIN_to_JMAX:
+		*p_min = 0;
+		*p_max = MUSTDIST_INF;
+		break;
+
+	case REOP_TRIE: {
+		size_t min = (size_t)-1, max = 0;
+		trie_lengths(pc, RETRIE_ROOT, 0, &min, &max);
+		*p_min = (uint16_t)MIN(min, MUSTDIST_INF);
+		*p_max = (uint16_t)MIN(max, MUSTDIST_INF);
+	}	break;
+
+	default:
+		*p_min = *p_max = 0;
+		break;
+	}
+}
+
+/* Return the target of a branch at `pc', or `NULL' if it doesn't have one.
+ * @param: p_fallthru: Set to true if execution may continue with the next opcode. */
+PRIVATE WUNUSED NONNULL((1, 2, 3)) byte_t const *
+NOTHROW_NCX(CC opcode_branch)(byte_t const *__restrict pc,
+                              byte_t const *__restrict next_pc,
+                              bool *__restrict p_fallthru) {
+	*p_fallthru = true;
+	switch (*pc) {
+
+	case REOP_JMP:
+		*p_fallthru = false;
+		ATTR_FALLTHROUGH
+	case REOP_JMP_ONFAIL:
+	case REOP_JMP_AND_RETURN_ONFAIL:
+	case REOP_SPAN:
+	case REOP_SPAN_AND_RETURN_ONFAIL:
+	case REOP_SPAN_LIT:
+	case REOP_SPAN_LIT_AND_RETURN_ONFAIL:
+		return next_pc + (int16_t)UNALIGNED_GET16(pc + 1);
+
+	case REOP_DEC_JMP:
+	case REOP_DEC_JMP_AND_RETURN_ONFAIL:
+		return next_pc + (int16_t)UNALIGNED_GET16(pc + 2);
+
+	case_REOP_GROUP_MATCH_JMIN_to_JMAX:
+		return next_pc + REOP_GROUP_MATCH_Joff(*pc);
+
+	case_REOP_GROUP_END_JMIN_to_JMAX:
+		return next_pc + REOP_GROUP_END_Joff(*pc);
+
+	case REOP_MATCHED:
+	case REOP_MATCHED_PERFECT:
+		*p_fallthru = false;
+		break;
+
+	default:
+		break;
+	}
+	return NULL;
+}
+
+PRIVATE ATTR_CONST WUNUSED uint16_t
+NOTHROW(CC mustdist_add)(uint16_t a, uint16_t b, uint16_t limit) {
+	uint32_t result = (uint32_t)a + b;
+	if (result > limit)
+		result = limit;
+	return (uint16_t)result;
+}
+
+/* Find a literal byte-sequence (other than the prefix) that  appears
+ * on every path through `self', and calculate the range of distances
+ * between the start of a match, and the start of said literal.
+ *
+ * A literal is required if no forward branch jumps across it. Min-distances
+ * are calculated by  relaxing all branches  until nothing changes  anymore,
+ * while max-distances are only calculated  for literals that aren't  preceded
+ * by any loops (since those would make the max-distance unbounded anyways). */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC populate_required)(struct re_code *__restrict self) {
+	byte_t const *pc, *code_end;
+	uint16_t *dmin, *dmax;
+	size_t codesize, reach, best_len, pass;
+	bool changed, has_loop;
+	self->rc_mustlen = 0;
+
+	/* Figure out the size of the code. */
+	for (pc = self->rc_code; *pc != REOP_MATCHED && *pc != REOP_MATCHED_PERFECT;)
+		pc = libre_opcode_next(pc);
+	code_end = pc + 1;
+	codesize = (size_t)(code_end - self->rc_code);
+	dmin = (uint16_t *)malloc(codesize * 2 * sizeof(uint16_t));
+	if unlikely(!dmin)
+		return; /* Not an error: just means we won't know about a required literal */
+	dmax = dmin + codesize;
+#define DMIN_UNREACHED 0xffff
+#define DMIN_LIMIT     0xfffe
+	memsetc(dmin, DMIN_UNREACHED, codesize, sizeof(uint16_t));
+	bzero(dmax, codesize * sizeof(uint16_t));
+	dmin[0] = 0;
+
+	/* Calculate min-distances (loops can only ever make them larger,
+	 * so this converges after at most 1 pass per backwards  branch).
+	 * Max-distances are calculated during the first pass only. */
+	for (pass = 0;; ++pass) {
+		changed = false;
+		for (pc = self->rc_code; pc < code_end;) {
+			byte_t const *next_pc = libre_opcode_next(pc);
+			byte_t const *target;
+			size_t offset = (size_t)(pc - self->rc_code);
+			uint16_t cmin, cmax, nmin, nmax;
+			bool fallthru;
+			if (dmin[offset] == DMIN_UNREACHED) {
+				pc = next_pc;
+				continue;
+			}
+			opcode_consumes(pc, &cmin, &cmax);
+			nmin   = mustdist_add(dmin[offset], cmin, DMIN_LIMIT);
+			nmax   = mustdist_add(dmax[offset], cmax, MUSTDIST_INF);
+			target = opcode_branch(pc, next_pc, &fallthru);
+			if (fallthru && next_pc < code_end) {
+				size_t next_offset = (size_t)(next_pc - self->rc_code);
+				if (dmin[next_offset] > nmin) {
+					dmin[next_offset] = nmin;
+					changed = true;
+				}
+				if (pass == 0 && dmax[next_offset] < nmax)
+					dmax[next_offset] = nmax;
+			}
+			if (target != NULL) {
+				size_t target_offset = (size_t)(target - self->rc_code);
+				if (dmin[target_offset] > nmin) {
+					dmin[target_offset] = nmin;
+					changed = true;
+				}
+				if (pass == 0 && target > pc && dmax[target_offset] < nmax)
+					dmax[target_offset] = nmax;
+			}
+			pc = next_pc;
+		}
+		if (!changed)
+			break;
+		if (pass >= 32) {
+			/* Give up (min-distances might not be correct yet) */
+			goto done;
+		}
+	}
+
+	/* Look for the longest literal that can't be skipped */
+	reach    = 0;
+	best_len = 0;
+	has_loop = false;
+	for (pc = self->rc_code; pc < code_end;) {
+		byte_t const *next_pc = libre_opcode_next(pc);
+		byte_t const *target;
+		size_t offset = (size_t)(pc - self->rc_code);
+		size_t lit_len;
+		bool fallthru;
+		if (reach <= offset && dmin[offset] != DMIN_UNREACHED &&
+		    (*pc == REOP_BYTE || *pc == REOP_EXACT)) {
+			byte_t const *lit = pc + 1;
+			lit_len = 1;
+			if (*pc == REOP_EXACT)
+				lit_len = *lit++;
+			if (lit_len > best_len &&
+			    !(self->rc_pfxlen != 0 && lit == self->rc_code + self->rc_pfxoff)) {
+				best_len         = lit_len;
+				self->rc_mustlen = (uint8_t)lit_len;
+				self->rc_mustoff = (uint16_t)(lit - self->rc_code);
+				self->rc_mustmin = dmin[offset];
+				self->rc_mustmax = has_loop ? RE_CODE_MUSTMAX_UNBOUNDED : dmax[offset];
+			}
+		}
+		target = opcode_branch(pc, next_pc, &fallthru);
+		if (target != NULL) {
+			if (target > pc) {
+				size_t target_offset = (size_t)(target - self->rc_code);
+				if (reach < target_offset)
+					reach = target_offset;
+			} else {
+				has_loop = true;
+			}
+		}
+		pc = next_pc;
+	}
+done:
+#undef DMIN_LIMIT
+#undef DMIN_UNREACHED
+	free(dmin);
+}
+#undef MUSTDIST_INF
+
+/* Max # of literal starts gathered by `populate_mlits()' (before they are
+ * cut down to the same length, which may turn some into duplicates) */
+#define MLITS_GATHER_MAX (RE_CODE_MLITS_MAX * 4)
+
+/* Max # of opcodes visited by `populate_mlits()' */
+#define MLITS_GATHER_MAXSTEPS 512
+
+struct mlits_gather {
+	size_t       mg_count;                                     /* # of gathered literal starts */
+	size_t       mg_steps;                                     /* # of opcodes that may still be visited */
+	byte_t const *mg_pc;                                       /* Opcode after the `REOP_TRIE' being walked */
+	byte_t       mg_lens[MLITS_GATHER_MAX];                    /* Lengths of gathered literal starts */
+	byte_t       mg_lits[MLITS_GATHER_MAX][RE_CODE_MLITS_LEN]; /* Gathered literal starts */
+};
+
+PRIVATE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC mlits_gather_add)(struct mlits_gather *__restrict self,
+                                 byte_t const *__restrict lit, size_t len) {
+	if (len < 2 || self->mg_count >= MLITS_GATHER_MAX)
+		return false; /* Too short, or too many */
+	memcpy(self->mg_lits[self->mg_count], lit, len);
+	self->mg_lens[self->mg_count] = (byte_t)len;
+	++self->mg_count;
+	return true;
+}
+
+PRIVATE WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC mlits_gather)(struct mlits_gather *__restrict self,
+                             byte_t const *pc,
+                             byte_t const *__restrict lit, size_t len);
+
+/* Gather literal starts that begin with `lit' and continue at the node
+ * at `nodeoff' of the `REOP_TRIE' at `trie' (followed by `self->mg_pc') */
+PRIVATE WUNUSED NONNULL((1, 2, 4)) bool
+NOTHROW_NCX(CC mlits_gather_trie)(struct mlits_gather *__restrict self,
+                                  byte_t const *__restrict trie, size_t nodeoff,
+                                  byte_t const *__restrict lit, size_t len) {
+	byte_t buf[RE_CODE_MLITS_LEN];
+	byte_t const *node = trie + nodeoff;
+	memcpy(buf, lit, len);
+	for (;;) {
+		if (len >= RE_CODE_MLITS_LEN)
+			return mlits_gather_add(self, buf, len);
+		if (*node & RETRIE_ACCEPT) {
+			/* Some literal ends here -> continue with what comes after the trie */
+			if (!mlits_gather(self, self->mg_pc, buf, len))
+				return false;
+		}
+		if (*node & RETRIE_RUN) {
+			byte_t i, runlen = *node & RETRIE_RUNMASK;
+			for (i = 0; i < runlen && len < RE_CODE_MLITS_LEN; ++i)
+				buf[len++] = node[1 + i];
+			node += 1 + runlen;
+		} else if (*node & RETRIE_BRANCH) {
+			size_t i, count = (size_t)node[1] + 1;
+			byte_t const *offsets = node + 2 + count;
+			for (i = 0; i < count; ++i) {
+				buf[len] = node[2 + i];
+				if (!mlits_gather_trie(self, trie, UNALIGNED_GET16(offsets + i * 2), buf, len + 1))
+					return false;
+			}
+			return true;
+		} else {
+			return true; /* Leaf (already handled as accepting node) */
+		}
+	}
+}
+
+/* Gather the literal starts of all paths through code starting at `pc',
+ * given that `len' bytes of `lit' have already been matched.
+ * @return: false: Some path doesn't start with a long enough literal, or too many literals */
+PRIVATE WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC mlits_gather)(struct mlits_gather *__restrict self,
+                             byte_t const *pc,
+                             byte_t const *__restrict lit, size_t len) {
+	byte_t buf[RE_CODE_MLITS_LEN];
+	memcpy(buf, lit, len);
+	for (;;) {
+		if (len >= RE_CODE_MLITS_LEN)
+			return mlits_gather_add(self, buf, len);
+		if (self->mg_steps == 0)
+			return false;
+		--self->mg_steps;
+		switch (*pc) {
+
+		case REOP_BYTE:
+			buf[len++] = pc[1];
+			pc += 2;
+			break;
+
+		case REOP_EXACT: {
+			byte_t i, exactlen = pc[1];
+			for (i = 0; i < exactlen && len < RE_CODE_MLITS_LEN; ++i)
+				buf[len++] = pc[2 + i];
+			pc += 2 + exactlen;
+		}	break;
+
+		case REOP_TRIE: {
+			byte_t const *saved_pc = self->mg_pc;
+			bool ok;
+			self->mg_pc = libre_opcode_next(pc);
+			ok = mlits_gather_trie(self, pc, RETRIE_ROOT, buf, len);
+			self->mg_pc = saved_pc;
+			return ok;
+		}
+
+		case_REOP_AT_MIN_to_MAX:
+		case REOP_NOP:
+		case REOP_POP_ONFAIL:
+		case REOP_JMP_ONFAIL_DUMMY:
+		case REOP_POP_ONFAIL_AT:
+		case REOP_JMP_ONFAIL_DUMMY_AT:
+		case REOP_GROUP_START:
+		case REOP_GROUP_END:
+		case REOP_SETVAR:
+			/* These don't consume any input */
+			pc = libre_opcode_next(pc);
+			break;
+
+		case_REOP_GROUP_END_JMIN_to_JMAX:
+			if (!mlits_gather(self, pc + 2 + REOP_GROUP_END_Joff(*pc), buf, len))
+				return false;
+			pc += 2;
+			break;
+
+		case REOP_JMP_ONFAIL:
+		case REOP_JMP_AND_RETURN_ONFAIL:
+		case REOP_SPAN:
+		case REOP_SPAN_AND_RETURN_ONFAIL:
+		case REOP_SPAN_LIT:
+		case REOP_SPAN_LIT_AND_RETURN_ONFAIL: {
+			int16_t delta = (int16_t)UNALIGNED_GET16(pc + 1);
+			if (delta <= 0)
+				return mlits_gather_add(self, buf, len); /* Loop (stop here) */
+			if (!mlits_gather(self, pc + 3 + delta, buf, len))
+				return false;
+			pc += 3;
+		}	break;
+
+		case REOP_JMP: {
+			int16_t delta = (int16_t)UNALIGNED_GET16(pc + 1);
+			if (delta < 0)
+				return mlits_gather_add(self, buf, len); /* Loop (stop here) */
+			pc += 3 + delta;
+		}	break;
+
+		default:
+			/* Anything else ends the literal start */
+			return mlits_gather_add(self, buf, len);
+		}
+	}
+}
+
+/* Check if every match of `self' must start with one of a small set of short literals
+ * (e.g. "GET|POST|PUT|DELETE"), and if so, remember their leading bytes. This is only
+ * done when there isn't a literal prefix (which is a more precise way of skipping). */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC populate_mlits)(struct re_code *__restrict self) {
+	struct mlits_gather gather;
+	size_t i, j, mllen;
+	self->rc_mlcount = 0;
+	if (self->rc_pfxlen != 0 || self->rc_minmatch < 2)
+		return;
+	gather.mg_count = 0;
+	gather.mg_steps = MLITS_GATHER_MAXSTEPS;
+	gather.mg_pc    = NULL;
+	if (!mlits_gather(&gather, self->rc_code, gather.mg_lits[0], 0))
+		return;
+	if (gather.mg_count == 0)
+		return;
+
+	/* Cut all literal starts down to the length of the shortest one */
+	mllen = RE_CODE_MLITS_LEN;
+	for (i = 0; i < gather.mg_count; ++i) {
+		if (mllen > gather.mg_lens[i])
+			mllen = gather.mg_lens[i];
+	}
+
+	/* Remove duplicates */
+	for (i = 0; i < gather.mg_count; ++i) {
+		for (j = 0; j < self->rc_mlcount; ++j) {
+			if (bcmp(self->rc_mlits[j], gather.mg_lits[i], mllen) == 0)
+				break;
+		}
+		if (j < self->rc_mlcount)
+			continue;
+		if (self->rc_mlcount >= RE_CODE_MLITS_MAX) {
+			self->rc_mlcount = 0; /* Too many */
+			return;
+		}
+		memcpy(self->rc_mlits[self->rc_mlcount], gather.mg_lits[i], mllen);
+		++self->rc_mlcount;
+	}
+	self->rc_mllen = (uint8_t)mllen;
+}
+#undef MLITS_GATHER_MAXSTEPS
+#undef MLITS_GATHER_MAX
+
 INTERN NONNULL((1)) void
 NOTHROW_NCX(CC libre_code_makefast)(struct re_code *__restrict self) {
 	byte_t *variables;
@@ -896,6 +1499,11 @@ NOTHROW_NCX(CC libre_code_makefast)(struct re_code *__restrict self) {
 	                 self->rc_code, self->rc_code);
 	assertf(self->rc_minmatch != SIZE_MAX,
 	        "minmatch attribute was never overwritten");
+
+	/* Check for literals that can be used to speed up searches */
+	populate_prefix(self);
+	populate_required(self);
+	populate_mlits(self);
 }
 #endif /* !__OPTIMIZE_SIZE__ */
 
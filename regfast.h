@@ -34,7 +34,16 @@ DECL_BEGIN
 
 /* Calculates, and fills in members of `self':
  * - self->rc_fmap
- * - self->rc_minmatch */
+ * - self->rc_minmatch
+ * - self->rc_pfxlen
+ * - self->rc_pfxoff
+ * - self->rc_mustlen
+ * - self->rc_mustoff
+ * - self->rc_mustmin
+ * - self->rc_mustmax
+ * - self->rc_mlcount
+ * - self->rc_mllen
+ * - self->rc_mlits */
 INTDEF NONNULL((1)) void
 NOTHROW_NCX(CC libre_code_makefast)(struct re_code *__restrict self);
 
@@ -0,0 +1,235 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGFINDALL_C
+#define GUARD_LIBREGEX_REGFINDALL_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regdfa.h"
+#include "regexec.h"
+#include "reginterp.h"
+#include "regpike.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+/* An iterator returns all matches of a pattern in the same input, one after
+ * the other. Everything that a search has to set up before its first match
+ * attempt is only done once, and then kept for all later matches: the
+ * interpreter (including its on-fail stack and memo bitmap), a DFA or pike
+ * VM once it's used for match attempts, the position of the next required
+ * literal, and the input pointer itself (which is simply left at the end of
+ * the previous match, so the iov doesn't have to be walked again). */
+struct re_findall {
+	struct re_exec         rf_exec;     /* [const] Copy of the caller's exec command block */
+	struct re_interpreter *rf_interp;   /* [0..1][owned(free)] Interpreter (positioned at `rf_offset'; NULL if `re_interpreter_init()' failed) */
+	struct re_dfa         *rf_dfa;      /* [0..1][owned] DFA used for match attempts */
+	struct re_pike        *rf_pike;     /* [0..1][owned] Pike VM used for match attempts */
+	size_t                 rf_offset;   /* Offset where the search for the next match starts */
+	size_t                 rf_mustnext; /* Offset from which the required literal has to be searched for again */
+	size_t                 rf_attempts; /* # of match attempts made so far (by all searches) */
+	re_errno_t             rf_error;    /* Error returned by all further calls to `libre_findall_next()' (RE_NOMATCH after the last match) */
+	COMPILER_FLEXIBLE_ARRAY(re_regmatch_t, rf_groups); /* [rf_exec.rx_code->rc_ngrps] Group buffer (only if `rf_exec.rx_nmatch' is too small) */
+};
+
+/* Create an iterator over all matches of `exec->rx_code' in the input of `exec'
+ * @return: * :   The new iterator (to be destroyed using `re_findall_destroy(3R)')
+ * @return: NULL: Out of memory */
+INTERN WUNUSED NONNULL((1)) struct re_findall *
+NOTHROW_NCX(CC libre_findall_new)(struct re_exec const *__restrict exec) {
+	struct re_findall *result;
+	struct re_interpreter *interp;
+	struct re_code const *code = exec->rx_code;
+	uint16_t ngrps = 0;
+	if (exec->rx_nmatch < code->rc_ngrps)
+		ngrps = code->rc_ngrps;
+	result = (struct re_findall *)malloc(offsetof(struct re_findall, rf_groups) +
+	                                     ngrps * sizeof(re_regmatch_t));
+	if unlikely(!result)
+		goto err;
+	interp = (struct re_interpreter *)malloc(offsetof(struct re_interpreter, ri_vars) +
+	                                         code->rc_nvars * sizeof(byte_t));
+	if unlikely(!interp)
+		goto err_r;
+	memcpy(&result->rf_exec, exec, sizeof(struct re_exec));
+	result->rf_interp   = interp;
+	result->rf_dfa      = NULL;
+	result->rf_pike     = NULL;
+	result->rf_offset   = exec->rx_startoff;
+	result->rf_mustnext = exec->rx_startoff;
+	result->rf_attempts = 0;
+	result->rf_error    = re_interpreter_init(interp, &result->rf_exec);
+	if unlikely(result->rf_error != RE_NOERROR) {
+		free(interp);
+		result->rf_interp = NULL;
+		return result;
+	}
+
+	/* Same as `re_interpreter_init_match()', but the group buffer must outlive this
+	 * call (groups are only reset by `libre_findall_next()', since the caller may
+	 * still change the contents of its own buffer until then) */
+	interp->ri_pmatch = ngrps ? result->rf_groups : exec->rx_pmatch;
+	if (exec->rx_nmatch || (code->rc_flags & RE_CODE_FLAG_NEEDGROUPS))
+		interp->ri_flags |= RE_INTERPRETER_F_RSGRPS;
+	result->rf_pike = re_pike_new(&result->rf_exec, &result->rf_error);
+	return result;
+err_r:
+	free(result);
+err:
+	return NULL;
+}
+
+/* Destroy an iterator previously created by `re_findall_new(3R)' */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC libre_findall_destroy)(struct re_findall *__restrict self) {
+	if (self->rf_interp != NULL) {
+		re_interpreter_fini(self->rf_interp);
+		free(self->rf_interp);
+	}
+	re_pike_destroy(self->rf_pike);
+	re_dfa_destroy(self->rf_dfa);
+	free(self);
+}
+
+/* Return the next match of `self' (what `re_exec_search_noepsilon(3R)' would return
+ * for a search that starts at the end of the previous match, or at `rx_startoff')
+ * @param: p_match_size: When non-NULL, set to the # of bytes that were matched
+ * @return: >= 0:        The offset where the matched area starts
+ * @return: -RE_NOMATCH: There are no more matches
+ * @return: -RE_ENOSYS:  `RE_EXEC_LINEAR' was given for a pattern (or input) that needs backtracking
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+INTERN WUNUSED NONNULL((1)) ssize_t
+NOTHROW_NCX(CC libre_findall_next)(struct re_findall *__restrict self,
+                                   size_t *p_match_size) {
+	ssize_t result;
+	struct re_interpreter *interp = self->rf_interp;
+	struct re_exec const *exec    = &self->rf_exec;
+	struct re_interpreter_inptr used_inptr;
+	size_t match_offset, search_range;
+	if unlikely(self->rf_error != RE_NOERROR)
+		return -self->rf_error;
+	match_offset = self->rf_offset;
+	if (OVERFLOW_USUB(exec->rx_endoff, match_offset, &search_range) ||
+	    OVERFLOW_USUB(search_range, exec->rx_code->rc_minmatch, &search_range)) {
+		result = -RE_NOMATCH;
+		goto done;
+	}
+	++search_range; /* +1, so the last search is still performed (s.a. `libre_exec_search()') */
+	if (interp->ri_flags & RE_INTERPRETER_F_RSGRPS) {
+		/* Groups may still be those of the previous match */
+		memsetc(interp->ri_pmatch, RE_REGOFF_UNSET,
+		        exec->rx_code->rc_ngrps * 2, sizeof(re_regoff_t));
+	}
+
+	/* Same search-loop as `libre_exec_search_noepsilon()' */
+	used_inptr = interp->ri_in;
+	for (;;) {
+		if (!re_interpreter_search_advance(interp, &search_range, &match_offset, &self->rf_mustnext)) {
+			result = -RE_NOMATCH;
+			break;
+		}
+		if (++self->rf_attempts == RE_DFA_MINATTEMPTS && self->rf_dfa == NULL) {
+			if (!re_interpreter_search_usedfa(interp, &self->rf_dfa, &search_range)) {
+				result = -RE_NOMATCH;
+				break;
+			}
+		}
+		used_inptr = interp->ri_in;
+		result = re_interpreter_exec(interp, &self->rf_dfa, &self->rf_pike);
+		if (result != -RE_NOMATCH) {
+			size_t match_size;
+			if unlikely(result != -RE_NOERROR)
+				break;
+
+			/* Items that are left on the on-fail stack by a successful attempt (and the
+			 * groups it matched) mustn't be seen by the next attempt. */
+			interp->ri_onfailc = 0;
+			match_size = re_interpreter_in_curoffset(interp) - match_offset;
+			if (match_size == 0) {
+				if (interp->ri_flags & RE_INTERPRETER_F_RSGRPS) {
+					memsetc(interp->ri_pmatch, RE_REGOFF_UNSET,
+					        exec->rx_code->rc_ngrps * 2, sizeof(re_regoff_t));
+				}
+				goto advance_one;
+			}
+			if (p_match_size != NULL)
+				*p_match_size = match_size;
+			re_interpreter_copy_match(interp);
+			self->rf_offset = match_offset + match_size;
+			return (ssize_t)match_offset;
+		}
+advance_one:
+		--search_range;
+		if (search_range == 0) {
+			result = -RE_NOMATCH;
+			break;
+		}
+		++match_offset;
+		re_interpreter_inptr_in_advance1(&used_inptr);
+		interp->ri_in = used_inptr;
+	}
+done:
+	self->rf_error = (re_errno_t)-result;
+	return result;
+}
+
+#undef HAVE_TRACE
+#undef TRACE
+
+DEFINE_PUBLIC_ALIAS(re_findall_new, libre_findall_new);
+DEFINE_PUBLIC_ALIAS(re_findall_destroy, libre_findall_destroy);
+DEFINE_PUBLIC_ALIAS(re_findall_next, libre_findall_next);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGFINDALL_C */
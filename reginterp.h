@@ -0,0 +1,782 @@
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGINTERP_H
+#define GUARD_LIBREGEX_REGINTERP_H 1
+
+#include "api.h"
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <hybrid/unaligned.h>
+
+#include <kos/types.h>
+#include <bits/os/iovec.h>
+
+#include <alloca.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unicode.h>
+
+#include <libregex/regcomp.h>
+#include <libregex/regexec.h>
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+/* Hot code is translated into x86_64 machine code (s.a. `re_jit_new()') */
+#if defined(__x86_64__) && !defined(LIBREGEX_REGEXEC_NO_JIT)
+#define HAVE_JIT
+#endif /* __x86_64__ && !LIBREGEX_REGEXEC_NO_JIT */
+
+DECL_BEGIN
+
+#define ascii_islf(ch) ((ch) == '\r' || (ch) == '\n')
+
+/* Same as `unicode_islf(ch)', but without a trait lookup for printable ASCII
+ * characters (line-feeds are never among those) */
+#define re_unicode_islf(ch) (((ch) < 0x20 || (ch) >= 0x7f) && unicode_islf(ch))
+
+/* Read the signed 16-bit jump delta of `REOP_JMP' & friends */
+#define delta16_get(p) ((int16_t)UNALIGNED_GET16(p))
+
+#define RE_ONFAILURE_ITEM_DUMMY                             512 /* == 256 * 2 (256 being the max # of groups per pattern, and 2 being the # of offsets per group) */
+#define RE_ONFAILURE_ITEM_MEMO                              513 /* `rof_in' is the index of a bit to set in `ri_memo' when popped by `onfail' */
+#define RE_ONFAILURE_ITEM_SPAN                              514 /* `rof_in' is where a `REOP_SPAN[_LIT]_AND_RETURN_ONFAIL' started, and `rof_pc' its single-character opcode.
+                                                                 * Always sits on top of the `RE_ONFAILURE_ITEM_RESUME' item of that same span, which
+                                                                 * gets re-used (with `rof_in' giving back characters) every time this is popped. */
+#define RE_ONFAILURE_ITEM_DUMMY_AT                          515 /* Dummy item whose `rof_pc' is used for identification (by `REOP_POP_ONFAIL_AT') */
+#define RE_ONFAILURE_ITEM_RESUME                            516 /* Resume execution at `rof_pc', with the input at `rof_in' */
+#define RE_ONFAILURE_ITEM_SPECIAL_CHECK(tag)                ((tag) != RE_ONFAILURE_ITEM_RESUME)
+#define RE_ONFAILURE_ITEM_TRANSPARENT_CHECK(tag)            ((tag) < RE_ONFAILURE_ITEM_DUMMY || (tag) == RE_ONFAILURE_ITEM_MEMO || (tag) == RE_ONFAILURE_ITEM_SPAN)
+#define RE_ONFAILURE_ITEM_HASPC_CHECK(tag)                  ((tag) >= RE_ONFAILURE_ITEM_DUMMY_AT)
+#define RE_ONFAILURE_ITEM_GROUP_RESTORE_CHECK(tag)          ((tag) < RE_ONFAILURE_ITEM_DUMMY)
+#define RE_ONFAILURE_ITEM_GROUP_RESTORE_ISSTART(tag)        ((tag) & 1)
+#define RE_ONFAILURE_ITEM_GROUP_RESTORE_GETGID(tag)         ((uint8_t)((tag) >> 1))
+#define RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE(is_start, gid) ((uint16_t)(((gid) << 1) | (is_start)))
+
+struct re_onfailure_item {
+	uint32_t rof_in;  /* Input offset to restore, relative to `rx_startoff' (as returned by `re_interpreter_in_reloffset()')
+	                   * - The start- or end-offset to restore for group-restore items (as a `re_regoff_t').
+	                   * - The index of a bit in `ri_memo' for `RE_ONFAILURE_ITEM_MEMO'.
+	                   * - Unused for dummy on-fail items. */
+	uint16_t rof_pc;  /* Program counter to restore (offset from `rc_code'; code is never larger than 2^16 bytes)
+	                   * NOTE: only used for identification when `rof_tag == RE_ONFAILURE_ITEM_DUMMY_AT' */
+	uint16_t rof_tag; /* One of `RE_ONFAILURE_ITEM_*', or `RE_ONFAILURE_ITEM_GROUP_RESTORE_ENCODE()' if
+	                   * `rof_in' is the start- or end-offset that should be restored for a group on fail. */
+};
+
+struct re_interpreter_inptr {
+	byte_t const       *ri_in_ptr;    /* [<= ri_in_cend] Current input pointer. */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	byte_t const       *ri_in_cend;   /* End of the current input chunk */
+	byte_t const       *ri_in_cbase;  /* [0..1] Original base pointer of current input IOV chunk */
+	byte_t const       *ri_in_vbase;  /* [0..1] Virtual base pointer of current input IOV chunk (such that `ri_in_ptr - ri_in_vbase'
+	                                   * produces offsets compatible with `struct re_exec::rx_startoff' and the like, including  the
+	                                   * start/end offsets stored in `ri_pmatch') */
+	struct iovec const *ri_in_miov;   /* [0..*] Further input chunks that have yet to be loaded. (current chunk originates from `ri_in_miov[-1]') */
+	size_t              ri_in_mcnt;   /* # of remaining bytes in buffers described by `ri_in_miov[*]' */
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+};
+
+struct re_interpreter {
+	union {
+		struct re_interpreter_inptr ri_in;        /* Input pointer controller. */
+		struct {
+			byte_t const           *ri_in_ptr;    /* [<= ri_in_cend] Current input pointer. */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+			byte_t const           *ri_in_cend;   /* End of the current input chunk */
+			byte_t const           *ri_in_cbase;  /* [0..1] Original base pointer of current input IOV chunk */
+			byte_t const           *ri_in_vbase;  /* [0..1] Virtual base pointer of current input IOV chunk (such that `ri_in_ptr - ri_in_vbase'
+			                                       * produces offsets compatible with `struct re_exec::rx_startoff' and the like, including  the
+			                                       * start/end offsets stored in `ri_pmatch') */
+			struct iovec const     *ri_in_miov;   /* [0..*] Further input chunks that have yet to be loaded. (current chunk originates from `ri_in_miov[-1]') */
+			size_t                  ri_in_mcnt;   /* # of remaining bytes in buffers described by `ri_in_miov[*]' */
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		}; /* TODO: Support for no-transparent-struct */
+	};     /* TODO: Support for no-transparent-union */
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define ri_in_vbase ri_in_cbase
+	byte_t const                   *ri_in_cbase;  /* [== ri_exec->rx_inbase] */
+	byte_t const                   *ri_in_cend;   /* [== ri_exec->rx_inbase + ri_exec->rx_endoff] */
+	byte_t const                   *ri_in_vend;   /* [== ri_exec->rx_inbase + ri_exec->rx_insize] */
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	struct iovec const             *ri_in_biov;   /* [0..*][<= ri_in_miov][const] Initial iov vector base (== `struct re_exec::rx_iov') */
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	struct re_exec const           *ri_exec;      /* [1..1][const] Regex exec command block. */
+	re_regmatch_t                  *ri_pmatch;    /* [1..ri_exec->rx_code->rc_ngrps][const] Group match start/end offset register buffer (owned if caller-provided buffer is too small). */
+	struct re_exec_ctx             *ri_ctx;       /* [0..1][const] Context from where buffers are taken, and to where they are given back (s.a. `RE_EXEC_CTX') */
+	struct re_onfailure_item       *ri_onfailv;   /* [0..ri_onfailc][owned(free)] On-failure stack */
+	size_t                          ri_onfailc;   /* [<= ri_onfaila] # of elements on the on-failure stack */
+	size_t                          ri_onfaila;   /* Allocated # of elements of `ri_onfailv' */
+	struct re_interpreter_inptr     ri_bmatch;    /* USED INTERNALLY: pending best match */
+	re_regmatch_t                  *ri_bmatch_g;  /* [1..ri_exec->rx_code->rc_ngrps]
+	                                               * [valid_if(best_match_isvalid() && ri_exec->rx_nmatch != 0)]
+	                                               * Group match buffer for `ri_bmatch' */
+	byte_t                         *ri_memo;      /* [0..ri_memo_size][owned(free)][(!= NULL && == ri_ctx->rxc_memov) -> owned(ri_ctx)] Bitmap of (pc, offset) pairs from where on-fail items were already resumed (s.a. `re_interpreter_memo_index()') */
+	size_t                          ri_memo_size; /* [valid_if(ri_memo)] Size of `ri_memo' (in bytes) */
+	size_t                          ri_memo_cols; /* [valid_if(ri_memo)] # of offsets (starting at `ri_exec->rx_startoff') per pc in `ri_memo' */
+	size_t                          ri_memo_wait; /* [valid_if(!ri_memo)] # of on-fail items left to resume before `ri_memo' is allocated (0: never) */
+#ifdef HAVE_JIT
+	struct re_jit                  *ri_jit;       /* [0..1][owned][(!= NULL && == ri_ctx->rxc_jit) -> owned(ri_ctx)] Machine code used to execute `ri_exec->rx_code' (s.a. `re_jit_new()') */
+	size_t                          ri_jit_wait;  /* [valid_if(!ri_jit)] # of calls to `libre_interp_exec()' left before `ri_jit' is created (0: never) */
+#endif /* HAVE_JIT */
+	byte_t                          ri_flags;     /* Execution flags (set of `RE_INTERPRETER_F_*') */
+#define RE_INTERPRETER_F_NORMAL     0x00          /* NORMAL flags */
+#define RE_INTERPRETER_F_RSGRPS     0x01          /* ResetGRouPS (on fail) -- must be set when wanting to re-use the interpreter in searches */
+#define RE_INTERPRETER_F_MEMODIRTY  0x02          /* `ri_memo' may contain marks from an attempt that didn't fail (must be cleared before the next attempt) */
+#define RE_INTERPRETER_F_MEMOUSED   0x04          /* `ri_memo' was used by the current attempt */
+#define RE_INTERPRETER_F_MEMOOFF    0x08          /* Don't use `ri_memo' for the rest of the current attempt */
+	COMPILER_FLEXIBLE_ARRAY(byte_t, ri_vars);     /* [ri_exec->rx_code->rc_nvars] Space for variables used by code. */
+};
+
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_inptr_in_advance1(self)  (++(self)->ri_in_ptr)
+#define re_interpreter_inptr_in_reverse1(self)  (--(self)->ri_in_ptr)
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_inptr_in_advance1(self)                                                           \
+	(unlikely((self)->ri_in_ptr >= (self)->ri_in_cend) ? re_interpreter_inptr_nextchunk(self) : (void)0, \
+	 ++(self)->ri_in_ptr)
+#define re_interpreter_inptr_in_reverse1(self)                                                            \
+	(unlikely((self)->ri_in_ptr <= (self)->ri_in_cbase) ? re_interpreter_inptr_prevchunk(self) : (void)0, \
+	 --(self)->ri_in_ptr)
+#define re_interpreter_in_chunkcontains(self, inptr) \
+	((inptr) >= re_interpreter_in_chunkbase(self) && \
+	 (inptr) <= re_interpreter_in_chunkend(self)) /* yes: '<=', because inptr == end-of-chunk means epsilon (in case of the last chunk) */
+#define re_interpreter_in_isfirstchunk(self)    ((self)->ri_in_miov <= (self)->ri_in_biov + 1)           /* True if in first chunk */
+#define re_interpreter_in_islastchunk(self)     ((self)->ri_in_mcnt <= 0)                                /* True if in last chunk */
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+#define re_interpreter_in_chunk_cangetc(self)   ((self)->ri_in_ptr < (self)->ri_in_cend)                 /* True if not at end of current chunk */
+#define re_interpreter_in_chunk_canungetc(self) ((self)->ri_in_ptr > (self)->ri_in_cbase)                /* True if not at start of current chunk */
+#define re_interpreter_in_chunkdone(self)       ((size_t)((self)->ri_in_ptr - (self)->ri_in_cbase))      /* Bytes already processed from current chunk */
+#define re_interpreter_in_chunkleft(self)       ((size_t)((self)->ri_in_cend - (self)->ri_in_ptr))       /* Bytes left to read from current chunk */
+#define re_interpreter_in_chunkbase(self)       ((self)->ri_in_cbase)                                    /* Current chunk base pointer */
+#define re_interpreter_in_chunkend(self)        ((self)->ri_in_cend)                                     /* Current chunk end pointer */
+#define re_interpreter_in_chunksize(self)       ((size_t)((self)->ri_in_cend - (self)->ri_in_cbase))     /* Total size of current chunk */
+#define re_interpreter_in_chunkoffset(self)     ((size_t)((self)->ri_in_cbase - (self)->ri_in_vbase))    /* Offset of the currently loaded chunk */
+#define re_interpreter_in_chunkendoffset(self)  ((size_t)((self)->ri_in_cend - (self)->ri_in_vbase))     /* Offset at the end of the currently loaded chunk */
+#define re_interpreter_in_curoffset(self)       ((size_t)((self)->ri_in_ptr - (self)->ri_in_vbase))      /* Current offset from start of initial chunk */
+#define re_interpreter_in_reloffset(self)       ((uint32_t)(re_interpreter_in_curoffset(self) - (self)->ri_exec->rx_startoff)) /* Current offset from `rx_startoff' (as stored in `rof_in') */
+#define re_interpreter_in_totalleft(self)       (re_interpreter_in_chunkleft(self) + (self)->ri_in_mcnt) /* Total # of bytes of input left */
+#define re_interpreter_in_totalleftX(self)      (re_interpreter_in_totalleft(self) + (self)->ri_exec->rx_extra)
+
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_in_curoffset_or_ptr(self) (self)->ri_in_ptr
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_in_curoffset_or_ptr(self) re_interpreter_in_curoffset(self)
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_is_soi(self)  ((self)->ri_in_ptr <= (self)->ri_in_vbase)
+#define re_interpreter_is_eoi(self)  ((self)->ri_in_ptr >= (self)->ri_in_cend)
+#define re_interpreter_is_eoiX(self) ((self)->ri_in_ptr >= (self)->ri_in_vend)
+#define re_interpreter_is_eoi_at_end_of_chunk re_interpreter_is_eoi
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_is_soi(self)  ((self)->ri_in_ptr == (self)->ri_in_vbase /* Must compare `==' in case `ri_in_vbase' had an underflow (`<' w/o underflow would already be an illegal state!) */ \
+                                      || (self)->ri_in_biov == &re_interpreter_empty_iov) /* Nothing comes before epsilon input that isn't backed by any chunks */
+#define re_interpreter_is_eoi(self)  ((self)->ri_in_ptr >= (self)->ri_in_cend && (self)->ri_in_mcnt <= 0)
+#define re_interpreter_is_eoiX(self) ((self)->ri_in_ptr >= (self)->ri_in_cend && (self)->ri_in_mcnt <= 0 && (self)->ri_exec->rx_extra <= 0)
+#define re_interpreter_is_eoi_at_end_of_chunk(self) ((self)->ri_in_mcnt <= 0)
+
+/* Used as input chunk for epsilon input (when there also aren't any extra bytes) */
+INTDEF struct iovec const re_interpreter_empty_iov;
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+static_assert(offsetof(struct re_interpreter_inptr, ri_in_ptr) == offsetof(struct re_interpreter_inptr, ri_in_ptr));
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+static_assert(offsetof(struct re_interpreter_inptr, ri_in_cend) == offsetof(struct re_interpreter_inptr, ri_in_cend));
+static_assert(offsetof(struct re_interpreter_inptr, ri_in_cbase) == offsetof(struct re_interpreter_inptr, ri_in_cbase));
+static_assert(offsetof(struct re_interpreter_inptr, ri_in_vbase) == offsetof(struct re_interpreter_inptr, ri_in_vbase));
+static_assert(offsetof(struct re_interpreter_inptr, ri_in_miov) == offsetof(struct re_interpreter_inptr, ri_in_miov));
+static_assert(offsetof(struct re_interpreter_inptr, ri_in_mcnt) == offsetof(struct re_interpreter_inptr, ri_in_mcnt));
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Load the next chunk into `self' */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_nextchunk(self) \
+	re_interpreter_inptr_nextchunk(&(self)->ri_in)
+LOCAL NONNULL((1)) void
+NOTHROW_NCX(CC re_interpreter_inptr_nextchunk)(struct re_interpreter_inptr *__restrict self) {
+	struct iovec nextchunk;
+	size_t old_chunk_endoffset;
+	/* vvv This wouldn't account for `struct re_exec::rx_extra'! */
+	/*assertf(self->ri_in_mcnt != 0, "No further chunks can be loaded");*/
+	old_chunk_endoffset = re_interpreter_in_chunkendoffset(self);
+	do {
+		nextchunk = *self->ri_in_miov++;
+	} while (nextchunk.iov_len == 0); /* Skip over empty chunks */
+	if (nextchunk.iov_len > self->ri_in_mcnt)
+		nextchunk.iov_len = self->ri_in_mcnt;
+	self->ri_in_mcnt -= nextchunk.iov_len;
+	self->ri_in_ptr   = (byte_t const *)nextchunk.iov_base;
+	self->ri_in_cend  = (byte_t const *)nextchunk.iov_base + nextchunk.iov_len;
+	self->ri_in_cbase = (byte_t const *)nextchunk.iov_base;
+	self->ri_in_vbase = (byte_t const *)nextchunk.iov_base - old_chunk_endoffset;
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Load the previous chunk into `self' */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_prevchunk(self) \
+	re_interpreter_inptr_prevchunk(&(self)->ri_in)
+LOCAL NONNULL((1)) void
+NOTHROW_NCX(CC re_interpreter_inptr_prevchunk)(struct re_interpreter_inptr *__restrict self) {
+	struct iovec prevchunk;
+	size_t old_chunk_startoffset;
+	size_t new_chunk_startoffset;
+	old_chunk_startoffset = re_interpreter_in_chunkoffset(self);
+	self->ri_in_mcnt += re_interpreter_in_chunksize(self);
+	do {
+		prevchunk = self->ri_in_miov[-2]; /* [-1] would be the current chunk... */
+		--self->ri_in_miov;
+	} while (prevchunk.iov_len == 0); /* Skip over empty chunks */
+	new_chunk_startoffset = old_chunk_startoffset - prevchunk.iov_len;
+	self->ri_in_ptr   = (byte_t const *)prevchunk.iov_base + prevchunk.iov_len;
+	self->ri_in_cend  = (byte_t const *)prevchunk.iov_base + prevchunk.iov_len;
+	self->ri_in_cbase = (byte_t const *)prevchunk.iov_base;
+	self->ri_in_vbase = (byte_t const *)prevchunk.iov_base - new_chunk_startoffset;
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_advance(self, num_bytes)       (void)((self)->ri_in_ptr += (num_bytes))
+#define re_interpreter_inptr_advance(self, num_bytes) (void)((self)->ri_in_ptr += (num_bytes))
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_advance(self, num_bytes) \
+	re_interpreter_inptr_advance(&(self)->ri_in, num_bytes)
+LOCAL NONNULL((1)) void
+NOTHROW_NCX(CC re_interpreter_inptr_advance)(struct re_interpreter_inptr *__restrict self,
+                                             size_t num_bytes) {
+again:
+	if likely(num_bytes <= re_interpreter_in_chunkleft(self)) {
+		self->ri_in_ptr += num_bytes;
+	} else {
+		num_bytes -= re_interpreter_in_chunkleft(self);
+		re_interpreter_inptr_nextchunk(self);
+		goto again;
+	}
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_reverse(self, num_bytes)       (void)((self)->ri_in_ptr -= (num_bytes))
+#define re_interpreter_inptr_reverse(self, num_bytes) (void)((self)->ri_in_ptr -= (num_bytes))
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_reverse(self, num_bytes) \
+	re_interpreter_inptr_reverse(&(self)->ri_in, num_bytes)
+LOCAL NONNULL((1)) void
+NOTHROW_NCX(CC re_interpreter_inptr_reverse)(struct re_interpreter_inptr *__restrict self,
+                                             size_t num_bytes) {
+again:
+	if likely(num_bytes <= re_interpreter_in_chunkdone(self)) {
+		self->ri_in_ptr -= num_bytes;
+	} else {
+		num_bytes -= re_interpreter_in_chunkdone(self);
+		re_interpreter_inptr_prevchunk(self);
+		goto again;
+	}
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+
+/* Return the previous byte from input */
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_prevbyte(self)       (self)->ri_in_ptr[-1]
+#define re_interpreter_inptr_prevbyte(self) (self)->ri_in_ptr[-1]
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_prevbyte(self) \
+	(likely(re_interpreter_in_chunk_canungetc(self)) ? (self)->ri_in_ptr[-1] : _re_interpreter_inptr_prevbyte(&(self)->ri_in))
+#define re_interpreter_inptr_prevbyte(self) \
+	(likely(re_interpreter_in_chunk_canungetc(self)) ? (self)->ri_in_ptr[-1] : _re_interpreter_inptr_prevbyte(self))
+LOCAL WUNUSED NONNULL((1)) byte_t
+NOTHROW_NCX(CC _re_interpreter_inptr_prevbyte)(struct re_interpreter_inptr const *__restrict self) {
+	struct iovec const *iov;
+	iov = self->ri_in_miov - 2; /* -1 would be the current chunk */
+	while (iov->iov_len == 0)
+		--iov; /* Skip over empty chunks */
+	return ((byte_t const *)iov->iov_base)[iov->iov_len - 1];
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Return the next byte that will be read from input */
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_nextbyte(self)       (*(self)->ri_in_ptr)
+#define re_interpreter_inptr_nextbyte(self) (*(self)->ri_in_ptr)
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_nextbyte(self) \
+	(likely(re_interpreter_in_chunk_cangetc(self)) ? *(self)->ri_in_ptr : _re_interpreter_inptr_nextbyte(&(self)->ri_in))
+#define re_interpreter_inptr_nextbyte(self) \
+	(likely(re_interpreter_in_chunk_cangetc(self)) ? *(self)->ri_in_ptr : _re_interpreter_inptr_nextbyte(self))
+LOCAL WUNUSED NONNULL((1)) byte_t
+NOTHROW_NCX(CC _re_interpreter_inptr_nextbyte)(struct re_interpreter_inptr const *__restrict self) {
+	struct iovec const *iov;
+	/* vvv This wouldn't account for `struct re_exec::rx_extra'! */
+	/*assertf(self->ri_in_mcnt != 0, "No further chunks can be loaded");*/
+	iov = self->ri_in_miov;
+	while (iov->iov_len == 0)
+		++iov; /* Skip over empty chunks */
+	return *(byte_t const *)iov->iov_base;
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Peek memory that has been read in the past, copying up to `max_bytes' bytes of it into `buf'. */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+LOCAL WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_peekmem_bck)(struct re_interpreter const *__restrict self,
+                                           void *buf, size_t max_bytes) {
+	size_t avail, result;
+	size_t total_prev = re_interpreter_in_curoffset(self);
+	byte_t *dst = (byte_t *)buf + max_bytes;
+	if (max_bytes > total_prev)
+		max_bytes = total_prev;
+	result = max_bytes;
+	avail  = re_interpreter_in_chunkdone(self);
+	if (avail > max_bytes)
+		avail = max_bytes;
+	dst -= avail;
+	max_bytes -= avail;
+	memcpy(dst, self->ri_in_ptr - avail, avail);
+	if (max_bytes) {
+		struct iovec const *iov = self->ri_in_miov - 2; /* -1 would be the current chunk */
+		do {
+			avail = iov->iov_len;
+			if (avail > max_bytes)
+				avail = max_bytes;
+			dst -= avail;
+			memcpy(dst, (byte_t *)iov->iov_base + iov->iov_len - avail, avail);
+			max_bytes -= avail;
+			--iov;
+		} while (max_bytes);
+	}
+	if (dst > (byte_t *)buf)
+		memmovedown(buf, dst, result);
+	return result;
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Peek memory that will be read in the future, copying up to `max_bytes' bytes of it into `buf'.
+ * NOTE: This function also allows access to trailing `rx_extra' extra bytes. */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+LOCAL WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_peekmem_fwd)(struct re_interpreter const *__restrict self,
+                                           void *buf, size_t max_bytes) {
+	size_t avail, result;
+	size_t total_left = re_interpreter_in_totalleftX(self);
+	if (max_bytes > total_left)
+		max_bytes = total_left;
+	result = max_bytes;
+	avail  = re_interpreter_in_chunkleft(self);
+	if (avail > max_bytes)
+		avail = max_bytes;
+	buf = mempcpy(buf, self->ri_in_ptr, avail);
+	max_bytes -= avail;
+	if (max_bytes) {
+		struct iovec const *iov = self->ri_in_miov;
+		do {
+			avail = iov->iov_len;
+			if (avail > max_bytes)
+				avail = max_bytes;
+			buf = mempcpy(buf, iov->iov_base, avail);
+			max_bytes -= avail;
+			++iov;
+		} while (max_bytes);
+	}
+	return result;
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Return the previous utf-8 character from input */
+LOCAL WUNUSED NONNULL((1)) char32_t
+NOTHROW_NCX(CC re_interpreter_prevutf8)(struct re_interpreter const *__restrict self) {
+	if likely(re_interpreter_in_chunk_canungetc(self)) {
+		byte_t prevbyte = self->ri_in_ptr[-1];
+		if likely(prevbyte < 0x80)
+			return prevbyte;
+		if likely((self->ri_in_ptr - UNICODE_UTF8_CURLEN) <= self->ri_in_cbase) {
+			/* Can just read the entire character from the current chunk */
+			char const *reader = (char const *)self->ri_in_ptr;
+			return unicode_readutf8_rev(&reader);
+		}
+	}
+
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	if likely(re_interpreter_in_isfirstchunk(self))
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	{
+		/* First chunk -> just read a restricted-length unicode character */
+		char const *reader = (char const *)self->ri_in_ptr;
+		assert(reader > (char const *)self->ri_in_cbase);
+		return unicode_readutf8_rev_n(&reader, (char const *)self->ri_in_cbase);
+	}
+
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	/* Fallback: copy memory into a temporary buffer. */
+	{
+		size_t utf8_len;
+		char utf8[UNICODE_UTF8_CURLEN], *reader;
+		utf8_len = re_interpreter_peekmem_bck(self, utf8, sizeof(utf8));
+		reader   = utf8 + utf8_len;
+		assert(utf8_len != 0);
+		return unicode_readutf8_rev_n((char const **)&reader, utf8);
+	}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+}
+
+/* Return the next utf-8 character that will be read from input */
+LOCAL WUNUSED NONNULL((1)) char32_t
+NOTHROW_NCX(CC re_interpreter_nextutf8)(struct re_interpreter const *__restrict self) {
+	if likely(re_interpreter_in_chunk_cangetc(self)) {
+		uint8_t seqlen;
+		byte_t nextbyte = *self->ri_in_ptr;
+		if likely(nextbyte < 0x80)
+			return nextbyte;
+		seqlen = unicode_utf8seqlen[nextbyte];
+		if unlikely(!seqlen)
+			return nextbyte; /* Dangling follow-up byte? */
+		if likely((self->ri_in_ptr + seqlen) <= self->ri_in_cend) {
+			/* Can just read the entire character from the current chunk */
+			char const *reader = (char const *)self->ri_in_ptr;
+			return unicode_readutf8(&reader);
+		}
+	}
+
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	if likely(re_interpreter_in_islastchunk(self))
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	{
+		/* Last chunk -> just read a restricted-length unicode character */
+		char const *reader = (char const *)self->ri_in_ptr;
+		assert(reader < (char const *)self->ri_in_cend);
+		return unicode_readutf8_n(&reader, (char const *)self->ri_in_cend);
+	}
+
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	/* Fallback: copy memory into a temporary buffer. */
+	{
+		size_t utf8_len;
+		char utf8[UNICODE_UTF8_CURLEN], *reader;
+		utf8_len = re_interpreter_peekmem_fwd(self, utf8, sizeof(utf8));
+		reader   = utf8;
+		assert(utf8_len != 0);
+		return unicode_readutf8_n((char const **)&reader, utf8 + utf8_len);
+	}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+}
+
+
+/* Read a byte whilst advancing the input pointer. */
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_readbyte(self)       (*(self)->ri_in_ptr++)
+#define re_interpreter_inptr_readbyte(self) (*(self)->ri_in_ptr++)
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_readbyte(self)                                                              \
+	(unlikely((self)->ri_in_ptr >= (self)->ri_in_cend) ? re_interpreter_nextchunk(self) : (void)0, \
+	 *(self)->ri_in_ptr++)
+#define re_interpreter_inptr_readbyte(self)                                                              \
+	(unlikely((self)->ri_in_ptr >= (self)->ri_in_cend) ? re_interpreter_inptr_nextchunk(self) : (void)0, \
+	 *(self)->ri_in_ptr++)
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+/* Read a utf-8 character whilst advancing the input pointer (ASCII characters are read inline). */
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+#define re_interpreter_readutf8(self)      \
+	(likely(*(self)->ri_in_ptr < 0x80)     \
+	 ? (char32_t)*(self)->ri_in_ptr++      \
+	 : unicode_readutf8_n((char const **)&(self)->ri_in_ptr, (char const *)(self)->ri_in_cend))
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_readutf8(self)                                           \
+	(likely(re_interpreter_in_chunk_cangetc(self) && *(self)->ri_in_ptr < 0x80) \
+	 ? (char32_t)*(self)->ri_in_ptr++                                           \
+	 : _re_interpreter_readutf8(self))
+LOCAL NONNULL((1)) char32_t
+NOTHROW_NCX(CC _re_interpreter_readutf8)(struct re_interpreter *__restrict self) {
+	uint8_t seqlen;
+	byte_t nextbyte;
+	if unlikely(!re_interpreter_in_chunk_cangetc(self))
+		re_interpreter_inptr_nextchunk(&self->ri_in);
+
+	nextbyte = *self->ri_in_ptr;
+	if likely(nextbyte < 0x80) {
+		++self->ri_in_ptr;
+		return nextbyte;
+	}
+	seqlen = unicode_utf8seqlen[nextbyte];
+	if unlikely(!seqlen) {
+		++self->ri_in_ptr;
+		return nextbyte; /* Dangling follow-up byte? */
+	}
+	if likely((self->ri_in_ptr + seqlen) <= self->ri_in_cend) {
+		/* Can just read the entire character from the current chunk */
+		return unicode_readutf8((char const **)&self->ri_in_ptr);
+	}
+	if likely(re_interpreter_in_islastchunk(self)) {
+		/* Last chunk -> just read a restricted-length unicode character */
+		assert((char const *)self->ri_in_ptr < (char const *)self->ri_in_cend);
+		return unicode_readutf8_n((char const **)&self->ri_in_ptr, (char const *)self->ri_in_cend);
+	}
+
+	/* Unicode character is spread across multiple chunks */
+	{
+		size_t firstchunk, missing, left;
+		char utf8[UNICODE_UTF8_CURLEN], *dst, *reader;
+		firstchunk = re_interpreter_in_chunkleft(self);
+		assert(seqlen > firstchunk);
+		dst     = (char *)mempcpy(utf8, self->ri_in_ptr, firstchunk);
+		missing = seqlen - firstchunk;
+		re_interpreter_inptr_nextchunk(&self->ri_in);
+		left = re_interpreter_in_totalleft(self);
+		if (missing > left)
+			missing = left;
+		if (missing) {
+			for (;;) {
+				size_t avail = re_interpreter_in_chunkleft(self);
+				if (avail > missing)
+					avail = missing;
+				dst = (char *)mempcpy(dst, self->ri_in_ptr, avail);
+				missing -= avail;
+				self->ri_in_ptr += avail;
+				if (!missing)
+					break;
+				re_interpreter_inptr_nextchunk(&self->ri_in);
+			}
+		}
+		reader = utf8;
+		return unicode_readutf8_n((char const **)&reader, dst);
+	}
+}
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+
+
+
+/* Set the absolute offset of `self' */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+LOCAL NONNULL((1)) void
+NOTHROW_NCX(CC re_interpreter_inptr_setoffset)(struct re_interpreter_inptr *__restrict self,
+                                               size_t offset) {
+	size_t curr_chunk_start_offset = re_interpreter_in_chunkoffset(self);
+	size_t curr_chunk_end_offset   = re_interpreter_in_chunkendoffset(self);
+	if (offset >= curr_chunk_start_offset &&
+	    offset <= curr_chunk_end_offset) { /* <<< yes: "<=" (in case `offset' points to the end of  the
+	                                        *     input buffer, we mustn't load an out-of-bounds chunk) */
+		/* Simple case: don't need to change chunks */
+		self->ri_in_ptr = self->ri_in_cbase + (offset - curr_chunk_start_offset);
+	} else {
+		size_t curr_offset = re_interpreter_in_curoffset(self);
+		if (offset >= curr_chunk_end_offset) {
+			/* Skip ahead */
+			assert(offset > curr_offset);
+			re_interpreter_inptr_advance(self, offset - curr_offset);
+		} else {
+			/* Rewind backwards */
+			assert(offset < curr_chunk_start_offset);
+			assert(offset < curr_offset);
+			re_interpreter_inptr_reverse(self, curr_offset - offset);
+		}
+	}
+}
+#define re_interpreter_setoffset(self, offset)                                                     \
+	(likely((size_t)(offset) - re_interpreter_in_chunkoffset(self) <= re_interpreter_in_chunksize(self)) \
+	 ? (void)((self)->ri_in_ptr = (self)->ri_in_vbase + (offset))                                      \
+	 : re_interpreter_inptr_setoffset(&(self)->ri_in, offset))
+#else /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_setoffset(self, offset) (void)((self)->ri_in_ptr = (self)->ri_in_vbase + (offset))
+#endif /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+#define re_interpreter_setreloffset(self, reloff) re_interpreter_setoffset(self, (self)->ri_exec->rx_startoff + (reloff))
+
+
+/* Allocate a new regex interpreter */
+#define re_interpreter_alloc(nvars) \
+	((struct re_interpreter *)alloca(offsetof(struct re_interpreter, ri_vars) + (nvars) * sizeof(byte_t)))
+
+/* Initialize a given regex interpreter
+ * @return: RE_NOERROR: Success
+ * @return: RE_ESIZE:   `rx_endoff - rx_startoff' doesn't fit into 32 bits */
+INTDEF WUNUSED NONNULL((1, 2)) re_errno_t
+NOTHROW_NCX(CC re_interpreter_init)(struct re_interpreter *__restrict self,
+                                   struct re_exec const *__restrict exec);
+
+/* Finalize a given regex interpreter (buffers are given back to `ri_ctx', if there is one) */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC re_interpreter_fini)(struct re_interpreter *__restrict self);
+
+
+/* Initialize the match-buffer of `self' */
+#define re_interpreter_init_match(self, exec, for_search)                                 \
+	do {                                                                                  \
+		uint16_t _ngrp;                                                                   \
+		(self)->ri_pmatch = (exec)->rx_pmatch;                                            \
+		_ngrp             = (exec)->rx_code->rc_ngrps;                                    \
+		if ((exec)->rx_nmatch >= _ngrp) {                                                 \
+			/* Able to use user-provided register buffer. */                              \
+		} else {                                                                          \
+			/* Need to use our own group start/end-offset buffer.                         \
+			 * NOTE: stack-allocated, because max size is 256*8 = 2048 bytes. */          \
+			(self)->ri_pmatch = (re_regmatch_t *)alloca(_ngrp * sizeof(re_regmatch_t));   \
+		}                                                                                 \
+		/* Set all offsets to RE_REGOFF_UNSET (if they're written back at the end,        \
+		 * or if the code being executed expects unset groups to be marked properly) */   \
+		if ((exec)->rx_nmatch || ((exec)->rx_code->rc_flags & RE_CODE_FLAG_NEEDGROUPS)) { \
+			memsetc((self)->ri_pmatch, RE_REGOFF_UNSET,                                   \
+			        _ngrp * 2, sizeof(re_regoff_t));                                      \
+			if (for_search) {                                                             \
+				/* Interpreter is used for searching and needs groups (reset on fail) */  \
+				(self)->ri_flags |= RE_INTERPRETER_F_RSGRPS;                              \
+			}                                                                             \
+		}                                                                                 \
+	}	__WHILE0
+
+/* Copy the matches produced by `self' back into the caller-provided
+ * buffer, unless it was the caller-provided buffer that was used by
+ * the interpreter. */
+#define re_interpreter_copy_match(self)                                       \
+	do {                                                                      \
+		if ((self)->ri_pmatch != (self)->ri_exec->rx_pmatch) {                \
+			/* Must copy over match information into user-provided buffer. */ \
+			memcpyc((self)->ri_exec->rx_pmatch,                               \
+			        (self)->ri_pmatch,                                        \
+			        (self)->ri_exec->rx_nmatch,                               \
+			        sizeof(re_regmatch_t));                                   \
+		}                                                                     \
+	}	__WHILE0
+
+
+INTDEF ATTR_PURE ATTR_RETNONNULL WUNUSED NONNULL((1)) byte_t * /* from "./regcomp.c" */
+NOTHROW_NCX(CC libre_opcode_next)(byte_t const *__restrict p_instr);
+
+/* Word-at-a-time helpers (s.a. `re_memcaseeq_folded()', `re_span_ascii()', `re_interpreter_skip_to_mlits()')
+ * These test all bytes of a `size_t' at once with plain integer arithmetic,
+ * which works the same on every target. The word-at-a-time helpers are portable
+ * C; the only arch-specific code path is the optional x86-64 JIT (s.a. "regjit.h") */
+#define RE_WORD_ONES             ((size_t)-1 / 0xff)    /* 0x0101...01 */
+#define RE_WORD_HIGHS            (RE_WORD_ONES << 7)    /* 0x8080...80 */
+#define RE_WORD_ZEROBYTES(x)     (((x) - RE_WORD_ONES) & ~(x) & RE_WORD_HIGHS)        /* Non-zero if a byte of `x' is 0 */
+#define RE_WORD_CNTRLBYTES(x)    (((x) - RE_WORD_ONES * 0x20) & ~(x) & RE_WORD_HIGHS) /* Non-zero if a byte of `x' is < 0x20 */
+#define RE_WORD_LOWERBYTES(x)                                      \
+	((((x) & ~RE_WORD_HIGHS) + RE_WORD_ONES * (0x80 - 'a')) &      \
+	 ~(((x) & ~RE_WORD_HIGHS) + RE_WORD_ONES * (0x80 - 'z' - 1)) & \
+	 ~(x) & RE_WORD_HIGHS) /* 0x80 in every byte of `x' that is in `[a-z]' */
+
+/* Return the offset (from `REOP_TRIE') of the child of the `RETRIE_BRANCH'
+ * node at `node' that follows after `ch' (or `0' if there is none) */
+INTDEF ATTR_PURE WUNUSED NONNULL((1)) uint16_t
+NOTHROW_NCX(CC re_trie_branch)(byte_t const *__restrict node, byte_t ch);
+
+/* Check if `ch' is matched by the `RECS_*' sequence at `pc' (the operand of `REOP_CS_BYTE') */
+INTDEF ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC CS_BYTE_contains)(__register byte_t const *__restrict pc, byte_t ch);
+
+/* Check if `ch' is matched by the operand `pc' of `REOP_CS_UTF8' */
+INTDEF ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC CS_UTF8_contains)(byte_t const *__restrict pc, char32_t ch);
+
+/* Check if `ch' is matched by the `REOP_[N]SEQ_UTF8'-operand at `pc' (ignoring the `N') */
+INTDEF ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC SEQ_UTF8_containschar)(byte_t const *__restrict pc, char32_t ch);
+
+/* Check if reg-match `a' is better than `b' */
+INTDEF ATTR_PURE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC is_regmatch_better)(re_regmatch_t const *__restrict a,
+                                   re_regmatch_t const *__restrict b,
+                                   uint16_t nregs);
+
+/* Skip input that can be proven to never be the start of a match, using either
+ * the literal prefix, the literal starts, or the fast-map of `self->ri_exec->rx_code'.
+ * @return: * : The # of bytes skipped (`>= max_skip' if no candidate exists) */
+INTDEF WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_interpreter_skip_candidates)(struct re_interpreter *__restrict self,
+                                               size_t max_skip);
+
+/* Check if the `REOP_AT_*' opcode `opcode' holds at the current position of `self' */
+INTDEF WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_interpreter_at)(struct re_interpreter *__restrict self, byte_t opcode);
+
+struct re_dfa;
+struct re_pike;
+
+/* Execute `self', using `*p_dfa' (if non-NULL), or `*p_pike' (if non-NULL)
+ * instead of `libre_interp_exec()'. If the DFA gives up, it is destroyed, and
+ * `*p_dfa' is set to `NULL' (with `RE_EXEC_LINEAR', the pike VM is used next,
+ * and if that gives up as well, `-RE_ENOSYS' is returned).
+ * If the on-fail stack of `libre_interp_exec()' becomes too large, try to
+ * create a DFA (and store it in `*p_dfa') to execute `self' with instead. */
+INTDEF WUNUSED NONNULL((1, 2, 3)) re_errno_t
+NOTHROW_NCX(CC re_interpreter_exec)(struct re_interpreter *__restrict self,
+                                    struct re_dfa **__restrict p_dfa,
+                                    struct re_pike **__restrict p_pike);
+
+/* Called by searches before their `RE_DFA_MINATTEMPTS'th match attempt:
+ * create a DFA (stored in `*p_dfa') for the remaining attempts, and use it
+ * to find the end of the first match that starts within the next
+ * `*p_search_range' bytes of `self', so later offsets needn't be tried.
+ * The input pointer of `self' is preserved.
+ * @return: true:  `*p_search_range' may have been reduced (or there is no DFA)
+ * @return: false: No match starts within `*p_search_range' */
+INTDEF WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_interpreter_search_usedfa)(struct re_interpreter *__restrict self,
+                                             struct re_dfa **__restrict p_dfa,
+                                             size_t *__restrict p_search_range);
+
+/* Advance `self' to the next offset where a match might start (as per `re_interpreter_skip_candidates()'),
+ * while also making sure that input at that offset contains the code's required literal (if there is one).
+ * @param: p_must_next: [in|out] Offset from which the  required literal has to be  searched
+ *                      for again (set to `*p_match_offset' before the first call). Because
+ *                      finding the literal can require a lot of input to be scanned,  this
+ *                      way it only needs to be done once for every occurrence.
+ * @return: true:  `self', `*p_search_range' and `*p_match_offset' were updated for the next candidate.
+ * @return: false: No offset within `*p_search_range' can ever produce a match. */
+INTDEF WUNUSED NONNULL((1, 2, 3, 4)) bool
+NOTHROW_NCX(CC re_interpreter_search_advance)(struct re_interpreter *__restrict self,
+                                              size_t *__restrict p_search_range,
+                                              size_t *__restrict p_match_offset,
+                                              size_t *__restrict p_must_next);
+
+/* Search for the left-most match that starts within the next `search_range'
+ * bytes from the current position of `self' (which must be set up for  this
+ * using `re_interpreter_init_match(..., true)'). `*p_dfa' and `*p_pike' are
+ * used for match attempts (if non-NULL), and may be created or destroyed.
+ * @return: >= 0:        The offset where the matched area starts
+ * @return: -RE_NOMATCH: Nothing was matched
+ * @return: -RE_ENOSYS:  The pike VM gave up (s.a. `RE_EXEC_LINEAR')
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large */
+INTDEF WUNUSED NONNULL((1, 3, 4)) ssize_t
+NOTHROW_NCX(CC re_interpreter_search)(struct re_interpreter *__restrict self, size_t search_range,
+                                      struct re_dfa **__restrict p_dfa, struct re_pike **__restrict p_pike,
+                                      size_t *p_match_size);
+
+/* Read the next utf-8 character and check if it is matched by the `REOP_[N]SEQ_UTF8'-operand
+ * at `pc' (ignoring the `N'). Characters that are  well-formed and fit into the current  chunk
+ * are matched as-is; anything else is decoded, and its shortest encoding is matched instead. */
+INTDEF WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_interpreter_readseq)(struct re_interpreter *__restrict self,
+                                       byte_t const *__restrict pc);
+
+/* Set the start- (`is_start') or end-offset of group `gid' to the current offset,
+ * pushing (or overriding an old) on-fail item to restore the old one, if needed.
+ * @return: false: Out of memory (nothing was changed) */
+INTDEF WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_interpreter_setgroup)(struct re_interpreter *__restrict self,
+                                        uint8_t gid, bool is_start);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGINTERP_H */
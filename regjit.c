@@ -0,0 +1,834 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGJIT_C
+#define GUARD_LIBREGEX_REGJIT_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <hybrid/align.h>
+#include <hybrid/unaligned.h>
+
+#include <kos/types.h>
+
+#include <assert.h>
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && !defined(LIBREGEX_REGEXEC_NO_JIT)
+#include <sys/mman.h>
+#endif /* __x86_64__ && !LIBREGEX_REGEXEC_NO_JIT */
+
+#include <libregex/regcomp.h>
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regdfa.h"
+#include "reginterp.h"
+#include "regjit.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+#ifdef HAVE_JIT
+
+/* Once a search has executed code often enough, opcodes that it spends most of its
+ * time on (those that consume input, jumps, on-fail stack operations and variables)
+ * are translated into x86_64 machine code, so that neither dispatching opcodes, nor
+ * decoding their operands costs anything anymore, and jumps become direct branches.
+ *
+ * Machine code works on the interpreter's own on-fail stack and group buffer, and
+ * gives control back to `libre_interp_exec()' whenever something has to be done
+ * that it doesn't do by itself: unwinding the on-fail stack after a failure,  any
+ * opcode that isn't translated (`REOP_MATCHED', back-references, ...), or growing
+ * the on-fail stack. The interpreter continues from there, and enters machine code
+ * again upon reaching the next opcode that has some. As such, the same on-fail items
+ * are pushed and popped in the same order, no matter which of the two executes code.
+ *
+ * Registers used by machine code:
+ * - %rbx: struct re_interpreter *self
+ * - %r12: self->ri_in_ptr   (written back before helper functions are called)
+ * - %r13: self->ri_in_cend  (machine code is only entered in the last chunk of input)
+ * - %r14: self->ri_in_vbase
+ * - %r15: self->ri_in_vbase + self->ri_exec->rx_startoff (base of `rof_in' offsets) */
+
+static_assert(sizeof(struct re_onfailure_item) == 8);
+static_assert(offsetof(struct re_onfailure_item, rof_in) == 0);
+static_assert(offsetof(struct re_onfailure_item, rof_pc) == 4);
+static_assert(offsetof(struct re_onfailure_item, rof_tag) == 6);
+
+/* x86 condition codes (as used by `jcc') */
+#define X86_CC_B   0x2 /* Below (unsigned) */
+#define X86_CC_AE  0x3 /* Above or equal (unsigned) */
+#define X86_CC_E   0x4 /* Equal */
+#define X86_CC_NE  0x5 /* Not equal */
+#define X86_CC_BE  0x6 /* Below or equal (unsigned) */
+#define X86_CC_A   0x7 /* Above (unsigned) */
+#define X86_CC_S   0x8 /* Sign */
+#define X86_CC_JMP 0xf /* Always (emits `jmp', rather than `jcc') */
+
+/* Machine code references whose target isn't known until all code has been generated */
+struct re_jitfix {
+	uint32_t rjf_pos;    /* Offset of a 32-bit displacement in `jg_text' (relative to its end) */
+	uint32_t rjf_target; /* PCOFF of an opcode (`RE_JITFIX_OPCODE'), or index of a table (`RE_JITFIX_TABLE') */
+	uint32_t rjf_kind;   /* Kind of fix (one of `RE_JITFIX_*') */
+#define RE_JITFIX_OPCODE 0 /* Jump to the machine code of an opcode */
+#define RE_JITFIX_TABLE  1 /* Address of a 256-byte table (appended to machine code) */
+};
+
+struct re_jitgen {
+	byte_t const     *jg_code;     /* [1..1][const] Code being translated (`rc_code') */
+	byte_t           *jg_text;     /* [0..jg_size][owned(free)] Machine code generated so far */
+	size_t            jg_size;     /* # of bytes in `jg_text' */
+	size_t            jg_alloc;    /* Allocated # of bytes in `jg_text' */
+	uint32_t         *jg_labels;   /* [1..1][owned(free)][codesize] Offsets into `jg_text' of the machine code of every opcode */
+	struct re_jitfix *jg_fixv;     /* [0..jg_fixc][owned(free)] References that still have to be resolved */
+	size_t            jg_fixc;     /* # of references in `jg_fixv' */
+	size_t            jg_fixa;     /* Allocated # of references in `jg_fixv' */
+	byte_t           *jg_tabv;     /* [0..jg_tabc*256][owned(free)] Tables (indexed by byte; non-zero if accepted) */
+	size_t            jg_tabc;     /* # of tables in `jg_tabv' */
+	uint32_t          jg_epilogue; /* Offset of machine code that returns `%eax' to `libre_interp_exec()' */
+	uint32_t          jg_fail;     /* Offset of machine code that returns failure to `libre_interp_exec()' */
+	bool              jg_nomem;    /* Set if memory ran out at some point */
+};
+
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_put)(struct re_jitgen *__restrict self,
+                              void const *data, size_t num_bytes) {
+	if unlikely(self->jg_size + num_bytes > self->jg_alloc) {
+		byte_t *newtext;
+		size_t newalloc = self->jg_alloc * 2;
+		if (newalloc < self->jg_size + num_bytes)
+			newalloc = self->jg_size + num_bytes;
+		newtext = (byte_t *)realloc(self->jg_text, newalloc);
+		if unlikely(!newtext) {
+			self->jg_nomem = true;
+			return;
+		}
+		self->jg_text  = newtext;
+		self->jg_alloc = newalloc;
+	}
+	memcpy(self->jg_text + self->jg_size, data, num_bytes);
+	self->jg_size += num_bytes;
+}
+
+#define re_jitgen_emit(self, ...)                              \
+	re_jitgen_put(self, (byte_t const[]){ __VA_ARGS__ }, \
+	              sizeof((byte_t const[]){ __VA_ARGS__ }))
+#define re_jitgen_emit32(self, value) \
+	do {                              \
+		uint32_t _v32 = (value);      \
+		re_jitgen_put(self, &_v32, 4); \
+	}	__WHILE0
+#define re_jitgen_emit64(self, value) \
+	do {                              \
+		uint64_t _v64 = (value);      \
+		re_jitgen_put(self, &_v64, 8); \
+	}	__WHILE0
+
+/* Emit a 32-bit displacement that is resolved once all code has been generated */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_emitfix)(struct re_jitgen *__restrict self,
+                                  uint32_t kind, uint32_t target) {
+	struct re_jitfix *fix;
+	if unlikely(self->jg_fixc >= self->jg_fixa) {
+		size_t newalloc = self->jg_fixa ? self->jg_fixa * 2 : 16;
+		fix = (struct re_jitfix *)reallocv(self->jg_fixv, newalloc, sizeof(struct re_jitfix));
+		if unlikely(!fix) {
+			self->jg_nomem = true;
+			return;
+		}
+		self->jg_fixv = fix;
+		self->jg_fixa = newalloc;
+	}
+	re_jitgen_emit32(self, 0);
+	fix = &self->jg_fixv[self->jg_fixc++];
+	fix->rjf_pos    = (uint32_t)self->jg_size;
+	fix->rjf_target = target;
+	fix->rjf_kind   = kind;
+}
+
+/* Emit `jcc' (or `jmp' for `X86_CC_JMP') to already generated machine code at `target' */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_jcc)(struct re_jitgen *__restrict self,
+                              uint8_t cc, uint32_t target) {
+	if (cc == X86_CC_JMP) {
+		re_jitgen_emit(self, 0xe9);
+	} else {
+		re_jitgen_emit(self, 0x0f, 0x80 | cc);
+	}
+	re_jitgen_emit32(self, target - (uint32_t)(self->jg_size + 4));
+}
+
+/* Emit `jcc' (or `jmp' for `X86_CC_JMP') to the machine code of the opcode at `pcoff' */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_jcc_opcode)(struct re_jitgen *__restrict self,
+                                     uint8_t cc, uint32_t pcoff) {
+	if (cc == X86_CC_JMP) {
+		re_jitgen_emit(self, 0xe9);
+	} else {
+		re_jitgen_emit(self, 0x0f, 0x80 | cc);
+	}
+	re_jitgen_emitfix(self, RE_JITFIX_OPCODE, pcoff);
+}
+
+/* Emit a short `jcc' whose target is set by `re_jitgen_jcc8_here()'
+ * @return: * : Token for `re_jitgen_jcc8_here()' */
+PRIVATE NONNULL((1)) size_t
+NOTHROW_NCX(CC re_jitgen_jcc8)(struct re_jitgen *__restrict self, uint8_t cc) {
+	re_jitgen_emit(self, cc == X86_CC_JMP ? 0xeb : 0x70 | cc, 0);
+	return self->jg_size;
+}
+
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_jcc8_here)(struct re_jitgen *__restrict self, size_t token) {
+	if likely(!self->jg_nomem) {
+		assert(self->jg_size - token <= 0x7f);
+		self->jg_text[token - 1] = (byte_t)(self->jg_size - token);
+	}
+}
+
+/* Emit a short `jcc' back to `target' */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_jcc8_back)(struct re_jitgen *__restrict self,
+                                    uint8_t cc, size_t target) {
+	assert(self->jg_size + 2 - target <= 0x80);
+	re_jitgen_emit(self, 0x70 | cc, (byte_t)(target - (self->jg_size + 2)));
+}
+
+/* Emit code to give control back to `libre_interp_exec()' at the opcode at `pcoff' */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_exit)(struct re_jitgen *__restrict self, uint32_t pcoff) {
+	re_jitgen_emit(self, 0xb8); /* mov $pcoff, %eax */
+	re_jitgen_emit32(self, pcoff);
+	re_jitgen_jcc(self, X86_CC_JMP, self->jg_epilogue);
+}
+
+/* Emit `lea table(%rip), %rdx', for a table that contains `accept(pc, ch)' for every byte `ch' */
+PRIVATE NONNULL((1, 2, 3)) void
+NOTHROW_NCX(CC re_jitgen_table)(struct re_jitgen *__restrict self, byte_t const *pc,
+                                bool (CC *accept)(byte_t const *__restrict pc, unsigned int ch),
+                                unsigned int count) {
+	byte_t table[256], *newtabv;
+	size_t i;
+	unsigned int ch;
+	bzero(table, sizeof(table));
+	for (ch = 0; ch < count; ++ch)
+		table[ch] = (*accept)(pc, ch) ? 1 : 0;
+	re_jitgen_emit(self, 0x48, 0x8d, 0x15); /* lea table(%rip), %rdx */
+	for (i = 0; i < self->jg_tabc; ++i) {
+		if (bcmp(self->jg_tabv + i * 256, table, 256) == 0) {
+			re_jitgen_emitfix(self, RE_JITFIX_TABLE, (uint32_t)i);
+			return;
+		}
+	}
+	newtabv = (byte_t *)realloc(self->jg_tabv, (self->jg_tabc + 1) * 256);
+	if unlikely(!newtabv) {
+		self->jg_nomem = true;
+		return;
+	}
+	self->jg_tabv = newtabv;
+	memcpy(newtabv + self->jg_tabc * 256, table, 256);
+	re_jitgen_emitfix(self, RE_JITFIX_TABLE, (uint32_t)self->jg_tabc);
+	++self->jg_tabc;
+}
+
+PRIVATE ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_jit_acceptbyte)(byte_t const *__restrict pc, unsigned int ch) {
+	return re_dfa_matchbyte(pc, (byte_t)ch);
+}
+
+PRIVATE ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_jit_acceptchar)(byte_t const *__restrict pc, unsigned int ch) {
+	return re_dfa_matchchar(pc, (char32_t)ch);
+}
+
+/* Emit `mov %r12, self->ri_in_ptr; mov %rbx, %rdi; mov $pc, %rsi; call func; mov self->ri_in_ptr, %r12; test %eax, %eax' */
+PRIVATE NONNULL((1, 2, 3)) void
+NOTHROW_NCX(CC re_jitgen_call)(struct re_jitgen *__restrict self,
+                               int (CC *func)(struct re_interpreter *__restrict, byte_t const *__restrict),
+                               byte_t const *pc) {
+	re_jitgen_emit(self, 0x4c, 0x89, 0xa3); /* mov %r12, ri_in_ptr(%rbx) */
+	re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_in_ptr));
+	re_jitgen_emit(self, 0x48, 0x89, 0xdf); /* mov %rbx, %rdi */
+	re_jitgen_emit(self, 0x48, 0xbe);       /* mov $pc, %rsi */
+	re_jitgen_emit64(self, (uint64_t)(uintptr_t)pc);
+	re_jitgen_emit(self, 0x48, 0xb8);       /* mov $func, %rax */
+	re_jitgen_emit64(self, (uint64_t)(uintptr_t)func);
+	re_jitgen_emit(self, 0xff, 0xd0);       /* call *%rax */
+	re_jitgen_emit(self, 0x4c, 0x8b, 0xa3); /* mov ri_in_ptr(%rbx), %r12 */
+	re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_in_ptr));
+	re_jitgen_emit(self, 0x85, 0xc0);       /* test %eax, %eax */
+}
+
+/* Functions called by machine code (with `self->ri_in_ptr' being up-to-date)
+ * @return: 0: The opcode at `pc' failed (`re_jit_setgroup()': out of memory)
+ * @return: 1: Continue with the next opcode
+ * @return: 2: Skip `REOP_GROUP_END_Joff()' bytes after the next opcode */
+PRIVATE WUNUSED NONNULL((1, 2)) int
+NOTHROW_NCX(CC re_jit_matchchar)(struct re_interpreter *__restrict self,
+                                 byte_t const *__restrict pc) {
+	char32_t ch;
+	if (re_interpreter_is_eoi(self))
+		return 0;
+	if (pc[0] == REOP_SEQ_UTF8 || pc[0] == REOP_NSEQ_UTF8)
+		return re_interpreter_readseq(self, pc + 1) == (pc[0] == REOP_SEQ_UTF8) ? 1 : 0;
+	ch = re_interpreter_readutf8(self);
+	return re_dfa_matchchar(pc, ch) ? 1 : 0;
+}
+
+PRIVATE WUNUSED NONNULL((1, 2)) int
+NOTHROW_NCX(CC re_jit_at)(struct re_interpreter *__restrict self,
+                          byte_t const *__restrict pc) {
+	return re_interpreter_at(self, pc[0]) ? 1 : 0;
+}
+
+PRIVATE WUNUSED NONNULL((1, 2)) int
+NOTHROW_NCX(CC re_jit_setgroup)(struct re_interpreter *__restrict self,
+                                byte_t const *__restrict pc) {
+	uint8_t gid = pc[1];
+	if unlikely(!re_interpreter_setgroup(self, gid, pc[0] == REOP_GROUP_START))
+		return 0;
+	if (pc[0] != REOP_GROUP_START && pc[0] != REOP_GROUP_END &&
+	    self->ri_pmatch[gid].rm_so >= self->ri_pmatch[gid].rm_eo)
+		return 2;
+	return 1;
+}
+
+/* Emit code to check that there's room for another on-fail item, returning to
+ * `libre_interp_exec()' at `pcoff' if there isn't (so it can grow the on-fail
+ * stack). Leaves `self->ri_onfailc' in `%rax' for `re_jitgen_pushfail()' */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_needfail)(struct re_jitgen *__restrict self, uint32_t pcoff) {
+	size_t token;
+	re_jitgen_emit(self, 0x48, 0x8b, 0x83); /* mov ri_onfailc(%rbx), %rax */
+	re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailc));
+	re_jitgen_emit(self, 0x48, 0x3b, 0x83); /* cmp ri_onfaila(%rbx), %rax */
+	re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfaila));
+	token = re_jitgen_jcc8(self, X86_CC_B);
+	re_jitgen_exit(self, pcoff);
+	re_jitgen_jcc8_here(self, token);
+}
+
+/* Emit code to push an on-fail item (must follow `re_jitgen_needfail()')
+ * @param: with_in: When true, `rof_in' is the current offset (else: 0) */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_jitgen_pushfail)(struct re_jitgen *__restrict self,
+                                   uint16_t tag, uint16_t pcoff, bool with_in) {
+	re_jitgen_emit(self, 0x48, 0x8b, 0x93); /* mov ri_onfailv(%rbx), %rdx */
+	re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailv));
+	re_jitgen_emit(self, 0x48, 0xb9);       /* mov $ITEM, %rcx */
+	re_jitgen_emit64(self, ((uint64_t)tag << 48) | ((uint64_t)pcoff << 32));
+	if (with_in) {
+		re_jitgen_emit(self, 0x4c, 0x89, 0xe6); /* mov %r12, %rsi */
+		re_jitgen_emit(self, 0x4c, 0x29, 0xfe); /* sub %r15, %rsi */
+		re_jitgen_emit(self, 0x89, 0xf6);       /* mov %esi, %esi */
+		re_jitgen_emit(self, 0x48, 0x09, 0xf1); /* or %rsi, %rcx */
+	}
+	re_jitgen_emit(self, 0x48, 0x89, 0x0c, 0xc2); /* mov %rcx, (%rdx,%rax,8) */
+	re_jitgen_emit(self, 0x48, 0xff, 0xc0);       /* inc %rax */
+	re_jitgen_emit(self, 0x48, 0x89, 0x83);       /* mov %rax, ri_onfailc(%rbx) */
+	re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailc));
+}
+
+/* Emit `cmp %r13, %r12; jae fail' (fail at end of input) */
+#define re_jitgen_needbyte(self)                      \
+	(re_jitgen_emit(self, 0x4d, 0x39, 0xec),          \
+	 re_jitgen_jcc(self, X86_CC_AE, (self)->jg_fail))
+
+/* Generate machine code for the opcode at `pc'
+ * @return: true:  Success
+ * @return: false: The opcode isn't translated (nothing was generated) */
+PRIVATE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_jitgen_opcode)(struct re_jitgen *__restrict self,
+                                 byte_t const *__restrict pc) {
+	byte_t const *next = libre_opcode_next(pc);
+	uint32_t pcoff     = (uint32_t)(pc - self->jg_code);
+	uint32_t nextoff   = (uint32_t)(next - self->jg_code);
+	switch (pc[0]) {
+
+	case REOP_EXACT:
+	case REOP_EXACT_ASCII_ICASE: {
+		byte_t i, count = pc[1];
+		byte_t const *str = pc + 2;
+		re_jitgen_emit(self, 0x4c, 0x89, 0xe8); /* mov %r13, %rax */
+		re_jitgen_emit(self, 0x4c, 0x29, 0xe0); /* sub %r12, %rax */
+		re_jitgen_emit(self, 0x48, 0x3d);       /* cmp $count, %rax */
+		re_jitgen_emit32(self, count);
+		re_jitgen_jcc(self, X86_CC_B, self->jg_fail);
+		for (i = 0; i < count;) {
+			/* Letters of `REOP_EXACT_ASCII_ICASE' are stored lower-case, so
+			 * input can be folded by OR-ing 0x20 into those bytes (only). */
+			if (pc[0] == REOP_EXACT_ASCII_ICASE && count - i >= 8) {
+				uint64_t word = UNALIGNED_GET64(str + i);
+				uint64_t mask = RE_WORD_LOWERBYTES(word) >> 2;
+				re_jitgen_emit(self, 0x49, 0x8b, 0x84, 0x24); /* mov i(%r12), %rax */
+				re_jitgen_emit32(self, i);
+				if (mask) {
+					re_jitgen_emit(self, 0x48, 0xba); /* mov $mask, %rdx */
+					re_jitgen_emit64(self, mask);
+					re_jitgen_emit(self, 0x48, 0x09, 0xd0); /* or %rdx, %rax */
+				}
+				re_jitgen_emit(self, 0x48, 0xba); /* mov $str, %rdx */
+				re_jitgen_emit64(self, word);
+				re_jitgen_emit(self, 0x48, 0x39, 0xd0); /* cmp %rdx, %rax */
+				i += 8;
+			} else if (pc[0] == REOP_EXACT_ASCII_ICASE && count - i >= 4) {
+				uint32_t word = UNALIGNED_GET32(str + i);
+				uint32_t mask = (uint32_t)(RE_WORD_LOWERBYTES((size_t)word) >> 2);
+				re_jitgen_emit(self, 0x41, 0x8b, 0x84, 0x24); /* mov i(%r12), %eax */
+				re_jitgen_emit32(self, i);
+				if (mask) {
+					re_jitgen_emit(self, 0x0d); /* or $mask, %eax */
+					re_jitgen_emit32(self, mask);
+				}
+				re_jitgen_emit(self, 0x3d); /* cmp $str, %eax */
+				re_jitgen_emit32(self, word);
+				i += 4;
+			} else if (pc[0] == REOP_EXACT_ASCII_ICASE &&
+			           str[i] >= 'a' && str[i] <= 'z') {
+				re_jitgen_emit(self, 0x41, 0x0f, 0xb6, 0x84, 0x24); /* movzbl i(%r12), %eax */
+				re_jitgen_emit32(self, i);
+				re_jitgen_emit(self, 0x0c, 0x20);   /* or $0x20, %al */
+				re_jitgen_emit(self, 0x3c, str[i]); /* cmp $ch, %al */
+				++i;
+			} else if (count - i >= 8) {
+				re_jitgen_emit(self, 0x48, 0xb8); /* mov $str, %rax */
+				re_jitgen_emit64(self, UNALIGNED_GET64(str + i));
+				re_jitgen_emit(self, 0x49, 0x39, 0x84, 0x24); /* cmp %rax, i(%r12) */
+				re_jitgen_emit32(self, i);
+				i += 8;
+			} else if (count - i >= 4) {
+				re_jitgen_emit(self, 0x41, 0x81, 0xbc, 0x24); /* cmpl $str, i(%r12) */
+				re_jitgen_emit32(self, i);
+				re_jitgen_emit32(self, UNALIGNED_GET32(str + i));
+				i += 4;
+			} else {
+				re_jitgen_emit(self, 0x41, 0x80, 0xbc, 0x24); /* cmpb $ch, i(%r12) */
+				re_jitgen_emit32(self, i);
+				re_jitgen_emit(self, str[i]);
+				++i;
+			}
+			re_jitgen_jcc(self, X86_CC_NE, self->jg_fail);
+		}
+		re_jitgen_emit(self, 0x49, 0x81, 0xc4); /* add $count, %r12 */
+		re_jitgen_emit32(self, count);
+		return true;
+	}
+
+	case REOP_BYTE:
+	case REOP_NBYTE:
+		re_jitgen_needbyte(self);
+		re_jitgen_emit(self, 0x41, 0x80, 0x3c, 0x24, pc[1]); /* cmpb $ch, (%r12) */
+		re_jitgen_jcc(self, pc[0] == REOP_BYTE ? X86_CC_NE : X86_CC_E, self->jg_fail);
+		re_jitgen_emit(self, 0x49, 0xff, 0xc4); /* inc %r12 */
+		return true;
+
+	case REOP_RANGE:
+	case REOP_NRANGE:
+		re_jitgen_needbyte(self);
+		re_jitgen_emit(self, 0x41, 0x0f, 0xb6, 0x04, 0x24);  /* movzbl (%r12), %eax */
+		re_jitgen_emit(self, 0x2c, pc[1]);                   /* sub $lo, %al */
+		re_jitgen_emit(self, 0x3c, (byte_t)(pc[2] - pc[1])); /* cmp $(hi - lo), %al */
+		re_jitgen_jcc(self, pc[0] == REOP_RANGE ? X86_CC_A : X86_CC_BE, self->jg_fail);
+		re_jitgen_emit(self, 0x49, 0xff, 0xc4); /* inc %r12 */
+		return true;
+
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	case REOP_AT_SOI:
+		re_jitgen_emit(self, 0x4d, 0x39, 0xf4); /* cmp %r14, %r12 */
+		re_jitgen_jcc(self, X86_CC_A, self->jg_fail);
+		return true;
+#endif /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+
+	case REOP_AT_EOI:
+		re_jitgen_emit(self, 0x4d, 0x39, 0xec); /* cmp %r13, %r12 */
+		re_jitgen_jcc(self, X86_CC_B, self->jg_fail);
+		return true;
+
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	case REOP_AT_SOI: /* Epsilon input may not be backed by any chunk (s.a. `re_interpreter_is_soi()') */
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	case REOP_AT_SOL:
+	case REOP_AT_SOL_UTF8:
+	case REOP_AT_EOL:
+	case REOP_AT_EOL_UTF8:
+	case REOP_AT_SOXL:
+	case REOP_AT_SOXL_UTF8:
+	case REOP_AT_EOXL:
+	case REOP_AT_EOXL_UTF8:
+	case REOP_AT_WOB:
+	case REOP_AT_WOB_UTF8:
+	case REOP_AT_WOB_NOT:
+	case REOP_AT_WOB_UTF8_NOT:
+	case REOP_AT_SOW:
+	case REOP_AT_SOW_UTF8:
+	case REOP_AT_EOW:
+	case REOP_AT_EOW_UTF8:
+	case REOP_AT_SOS_UTF8:
+		re_jitgen_call(self, &re_jit_at, pc);
+		re_jitgen_jcc(self, X86_CC_E, self->jg_fail);
+		return true;
+
+	case REOP_GROUP_START:
+	case REOP_GROUP_END:
+	case_REOP_GROUP_END_JMIN_to_JMAX: {
+		size_t token;
+		re_jitgen_call(self, &re_jit_setgroup, pc);
+		token = re_jitgen_jcc8(self, X86_CC_NE);
+		re_jitgen_exit(self, pcoff); /* Out of memory (let the interpreter deal with it) */
+		re_jitgen_jcc8_here(self, token);
+		if (pc[0] != REOP_GROUP_START && pc[0] != REOP_GROUP_END) {
+			re_jitgen_emit(self, 0x83, 0xf8, 0x02); /* cmp $2, %eax */
+			re_jitgen_jcc_opcode(self, X86_CC_E, nextoff + REOP_GROUP_END_Joff(pc[0]));
+		}
+		return true;
+	}
+
+	case REOP_POP_ONFAIL: {
+		size_t token_empty, token_done, loop;
+		re_jitgen_emit(self, 0x48, 0x8b, 0x83); /* mov ri_onfailc(%rbx), %rax */
+		re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailc));
+		re_jitgen_emit(self, 0x48, 0x85, 0xc0); /* test %rax, %rax */
+		token_empty = re_jitgen_jcc8(self, X86_CC_E);
+		re_jitgen_emit(self, 0x48, 0x8b, 0x93); /* mov ri_onfailv(%rbx), %rdx */
+		re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailv));
+		/* Keep popping until the stack becomes empty, or a non-group-restore element was removed */
+		loop = self->jg_size;
+		re_jitgen_emit(self, 0x48, 0xff, 0xc8); /* dec %rax */
+		token_done = re_jitgen_jcc8(self, X86_CC_E);
+		re_jitgen_emit(self, 0x0f, 0xb7, 0x4c, 0xc2, 0x06); /* movzwl 6(%rdx,%rax,8), %ecx */
+		re_jitgen_emit(self, 0x81, 0xf9);                   /* cmp $RE_ONFAILURE_ITEM_DUMMY, %ecx */
+		re_jitgen_emit32(self, RE_ONFAILURE_ITEM_DUMMY);
+		re_jitgen_jcc8_back(self, X86_CC_B, loop);
+		re_jitgen_emit(self, 0x81, 0xf9);                   /* cmp $RE_ONFAILURE_ITEM_MEMO, %ecx */
+		re_jitgen_emit32(self, RE_ONFAILURE_ITEM_MEMO);
+		re_jitgen_jcc8_back(self, X86_CC_E, loop);
+		re_jitgen_emit(self, 0x81, 0xf9);                   /* cmp $RE_ONFAILURE_ITEM_SPAN, %ecx */
+		re_jitgen_emit32(self, RE_ONFAILURE_ITEM_SPAN);
+		re_jitgen_jcc8_back(self, X86_CC_E, loop);
+		re_jitgen_jcc8_here(self, token_done);
+		re_jitgen_emit(self, 0x48, 0x89, 0x83); /* mov %rax, ri_onfailc(%rbx) */
+		re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailc));
+		re_jitgen_jcc8_here(self, token_empty);
+		return true;
+	}
+
+	case REOP_POP_ONFAIL_AT: {
+		size_t token_done, loop;
+		uint16_t target = (uint16_t)(nextoff + delta16_get(pc + 1));
+		re_jitgen_emit(self, 0x48, 0x8b, 0x83); /* mov ri_onfailc(%rbx), %rax */
+		re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailc));
+		re_jitgen_emit(self, 0x48, 0x8b, 0x93); /* mov ri_onfailv(%rbx), %rdx */
+		re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailv));
+		loop = self->jg_size;
+		re_jitgen_emit(self, 0x48, 0x85, 0xc0); /* test %rax, %rax */
+		token_done = re_jitgen_jcc8(self, X86_CC_E);
+		re_jitgen_emit(self, 0x48, 0xff, 0xc8); /* dec %rax */
+		re_jitgen_emit(self, 0x66, 0x81, 0x7c, 0xc2, 0x04, /* cmpw $target, 4(%rdx,%rax,8) */
+		               (byte_t)target, (byte_t)(target >> 8));
+		re_jitgen_jcc8_back(self, X86_CC_NE, loop);
+		re_jitgen_emit(self, 0x66, 0x81, 0x7c, 0xc2, 0x06, /* cmpw $RE_ONFAILURE_ITEM_DUMMY_AT, 6(%rdx,%rax,8) */
+		               (byte_t)RE_ONFAILURE_ITEM_DUMMY_AT, (byte_t)(RE_ONFAILURE_ITEM_DUMMY_AT >> 8));
+		re_jitgen_jcc8_back(self, X86_CC_B, loop);
+		re_jitgen_jcc8_here(self, token_done);
+		re_jitgen_emit(self, 0x48, 0x89, 0x83); /* mov %rax, ri_onfailc(%rbx) */
+		re_jitgen_emit32(self, offsetof(struct re_interpreter, ri_onfailc));
+		return true;
+	}
+
+	case REOP_JMP_ONFAIL:
+		re_jitgen_needfail(self, pcoff);
+		re_jitgen_pushfail(self, RE_ONFAILURE_ITEM_RESUME, (uint16_t)(nextoff + delta16_get(pc + 1)), true);
+		return true;
+
+	case REOP_JMP_ONFAIL_DUMMY_AT:
+		re_jitgen_needfail(self, pcoff);
+		re_jitgen_pushfail(self, RE_ONFAILURE_ITEM_DUMMY_AT, (uint16_t)(nextoff + delta16_get(pc + 1)), false);
+		return true;
+
+	case REOP_JMP_ONFAIL_DUMMY:
+		re_jitgen_needfail(self, pcoff);
+		re_jitgen_pushfail(self, RE_ONFAILURE_ITEM_DUMMY, 0, false);
+		return true;
+
+	case REOP_JMP:
+		re_jitgen_jcc_opcode(self, X86_CC_JMP, nextoff + delta16_get(pc + 1));
+		return true;
+
+	case REOP_JMP_AND_RETURN_ONFAIL:
+		re_jitgen_needfail(self, pcoff);
+		re_jitgen_pushfail(self, RE_ONFAILURE_ITEM_RESUME, (uint16_t)nextoff, true);
+		re_jitgen_jcc_opcode(self, X86_CC_JMP, nextoff + delta16_get(pc + 1));
+		return true;
+
+	case REOP_DEC_JMP:
+	case REOP_DEC_JMP_AND_RETURN_ONFAIL: {
+		uint32_t varoff = (uint32_t)offsetof(struct re_interpreter, ri_vars) + pc[1];
+		re_jitgen_emit(self, 0x80, 0xbb); /* cmpb $0, VAR(%rbx) */
+		re_jitgen_emit32(self, varoff);
+		re_jitgen_emit(self, 0x00);
+		re_jitgen_jcc_opcode(self, X86_CC_E, nextoff);
+		if (pc[0] == REOP_DEC_JMP_AND_RETURN_ONFAIL)
+			re_jitgen_needfail(self, pcoff);
+		re_jitgen_emit(self, 0xfe, 0x8b); /* decb VAR(%rbx) */
+		re_jitgen_emit32(self, varoff);
+		if (pc[0] == REOP_DEC_JMP_AND_RETURN_ONFAIL)
+			re_jitgen_pushfail(self, RE_ONFAILURE_ITEM_RESUME, (uint16_t)nextoff, true);
+		re_jitgen_jcc_opcode(self, X86_CC_JMP, nextoff + delta16_get(pc + 2));
+		return true;
+	}
+
+	case REOP_SETVAR:
+		re_jitgen_emit(self, 0xc6, 0x83); /* movb $value, VAR(%rbx) */
+		re_jitgen_emit32(self, (uint32_t)offsetof(struct re_interpreter, ri_vars) + pc[1]);
+		re_jitgen_emit(self, pc[2]);
+		return true;
+
+	case REOP_NOP:
+		return true;
+
+	default:
+		break;
+	}
+
+	switch (re_dfa_opkind(pc[0])) {
+
+	case RE_DFA_OP_BYTE:
+		re_jitgen_needbyte(self);
+#ifdef REOP_ANY
+		if (pc[0] != REOP_ANY)
+#endif /* REOP_ANY */
+		{
+			re_jitgen_emit(self, 0x41, 0x0f, 0xb6, 0x04, 0x24); /* movzbl (%r12), %eax */
+			re_jitgen_table(self, pc, &re_jit_acceptbyte, 256);
+			re_jitgen_emit(self, 0x80, 0x3c, 0x02, 0x00); /* cmpb $0, (%rdx,%rax) */
+			re_jitgen_jcc(self, X86_CC_E, self->jg_fail);
+		}
+		re_jitgen_emit(self, 0x49, 0xff, 0xc4); /* inc %r12 */
+		return true;
+
+	case RE_DFA_OP_UTF8: {
+		/* ASCII is looked up in a table, and anything else is left to `re_jit_matchchar()' */
+		size_t token_utf8, token_done;
+		re_jitgen_needbyte(self);
+		re_jitgen_emit(self, 0x41, 0x0f, 0xb6, 0x04, 0x24); /* movzbl (%r12), %eax */
+		re_jitgen_emit(self, 0x84, 0xc0);                   /* test %al, %al */
+		token_utf8 = re_jitgen_jcc8(self, X86_CC_S);
+		re_jitgen_table(self, pc, &re_jit_acceptchar, 0x80);
+		re_jitgen_emit(self, 0x80, 0x3c, 0x02, 0x00); /* cmpb $0, (%rdx,%rax) */
+		re_jitgen_jcc(self, X86_CC_E, self->jg_fail);
+		re_jitgen_emit(self, 0x49, 0xff, 0xc4); /* inc %r12 */
+		token_done = re_jitgen_jcc8(self, X86_CC_JMP);
+		re_jitgen_jcc8_here(self, token_utf8);
+		re_jitgen_call(self, &re_jit_matchchar, pc);
+		re_jitgen_jcc(self, X86_CC_E, self->jg_fail);
+		re_jitgen_jcc8_here(self, token_done);
+		return true;
+	}
+
+	default:
+		break;
+	}
+	return false;
+}
+
+/* Return the # of bytes in `code->rc_code...REOP_MATCHED' */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_jit_codesize)(struct re_code const *__restrict code) {
+	byte_t const *pc;
+	for (pc = code->rc_code; *pc != REOP_MATCHED && *pc != REOP_MATCHED_PERFECT;)
+		pc = libre_opcode_next(pc);
+	return (size_t)(pc - code->rc_code) + 1;
+}
+
+/* Translate `code' into machine code
+ * @return: * :   The machine code (to be destroyed using `re_jit_destroy()')
+ * @return: NULL: Out of memory, or nothing that's worth it could be translated */
+INTERN WUNUSED NONNULL((1)) struct re_jit *
+NOTHROW_NCX(CC re_jit_new)(struct re_code const *__restrict code) {
+	struct re_jitgen gen;
+	struct re_jit *result;
+	byte_t const *pc;
+	size_t i, codesize, tabbase, textsize;
+	bool translated = false;
+	codesize = re_jit_codesize(code);
+	result   = (struct re_jit *)malloc(offsetof(struct re_jit, rj_entries) +
+	                                   codesize * (sizeof(uint32_t) + sizeof(byte_t)));
+	if unlikely(!result)
+		goto err;
+	result->rj_code     = code->rc_code;
+	result->rj_codecopy = (byte_t *)(result->rj_entries + codesize);
+	result->rj_codesize = codesize;
+	memcpy(result->rj_codecopy, code->rc_code, codesize);
+	bzero(&gen, sizeof(gen));
+	gen.jg_code   = code->rc_code;
+	gen.jg_labels = (uint32_t *)malloc(codesize * sizeof(uint32_t));
+	if unlikely(!gen.jg_labels)
+		goto err_r;
+
+	/* Entry: save registers, then jump to `entry' */
+	re_jitgen_emit(&gen, 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57); /* push %rbx, %r12, %r13, %r14, %r15 */
+	re_jitgen_emit(&gen, 0x48, 0x89, 0xfb);                                     /* mov %rdi, %rbx */
+	re_jitgen_emit(&gen, 0x4c, 0x8b, 0xa3);                                     /* mov ri_in_ptr(%rbx), %r12 */
+	re_jitgen_emit32(&gen, offsetof(struct re_interpreter, ri_in_ptr));
+	re_jitgen_emit(&gen, 0x4c, 0x8b, 0xab);                                     /* mov ri_in_cend(%rbx), %r13 */
+	re_jitgen_emit32(&gen, offsetof(struct re_interpreter, ri_in_cend));
+	re_jitgen_emit(&gen, 0x4c, 0x8b, 0xb3);                                     /* mov ri_in_vbase(%rbx), %r14 */
+	re_jitgen_emit32(&gen, offsetof(struct re_interpreter, ri_in_vbase));
+	re_jitgen_emit(&gen, 0x4c, 0x8b, 0xbb);                                     /* mov ri_exec(%rbx), %r15 */
+	re_jitgen_emit32(&gen, offsetof(struct re_interpreter, ri_exec));
+	re_jitgen_emit(&gen, 0x4d, 0x8b, 0xbf);                                     /* mov rx_startoff(%r15), %r15 */
+	re_jitgen_emit32(&gen, offsetof(struct re_exec, rx_startoff));
+	re_jitgen_emit(&gen, 0x4d, 0x01, 0xf7);                                     /* add %r14, %r15 */
+	re_jitgen_emit(&gen, 0xff, 0xe6);                                           /* jmp *%rsi */
+
+	/* Return `%eax' to `libre_interp_exec()' */
+	gen.jg_epilogue = (uint32_t)gen.jg_size;
+	re_jitgen_emit(&gen, 0x4c, 0x89, 0xa3); /* mov %r12, ri_in_ptr(%rbx) */
+	re_jitgen_emit32(&gen, offsetof(struct re_interpreter, ri_in_ptr));
+	re_jitgen_emit(&gen, 0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5b, 0xc3); /* pop ...; ret */
+	gen.jg_fail = (uint32_t)gen.jg_size;
+	re_jitgen_emit(&gen, 0xb8, 0xff, 0xff, 0xff, 0xff); /* mov $-1, %eax */
+	re_jitgen_jcc(&gen, X86_CC_JMP, gen.jg_epilogue);
+
+	/* Translate opcodes (in order, so each one falls through to the next) */
+	bzero(result->rj_entries, codesize * sizeof(uint32_t));
+	for (pc = code->rc_code;; pc = libre_opcode_next(pc)) {
+		size_t pcoff = (size_t)(pc - code->rc_code);
+		gen.jg_labels[pcoff] = (uint32_t)gen.jg_size;
+		if (re_jitgen_opcode(&gen, pc)) {
+			result->rj_entries[pcoff] = gen.jg_labels[pcoff];
+			translated = true;
+		} else {
+			re_jitgen_exit(&gen, (uint32_t)pcoff);
+		}
+		if (pcoff == codesize - 1)
+			break;
+	}
+	if (!translated || gen.jg_nomem)
+		goto err_r_gen;
+
+	/* Append tables, and resolve references */
+	tabbase  = CEIL_ALIGN(gen.jg_size, 64);
+	textsize = tabbase + gen.jg_tabc * 256;
+	if (gen.jg_alloc < textsize) {
+		byte_t *newtext = (byte_t *)realloc(gen.jg_text, textsize);
+		if unlikely(!newtext)
+			goto err_r_gen;
+		gen.jg_text = newtext;
+	}
+	memset(gen.jg_text + gen.jg_size, 0xcc, tabbase - gen.jg_size); /* int3 */
+	memcpy(gen.jg_text + tabbase, gen.jg_tabv, gen.jg_tabc * 256);
+	for (i = 0; i < gen.jg_fixc; ++i) {
+		struct re_jitfix *fix = &gen.jg_fixv[i];
+		uint32_t target;
+		if (fix->rjf_kind == RE_JITFIX_OPCODE) {
+			target = gen.jg_labels[fix->rjf_target];
+		} else {
+			target = (uint32_t)(tabbase + fix->rjf_target * 256);
+		}
+		UNALIGNED_SET32(gen.jg_text + fix->rjf_pos - 4, target - fix->rjf_pos);
+	}
+
+	/* Copy into executable memory */
+	result->rj_textsize = textsize;
+	result->rj_text     = (byte_t *)mmap(NULL, textsize, PROT_READ | PROT_WRITE,
+	                                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if unlikely(result->rj_text == (byte_t *)MAP_FAILED)
+		goto err_r_gen;
+	memcpy(result->rj_text, gen.jg_text, textsize);
+	if unlikely(mprotect(result->rj_text, textsize, PROT_READ | PROT_EXEC) != 0) {
+		(void)munmap(result->rj_text, textsize);
+		goto err_r_gen;
+	}
+	free(gen.jg_tabv);
+	free(gen.jg_fixv);
+	free(gen.jg_labels);
+	free(gen.jg_text);
+	return result;
+err_r_gen:
+	free(gen.jg_tabv);
+	free(gen.jg_fixv);
+	free(gen.jg_labels);
+	free(gen.jg_text);
+err_r:
+	free(result);
+err:
+	return NULL;
+}
+
+/* Destroy machine code created by `re_jit_new()' */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC re_jit_destroy)(struct re_jit *__restrict self) {
+	(void)munmap(self->rj_text, self->rj_textsize);
+	free(self);
+}
+
+/* Check if `self' can execute `code'. Code of a pattern that was freed can be re-used
+ * for a different one, so the opcodes are compared as well (after their lengths, such
+ * that `code' is never read past its `REOP_MATCHED').
+ * @return: true:  `self' was created for `code'
+ * @return: false: `self' is for some other pattern */
+INTERN ATTR_PURE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_jit_iscode)(struct re_jit const *__restrict self,
+                              struct re_code const *__restrict code) {
+	if (self->rj_code != code->rc_code)
+		return false;
+	if (re_jit_codesize(code) != self->rj_codesize)
+		return false;
+	return memcmp(code->rc_code, self->rj_codecopy, self->rj_codesize) == 0;
+}
+
+#undef re_jitgen_needbyte
+#undef re_jitgen_emit64
+#undef re_jitgen_emit32
+#undef re_jitgen_emit
+#endif /* HAVE_JIT */
+
+#undef HAVE_TRACE
+#undef TRACE
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGJIT_C */
@@ -0,0 +1,79 @@
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGJIT_H
+#define GUARD_LIBREGEX_REGJIT_H 1
+
+#include "api.h"
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <stdbool.h>
+
+#include <libregex/regcomp.h>
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "reginterp.h"
+
+DECL_BEGIN
+
+#ifdef HAVE_JIT
+/* Machine code for some `struct re_code' (s.a. `re_jit_new()')
+ * @param: entry: `rj_text + rj_entries[PCOFF]', where execution starts
+ * @return: >= 0: The PCOFF of the next opcode to execute by `libre_interp_exec()'
+ * @return: < 0:  Failure (unwind the on-fail stack) */
+typedef int32_t (*re_jit_text_t)(struct re_interpreter *__restrict self, byte_t const *entry);
+struct re_jit {
+	byte_t        *rj_text;     /* [1..rj_textsize][owned(munmap)] Executable machine code */
+	size_t         rj_textsize; /* Size of `rj_text' (in bytes) */
+	byte_t const  *rj_code;     /* [1..1][const] `rc_code' of the pattern (machine code refers to its opcodes by address) */
+	byte_t        *rj_codecopy; /* [1..rj_codesize][const] Copy of `rj_code' (points after `rj_entries') */
+	size_t         rj_codesize; /* # of bytes in `rc_code...REOP_MATCHED' */
+	COMPILER_FLEXIBLE_ARRAY(uint32_t, rj_entries); /* [rj_codesize] Offsets into `rj_text' where the machine code of
+	                                                * every opcode starts (0: the opcode is only executed by the interpreter) */
+};
+#define re_jit_run(self, interp, entry) \
+	(*(re_jit_text_t)(self)->rj_text)(interp, (self)->rj_text + (entry))
+
+/* Translate `code' into machine code
+ * @return: * :   The machine code (to be destroyed using `re_jit_destroy()')
+ * @return: NULL: Out of memory, or nothing that's worth it could be translated */
+INTDEF WUNUSED NONNULL((1)) struct re_jit *
+NOTHROW_NCX(CC re_jit_new)(struct re_code const *__restrict code);
+
+/* Destroy machine code created by `re_jit_new()' */
+INTDEF NONNULL((1)) void
+NOTHROW_NCX(CC re_jit_destroy)(struct re_jit *__restrict self);
+
+/* Check if `self' can execute `code'. Code of a pattern that was freed can be re-used
+ * for a different one, so the opcodes are compared as well (after their lengths, such
+ * that `code' is never read past its `REOP_MATCHED').
+ * @return: true:  `self' was created for `code'
+ * @return: false: `self' is for some other pattern */
+INTDEF ATTR_PURE WUNUSED NONNULL((1, 2)) bool
+NOTHROW_NCX(CC re_jit_iscode)(struct re_jit const *__restrict self,
+                              struct re_code const *__restrict code);
+#endif /* HAVE_JIT */
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGJIT_H */
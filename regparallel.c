@@ -0,0 +1,299 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGPARALLEL_C
+#define GUARD_LIBREGEX_REGPARALLEL_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <hybrid/__atomic.h>
+
+#include <kos/types.h>
+
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef LIBREGEX_REGEXEC_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif /* LIBREGEX_REGEXEC_THREADS */
+
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regdfa.h"
+#include "regexec.h"
+#include "reginterp.h"
+#include "regpike.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+/* Min # of starting offsets that every thread of a parallel search has to
+ * get (for less than this, creating the thread costs more than it saves) */
+#ifndef RE_PARALLEL_MINRANGE
+#define RE_PARALLEL_MINRANGE 0x40000
+#endif /* !RE_PARALLEL_MINRANGE */
+
+/* Threads are only used when libregex is built with `-DLIBREGEX_REGEXEC_THREADS'
+ * (which also means having to link against pthread). Without it, a parallel
+ * search is just a regular search. */
+#ifdef LIBREGEX_REGEXEC_THREADS
+struct re_parallel;
+
+/* One part of the range of starting offsets of a parallel search */
+struct re_parallel_part {
+	struct re_exec      rpp_exec;    /* [const] Copy of the caller's exec command block (with its own group buffer, and without `RE_EXEC_CTX') */
+	struct re_parallel *rpp_search;  /* [1..1][const] The search that this part belongs to */
+	size_t              rpp_index;   /* [const] Index of this part (parts with lower indices have lower offsets) */
+	size_t              rpp_offset;  /* [const] First starting offset of this part */
+	size_t              rpp_range;   /* [const] # of starting offsets of this part */
+	size_t              rpp_size;    /* [valid_if(rpp_result >= 0)] # of bytes that were matched */
+	ssize_t             rpp_result;  /* Result of searching this part (as would be returned by `libre_exec_search()') */
+	pthread_t           rpp_thread;  /* [valid_if(rpp_started)] Thread that searches this part */
+	bool                rpp_started; /* True if `rpp_thread' was started (else, the calling thread searches this part) */
+};
+
+struct re_parallel {
+	size_t                                           rp_first; /* [lock(ATOMIC)] Lowest index of a part that found a match (or an error) */
+	COMPILER_FLEXIBLE_ARRAY(struct re_parallel_part, rp_partv); /* [*] Parts of the search (followed by their group buffers) */
+};
+
+/* Lower `self->rp_first' to `index' (unless a part before that one already got there) */
+PRIVATE NONNULL((1)) void
+NOTHROW(CC re_parallel_setfirst)(struct re_parallel *__restrict self, size_t index) {
+	size_t oldval;
+	do {
+		oldval = __hybrid_atomic_load(&self->rp_first, __ATOMIC_ACQUIRE);
+		if (oldval <= index)
+			break;
+	} while (!__hybrid_atomic_cmpxch_weak(&self->rp_first, oldval, index,
+	                                      __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+}
+
+/* Search the starting offsets of `self' (same search-loop as `libre_exec_search()') */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_parallel_part_search)(struct re_parallel_part *__restrict self) {
+	ssize_t result;
+	re_errno_t error;
+	struct re_exec const *exec = &self->rpp_exec;
+	struct re_interpreter *interp;
+	struct re_interpreter_inptr used_inptr;
+	struct re_dfa *dfa;
+	struct re_pike *pike;
+	size_t match_offset, must_next, search_range, attempts;
+	interp = re_interpreter_alloc(exec->rx_code->rc_nvars);
+	error  = re_interpreter_init(interp, exec);
+	if unlikely(error != 0) {
+		result = -error;
+		goto done;
+	}
+	re_interpreter_init_match(interp, exec, true);
+
+	/* Whether or not something matches can also depend on input before the
+	 * part (e.g. "\b"), so the interpreter is set up for all of the input,
+	 * and only then moved ahead to where this part begins. */
+	re_interpreter_advance(interp, self->rpp_offset - exec->rx_startoff);
+	dfa          = NULL;
+	pike         = NULL;
+	attempts     = 0;
+	search_range = self->rpp_range;
+	match_offset = self->rpp_offset;
+	must_next    = match_offset;
+	used_inptr   = interp->ri_in;
+	for (;;) {
+		/* Once a part before this one has a result, that result wins */
+		if (__hybrid_atomic_load(&self->rpp_search->rp_first, __ATOMIC_ACQUIRE) < self->rpp_index) {
+			result = -RE_NOMATCH;
+			break;
+		}
+		if (!re_interpreter_search_advance(interp, &search_range, &match_offset, &must_next)) {
+			result = -RE_NOMATCH;
+			break;
+		}
+		if (++attempts == RE_DFA_MINATTEMPTS && dfa == NULL) {
+			if (!re_interpreter_search_usedfa(interp, &dfa, &search_range)) {
+				result = -RE_NOMATCH;
+				break;
+			}
+		}
+		used_inptr = interp->ri_in;
+		result = re_interpreter_exec(interp, &dfa, &pike);
+		if (result != -RE_NOMATCH) {
+			if likely(result == -RE_NOERROR) {
+				self->rpp_size = re_interpreter_in_curoffset(interp) - match_offset;
+				result = (ssize_t)match_offset;
+				re_interpreter_copy_match(interp);
+			}
+			break;
+		}
+		--search_range;
+		if (search_range == 0)
+			break;
+		++match_offset;
+		re_interpreter_inptr_in_advance1(&used_inptr);
+		interp->ri_in = used_inptr;
+	}
+	re_pike_destroy(pike);
+	re_dfa_destroy(dfa);
+	re_interpreter_fini(interp);
+done:
+	self->rpp_result = result;
+	if (result != -RE_NOMATCH)
+		re_parallel_setfirst(self->rpp_search, self->rpp_index);
+}
+
+PRIVATE void *
+NOTHROW_NCX(re_parallel_part_main)(void *arg) {
+	re_parallel_part_search((struct re_parallel_part *)arg);
+	return NULL;
+}
+#endif /* LIBREGEX_REGEXEC_THREADS */
+
+/* Same as `re_exec_search(3R)', but split the range of starting offsets
+ * between up to `nthreads' threads (`0': one per online CPU) */
+INTERN WUNUSED NONNULL((1)) ssize_t
+NOTHROW_NCX(CC libre_exec_search_parallel)(struct re_exec const *__restrict exec,
+                                           size_t search_range, size_t *p_match_size,
+                                           unsigned int nthreads) {
+#ifdef LIBREGEX_REGEXEC_THREADS
+	ssize_t result;
+	struct re_parallel *search;
+	struct re_parallel_part *part;
+	re_regmatch_t *groups;
+	size_t i, partc, nmatch, offset, total_left;
+	if (exec->rx_eflags & RE_EXEC_LINEAR)
+		goto serial; /* Already a single pass of the pike VM over all offsets */
+	if (OVERFLOW_USUB(exec->rx_endoff, exec->rx_startoff, &total_left))
+		total_left = 0;
+	if (OVERFLOW_USUB(total_left, exec->rx_code->rc_minmatch, &total_left))
+		return -RE_NOMATCH; /* Buffer is to small to ever match */
+	if (search_range > total_left + 1)
+		search_range = total_left + 1;
+	if (nthreads == 0) {
+		long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads   = ncpus > 0 ? (unsigned int)ncpus : 1;
+	}
+	partc = search_range / RE_PARALLEL_MINRANGE;
+	if (partc > nthreads)
+		partc = nthreads;
+	if (partc <= 1)
+		goto serial;
+	nmatch = exec->rx_nmatch;
+	if (nmatch > exec->rx_code->rc_ngrps)
+		nmatch = exec->rx_code->rc_ngrps;
+	search = (struct re_parallel *)malloc(offsetof(struct re_parallel, rp_partv) +
+	                                      partc * (sizeof(struct re_parallel_part) +
+	                                               nmatch * sizeof(re_regmatch_t)));
+	if unlikely(!search)
+		goto serial;
+	search->rp_first = partc;
+	groups = (re_regmatch_t *)&search->rp_partv[partc];
+	offset = exec->rx_startoff;
+	for (i = 0; i < partc; ++i) {
+		part = &search->rp_partv[i];
+		memcpy(&part->rpp_exec, exec, sizeof(struct re_exec));
+		part->rpp_exec.rx_eflags &= ~RE_EXEC_CTX; /* Its buffers can only be used by one thread */
+		part->rpp_exec.rx_pmatch = groups;
+		part->rpp_search  = search;
+		part->rpp_index   = i;
+		part->rpp_offset  = offset;
+		part->rpp_range   = search_range / partc;
+		part->rpp_started = false;
+		if (i == partc - 1)
+			part->rpp_range = search_range - (offset - exec->rx_startoff);
+		groups += nmatch;
+		offset += part->rpp_range;
+	}
+
+	/* The calling thread searches the first part itself (and those of threads that couldn't be created) */
+	for (i = 1; i < partc; ++i) {
+		part = &search->rp_partv[i];
+		part->rpp_started = pthread_create(&part->rpp_thread, NULL,
+		                                   &re_parallel_part_main, part) == 0;
+	}
+	re_parallel_part_search(&search->rp_partv[0]);
+	for (i = 1; i < partc; ++i) {
+		part = &search->rp_partv[i];
+		if (!part->rpp_started)
+			re_parallel_part_search(part);
+	}
+	for (i = 1; i < partc; ++i) {
+		part = &search->rp_partv[i];
+		if (part->rpp_started)
+			pthread_join(part->rpp_thread, NULL);
+	}
+
+	/* Parts that didn't find anything either had nothing, or stopped because of
+	 * a result in an earlier part -> the first part with a result is leftmost. */
+	result = -RE_NOMATCH;
+	for (i = 0; i < partc; ++i) {
+		part = &search->rp_partv[i];
+		if (part->rpp_result == -RE_NOMATCH)
+			continue;
+		result = part->rpp_result;
+		if (result >= 0) {
+			if (p_match_size != NULL)
+				*p_match_size = part->rpp_size;
+			memcpyc(exec->rx_pmatch, part->rpp_exec.rx_pmatch,
+			        nmatch, sizeof(re_regmatch_t));
+		}
+		break;
+	}
+	free(search);
+	return result;
+serial:
+#else /* LIBREGEX_REGEXEC_THREADS */
+	(void)nthreads;
+#endif /* !LIBREGEX_REGEXEC_THREADS */
+	return libre_exec_search(exec, search_range, p_match_size);
+}
+
+#undef HAVE_TRACE
+#undef TRACE
+
+DEFINE_PUBLIC_ALIAS(re_exec_search_parallel, libre_exec_search_parallel);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGPARALLEL_C */
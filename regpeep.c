@@ -93,6 +93,7 @@ struct re_mini_interpreter {
 	byte_t const                    *rmi_endpc;      /* [1..1] Hard program end pointer */
 	byte_t const                    *rmi_exact_data; /* [?..1] Data pointer for EXACT-like opcodes */
 	uint8_t                          rmi_exact_nrem; /* # of remaining elements in `rmi_exact_data' */
+	bool                             rmi_skipped_at; /* Set once a `REOP_AT_*' opcode (other than `REOP_AT_EOI') was skipped */
 	COMPILER_FLEXIBLE_ARRAY(uint8_t, rmi_vars); /* Values for code variables. */
 };
 
@@ -101,7 +102,7 @@ struct re_mini_interpreter {
 #define re_mini_interpreter_alloc(nvars) \
 	((struct re_mini_interpreter *)alloca(_re_mini_interpreter_sizeof(nvars)))
 #define re_mini_interpreter_init(self, pc, endpc) \
-	(void)((self)->rmi_pc = (pc), (self)->rmi_endpc = (endpc), (self)->rmi_exact_nrem = 0)
+	(void)((self)->rmi_pc = (pc), (self)->rmi_endpc = (endpc), (self)->rmi_exact_nrem = 0, (self)->rmi_skipped_at = false)
 
 /* Check if the interpreter is part-way into an EXACT-like opcode */
 #define re_mini_interpreter_inpartialexact(self) \
@@ -125,6 +126,7 @@ NOTHROW_NCX(CC re_mini_interpreter_exact_readutf8)(struct re_mini_interpreter *_
  * @return: * :              The currently loaded opcode
  * @return: REOP_MATCHED:    End-of-instruction-stream (or `rmi_endpc' reached)
  * @return: REOP_JMP_ONFAIL: At a bi-branch opcode (`delta16_get(self->rmi_pc)' is the relevant delta)
+ * @return: REOP_JMP_AND_RETURN_ONFAIL: At the tail of a loop
  */
 PRIVATE NONNULL((1)) byte_t
 NOTHROW_NCX(CC re_mini_interpreter_getopcode)(struct re_mini_interpreter *__restrict self) {
@@ -171,6 +173,8 @@ again:
 		 * There are some cases where they could say so (e.g. when both branches specify
 		 * AT-instructions that mutually exclusive), but  that's too complicated for  us
 		 * to really care. */
+		if (opcode != REOP_AT_EOI)
+			self->rmi_skipped_at = true;
 		goto again;
 
 	case REOP_POP_ONFAIL:
@@ -192,7 +196,8 @@ again:
 	}
 
 	case REOP_JMP_AND_RETURN_ONFAIL:
-		opcode = REOP_JMP_ONFAIL;
+		/* Loop tail (let the caller deal with this) */
+		--pc;
 		goto done;
 
 	case REOP_DEC_JMP: {
@@ -243,10 +248,11 @@ done:
 	return opcode;
 }
 
-PRIVATE WUNUSED NONNULL((1, 2, 3)) bool
+PRIVATE WUNUSED NONNULL((1, 2, 3, 5)) bool
 NOTHROW_NCX(CC input_can_match_both_ex)(struct re_code const *code,
                                         struct re_mini_interpreter *int1,
-                                        struct re_mini_interpreter *int2) {
+                                        struct re_mini_interpreter *int2,
+                                        bool consumed, bool *p_prunes) {
 	/* Process and compare opcodes from our 2 interpreters. */
 	struct re_mini_interpreter *int1_copy;
 	struct re_mini_interpreter *int2_copy;
@@ -258,7 +264,10 @@ NOTHROW_NCX(CC input_can_match_both_ex)(struct re_code const *code,
 	}	__WHILE0
 	int1_copy = NULL;
 	int2_copy = NULL;
+	goto start;
 again:
+	consumed = true;
+start:
 	opcode1 = re_mini_interpreter_getopcode(int1);
 	opcode2 = re_mini_interpreter_getopcode(int2);
 
@@ -276,10 +285,10 @@ again:
 		memcpy(int1_copy, int1, _re_mini_interpreter_sizeof(code->rc_nvars));
 		memcpy(int2_copy, int2, _re_mini_interpreter_sizeof(code->rc_nvars));
 		int1_copy->rmi_pc = pc1;
-		if (input_can_match_both_ex(code, int1_copy, int2_copy))
+		if (input_can_match_both_ex(code, int1_copy, int2_copy, consumed, p_prunes))
 			return true;
 		int1->rmi_pc = pc2;
-		goto again;
+		goto start;
 	}
 	if (opcode2 == REOP_JMP_ONFAIL) {
 		/* Must check both branches. */
@@ -294,17 +303,32 @@ again:
 		memcpy(int1_copy, int1, _re_mini_interpreter_sizeof(code->rc_nvars));
 		memcpy(int2_copy, int2, _re_mini_interpreter_sizeof(code->rc_nvars));
 		int2_copy->rmi_pc = pc1;
-		if (input_can_match_both_ex(code, int1_copy, int2_copy))
+		if (input_can_match_both_ex(code, int1_copy, int2_copy, consumed, p_prunes))
 			return true;
 		int2->rmi_pc = pc2;
-		goto again;
+		goto start;
 	}
 
+	/* Following  loops back to their start could recurse forever (e.g. "(\<)*"
+	 * never consumes input), so  just assume that both branches can match. */
+	if (opcode1 == REOP_JMP_AND_RETURN_ONFAIL || opcode2 == REOP_JMP_AND_RETURN_ONFAIL)
+		goto can_match_both;
+
 	if (opcode1 != opcode2) {
 		if (opcode1 == REOP_MATCHED || opcode2 == REOP_MATCHED) {
 			/* One of the 2 interpreters reached its end before the other.
 			 * -> Because of different length-requirements, it's  impossible
-			 *    for any kind of input to exist that matches both branches! */
+			 *    for any kind of input to exist that matches both branches!
+			 * Note that this isn't actually true when looking for the longest match:
+			 * the shorter branch still matches a prefix of the longer one, so  when
+			 * the longer branch ends up failing, the shorter one would have been  a
+			 * match (e.g. "b.*."). The only case where this really is exact is when
+			 * the on-fail branch  reaches the end of the  pattern without  consuming
+			 * input (or checking anything but `REOP_AT_EOI'), since the non-fail
+			 * branch can always take that same exit later on (e.g. "x.*"). */
+			if (!(opcode2 == REOP_MATCHED && !consumed && !int2->rmi_skipped_at &&
+			      (*int2->rmi_pc == REOP_MATCHED || *int2->rmi_pc == REOP_MATCHED_PERFECT)))
+				*p_prunes = true;
 			return false;
 		}
 	} else {
@@ -346,11 +370,14 @@ again:
 	 * - REOP_NBYTE2
 	 * - REOP_RANGE
 	 * - REOP_NRANGE
+	 * - REOP_BITSET
 	 * - REOP_CONTAINS_UTF8
 	 * - REOP_NCONTAINS_UTF8
 	 * - REOP_CS_UTF8
 	 * - REOP_CS_BYTE
 	 * - REOP_NCS_UTF8
+	 * - REOP_SEQ_UTF8
+	 * - REOP_NSEQ_UTF8
 	 */
 	switch (opcode1) {
 
@@ -397,11 +424,14 @@ again:
 		case REOP_NBYTE2:
 		case REOP_RANGE:
 		case REOP_NRANGE:
+		case REOP_BITSET:
 		case REOP_CONTAINS_UTF8:
 		case REOP_NCONTAINS_UTF8:
 		case REOP_CS_UTF8:
 		case REOP_CS_BYTE:
 		case REOP_NCS_UTF8:
+		case REOP_SEQ_UTF8:
+		case REOP_NSEQ_UTF8:
 			int2->rmi_pc = libre_opcode_next(int2->rmi_pc);
 			goto again;
 
@@ -566,11 +596,14 @@ compare_ascii_utf8_icase_exact:
 			__builtin_unreachable();
 		}
 
+		case REOP_BITSET:
 		case REOP_CONTAINS_UTF8:
 		case REOP_NCONTAINS_UTF8:
 		case REOP_CS_UTF8:
 		case REOP_CS_BYTE:
 		case REOP_NCS_UTF8:
+		case REOP_SEQ_UTF8:
+		case REOP_NSEQ_UTF8:
 			/* TODO */
 
 		default: break;
@@ -647,6 +680,8 @@ compare_ascii_utf8_icase_exact:
 		case REOP_CS_UTF8:
 		case REOP_CS_BYTE:
 		case REOP_NCS_UTF8:
+		case REOP_SEQ_UTF8:
+		case REOP_NSEQ_UTF8:
 			/* TODO */
 
 		default: break;
@@ -677,11 +712,14 @@ compare_ascii_utf8_icase_exact:
 		case REOP_NBYTE2:
 		case REOP_RANGE:
 		case REOP_NRANGE:
+		case REOP_BITSET:
 		case REOP_CONTAINS_UTF8:
 		case REOP_NCONTAINS_UTF8:
 		case REOP_CS_UTF8:
 		case REOP_CS_BYTE:
 		case REOP_NCS_UTF8:
+		case REOP_SEQ_UTF8:
+		case REOP_NSEQ_UTF8:
 			/* TODO */
 
 		default: break;
@@ -740,11 +778,14 @@ compare_ascii_utf8_icase_exact:
 		case REOP_NBYTE2:
 		case REOP_RANGE:
 		case REOP_NRANGE:
+		case REOP_BITSET:
 		case REOP_CONTAINS_UTF8:
 		case REOP_NCONTAINS_UTF8:
 		case REOP_CS_UTF8:
 		case REOP_CS_BYTE:
 		case REOP_NCS_UTF8:
+		case REOP_SEQ_UTF8:
+		case REOP_NSEQ_UTF8:
 			/* Because all of these always match at least 2 different bytes, and
 			 * because the int1-opcode matches all  bytes except for 1, we  know
 			 * that there is always  at least one byte  that is matched by  both
@@ -760,11 +801,14 @@ compare_ascii_utf8_icase_exact:
 	case REOP_NBYTE2:
 	case REOP_RANGE:
 	case REOP_NRANGE:
+	case REOP_BITSET:
 	case REOP_CONTAINS_UTF8:
 	case REOP_NCONTAINS_UTF8:
 	case REOP_CS_UTF8:
 	case REOP_CS_BYTE:
 	case REOP_NCS_UTF8:
+	case REOP_SEQ_UTF8:
+	case REOP_NSEQ_UTF8:
 		/* TODO */
 
 	default:
@@ -790,20 +834,48 @@ int2_after_exact_data:
  *                 (but not at the same time), on all possible branches, then
  *                 no input exists that can match both branches.
  *                 Example: "b?" -> no input can both match "b" and the epsilon-branch
+ * @param: p_prunes: Set to `true' if `false' is returned based on the above assumption in
+ *                   a case where it doesn't hold for longest-match semantics (s.a.
+ *                   `RE_CODE_FLAG_POPPRUNES'); left unchanged otherwise.
  * @return: true:  Yes, such input _does_ in deed exist (or it might if unsure).
  * @return: false: No, it's always one or the other. */
-PRIVATE WUNUSED NONNULL((1, 2, 3, 4)) bool
+PRIVATE WUNUSED NONNULL((1, 2, 3, 4, 5)) bool
 NOTHROW_NCX(CC input_can_match_both)(struct re_code const *code,
                                      byte_t const *pc1,
                                      byte_t const *pc2,
-                                     byte_t const *pc_end) {
+                                     byte_t const *pc_end,
+                                     bool *p_prunes) {
 	struct re_mini_interpreter *int1;
 	struct re_mini_interpreter *int2;
 	int1 = re_mini_interpreter_alloc(code->rc_nvars);
 	int2 = re_mini_interpreter_alloc(code->rc_nvars);
 	re_mini_interpreter_init(int1, pc1, pc_end);
 	re_mini_interpreter_init(int2, pc2, pc_end);
-	return input_can_match_both_ex(code, int1, int2);
+	return input_can_match_both_ex(code, int1, int2, false, p_prunes);
+}
+
+/* Check if the `REOP_TRIE' at `trie' leaves behind on-fail items when run, which
+ * is the case when a literal ends at a node from which longer ones continue. */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC trie_pushes_onfail)(byte_t const *__restrict trie, size_t nodeoff) {
+	byte_t const *node = trie + nodeoff;
+	for (;;) {
+		if ((*node & RETRIE_ACCEPT) && (*node & (RETRIE_RUN | RETRIE_BRANCH)))
+			return true;
+		if (*node & RETRIE_RUN) {
+			node += 1 + (*node & RETRIE_RUNMASK);
+		} else if (*node & RETRIE_BRANCH) {
+			size_t i, count = (size_t)node[1] + 1;
+			byte_t const *offsets = node + 2 + count;
+			for (i = 0; i < count; ++i) {
+				if (trie_pushes_onfail(trie, UNALIGNED_GET16(offsets + i * 2)))
+					return true;
+			}
+			return false;
+		} else {
+			return false;
+		}
+	}
 }
 
 /* Find the next unbalanced `REOP_MAYBE_POP_ONFAIL' opcode. */
@@ -889,7 +961,7 @@ dispatch:
 	case REOP_JMP_ONFAIL_DUMMY_AT:
 	case REOP_JMP_ONFAIL: {
 		unsigned int inner_flags;
-		bool bimatch_possible;
+		bool bimatch_possible, prunes;
 		byte_t *expr_start, *expr_end, *onfail_pc;
 		int16_t delta = getw();
 		assertf(delta >= 0, "Compiler should only ever generate position offsets for `REOP_JMP_ONFAIL[_DUMMY]'");
@@ -908,7 +980,8 @@ dispatch:
 		result |= inner_flags;
 
 		/* Figure out how we should replace the trailing `REOP_MAYBE_POP_ONFAIL' */
-		bimatch_possible = input_can_match_both(code, expr_start, onfail_pc, pc_end);
+		prunes           = false;
+		bimatch_possible = input_can_match_both(code, expr_start, onfail_pc, pc_end, &prunes);
 		if (bimatch_possible) {
 			/* Even after the non-failing branch has been matched, it is still possible
 			 * for input to be constructed such that we'll need to roll-back to run the
@@ -930,6 +1003,11 @@ dispatch:
 			 *
 			 * As such, we can pop on-fail items until we hit the one that was originally
 			 * pushed by the `REOP_JMP_ONFAIL' above. */
+			if (prunes || (inner_flags & PEEP_ONFAIL_STACK_F_UNBALANCED_ONFAIL)) {
+				/* Either our own on-fail item, or ones left behind by <X> (which we're
+				 * also about to pop) may still be needed to find the longest match. */
+				code->rc_flags |= RE_CODE_FLAG_POPPRUNES;
+			}
 			if (inner_flags & PEEP_ONFAIL_STACK_F_UNBALANCED_ONFAIL) {
 				/* Need to encode the more complicated `REOP_POP_ONFAIL_AT' opcode. */
 				*expr_end++ = REOP_POP_ONFAIL_AT;
@@ -1012,6 +1090,13 @@ dispatch:
 	 * Can be optimized to: "fooooooooo(o)bar"
 	 */
 
+	case REOP_TRIE:
+		/* Literals that are prefixes of others get pushed as on-fail items. */
+		if (trie_pushes_onfail(pc - 1, RETRIE_ROOT))
+			result |= PEEP_ONFAIL_STACK_F_UNBALANCED_ONFAIL;
+		pc = libre_opcode_next(pc - 1);
+		goto dispatch;
+
 	default:
 		/* Note how we don't follow `REOP_JMP' or `REOP_DEC_JMP' here!
 		 *
@@ -1194,6 +1279,101 @@ again:
 
 
 
+/* Check if `opcode' always consumes exactly 1 byte or character (and does nothing else) */
+PRIVATE ATTR_CONST WUNUSED bool
+NOTHROW_NCX(CC peep_is_span_opcode)(byte_t opcode) {
+	switch (opcode) {
+#ifdef REOP_ANY
+	case REOP_ANY:
+#endif /* REOP_ANY */
+#ifdef REOP_ANY_UTF8
+	case REOP_ANY_UTF8:
+#endif /* REOP_ANY_UTF8 */
+#ifdef REOP_ANY_NOTLF
+	case REOP_ANY_NOTLF:
+#endif /* REOP_ANY_NOTLF */
+#ifdef REOP_ANY_NOTLF_UTF8
+	case REOP_ANY_NOTLF_UTF8:
+#endif /* REOP_ANY_NOTLF_UTF8 */
+#ifdef REOP_ANY_NOTNUL
+	case REOP_ANY_NOTNUL:
+#endif /* REOP_ANY_NOTNUL */
+#ifdef REOP_ANY_NOTNUL_UTF8
+	case REOP_ANY_NOTNUL_UTF8:
+#endif /* REOP_ANY_NOTNUL_UTF8 */
+#ifdef REOP_ANY_NOTNUL_NOTLF
+	case REOP_ANY_NOTNUL_NOTLF:
+#endif /* REOP_ANY_NOTNUL_NOTLF */
+#ifdef REOP_ANY_NOTNUL_NOTLF_UTF8
+	case REOP_ANY_NOTNUL_NOTLF_UTF8:
+#endif /* REOP_ANY_NOTNUL_NOTLF_UTF8 */
+	case REOP_BYTE:
+	case REOP_NBYTE:
+	case REOP_BYTE2:
+	case REOP_NBYTE2:
+	case REOP_RANGE:
+	case REOP_NRANGE:
+	case REOP_BITSET:
+	case REOP_CONTAINS_UTF8:
+	case REOP_NCONTAINS_UTF8:
+	case REOP_CS_BYTE:
+	case REOP_CS_UTF8:
+	case REOP_NCS_UTF8:
+	case REOP_SEQ_UTF8:
+	case REOP_NSEQ_UTF8:
+		return true;
+	default:
+		break;
+	}
+	return false;
+}
+
+/* Check if `pc' is a `REOP_BYTE' or `REOP_EXACT' (after skipping group markers) */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC peep_is_literal)(byte_t const *__restrict pc) {
+	while (pc[0] == REOP_GROUP_START || pc[0] == REOP_GROUP_END)
+		pc += 2;
+	return pc[0] == REOP_BYTE || (pc[0] == REOP_EXACT && pc[1] != 0);
+}
+
+/* Turn loops around single-character opcodes into `REOP_SPAN[_AND_RETURN_ONFAIL]':
+ * >> 1:  <X>
+ * >>     REOP_JMP_AND_RETURN_ONFAIL 1b  // Becomes `REOP_SPAN_AND_RETURN_ONFAIL 1b'
+ * >> 2:
+ *
+ * >> 1:  <X>
+ * >>     REOP_POP_ONFAIL
+ * >>     REOP_JMP_AND_RETURN_ONFAIL 1b  // Becomes `REOP_SPAN 1b'
+ * >> 2:
+ * That way, "[^ ]* " no longer needs to push an on-fail item for every character it consumes.
+ * When `2:' is a literal (possibly preceded by group markers), use `REOP_SPAN_LIT[_AND_RETURN_ONFAIL]'
+ * instead, so ".*foo" or "\"[^\"]*\"" can go straight to where that literal appears. */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC peep_spans)(byte_t *pc) {
+	for (;;) {
+		byte_t opcode = *pc;
+		if (opcode == REOP_MATCHED || opcode == REOP_MATCHED_PERFECT)
+			break;
+		if (opcode == REOP_JMP_AND_RETURN_ONFAIL) {
+			byte_t *loop_pc = pc + 3 + delta16_get(pc + 1);
+			if (loop_pc < pc && peep_is_span_opcode(*loop_pc)) {
+				byte_t *loop_end = libre_opcode_next(loop_pc);
+				if (loop_end == pc) {
+					*pc = peep_is_literal(pc + 3)
+					      ? REOP_SPAN_LIT_AND_RETURN_ONFAIL
+					      : REOP_SPAN_AND_RETURN_ONFAIL;
+				} else if (*loop_end == REOP_POP_ONFAIL && loop_end + 1 == pc) {
+					*pc = peep_is_literal(pc + 3)
+					      ? REOP_SPAN_LIT
+					      : REOP_SPAN;
+				}
+			}
+		}
+		pc = libre_opcode_next(pc);
+	}
+}
+
+
 /* Apply peephole optimizations to the code produced by `self' */
 INTERN NONNULL((1)) void
 NOTHROW_NCX(CC libre_compiler_peephole)(struct re_compiler *__restrict self) {
@@ -1247,6 +1427,9 @@ NOTHROW_NCX(CC libre_compiler_peephole)(struct re_compiler *__restrict self) {
 	/* Remove all NOP opcodes from the code-stream */
 	libre_compiler_delnops(self);
 
+	/* Consume repetitions of single-character opcodes in one go */
+	peep_spans(self->rec_code->rc_code);
+
 	/* XXX: On host architectures without unaligned memory access, reflow generated
 	 *      code by inserting `REOP_NOP' opcodes before instructions with unaligned
 	 *      jump offsets.
@@ -0,0 +1,516 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGPIKE_C
+#define GUARD_LIBREGEX_REGPIKE_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <assert.h>
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libregex/regcomp.h>
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regdfa.h"
+#include "reginterp.h"
+#include "regpike.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+/* With `RE_EXEC_LINEAR', code is executed by following all of its  threads
+ * in lock-step (one byte of input at a time) instead of by backtracking.
+ * Every thread has its own copy of group offsets, and when two threads reach
+ * the same program counter at the same offset, only the one that was created
+ * first (iow: the one the interpreter would have tried first) is kept. As  a
+ * result, execution takes O(input_length * code_size) time, no matter what.
+ *
+ * Like in the interpreter, the longest match wins (or the first one if code
+ * ends with `REOP_MATCHED_PERFECT'), and group offsets of equally long matches
+ * are compared using `is_regmatch_better()'. However, because merged threads
+ * only keep the group offsets of one of them, not all combinations of group
+ * offsets are compared, so the result may differ from the interpreter's.
+ * Alternatives discarded by `REOP_POP_ONFAIL[_AT]' are still followed (those
+ * opcodes are no-ops here), so  matches can also be longer than ones  found
+ * by the interpreter for code with `RE_CODE_FLAG_POPPRUNES'.
+ *
+ * Opcode handling is shared with the DFA (threads use the same encoding),
+ * but assertions are simply checked against input, and so are supported
+ * for utf-8, too. */
+
+struct re_pike_frame {
+	uint32_t    pf_pcoff; /* Program counter offset to visit (or `(uint32_t)-1' to restore a slot) */
+	uint32_t    pf_slot;  /* [valid_if(pf_pcoff == (uint32_t)-1)] Slot to restore */
+	re_regoff_t pf_value; /* [valid_if(pf_pcoff == (uint32_t)-1)] Value to restore */
+};
+
+/* Thread slots are: 2 group offsets per group (only if the caller wants them),
+ * followed by the offset where the thread's match started. */
+struct re_pike {
+	struct re_exec const      *pk_exec;       /* [1..1][const] Exec command block */
+	byte_t const              *pk_code;       /* [1..1][const][== pk_exec->rx_code->rc_code] */
+	size_t                     pk_maxthreads; /* [const] Max # of threads that can be alive at once */
+	size_t                     pk_ngoffs;     /* [const] # of group offsets in thread slots (0 or `2 * rc_ngrps') */
+	size_t                     pk_nslots;     /* [const][== pk_ngoffs + 1] # of slots per thread */
+	re_dfa_thread_t           *pk_kernel;     /* [0..pk_maxthreads] Threads that just consumed input (by priority) */
+	re_regoff_t               *pk_kslots;     /* [pk_maxthreads * pk_nslots] Slots of `pk_kernel' */
+	re_dfa_thread_t           *pk_closure;    /* [0..pk_maxthreads] Threads that are about to consume input (by priority) */
+	re_regoff_t               *pk_cslots;     /* [pk_maxthreads * pk_nslots] Slots of `pk_closure' */
+	re_regoff_t               *pk_slots;      /* [pk_nslots] Slots of the thread being followed by `re_pike_closure()' */
+	re_regoff_t               *pk_bslots;     /* [pk_nslots][valid_if(pk_matched)] Slots of the best match */
+	struct re_pike_frame      *pk_stack;      /* [2 * code_size] Scratch buffer for `re_pike_closure()' */
+	uint32_t                  *pk_mark;       /* [4 * code_size] Threads seen by the current closure/step (`== pk_markgen') */
+	uint32_t                  *pk_cindex;     /* [code_size] Index of the thread at some PC in `pk_closure' (if it is there) */
+	uint32_t                   pk_markgen;    /* Marker of the current closure/step */
+	bool                       pk_perfect;    /* [const] Code ends with `REOP_MATCHED_PERFECT' */
+	bool                       pk_posix;      /* [const] Group offsets are needed, and `!pk_perfect' */
+	bool                       pk_matched;    /* True if a match was found */
+	size_t                     pk_bend;       /* [valid_if(pk_matched)] Offset where the best match ends */
+	struct re_interpreter_inptr pk_bmatch;    /* [valid_if(pk_matched)] Input pointer at the end of the best match */
+};
+
+/* Return the index of `thread' in `struct re_pike::pk_mark'. Threads in the middle
+ * of `REOP_EXACT*' use the offset of the next operand byte in place of their PC,
+ * and threads in the middle of `REOP_TRIE' that of their node (plus progress). */
+PRIVATE ATTR_CONST WUNUSED size_t
+NOTHROW_NCX(CC re_pike_markof)(re_dfa_thread_t thread) {
+	size_t pcoff = RE_DFA_THREAD_PCOFF(thread);
+	uint64_t aux = RE_DFA_THREAD_AUX(thread);
+	uint32_t progress = RE_DFA_AUX_PROGRESS(aux);
+	unsigned int len  = RE_DFA_AUX_UTF8LEN(aux);
+	if (len == 0 && RE_DFA_AUX_UTF8(aux) != 0)
+		return (pcoff + RE_DFA_AUX_UTF8(aux) + progress) * 4; /* `REOP_TRIE' */
+	if (progress != 0)
+		pcoff += 2 + progress;
+	return pcoff * 4 + len;
+}
+
+/* Create a new pike VM for `exec'
+ * @param: p_error:     Set to `RE_NOERROR', or to the reason why `exec' can't be executed at all
+ * @return: * :         The new pike VM
+ * @return: NULL:       `RE_EXEC_LINEAR' isn't set, or there is no input (`*p_error == RE_NOERROR';
+ *                      nothing can be backtracked over, so `libre_interp_exec()' may be used)
+ * @return: NULL:       The pike VM can't be used for `exec' (`*p_error == RE_ENOSYS')
+ * @return: NULL:       Out of memory (`*p_error == RE_ESPACE') */
+INTERN WUNUSED NONNULL((1, 2)) struct re_pike *
+NOTHROW_NCX(CC re_pike_new)(struct re_exec const *__restrict exec,
+                            re_errno_t *__restrict p_error) {
+	struct re_code const *code = exec->rx_code;
+	struct re_pike *result;
+	byte_t const *pc;
+	size_t codesize, maxthreads, ngoffs, nslots, slotsize;
+	*p_error = RE_NOERROR;
+	if (!(exec->rx_eflags & RE_EXEC_LINEAR))
+		return NULL;
+	if (exec->rx_startoff >= exec->rx_endoff)
+		return NULL; /* Epsilon input (and in multi-chunk mode, surrounding input isn't available for assertions) */
+	*p_error = RE_ENOSYS;
+	if (code->rc_flags & RE_CODE_FLAG_NEEDGROUPS)
+		return NULL; /* Back-references need the interpreter */
+
+	/* Check that all opcodes that appear in code are supported */
+	for (pc = code->rc_code; *pc != REOP_MATCHED && *pc != REOP_MATCHED_PERFECT;
+	     pc = libre_opcode_next(pc)) {
+		if (re_dfa_opkind(*pc) == RE_DFA_OP_UNSUPPORTED &&
+		    !(*pc >= REOP_AT_MIN && *pc <= REOP_AT_MAX))
+			return NULL;
+	}
+	codesize = (size_t)(pc - code->rc_code) + 1;
+	if unlikely(codesize > RE_DFA_PCOFF_MAX)
+		return NULL;
+	*p_error   = RE_ESPACE;
+	ngoffs     = exec->rx_nmatch ? code->rc_ngrps * 2 : 0;
+	nslots     = ngoffs + 1;
+	maxthreads = codesize * 4; /* == # of distinct indices in `pk_mark' */
+	if unlikely(OVERFLOW_UMUL(maxthreads * 2 + 2, nslots * sizeof(re_regoff_t), &slotsize))
+		return NULL;
+	result = (struct re_pike *)malloc(sizeof(struct re_pike) +
+	                                  maxthreads * 2 * sizeof(re_dfa_thread_t) +
+	                                  codesize * 2 * sizeof(struct re_pike_frame) +
+	                                  codesize * 5 * sizeof(uint32_t) +
+	                                  slotsize);
+	if unlikely(!result)
+		return NULL;
+	result->pk_exec       = exec;
+	result->pk_code       = code->rc_code;
+	result->pk_maxthreads = maxthreads;
+	result->pk_ngoffs     = ngoffs;
+	result->pk_nslots     = nslots;
+	result->pk_kernel     = (re_dfa_thread_t *)(result + 1);
+	result->pk_closure    = result->pk_kernel + maxthreads;
+	result->pk_stack      = (struct re_pike_frame *)(result->pk_closure + maxthreads);
+	result->pk_mark       = (uint32_t *)(result->pk_stack + codesize * 2);
+	result->pk_cindex     = result->pk_mark + codesize * 4;
+	result->pk_kslots     = (re_regoff_t *)(result->pk_cindex + codesize);
+	result->pk_cslots     = result->pk_kslots + maxthreads * nslots;
+	result->pk_slots      = result->pk_cslots + maxthreads * nslots;
+	result->pk_bslots     = result->pk_slots + nslots;
+	result->pk_markgen    = 0;
+	result->pk_perfect    = *pc == REOP_MATCHED_PERFECT;
+	result->pk_posix      = ngoffs != 0 && !result->pk_perfect;
+	result->pk_matched    = false;
+	bzero(result->pk_mark, codesize * 5 * sizeof(uint32_t));
+	*p_error = RE_NOERROR;
+	return result;
+}
+
+/* Begin a new closure/step of `self'
+ * @return: * : The marker to use for `self->pk_mark' */
+PRIVATE WUNUSED NONNULL((1)) uint32_t
+NOTHROW_NCX(CC re_pike_newgen)(struct re_pike *__restrict self) {
+	uint32_t result = ++self->pk_markgen;
+	if unlikely(result == 0) {
+		bzero(self->pk_mark, self->pk_maxthreads * sizeof(uint32_t));
+		result = self->pk_markgen = 1;
+	}
+	return result;
+}
+
+/* Record a match of the thread with slots `slots' that ends at the current position of `interp' */
+PRIVATE NONNULL((1, 2, 3)) void
+NOTHROW_NCX(CC re_pike_matched)(struct re_pike *__restrict self,
+                                struct re_interpreter *__restrict interp,
+                                re_regoff_t const *__restrict slots) {
+	size_t start = slots[self->pk_ngoffs];
+	size_t end   = re_interpreter_in_curoffset(interp);
+	if (self->pk_matched && !self->pk_perfect) {
+		/* Threads of matches that start later have lower priority (so the first match
+		 * to start  wins), but the threads of the best match may have found a longer
+		 * one (or one with better group offsets). */
+		size_t bstart = self->pk_bslots[self->pk_ngoffs];
+		if (start > bstart)
+			return;
+		if (start == bstart && end == self->pk_bend &&
+		    !(self->pk_ngoffs != 0 &&
+		      is_regmatch_better((re_regmatch_t const *)slots,
+		                         (re_regmatch_t const *)self->pk_bslots,
+		                         self->pk_exec->rx_code->rc_ngrps)))
+			return;
+	}
+	memcpy(self->pk_bslots, slots, self->pk_nslots * sizeof(re_regoff_t));
+	self->pk_bend    = end;
+	self->pk_bmatch  = interp->ri_in;
+	self->pk_matched = true;
+}
+
+/* Check if the thread with slots `a' is better than the one with slots `b' (when
+ * both are at the same PC): it either started earlier, or its group offsets are
+ * better (s.a. `is_regmatch_better()'). Only used if `self->pk_posix'. */
+PRIVATE ATTR_PURE WUNUSED NONNULL((1, 2, 3)) bool
+NOTHROW_NCX(CC re_pike_isbetter)(struct re_pike const *__restrict self,
+                                 re_regoff_t const *__restrict a,
+                                 re_regoff_t const *__restrict b) {
+	if (a[self->pk_ngoffs] != b[self->pk_ngoffs])
+		return a[self->pk_ngoffs] < b[self->pk_ngoffs];
+	return is_regmatch_better((re_regmatch_t const *)a, (re_regmatch_t const *)b,
+	                          self->pk_exec->rx_code->rc_ngrps);
+}
+
+/* Follow all epsilon-transitions (by priority) from threads in `self->pk_kernel', and
+ * (lastly) from a new thread at `inject' (unless that is `(size_t)-1'). Threads that
+ * are about to consume input are stored in `self->pk_closure', and matches that  are
+ * found are recorded in `self'. `interp' must point at the current position.
+ *
+ * Normally, a PC reached by multiple threads is only followed by the first one. But
+ * if `self->pk_posix', every thread follows its own transitions, and when threads
+ * end up at the same PC of `self->pk_closure', the better one  (`re_pike_isbetter()')
+ * is kept. That costs O(code_size^2) time per byte, but needs to be done since the
+ * group offsets of the longest match don't depend on thread priorities.
+ * @return: * : The # of threads written to `self->pk_closure' */
+PRIVATE WUNUSED NONNULL((1, 2)) size_t
+NOTHROW_NCX(CC re_pike_closure)(struct re_pike *__restrict self,
+                                struct re_interpreter *__restrict interp,
+                                size_t count, size_t inject) {
+	byte_t const *code = self->pk_code;
+	struct re_pike_frame *stack = self->pk_stack;
+	re_regoff_t *slots = self->pk_slots;
+	size_t i, nslots = self->pk_nslots, result = 0;
+	re_regoff_t offset = (re_regoff_t)re_interpreter_in_curoffset(interp);
+	uint32_t gen = re_pike_newgen(self);
+	for (i = 0; i <= count; ++i) {
+		size_t sp = 0, pcoff;
+		if (i < count) {
+			re_dfa_thread_t thread = self->pk_kernel[i];
+			memcpy(slots, self->pk_kslots + i * nslots, nslots * sizeof(re_regoff_t));
+			if (RE_DFA_THREAD_AUX(thread) != 0) {
+				/* Thread is in the middle of an opcode */
+				self->pk_closure[result] = thread;
+				memcpy(self->pk_cslots + result * nslots, slots, nslots * sizeof(re_regoff_t));
+				++result;
+				/* Where a literal of `REOP_TRIE' ends, the thread also continues
+				 * after  it  (with lower  priority,  as in  `libre_interp_exec()') */
+				pcoff = re_dfa_trieaccept(code, thread);
+				if (pcoff == (size_t)-1)
+					continue;
+			} else {
+				pcoff = RE_DFA_THREAD_PCOFF(thread);
+			}
+		} else {
+			if (inject == (size_t)-1)
+				break;
+			/* New thread (with all groups unset) */
+			memsetc(slots, RE_REGOFF_UNSET, nslots - 1, sizeof(re_regoff_t));
+			slots[nslots - 1] = offset;
+			pcoff = inject;
+		}
+		if (self->pk_posix && i != 0)
+			gen = re_pike_newgen(self);
+		for (;;) {
+			byte_t const *pc = code + pcoff;
+			byte_t opcode = *pc;
+			if (opcode == REOP_MATCHED || opcode == REOP_MATCHED_PERFECT) {
+				re_pike_matched(self, interp, slots);
+				if (self->pk_perfect)
+					return result; /* All remaining threads have lower priority */
+				goto next_frame;
+			}
+			if (self->pk_mark[pcoff * 4] == gen)
+				goto next_frame;
+			self->pk_mark[pcoff * 4] = gen;
+			switch (opcode) {
+
+			case REOP_GROUP_START:
+			case REOP_GROUP_END:
+			case_REOP_GROUP_END_JMIN_to_JMAX:
+				if (self->pk_ngoffs != 0) {
+					uint32_t slot = pc[1] * 2 + (opcode != REOP_GROUP_START);
+					stack[sp].pf_pcoff = (uint32_t)-1;
+					stack[sp].pf_slot  = slot;
+					stack[sp].pf_value = slots[slot];
+					++sp;
+					slots[slot] = offset;
+					if (opcode >= REOP_GROUP_END_JMIN && opcode <= REOP_GROUP_END_JMAX &&
+					    slots[slot - 1] >= slots[slot]) {
+						/* Group matched epsilon -> skip ahead (same as `libre_interp_exec()') */
+						pcoff += 2 + REOP_GROUP_END_Joff(opcode);
+						continue;
+					}
+				}
+				break;
+
+			case REOP_JMP:
+				pcoff = (size_t)((pc + 3 + delta16_get(pc + 1)) - code);
+				continue;
+
+			case REOP_JMP_ONFAIL:
+				/* The alternative is taken after everything that follows (has priority) */
+				stack[sp].pf_pcoff = (uint32_t)((pc + 3 + delta16_get(pc + 1)) - code);
+				++sp;
+				break;
+
+			case REOP_JMP_AND_RETURN_ONFAIL:
+			case REOP_SPAN:
+			case REOP_SPAN_AND_RETURN_ONFAIL:
+			case REOP_SPAN_LIT:
+			case REOP_SPAN_LIT_AND_RETURN_ONFAIL:
+				stack[sp].pf_pcoff = (uint32_t)(pcoff + 3);
+				++sp;
+				pcoff = (size_t)((pc + 3 + delta16_get(pc + 1)) - code);
+				continue;
+
+			default:
+				if (opcode >= REOP_AT_MIN && opcode <= REOP_AT_MAX) {
+					if (!re_interpreter_at(interp, opcode))
+						goto next_frame;
+				} else if (re_dfa_opkind(opcode) != RE_DFA_OP_EPSILON) {
+					/* Opcode consumes input */
+					re_dfa_thread_t thread = RE_DFA_THREAD(pcoff, 0);
+					size_t index = self->pk_cindex[pcoff];
+					if (index < result && self->pk_closure[index] == thread) {
+						/* Some other thread already got here */
+						re_regoff_t *oslots = self->pk_cslots + index * nslots;
+						if (self->pk_posix && re_pike_isbetter(self, slots, oslots))
+							memcpy(oslots, slots, nslots * sizeof(re_regoff_t));
+						goto next_frame;
+					}
+					assert(result < self->pk_maxthreads);
+					self->pk_cindex[pcoff]   = (uint32_t)result;
+					self->pk_closure[result] = thread;
+					memcpy(self->pk_cslots + result * nslots, slots, nslots * sizeof(re_regoff_t));
+					++result;
+					goto next_frame;
+				}
+				break;
+			}
+			pcoff = (size_t)(libre_opcode_next(pc) - code);
+			continue;
+next_frame:
+			for (;;) {
+				if (!sp)
+					goto next_thread;
+				--sp;
+				if (stack[sp].pf_pcoff != (uint32_t)-1)
+					break;
+				slots[stack[sp].pf_slot] = stack[sp].pf_value;
+			}
+			pcoff = stack[sp].pf_pcoff;
+		}
+next_thread:
+		;
+	}
+	return result;
+}
+
+/* Have all threads from `self->pk_closure[0..count-1]' consume `ch', and store
+ * the threads that survive in `self->pk_kernel' (by priority). Threads whose
+ * match would start after the best match found so far are discarded.
+ * @return: * :         The # of threads written to `self->pk_kernel'
+ * @return: (size_t)-1: Malformed utf-8 (the pike VM has to give up) */
+PRIVATE WUNUSED NONNULL((1)) size_t
+NOTHROW_NCX(CC re_pike_step)(struct re_pike *__restrict self,
+                             size_t count, byte_t ch) {
+	size_t i, nslots = self->pk_nslots, result = 0;
+	size_t maxstart = self->pk_matched ? self->pk_bslots[self->pk_ngoffs] : (size_t)-1;
+	uint32_t gen = re_pike_newgen(self);
+	for (i = 0; i < count; ++i) {
+		re_regoff_t const *slots = self->pk_cslots + i * nslots;
+		re_dfa_thread_t thread;
+		size_t mark;
+		if (slots[nslots - 1] > maxstart)
+			continue;
+		thread = re_dfa_stepthread(self->pk_code, self->pk_closure[i], ch);
+		if (thread == RE_DFA_THREAD_DEAD)
+			continue;
+		if unlikely(thread == RE_DFA_THREAD_ILLSEQ)
+			return (size_t)-1;
+		mark = re_pike_markof(thread);
+		if (self->pk_mark[mark] == gen)
+			continue; /* Thread with higher priority already exists */
+		self->pk_mark[mark] = gen;
+		self->pk_kernel[result] = thread;
+		memcpy(self->pk_kslots + result * nslots, slots, nslots * sizeof(re_regoff_t));
+		++result;
+	}
+	return result;
+}
+
+/* Use the pike VM to find the left-most match that starts within the next
+ * `search_range' bytes from the current position of `interp' (which must
+ * be valid for the input of `interp'). The longest (or first) match is
+ * chosen among those that start at the same offset.
+ * @return: -RE_NOERROR:     Input was matched (`interp' points at the end of the match,
+ *                           and group offsets were written to `interp->ri_pmatch')
+ * @return: -RE_NOMATCH:     Nothing was matched
+ * @return: RE_DFA_FALLBACK: The pike VM gave up (the position of `interp' is undefined) */
+INTERN WUNUSED NONNULL((1, 2, 4)) re_errno_t
+NOTHROW_NCX(CC re_pike_exec)(struct re_pike *__restrict self,
+                             struct re_interpreter *__restrict interp,
+                             size_t search_range, size_t *__restrict p_match_offset) {
+	struct re_code const *code = self->pk_exec->rx_code;
+	size_t count = 0, offset, inject_end;
+	offset     = re_interpreter_in_curoffset(interp);
+	inject_end = offset + search_range;
+	self->pk_matched = false;
+	for (;;) {
+		size_t inject = (size_t)-1;
+		bool eoi;
+		byte_t ch = 0;
+		if (count == 0 && !self->pk_matched && offset < inject_end) {
+			/* No threads are alive -> skip to the next offset where a match might start. */
+			size_t skip = re_interpreter_skip_candidates(interp, inject_end - offset);
+			if (skip >= inject_end - offset)
+				break;
+			offset += skip;
+		}
+		eoi = re_interpreter_is_eoi(interp);
+		if (!eoi) {
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+			if (!re_interpreter_in_chunk_cangetc(interp))
+				re_interpreter_nextchunk(interp);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+			ch = *interp->ri_in_ptr;
+		} else {
+			size_t i, j;
+			for (i = j = 0; i < count; ++i) {
+				re_dfa_thread_t thread = re_dfa_stepeoi(self->pk_code, self->pk_kernel[i]);
+				if (thread == RE_DFA_THREAD_DEAD)
+					continue;
+				self->pk_kernel[j] = thread;
+				memmove(self->pk_kslots + j * self->pk_nslots,
+				        self->pk_kslots + i * self->pk_nslots,
+				        self->pk_nslots * sizeof(re_regoff_t));
+				++j;
+			}
+			count = j;
+		}
+		if (!self->pk_matched && offset < inject_end) {
+			/* A new match may start here (same as `libre_interp_exec()': the fast-map decides where) */
+			byte_t fmap = eoi ? 0xff : code->rc_fmap[ch];
+			if (fmap != 0xff) {
+				inject = fmap;
+			} else if (code->rc_minmatch == 0) {
+				/* Must run code to find out if the epsilon match holds (e.g. "^$"),
+				 * and (in case of optional groups) which groups are set */
+				inject = 0;
+			}
+		}
+		count = re_pike_closure(self, interp, count, inject);
+		if (eoi)
+			break;
+		if (count == 0 && (self->pk_matched || offset + 1 >= inject_end))
+			break;
+		count = re_pike_step(self, count, ch);
+		if unlikely(count == (size_t)-1)
+			return RE_DFA_FALLBACK;
+		++interp->ri_in_ptr;
+		++offset;
+	}
+	if (!self->pk_matched)
+		return -RE_NOMATCH;
+	interp->ri_in = self->pk_bmatch;
+	memcpy(interp->ri_pmatch, self->pk_bslots, self->pk_ngoffs * sizeof(re_regoff_t));
+	*p_match_offset = self->pk_bslots[self->pk_ngoffs];
+	return -RE_NOERROR;
+}
+
+#undef HAVE_TRACE
+#undef TRACE
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGPIKE_C */
@@ -0,0 +1,70 @@
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGPIKE_H
+#define GUARD_LIBREGEX_REGPIKE_H 1
+
+#include "api.h"
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <stdlib.h>
+
+#include <libregex/regexec.h>
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "reginterp.h"
+
+DECL_BEGIN
+
+/* Pike VM (s.a. `RE_EXEC_LINEAR') */
+struct re_pike;
+
+#define re_pike_destroy(self) free(self)
+
+/* Create a new pike VM for `exec'
+ * @param: p_error:     Set to `RE_NOERROR', or to the reason why `exec' can't be executed at all
+ * @return: * :         The new pike VM
+ * @return: NULL:       `RE_EXEC_LINEAR' isn't set, or there is no input (`*p_error == RE_NOERROR';
+ *                      nothing can be backtracked over, so `libre_interp_exec()' may be used)
+ * @return: NULL:       The pike VM can't be used for `exec' (`*p_error == RE_ENOSYS')
+ * @return: NULL:       Out of memory (`*p_error == RE_ESPACE') */
+INTDEF WUNUSED NONNULL((1, 2)) struct re_pike *
+NOTHROW_NCX(CC re_pike_new)(struct re_exec const *__restrict exec,
+                            re_errno_t *__restrict p_error);
+
+/* Use the pike VM to find the left-most match that starts within the next
+ * `search_range' bytes from the current position of `interp' (which must
+ * be valid for the input of `interp'). The longest (or first) match is
+ * chosen among those that start at the same offset.
+ * @return: -RE_NOERROR:     Input was matched (`interp' points at the end of the match,
+ *                           and group offsets were written to `interp->ri_pmatch')
+ * @return: -RE_NOMATCH:     Nothing was matched
+ * @return: RE_DFA_FALLBACK: The pike VM gave up (the position of `interp' is undefined) */
+INTDEF WUNUSED NONNULL((1, 2, 4)) re_errno_t
+NOTHROW_NCX(CC re_pike_exec)(struct re_pike *__restrict self,
+                             struct re_interpreter *__restrict interp,
+                             size_t search_range, size_t *__restrict p_match_offset);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGPIKE_H */
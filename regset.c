@@ -0,0 +1,482 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGSET_C
+#define GUARD_LIBREGEX_REGSET_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <assert.h>
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libregex/regcomp.h>
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regcomp.h"
+#include "regdfa.h"
+#include "regexec.h"
+#include "reginterp.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+/* A set matches the same input against many patterns: the code of  every
+ * pattern that the DFA supports is concatenated into that of a single set
+ * DFA, which starts a new thread for every pattern before every byte, and
+ * tells patterns apart by the `REOP_MATCHED' opcode that a thread reached.
+ * That way, input is scanned only once, no matter how many patterns there
+ * are. Since states are cached by the set (rather than by a single call),
+ * scanning gets cheaper the more input has already been scanned before.
+ *
+ * Patterns that can match epsilon (whether they do still depends on assertions,
+ * e.g. `^$' or `\<'), and other patterns that the DFA doesn't support (e.g. ones
+ * with back-references), or that have to be searched for after the DFA gave up
+ * are searched for one-by-one. */
+
+/* Size of the state cache of a set DFA (in bytes) */
+#ifndef RE_SET_CACHESIZE
+#define RE_SET_CACHESIZE 0x100000
+#endif /* !RE_SET_CACHESIZE */
+
+/* How a pattern of a set is matched */
+#define RE_SET_KIND_DFA    0 /* Pattern is part of `struct re_set::rs_dfa' */
+#define RE_SET_KIND_SEARCH 1 /* Pattern is searched for using `libre_exec_search()' (e.g. because it can match epsilon) */
+
+struct re_set {
+	size_t                 rs_codec;  /* [const] # of patterns */
+	struct re_code const **rs_codev;  /* [1..1][rs_codec][const][owned] Patterns (the patterns themselves are owned by the caller, unless `rs_owned') */
+	byte_t                *rs_kindv;  /* [rs_codec][const] How every pattern is matched (one of `RE_SET_KIND_*') */
+	struct re_dfa         *rs_dfa;    /* [0..1][owned] Set DFA for patterns of kind `RE_SET_KIND_DFA' (NULL if there are none) */
+	unsigned int           rs_eflags; /* `RE_EXEC_NOTBOL | RE_EXEC_NOTEOL' flags that states of `rs_dfa' were computed for */
+	bool                   rs_owned;  /* [const] Patterns were compiled by `libre_set_compile()', and are freed with the set */
+};
+
+/* Create the set DFA of `self' (and assign the kinds of all patterns)
+ * @return: true:  Success (`self->rs_dfa' may still be `NULL' if no pattern can be part of it)
+ * @return: false: Out of memory */
+PRIVATE WUNUSED NONNULL((1)) bool
+NOTHROW_NCX(CC re_set_dfa_new)(struct re_set *__restrict self) {
+	struct re_dfa *dfa;
+	size_t i, setc = 0, codesize = 0, sigbits = 0;
+	uint8_t ctxmask = 0;
+	bool utf8 = false;
+	byte_t *code;
+	for (i = 0; i < self->rs_codec; ++i) {
+		struct re_code const *pattern = self->rs_codev[i];
+		size_t size;
+		self->rs_kindv[i] = RE_SET_KIND_SEARCH;
+		if (pattern->rc_minmatch == 0)
+			continue; /* Epsilon matches may still depend on assertions (e.g. `^$') */
+#if __SIZEOF_SIZE_T__ > 4
+		if unlikely(i > (uint32_t)-1)
+			continue; /* Index doesn't fit into `df_setindex' */
+#endif /* __SIZEOF_SIZE_T__ > 4 */
+		if (pattern->rc_flags & RE_CODE_FLAG_POPPRUNES)
+			continue; /* Interpreter semantics differ from a plain NFA */
+		size = re_dfa_scancode(pattern, &sigbits, &utf8, &ctxmask);
+		if (size == 0 || size > RE_DFA_PCOFF_MAX - codesize)
+			continue;
+		self->rs_kindv[i] = RE_SET_KIND_DFA;
+		codesize += size;
+		++setc;
+	}
+	self->rs_dfa = NULL;
+	if (setc == 0)
+		return true;
+	dfa = re_dfa_alloc(codesize, ctxmask, RE_SET_CACHESIZE,
+	                   codesize + (setc * 3 + 1) * sizeof(uint32_t));
+	if unlikely(!dfa)
+		return false;
+	dfa->df_exec     = NULL; /* Set by every call */
+	dfa->df_setc     = setc;
+	dfa->df_setstart = (uint32_t *)dfa->df_cacheend;
+	dfa->df_setindex = dfa->df_setstart + setc;
+	dfa->df_setmatch = dfa->df_setindex + setc;
+	code             = (byte_t *)(dfa->df_setmatch + 1 + setc);
+	dfa->df_code     = code;
+	for (i = 0, setc = 0; i < self->rs_codec; ++i) {
+		struct re_code const *pattern = self->rs_codev[i];
+		size_t size, unused_sigbits = 0;
+		bool unused_utf8 = false;
+		uint8_t unused_ctxmask = 0;
+		if (self->rs_kindv[i] != RE_SET_KIND_DFA)
+			continue;
+		size = re_dfa_scancode(pattern, &unused_sigbits, &unused_utf8, &unused_ctxmask);
+		dfa->df_setstart[setc] = (uint32_t)(code - dfa->df_code);
+		dfa->df_setindex[setc] = (uint32_t)i;
+		code = (byte_t *)mempcpy(code, pattern->rc_code, size);
+		++setc;
+	}
+	assert(code == dfa->df_code + dfa->df_codesize);
+	re_dfa_init_classes(dfa, NULL, sigbits, utf8);
+	self->rs_dfa    = dfa;
+	self->rs_eflags = 0;
+	return true;
+}
+
+/* Mark patterns `ids[1..ids[0]]' as matching in `matches'
+ * @return: * : The # of patterns that weren't marked before */
+PRIVATE NONNULL((1, 2)) size_t
+NOTHROW_NCX(CC re_set_mark)(byte_t *__restrict matches,
+                            uint32_t const *__restrict ids) {
+	uint32_t i;
+	size_t result = 0;
+	for (i = 1; i <= ids[0]; ++i) {
+		uint32_t index = ids[i];
+		byte_t mask = (byte_t)1 << (index % 8);
+		if (!(matches[index / 8] & mask)) {
+			matches[index / 8] |= mask;
+			++result;
+		}
+	}
+	return result;
+}
+
+/* Scan all of the input of `exec' (which mustn't be empty) using the set DFA of
+ * `self', and mark the patterns that match in `matches' (adding their # to `*p_count')
+ * @return: -RE_NOERROR:     Success
+ * @return: -RE_ESIZE:       `exec->rx_endoff - exec->rx_startoff' doesn't fit into 32 bits
+ * @return: RE_DFA_FALLBACK: The DFA gave up (patterns that were already marked do match) */
+PRIVATE WUNUSED NONNULL((1, 2, 3, 4)) re_errno_t
+NOTHROW_NCX(CC re_set_dfa_scan)(struct re_set *__restrict self,
+                                struct re_exec const *__restrict exec,
+                                byte_t *__restrict matches,
+                                size_t *__restrict p_count) {
+	struct re_dfa *dfa = self->rs_dfa;
+	struct re_interpreter *interp;
+	struct re_exec dfa_exec;
+	struct re_dfa_state *state;
+	re_errno_t result;
+	size_t found = 0;
+	bool flushed = false;
+	unsigned int eflags;
+
+	/* Cached states depend on these flags */
+	eflags = exec->rx_eflags & (RE_EXEC_NOTBOL | RE_EXEC_NOTEOL);
+	if (self->rs_eflags != eflags) {
+		re_dfa_flush(dfa);
+		self->rs_eflags = eflags;
+	}
+
+	/* The interpreter is only used to read input */
+	dfa_exec           = *exec;
+	dfa_exec.rx_code   = self->rs_codev[dfa->df_setindex[0]];
+	dfa_exec.rx_eflags &= ~RE_EXEC_CTX;
+	dfa->df_exec       = &dfa_exec;
+	interp = re_interpreter_alloc(dfa_exec.rx_code->rc_nvars);
+	result = re_interpreter_init(interp, &dfa_exec);
+	if unlikely(result != RE_NOERROR)
+		return -result;
+	result = RE_DFA_FALLBACK;
+	state  = re_dfa_getstate(dfa, 0, RE_DFA_CTX_SEARCH | re_dfa_getctx(dfa, interp), &flushed);
+	if unlikely(!state)
+		goto done;
+	for (;;) {
+		struct re_dfa_state *next;
+		uint32_t const *ids;
+		byte_t ch, cls;
+		bool accept;
+		if (re_interpreter_is_eoi(interp)) {
+			if (re_dfa_accepts_eoi(dfa, state, interp))
+				found += re_set_mark(matches, dfa->df_setmatch);
+			break;
+		}
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+		if (!re_interpreter_in_chunk_cangetc(interp))
+			re_interpreter_nextchunk(interp);
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+		ch   = *interp->ri_in_ptr;
+		cls  = dfa->df_classes[ch];
+		next = state->ds_next[cls];
+		if likely(next) {
+			accept = (state->ds_accept[cls / 8] & (1 << (cls % 8))) != 0;
+			ids    = state->ds_matches[cls];
+		} else {
+			next = re_dfa_transition(dfa, state, ch, &accept);
+			if unlikely(!next)
+				goto done;
+			ids = dfa->df_setmatch;
+		}
+		if (accept) {
+			found += re_set_mark(matches, ids);
+			if (found >= dfa->df_setc)
+				break; /* Nothing left to find */
+		}
+		++interp->ri_in_ptr;
+		++dfa->df_scanned;
+		state = next;
+	}
+	result = -RE_NOERROR;
+done:
+	*p_count += found;
+	re_interpreter_fini(interp);
+	return result;
+}
+
+/* Mark all patterns of `self' that match somewhere in the input of `exec' in `matches'
+ * @return: >= 0: The # of patterns marked in `matches'
+ * @return: < 0:  Negative error code (s.a. `libre_exec_search()') */
+PRIVATE WUNUSED NONNULL((1, 2, 3)) ssize_t
+NOTHROW_NCX(CC re_set_scan)(struct re_set *__restrict self,
+                            struct re_exec const *__restrict exec,
+                            byte_t *__restrict matches) {
+	struct re_exec search_exec;
+	size_t i, count = 0;
+	bool dfa_done = true;
+	bzero(matches, CEILDIV(self->rs_codec, 8));
+
+	/* Scan input once for all patterns of the set DFA (which can't match empty input) */
+	if (self->rs_dfa != NULL && exec->rx_startoff < exec->rx_endoff) {
+		re_errno_t error;
+		error = re_set_dfa_scan(self, exec, matches, &count);
+		if (error == RE_DFA_FALLBACK) {
+			dfa_done = false;
+		} else if unlikely(error != -RE_NOERROR) {
+			return error;
+		}
+	}
+
+	/* Search for the remaining patterns one-by-one */
+	search_exec           = *exec;
+	search_exec.rx_nmatch = 0;
+	for (i = 0; i < self->rs_codec; ++i) {
+		ssize_t error;
+		if (self->rs_kindv[i] == RE_SET_KIND_DFA && dfa_done)
+			continue;
+		if (matches[i / 8] & (1 << (i % 8)))
+			continue;
+		search_exec.rx_code = self->rs_codev[i];
+		error = libre_exec_search(&search_exec, (size_t)-1, NULL);
+		if (error >= 0) {
+			matches[i / 8] |= 1 << (i % 8);
+			++count;
+		} else if unlikely(error != -RE_NOMATCH) {
+			return error;
+		}
+	}
+	return (ssize_t)count;
+}
+
+/* Allocate a set for `codec' patterns (`rs_codev' must still be filled in)
+ * @return: NULL: Out of memory */
+PRIVATE WUNUSED struct re_set *
+NOTHROW_NCX(CC re_set_alloc)(size_t codec) {
+	struct re_set *result;
+	size_t size;
+	if (OVERFLOW_UMUL(codec, sizeof(struct re_code const *) + sizeof(byte_t), &size) ||
+	    OVERFLOW_UADD(size, sizeof(struct re_set), &size))
+		return NULL;
+	result = (struct re_set *)malloc(size);
+	if unlikely(!result)
+		return NULL;
+	result->rs_codec = codec;
+	result->rs_codev = (struct re_code const **)(result + 1);
+	result->rs_kindv = (byte_t *)(result->rs_codev + codec);
+	result->rs_dfa   = NULL;
+	result->rs_owned = false;
+	return result;
+}
+
+
+/* Create a set of patterns that can all be matched against the same input at
+ * once (in a single pass over input, rather than one per pattern, where possible)
+ * @param: codev: [codec] Patterns of the set (the caller must keep them alive
+ *                until the set is destroyed, but not the vector itself)
+ * @return: * :   The new set (to be destroyed using `re_set_destroy(3R)')
+ * @return: NULL: Out of memory */
+INTERN WUNUSED NONNULL((1)) struct re_set *
+NOTHROW_NCX(CC libre_set_new)(struct re_code const *const *__restrict codev, size_t codec) {
+	struct re_set *result;
+	result = re_set_alloc(codec);
+	if unlikely(!result)
+		return NULL;
+	memcpyc(result->rs_codev, codev, codec, sizeof(struct re_code const *));
+	if unlikely(!re_set_dfa_new(result)) {
+		free(result);
+		return NULL;
+	}
+	return result;
+}
+
+/* Compile `patternv' (each using `syntax', s.a. `re_compiler_init(3R)') and
+ * create a set of them, the same way `re_set_new(3R)' would. Compiled patterns
+ * belong to the set, and are freed by `re_set_destroy(3R)'.
+ * @param: patternv:    [patternc] NUL-terminated patterns of the set
+ * @param: p_errindex:  [0..1] Set to the index of the pattern that didn't compile
+ * @return: RE_NOERROR: Success (`*p_set' is the new set)
+ * @return: RE_ESPACE:  Out of memory
+ * @return: * :         Error of `re_compiler_compile(3R)' for `patternv[*p_errindex]' */
+INTERN WUNUSED NONNULL((1)) re_errno_t
+NOTHROW_NCX(CC libre_set_compile)(struct re_set **__restrict p_set,
+                                  char const *const *patternv, size_t patternc,
+                                  uintptr_t syntax, size_t *p_errindex) {
+	struct re_set *result;
+	re_errno_t error;
+	size_t i;
+	result = re_set_alloc(patternc);
+	if unlikely(!result)
+		return RE_ESPACE;
+	result->rs_owned = true;
+	for (i = 0; i < patternc; ++i) {
+		struct re_compiler compiler;
+		char const *pattern = patternv[i];
+		re_compiler_init(&compiler, pattern, strend(pattern), syntax);
+		error = libre_compiler_compile(&compiler);
+		if unlikely(error != RE_NOERROR) {
+			re_compiler_fini(&compiler);
+			if (p_errindex)
+				*p_errindex = i;
+			goto err_result;
+		}
+		result->rs_codev[i] = re_compiler_pack(&compiler);
+	}
+	if unlikely(!re_set_dfa_new(result)) {
+		error = RE_ESPACE;
+		goto err_result;
+	}
+	*p_set = result;
+	return RE_NOERROR;
+err_result:
+	result->rs_codec = i; /* Only free patterns that were compiled */
+	libre_set_destroy(result);
+	return error;
+}
+
+/* Destroy a set previously created by `re_set_new(3R)' or `re_set_compile(3R)' */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC libre_set_destroy)(struct re_set *__restrict self) {
+	if (self->rs_dfa != NULL)
+		re_dfa_destroy(self->rs_dfa);
+	if (self->rs_owned) {
+		size_t i;
+		for (i = 0; i < self->rs_codec; ++i)
+			free((void *)self->rs_codev[i]);
+	}
+	free(self);
+}
+
+/* Check which patterns of `self' match somewhere in the input of `exec' (with
+ * the same semantics as `re_exec_search(3R)' for an unlimited search range).
+ * `exec->rx_code', `exec->rx_nmatch' and `exec->rx_pmatch' are ignored.
+ * @param: matches: [CEILDIV(codec, 8)] Bitset of patterns that match (bit `i % 8'
+ *                  of `matches[i / 8]' is set if `codev[i]' matches)
+ * @return: >= 0:        The # of patterns that match
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+INTERN WUNUSED NONNULL((1, 2, 3)) ssize_t
+NOTHROW_NCX(CC libre_set_exec)(struct re_set *__restrict self,
+                               struct re_exec const *__restrict exec,
+                               byte_t *__restrict matches) {
+	return re_set_scan(self, exec, matches);
+}
+
+/* Same as `re_set_exec(3R)', but only return the index of the pattern whose match
+ * starts first (as per `re_exec_search(3R)'). When more than one pattern matches
+ * at that offset, the one that comes first in `codev' is returned. After a  scan
+ * for which patterns match at all, every pattern that does is searched for  once
+ * more (but only before the start of the best match found so far).
+ * @return: >= 0:        Index of the pattern with the leftmost match
+ * @return: -RE_NOMATCH: No pattern matches
+ * @return: -RE_ESPACE:  Out of memory
+ * @return: -RE_ESIZE:   On-failure stack became too large (or `rx_endoff - rx_startoff' doesn't fit into 32 bits). */
+INTERN WUNUSED NONNULL((1, 2)) ssize_t
+NOTHROW_NCX(CC libre_set_first)(struct re_set *__restrict self,
+                                struct re_exec const *__restrict exec) {
+	ssize_t result;
+	struct re_exec search_exec;
+	size_t i, search_range, size = CEILDIV(self->rs_codec, 8);
+	byte_t *matches;
+	if unlikely(size == 0)
+		return -RE_NOMATCH; /* Empty set */
+	matches = (byte_t *)malloc(size);
+	if unlikely(!matches)
+		return -RE_ESPACE;
+	result = re_set_scan(self, exec, matches);
+	if (result <= 0) {
+		if (result == 0)
+			result = -RE_NOMATCH;
+		goto done;
+	}
+
+	/* Only patterns that match somewhere have to be searched for. For every
+	 * one of them, only offsets before the best match so far are searched
+	 * (so that on a tie, the pattern with the lower index wins). */
+	search_exec           = *exec;
+	search_exec.rx_nmatch = 0;
+	search_range          = (size_t)-1;
+	result                = -RE_NOMATCH;
+	for (i = 0; i < self->rs_codec && search_range != 0; ++i) {
+		ssize_t offset;
+		if (!(matches[i / 8] & (1 << (i % 8))))
+			continue;
+		search_exec.rx_code = self->rs_codev[i];
+		offset = libre_exec_search(&search_exec, search_range, NULL);
+		if (offset >= 0) {
+			result       = (ssize_t)i;
+			search_range = (size_t)offset - exec->rx_startoff;
+		} else if unlikely(offset != -RE_NOMATCH) {
+			result = offset;
+			break;
+		}
+	}
+done:
+	free(matches);
+	return result;
+}
+
+#undef HAVE_TRACE
+#undef TRACE
+
+DEFINE_PUBLIC_ALIAS(re_set_new, libre_set_new);
+DEFINE_PUBLIC_ALIAS(re_set_compile, libre_set_compile);
+DEFINE_PUBLIC_ALIAS(re_set_destroy, libre_set_destroy);
+DEFINE_PUBLIC_ALIAS(re_set_exec, libre_set_exec);
+DEFINE_PUBLIC_ALIAS(re_set_first, libre_set_first);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGSET_C */
@@ -0,0 +1,368 @@
+/*[[[magic
+// Compile as `c', so we can use the "register" keyword for optimization hints
+options["COMPILE.language"] = "c";
+]]]*/
+/* Copyright (c) 2019-2025 Griefer@Work                                       *
+ *                                                                            *
+ * This software is provided 'as-is', without any express or implied          *
+ * warranty. In no event will the authors be held liable for any damages      *
+ * arising from the use of this software.                                     *
+ *                                                                            *
+ * Permission is granted to anyone to use this software for any purpose,      *
+ * including commercial applications, and to alter it and redistribute it     *
+ * freely, subject to the following restrictions:                             *
+ *                                                                            *
+ * 1. The origin of this software must not be misrepresented; you must not    *
+ *    claim that you wrote the original software. If you use this software    *
+ *    in a product, an acknowledgement (see the following) in the product     *
+ *    documentation is required:                                              *
+ *    Portions Copyright (c) 2019-2025 Griefer@Work                           *
+ * 2. Altered source versions must be plainly marked as such, and must not be *
+ *    misrepresented as being the original software.                          *
+ * 3. This notice may not be removed or altered from any source distribution. *
+ */
+#ifndef GUARD_LIBREGEX_REGSTREAM_C
+#define GUARD_LIBREGEX_REGSTREAM_C 1
+#define _KOS_SOURCE 1
+#define _GNU_SOURCE 1
+#define LIBREGEX_WANT_PROTOTYPES
+
+#include "api.h"
+/**/
+
+#ifndef LIBREGEX_NO_SYSTEM_INCLUDES
+#include <hybrid/compiler.h>
+
+#include <kos/types.h>
+
+#include <assert.h>
+#include <ctype.h>
+#include <malloc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libregex/regcomp.h>
+#include <libregex/regexec.h>
+
+#if 0
+#include <sys/syslog.h>
+#define HAVE_TRACE
+#define TRACE(...) syslog(LOG_DEBUG, __VA_ARGS__)
+#endif
+#endif /* !LIBREGEX_NO_SYSTEM_INCLUDES */
+
+#include "regdfa.h"
+#include "regexec.h"
+#include "reginterp.h"
+
+#ifndef TRACE
+#undef HAVE_TRACE
+#define TRACE(...) (void)0
+#endif /* !TRACE */
+
+DECL_BEGIN
+
+/* A stream keeps a window of input: bytes from (a little before) the first
+ * offset where a match might still start, up to the end of what was fed so
+ * far. Searches are performed on the window as though it was all of input,
+ * and a match that they find is returned once a DFA (used for nothing else)
+ * shows that all threads which started at, or before it have died before
+ * the end of the window: from then on, no further input can change it.
+ *
+ * When no match is found, the window is shortened to the first offset from
+ * where threads are still alive. Patterns that the DFA can't be used for are
+ * rejected by `re_stream_new(3R)'. Should the DFA give up later on, all input
+ * is kept, and matches are only returned after `re_stream_finish(3R)' */
+
+/* # of bytes kept before the first offset where a match might still start
+ * (so `REOP_AT_*' can see what came before it, even if it's a utf-8 char) */
+#define RE_STREAM_LOOKBEHIND 4
+
+struct re_stream {
+	struct re_exec      rs_exec;   /* Exec command block for the window (`rx_eflags' are those given by the caller) */
+#ifndef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	struct iovec        rs_iov;    /* [== { rs_buf, rs_len }] Input chunk for `rs_exec' */
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	struct re_exec_ctx  rs_ctx;    /* Buffers kept for searches */
+	struct re_dfa      *rs_dfa;    /* [0..1][owned] DFA to tell when threads have died (NULL if it gave up) */
+	byte_t             *rs_buf;    /* [0..rs_len][owned(free)] Window of input */
+	size_t              rs_len;    /* # of bytes in `rs_buf' */
+	size_t              rs_alloc;  /* Allocated # of bytes in `rs_buf' */
+	size_t              rs_cur;    /* [<= rs_len] Offset in `rs_buf' of the first byte where a match might still start */
+	uint64_t            rs_base;   /* Absolute offset of `rs_buf[0]' */
+	bool                rs_done;   /* True if `re_stream_finish(3R)' was called */
+};
+
+/* Follow the threads that start at the first `range' offsets from `start' in
+ * the window of `self' (using `self->rs_dfa'), until all of them have died, or
+ * the end of the window is reached.
+ * @param: p_accept: Set to true if a match ends before the end of the window (if this
+ *                   happens while threads are still being started, stop there)
+ * @return: * :         The greatest offset `<= self->rs_len' by which all threads that
+ *                      started before it had died (`>= start + range' if all of them did)
+ * @return: (size_t)-1: The DFA gave up */
+PRIVATE WUNUSED NONNULL((1, 4)) size_t
+NOTHROW_NCX(CC re_stream_walk)(struct re_stream *__restrict self,
+                               size_t start, size_t range,
+                               bool *__restrict p_accept) {
+	struct re_dfa *dfa = self->rs_dfa;
+	struct re_dfa_state *state;
+	size_t offset, result;
+	bool flushed = false;
+	uint8_t ctx;
+	if (start == 0) {
+		ctx = RE_DFA_CTX_SOI & dfa->df_ctxmask;
+	} else {
+		ctx = re_dfa_ctxof(dfa, self->rs_buf[start - 1]);
+	}
+	state = re_dfa_getstate(dfa, 0, RE_DFA_CTX_SEARCH | ctx, &flushed);
+	if unlikely(!state)
+		return (size_t)-1;
+	for (offset = result = start;; ++offset) {
+		struct re_dfa_state *next;
+		byte_t ch, cls;
+		bool accept;
+		if ((state->ds_ctx & RE_DFA_CTX_SEARCH) && offset >= start + range) {
+			/* No more threads are started from here on. */
+			memcpy(dfa->df_kernel, state->ds_threads,
+			       state->ds_count * sizeof(re_dfa_thread_t));
+			state = re_dfa_getstate(dfa, state->ds_count,
+			                        state->ds_ctx & ~RE_DFA_CTX_SEARCH,
+			                        &flushed);
+			if unlikely(!state)
+				return (size_t)-1;
+		}
+		if (state->ds_count == 0) {
+			result = offset;
+			if (!(state->ds_ctx & RE_DFA_CTX_SEARCH))
+				break; /* All threads have died */
+		}
+		if (offset >= self->rs_len)
+			break;
+		ch   = self->rs_buf[offset];
+		cls  = dfa->df_classes[ch];
+		next = state->ds_next[cls];
+		if likely(next) {
+			accept = (state->ds_accept[cls / 8] & (1 << (cls % 8))) != 0;
+		} else {
+			next = re_dfa_transition(dfa, state, ch, &accept);
+			if unlikely(!next)
+				return (size_t)-1;
+		}
+		++dfa->df_scanned;
+		if (accept) {
+			*p_accept = true;
+			if (state->ds_ctx & RE_DFA_CTX_SEARCH)
+				break; /* Caller has to search for the match */
+		}
+		state = next;
+	}
+	return result;
+}
+
+/* Drop bytes from the start of the window of `self' that are no longer needed */
+PRIVATE NONNULL((1)) void
+NOTHROW_NCX(CC re_stream_compact)(struct re_stream *__restrict self) {
+	size_t drop;
+	if (self->rs_cur <= RE_STREAM_LOOKBEHIND)
+		return;
+	drop = self->rs_cur - RE_STREAM_LOOKBEHIND;
+	memmovedown(self->rs_buf, self->rs_buf + drop, self->rs_len - drop);
+	self->rs_len  -= drop;
+	self->rs_cur  -= drop;
+	self->rs_base += drop;
+}
+
+/* Search the window of `self' (from `rs_cur') as though it was all of input.
+ * @return: >= 0: Offset in the window where the match starts
+ * @return: < 0:  Negative error code (s.a. `libre_exec_search_noepsilon()') */
+PRIVATE WUNUSED NONNULL((1, 2)) ssize_t
+NOTHROW_NCX(CC re_stream_search)(struct re_stream *__restrict self,
+                                 size_t *__restrict p_match_size) {
+	struct re_exec exec = self->rs_exec;
+#ifdef LIBREGEX_REGEXEC_SINGLE_CHUNK
+	exec.rx_inbase = self->rs_buf;
+	exec.rx_insize = self->rs_len;
+#else /* LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	self->rs_iov.iov_base = self->rs_buf;
+	self->rs_iov.iov_len  = self->rs_len;
+	exec.rx_iov   = &self->rs_iov;
+	exec.rx_extra = 0;
+#endif /* !LIBREGEX_REGEXEC_SINGLE_CHUNK */
+	exec.rx_startoff = self->rs_cur;
+	exec.rx_endoff   = self->rs_len;
+	exec.rx_eflags |= RE_EXEC_CTX;
+	exec.rx_ctx = &self->rs_ctx;
+	if (!self->rs_done)
+		exec.rx_eflags |= RE_EXEC_NOTEOL; /* The end of the window isn't the end of input */
+	return libre_exec_search_noepsilon(&exec, (size_t)-1, p_match_size);
+}
+
+
+/* Create a stream for searching `code' in input that arrives piece by piece
+ * @param: eflags:      Set of `RE_EXEC_NOTBOL | RE_EXEC_NOTEOL | RE_EXEC_LINEAR'
+ * @return: RE_NOERROR: Success (`*p_stream' is the new stream, to be destroyed using `re_stream_destroy(3R)')
+ * @return: RE_ESPACE:  Out of memory
+ * @return: RE_ENOSYS:  `code' can't be matched by a DFA (s.a. `re_dfa_scancode()') */
+INTERN WUNUSED NONNULL((1, 2)) re_errno_t
+NOTHROW_NCX(CC libre_stream_new)(struct re_stream **__restrict p_stream,
+                                 struct re_code const *__restrict code,
+                                 unsigned int eflags) {
+	struct re_stream *result;
+	struct re_dfa *dfa;
+	size_t codesize, sigbits = 0;
+	uint8_t ctxmask = 0;
+	bool utf8 = false;
+
+	/* Without a DFA, there'd be no telling when a match is final, so all
+	 * input would have to be kept until `re_stream_finish(3R)'. */
+	codesize = re_dfa_scancode(code, &sigbits, &utf8, &ctxmask);
+	if (codesize == 0 || codesize > RE_DFA_PCOFF_MAX)
+		return RE_ENOSYS;
+	result = (struct re_stream *)malloc(sizeof(struct re_stream));
+	if unlikely(!result)
+		return RE_ESPACE;
+	dfa = re_dfa_alloc(codesize, ctxmask, RE_DFA_CACHESIZE, 0);
+	if unlikely(!dfa) {
+		free(result);
+		return RE_ESPACE;
+	}
+	bzero(&result->rs_exec, sizeof(result->rs_exec));
+	result->rs_exec.rx_code   = code;
+	result->rs_exec.rx_eflags = eflags & (RE_EXEC_NOTBOL | RE_EXEC_NOTEOL | RE_EXEC_LINEAR);
+	re_exec_ctx_init(&result->rs_ctx);
+	dfa->df_exec = &result->rs_exec;
+	dfa->df_code = code->rc_code;
+	re_dfa_init_classes(dfa, code->rc_fmap, sigbits, utf8);
+	result->rs_dfa   = dfa;
+	result->rs_buf   = NULL;
+	result->rs_len   = 0;
+	result->rs_alloc = 0;
+	result->rs_cur   = 0;
+	result->rs_base  = 0;
+	result->rs_done  = false;
+	*p_stream = result;
+	return RE_NOERROR;
+}
+
+/* Destroy a stream previously created by `re_stream_new(3R)' */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC libre_stream_destroy)(struct re_stream *__restrict self) {
+	if (self->rs_dfa != NULL)
+		re_dfa_destroy(self->rs_dfa);
+	libre_exec_ctx_fini(&self->rs_ctx);
+	free(self->rs_buf);
+	free(self);
+}
+
+/* Append `size' bytes from `data' to the input of `self'
+ * @return: RE_NOERROR: Success
+ * @return: RE_ESPACE:  Out of memory */
+INTERN WUNUSED NONNULL((1)) re_errno_t
+NOTHROW_NCX(CC libre_stream_feed)(struct re_stream *__restrict self,
+                                  void const *data, size_t size) {
+	assertf(!self->rs_done, "Input was already finished");
+	if (size > self->rs_alloc - self->rs_len) {
+		size_t new_alloc;
+		re_stream_compact(self);
+		if (OVERFLOW_UADD(self->rs_len, size, &new_alloc))
+			return RE_ESPACE;
+		if (new_alloc > self->rs_alloc) {
+			byte_t *new_buf;
+			if (new_alloc < self->rs_alloc * 2)
+				new_alloc = self->rs_alloc * 2;
+			new_buf = (byte_t *)realloc(self->rs_buf, new_alloc);
+			if unlikely(!new_buf)
+				return RE_ESPACE;
+			self->rs_buf   = new_buf;
+			self->rs_alloc = new_alloc;
+		}
+	}
+	memcpy(self->rs_buf + self->rs_len, data, size);
+	self->rs_len += size;
+	return RE_NOERROR;
+}
+
+/* Mark the end of the input of `self' */
+INTERN NONNULL((1)) void
+NOTHROW_NCX(CC libre_stream_finish)(struct re_stream *__restrict self) {
+	self->rs_done = true;
+}
+
+/* Return the next match in the input of `self'
+ * @param: p_match_start: Set to the absolute offset where the match starts
+ * @return: > 0:          The # of bytes that were matched
+ * @return: -RE_NOMATCH:  No further match is known yet (or ever, after `re_stream_finish(3R)')
+ * @return: -RE_ENOSYS:   The DFA gave up (matches are only known after `re_stream_finish(3R)')
+ * @return: -RE_ESPACE:   Out of memory
+ * @return: -RE_ESIZE:    On-failure stack became too large (or the window doesn't fit into 32 bits) */
+INTERN WUNUSED NONNULL((1, 2)) ssize_t
+NOTHROW_NCX(CC libre_stream_next)(struct re_stream *__restrict self,
+                                  uint64_t *__restrict p_match_start) {
+	ssize_t start;
+	size_t size, dead = self->rs_cur;
+	bool accept = false;
+	if (!self->rs_done) {
+		if (self->rs_cur >= self->rs_len)
+			return -RE_NOMATCH; /* Wait for more input */
+		if (self->rs_dfa == NULL)
+			return -RE_ENOSYS; /* Can't tell when matches are final */
+
+		/* Skip offsets from where threads have already died. Unless a thread
+		 * reached a match on the way, there's nothing else to do for now. */
+		dead = re_stream_walk(self, self->rs_cur, self->rs_len - self->rs_cur, &accept);
+		if unlikely(dead == (size_t)-1)
+			goto fallback;
+		if (!accept) {
+			self->rs_cur = dead;
+			return -RE_NOMATCH;
+		}
+	}
+	start = re_stream_search(self, &size);
+	if unlikely(start < 0) {
+		if (start == -RE_NOMATCH)
+			self->rs_cur = self->rs_done ? self->rs_len : dead;
+		return start;
+	}
+	if (!self->rs_done) {
+		/* Check that no further input can result in a different match. */
+		if ((size_t)start > self->rs_cur) {
+			dead = re_stream_walk(self, self->rs_cur, (size_t)start - self->rs_cur, &accept);
+			if unlikely(dead == (size_t)-1)
+				goto fallback;
+			if (dead < (size_t)start) {
+				self->rs_cur = dead;
+				return -RE_NOMATCH; /* A match might still start earlier */
+			}
+		}
+		dead = re_stream_walk(self, (size_t)start, 1, &accept);
+		if unlikely(dead == (size_t)-1)
+			goto fallback;
+		if (dead <= (size_t)start) {
+			self->rs_cur = (size_t)start;
+			return -RE_NOMATCH; /* The match might still become longer */
+		}
+	}
+	*p_match_start = self->rs_base + (size_t)start;
+	self->rs_cur   = (size_t)start + size;
+	return (ssize_t)size;
+fallback:
+	re_dfa_destroy(self->rs_dfa);
+	self->rs_dfa = NULL;
+	return -RE_ENOSYS;
+}
+
+#undef HAVE_TRACE
+#undef TRACE
+
+DEFINE_PUBLIC_ALIAS(re_stream_new, libre_stream_new);
+DEFINE_PUBLIC_ALIAS(re_stream_destroy, libre_stream_destroy);
+DEFINE_PUBLIC_ALIAS(re_stream_feed, libre_stream_feed);
+DEFINE_PUBLIC_ALIAS(re_stream_finish, libre_stream_finish);
+DEFINE_PUBLIC_ALIAS(re_stream_next, libre_stream_next);
+
+DECL_END
+
+#endif /* !GUARD_LIBREGEX_REGSTREAM_C */